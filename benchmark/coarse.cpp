@@ -0,0 +1,276 @@
+/*
+ *
+ * Copyright (C) 2025 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+// Benchmark of the coarse library driving coarse_alloc() and coarse_free()
+// directly (without any pool or memory provider) over a fixed memory region.
+// Every thread runs a random mix of allocations of sizes and alignments
+// of a wide range and frees of its live allocations in a random order.
+// For every allocation strategy, number of threads and number of arenas
+// it reports the throughput, the median and the p99 latency of operations
+// and the fragmentation of the free memory measured at the end
+// of the workload: the largest free block / total free memory.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "coarse.h"
+#include "multithread.hpp"
+#include "utils_common.h"
+
+struct bench_params {
+    size_t n_ops = 200000;   // number of operations per thread
+    size_t max_live = 2048;  // maximum number of live allocations per thread
+    size_t min_size = 64;    // minimum allocation size
+    size_t max_size = 65536; // maximum allocation size
+    size_t heap_size_per_thread = 128 * 1024 * 1024;
+};
+
+struct bench_results {
+    double ops_per_sec;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    size_t n_failures;
+    double largest_free_ratio;
+};
+
+static const struct {
+    coarse_strategy_t strategy;
+    const char *name;
+} strategies[] = {
+    {UMF_COARSE_MEMORY_STRATEGY_FASTEST_BUT_ONE, "fastest_but_one"},
+    {UMF_COARSE_MEMORY_STRATEGY_FASTEST, "fastest"},
+    {UMF_COARSE_MEMORY_STRATEGY_CHECK_ALL_SIZE, "check_all_size"},
+    {UMF_COARSE_MEMORY_STRATEGY_TLSF, "tlsf"},
+    {UMF_COARSE_MEMORY_STRATEGY_BEST_FIT, "best_fit"},
+};
+
+// most of allocations do not require any alignment
+static const size_t alignments[] = {0, 0, 0, 0, 64, 256, 4096, 65536};
+
+// the fixed memory is never accessed, so split and merge always succeed
+static umf_result_t split_cb(void *provider, void *ptr, size_t totalSize,
+                             size_t firstSize) {
+    (void)provider;  // unused
+    (void)ptr;       // unused
+    (void)totalSize; // unused
+    (void)firstSize; // unused
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t merge_cb(void *provider, void *lowPtr, void *highPtr,
+                             size_t totalSize) {
+    (void)provider;  // unused
+    (void)lowPtr;    // unused
+    (void)highPtr;   // unused
+    (void)totalSize; // unused
+    return UMF_RESULT_SUCCESS;
+}
+
+struct allocation {
+    void *ptr;
+    size_t size;
+};
+
+// size of allocations is log-uniformly distributed
+// from bench.min_size to bench.max_size
+static size_t random_size(std::mt19937_64 &rng, const bench_params &bench) {
+    std::uniform_real_distribution<double> dist(
+        std::log2((double)bench.min_size), std::log2((double)bench.max_size));
+    return (size_t)std::exp2(dist(rng));
+}
+
+template <typename F> static uint64_t measure_ns(F &&func) {
+    return umf_bench::measure<std::chrono::nanoseconds>(
+        std::forward<F>(func));
+}
+
+static bench_results run_coarse(coarse_strategy_t strategy, size_t n_threads,
+                                unsigned num_arenas,
+                                const bench_params &bench) {
+    size_t page_size = utils_get_page_size();
+    size_t heap_size = bench.heap_size_per_thread * n_threads;
+
+    // the memory is only reserved, it is never touched
+    void *heap = std::malloc(heap_size + page_size);
+    if (heap == nullptr) {
+        std::cerr << "heap allocation failed" << std::endl;
+        abort();
+    }
+    void *heap_aligned = (void *)ALIGN_UP_SAFE((uintptr_t)heap, page_size);
+
+    coarse_params_t coarse_params;
+    memset(&coarse_params, 0, sizeof(coarse_params));
+    coarse_params.provider = heap;
+    coarse_params.page_size = page_size;
+    coarse_params.cb.split = split_cb;
+    coarse_params.cb.merge = merge_cb;
+    coarse_params.allocation_strategy = strategy;
+    coarse_params.num_arenas = num_arenas;
+
+    coarse_t *coarse = nullptr;
+    umf_result_t ret = coarse_new(&coarse_params, &coarse);
+    if (ret != UMF_RESULT_SUCCESS) {
+        std::cerr << "coarse_new() failed" << std::endl;
+        abort();
+    }
+
+    ret = coarse_add_memory_fixed(coarse, heap_aligned, heap_size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        std::cerr << "coarse_add_memory_fixed() failed" << std::endl;
+        abort();
+    }
+
+    std::vector<std::vector<uint64_t>> latencies(n_threads);
+    std::vector<std::vector<allocation>> live(n_threads);
+    std::vector<size_t> n_failures(n_threads);
+    std::vector<uint64_t> durations(n_threads);
+    coarse_stats_t end_stats = coarse_get_stats(coarse);
+
+    umf_test::syncthreads_barrier syncthreads(n_threads);
+    umf_test::parallel_exec(n_threads, [&](size_t id) {
+        std::mt19937_64 rng(id + 1);
+        std::uniform_int_distribution<size_t> alignment_dist(
+            0, sizeof(alignments) / sizeof(alignments[0]) - 1);
+        auto &thread_latencies = latencies[id];
+        auto &thread_live = live[id];
+        thread_latencies.reserve(bench.n_ops);
+        thread_live.reserve(bench.max_live);
+
+        syncthreads();
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < bench.n_ops; i++) {
+            // keep the heap about half full on average,
+            // the live allocations are freed in a random order
+            bool do_free = thread_live.size() == bench.max_live ||
+                           (!thread_live.empty() && (rng() & 1));
+            if (do_free) {
+                size_t idx = rng() % thread_live.size();
+                allocation a = thread_live[idx];
+                thread_live[idx] = thread_live.back();
+                thread_live.pop_back();
+
+                thread_latencies.push_back(measure_ns(
+                    [&]() { coarse_free(coarse, a.ptr, a.size); }));
+                continue;
+            }
+
+            size_t size = random_size(rng, bench);
+            size_t alignment = alignments[alignment_dist(rng)];
+            void *ptr = nullptr;
+            umf_result_t umf_result = UMF_RESULT_SUCCESS;
+
+            thread_latencies.push_back(measure_ns([&]() {
+                umf_result = coarse_alloc(coarse, size, alignment, &ptr);
+            }));
+
+            if (umf_result != UMF_RESULT_SUCCESS) {
+                n_failures[id]++;
+                continue;
+            }
+
+            thread_live.push_back({ptr, size});
+        }
+        durations[id] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+        // the fragmentation is measured when all threads are done,
+        // before their live allocations are freed
+        syncthreads();
+        if (id == 0) {
+            end_stats = coarse_get_stats(coarse);
+        }
+        syncthreads();
+
+        for (auto &a : thread_live) {
+            coarse_free(coarse, a.ptr, a.size);
+        }
+        thread_live.clear();
+    });
+
+    coarse_stats_t stats = coarse_get_stats(coarse);
+    if (stats.used_size != 0) {
+        std::cerr << "memory leak detected: " << stats.used_size << " bytes"
+                  << std::endl;
+        abort();
+    }
+
+    coarse_delete(coarse);
+    std::free(heap);
+
+    std::vector<uint64_t> all_latencies;
+    for (auto &v : latencies) {
+        all_latencies.insert(all_latencies.end(), v.begin(), v.end());
+    }
+    std::sort(all_latencies.begin(), all_latencies.end());
+
+    bench_results results;
+    results.ops_per_sec = (double)(bench.n_ops * n_threads) /
+                          (umf_bench::max(durations) / 1e9);
+    results.p50_ns = all_latencies[all_latencies.size() / 2];
+    results.p99_ns = all_latencies[all_latencies.size() * 99 / 100];
+    results.n_failures = 0;
+    for (auto n : n_failures) {
+        results.n_failures += n;
+    }
+
+    size_t free_size = end_stats.alloc_size - end_stats.used_size;
+    results.largest_free_ratio =
+        free_size ? (double)end_stats.largest_free_block / free_size : 1.0;
+
+    return results;
+}
+
+int main() {
+    bench_params bench;
+    const size_t n_threads_list[] = {1, 4};
+
+    std::cout << std::left << std::setw(17) << "strategy" << std::setw(9)
+              << "threads" << std::setw(8) << "arenas" << std::setw(14)
+              << "ops/s" << std::setw(9) << "p50[ns]" << std::setw(9)
+              << "p99[ns]" << std::setw(10) << "failures"
+              << "largest/free" << std::endl;
+
+    for (auto &s : strategies) {
+        for (size_t n_threads : n_threads_list) {
+            // compare a single lock with one arena per thread
+            for (unsigned num_arenas : {0U, (unsigned)n_threads}) {
+                if (n_threads == 1 && num_arenas > 0) {
+                    continue;
+                }
+
+                bench_results r =
+                    run_coarse(s.strategy, n_threads, num_arenas, bench);
+
+                std::cout << std::left << std::setw(17) << s.name
+                          << std::setw(9) << n_threads << std::setw(8)
+                          << num_arenas << std::setw(14) << std::fixed
+                          << std::setprecision(0) << r.ops_per_sec
+                          << std::setw(9) << r.p50_ns << std::setw(9)
+                          << r.p99_ns << std::setw(10) << r.n_failures
+                          << std::setprecision(3) << r.largest_free_ratio
+                          << std::endl;
+            }
+        }
+    }
+
+    // ctest looks for "PASSED" in the output
+    std::cout << "PASSED" << std::endl;
+
+    return 0;
+}
@@ -38,12 +38,52 @@ umf_result_t umfPoolGetIPCHandleSize(umf_memory_pool_handle_t hPool,
 umf_result_t umfGetIPCHandle(const void *ptr, umf_ipc_handle_t *ipcHandle,
                              size_t *size);
 
+///
+/// @brief Creates an IPC handle for the specified UMF allocation in a buffer
+///        provided by the caller, so no memory is allocated for the handle.
+///        The handle has to be released with umfPutIPCHandleInBuffer
+///        before the buffer is reused or freed.
+/// @param ptr pointer to the allocated memory.
+/// @param buffer [in] buffer aligned to 8 bytes where the IPC handle is stored.
+/// @param bufferSize size of the buffer in bytes, at least the size
+///        returned by umfPoolGetIPCHandleSize for the pool of the allocation.
+/// @param ipcHandle [out] returned IPC handle, it points to the buffer.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         UMF_RESULT_ERROR_INVALID_ARGUMENT if the buffer is too small or not aligned.
+umf_result_t umfGetIPCHandleInBuffer(const void *ptr, void *buffer,
+                                     size_t bufferSize,
+                                     umf_ipc_handle_t *ipcHandle);
+
+///
+/// @brief Creates IPC handles for multiple UMF allocations at once.
+///        Looking up the allocations is amortized over pointers that belong to
+///        the same memory provider allocation and follow each other.
+///        Each returned handle has to be released with umfPutIPCHandle.
+/// @param ptrs [in] array of \p count pointers to the allocated memory.
+/// @param count number of pointers.
+/// @param ipcHandles [out] array of \p count returned IPC handles.
+/// @param sizes [out] array of \p count sizes of the IPC handles in bytes.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         On failure no IPC handle is created.
+umf_result_t umfGetIPCHandles(void *const *ptrs, size_t count,
+                              umf_ipc_handle_t *ipcHandles, size_t *sizes);
+
 ///
 /// @brief Release IPC handle retrieved by umfGetIPCHandle.
+///        The memory provider may release the shared memory of the handle
+///        only after all handles of it are released or the memory is freed,
+///        so the handle has to be released only after the consumer opens it.
 /// @param ipcHandle IPC handle.
 /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
 umf_result_t umfPutIPCHandle(umf_ipc_handle_t ipcHandle);
 
+///
+/// @brief Release IPC handle retrieved by umfGetIPCHandleInBuffer.
+///        The buffer of the handle is not freed, it is owned by the caller.
+/// @param ipcHandle IPC handle.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfPutIPCHandleInBuffer(umf_ipc_handle_t ipcHandle);
+
 ///
 /// @brief Open IPC handle retrieved by umfGetIPCHandle.
 /// @param hIPCHandler [in] IPC Handler handle used to open the IPC handle.
@@ -53,6 +93,36 @@ umf_result_t umfPutIPCHandle(umf_ipc_handle_t ipcHandle);
 umf_result_t umfOpenIPCHandle(umf_ipc_handler_handle_t hIPCHandler,
                               umf_ipc_handle_t ipcHandle, void **ptr);
 
+///
+/// @brief Open IPC handle in advance, in the background.
+///        It is a hint: the IPC handle is opened by a worker thread of the IPC
+///        handler and the mapping is kept in the cache of opened IPC handles,
+///        so the following umfOpenIPCHandle of the handle does not have to map
+///        the memory. The number of worker threads can be set with
+///        UMF_IPC_CACHE="prefetch_threads=<number>".
+/// @param hIPCHandler [in] IPC Handler handle used to open the IPC handle.
+/// @param ipcHandle [in] IPC handle. It is copied, so it can be released
+///        right after the call.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfPrefetchIPCHandle(umf_ipc_handler_handle_t hIPCHandler,
+                                  umf_ipc_handle_t ipcHandle);
+
+///
+/// @brief Open multiple IPC handles at once.
+///        IPC handles of the same remote memory provider allocation that follow
+///        each other are opened with a single lookup in the cache of opened
+///        IPC handles and share a single mapping.
+///        Each opened pointer has to be closed with umfCloseIPCHandle.
+/// @param hIPCHandler [in] IPC Handler handle used to open the IPC handles.
+/// @param ipcHandles [in] array of \p count IPC handles.
+/// @param count number of IPC handles.
+/// @param ptrs [out] array of \p count pointers to the memory in the current process.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         On failure no IPC handle is opened.
+umf_result_t umfOpenIPCHandles(umf_ipc_handler_handle_t hIPCHandler,
+                               const umf_ipc_handle_t *ipcHandles, size_t count,
+                               void **ptrs);
+
 ///
 /// @brief Close IPC handle.
 /// @param ptr [in] pointer to the memory.
@@ -66,6 +136,112 @@ umf_result_t umfCloseIPCHandle(void *ptr);
 umf_result_t umfPoolGetIPCHandler(umf_memory_pool_handle_t hPool,
                                   umf_ipc_handler_handle_t *hIPCHandler);
 
+/// @brief Statistics of the cache of IPC handles created for the allocations of a pool.
+///        The upstream IPC handle of an allocation is kept in the cache until the allocation
+///        is freed or the handle is evicted. The number of cached handles is limited
+///        with UMF_IPC_CACHE="max_handles=<number>".
+typedef struct umf_ipc_handle_cache_stats_t {
+    size_t entries;     ///< number of cached IPC handles
+    uint64_t hits;      ///< number of IPC handles found in the cache
+    uint64_t misses;    ///< number of IPC handles retrieved from the memory provider
+    uint64_t evictions; ///< number of IPC handles evicted from the cache
+} umf_ipc_handle_cache_stats_t;
+
+/// @brief Get statistics of the cache of IPC handles of the pool.
+/// @param hPool [in] Pool handle
+/// @param stats [out] statistics of the cache
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if the pool was created with
+///         UMF_POOL_CREATE_FLAG_DISABLE_TRACKING.
+umf_result_t
+umfPoolGetIPCHandleCacheStats(umf_memory_pool_handle_t hPool,
+                              umf_ipc_handle_cache_stats_t *stats);
+
+typedef struct umf_ipc_channel_t *umf_ipc_channel_handle_t;
+
+///
+/// @brief Creates a channel for passing IPC handles to other processes
+///        on the same host without a socket per message.
+///        The channel is a lock-free ring buffer of IPC handles allocated
+///        from the given pool, so the memory provider of the pool has to
+///        support IPC, e.g. the OS memory provider with UMF_MEM_MAP_SHARED.
+///        Multiple producers and consumers can use the channel concurrently.
+/// @param hPool [in] pool used to allocate the ring buffer of the channel.
+/// @param capacity maximum number of IPC handles in the channel,
+///        rounded up to a power of 2.
+/// @param maxHandleSize maximum size of IPC handles sent through the channel,
+///        e.g. the size returned by umfPoolGetIPCHandleSize.
+/// @param hChannel [out] handle to the created channel.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCChannelCreate(umf_memory_pool_handle_t hPool,
+                                 size_t capacity, size_t maxHandleSize,
+                                 umf_ipc_channel_handle_t *hChannel);
+
+///
+/// @brief Creates an IPC handle of the ring buffer of the channel.
+///        It has to be passed to the other process once, which opens
+///        the channel with umfIPCChannelOpen, and released with umfPutIPCHandle.
+/// @param hChannel [in] handle to the channel created with umfIPCChannelCreate.
+/// @param ipcHandle [out] returned IPC handle.
+/// @param size [out] size of IPC handle in bytes.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCChannelGetIPCHandle(umf_ipc_channel_handle_t hChannel,
+                                       umf_ipc_handle_t *ipcHandle,
+                                       size_t *size);
+
+///
+/// @brief Opens a channel created by another process.
+/// @param hIPCHandler [in] IPC Handler handle used to open the IPC handle.
+/// @param ipcHandle [in] IPC handle returned by umfIPCChannelGetIPCHandle.
+/// @param hChannel [out] handle to the opened channel.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCChannelOpen(umf_ipc_handler_handle_t hIPCHandler,
+                               umf_ipc_handle_t ipcHandle,
+                               umf_ipc_channel_handle_t *hChannel);
+
+///
+/// @brief Destroys a channel created with umfIPCChannelCreate or closes
+///        a channel opened with umfIPCChannelOpen.
+///        IPC handles that were not received are dropped.
+/// @param hChannel [in] handle to the channel.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCChannelDestroy(umf_ipc_channel_handle_t hChannel);
+
+///
+/// @brief Copies IPC handles into the channel. It does not block,
+///        only as many handles as fit in the channel are sent.
+///        The handles are copied, but they can be released with
+///        umfPutIPCHandle and the memory can be freed only after
+///        the handles are received.
+/// @param hChannel [in] handle to the channel.
+/// @param ipcHandles [in] array of \p count IPC handles.
+/// @param sizes [in] array of \p count sizes of the IPC handles in bytes.
+/// @param count number of IPC handles.
+/// @param sent [out] number of IPC handles sent, the first \p sent
+///        handles of the array.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCChannelSend(umf_ipc_channel_handle_t hChannel,
+                               const umf_ipc_handle_t *ipcHandles,
+                               const size_t *sizes, size_t count,
+                               size_t *sent);
+
+///
+/// @brief Receives IPC handles from the channel and opens them in batches
+///        with umfOpenIPCHandles. It does not block.
+///        Each opened pointer has to be closed with umfCloseIPCHandle.
+/// @param hChannel [in] handle to the channel.
+/// @param hIPCHandler [in] IPC Handler handle used to open the IPC handles.
+/// @param ptrs [out] array of at least \p maxCount pointers to the memory
+///        in the current process.
+/// @param maxCount maximum number of IPC handles to receive.
+/// @param count [out] number of IPC handles received and opened.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         On failure the IPC handles of the batch that failed to open are
+///         removed from the channel.
+umf_result_t umfIPCChannelReceive(umf_ipc_channel_handle_t hChannel,
+                                  umf_ipc_handler_handle_t hIPCHandler,
+                                  void **ptrs, size_t maxCount, size_t *count);
+
 #ifdef __cplusplus
 }
 #endif
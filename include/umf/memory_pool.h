@@ -181,6 +181,47 @@ umf_result_t umfPoolSetTag(umf_memory_pool_handle_t hPool, void *tag,
 /// @return UMF_RESULT_SUCCESS on success.
 umf_result_t umfPoolGetTag(umf_memory_pool_handle_t hPool, void **tag);
 
+/// @brief A memory region allocated from a memory provider and tracked by UMF
+typedef struct umf_tracked_region_t {
+    void *base;                    ///< base address of the region
+    size_t size;                   ///< size of the region in bytes
+    umf_memory_pool_handle_t pool; ///< pool the region belongs to
+} umf_tracked_region_t;
+
+/// @brief Callback called for each tracked region by umfPoolWalk and umfTrackerWalk.
+/// @param region snapshot of the tracked region, valid only during the call
+/// @param arg user argument passed to the walk function
+/// @return 0 to continue the walk or a non-zero value to stop it
+typedef int (*umf_region_walk_cb_t)(const umf_tracked_region_t *region,
+                                    void *arg);
+
+///
+/// @brief Walk all memory regions the pool allocated from its memory provider.
+///        The walk does not block allocations and deallocations done concurrently
+///        in the pool. Each reported region was tracked at some point during the walk,
+///        regions added or removed concurrently may or may not be reported.
+///        A region split concurrently may be reported twice: as a whole
+///        and then as its second part.
+///        The callback may allocate from and free to any pool.
+/// @param hPool specified memory pool
+/// @param cb callback called for each region
+/// @param arg user argument passed to the callback
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if the pool was created with
+///         UMF_POOL_CREATE_FLAG_DISABLE_TRACKING.
+///
+umf_result_t umfPoolWalk(umf_memory_pool_handle_t hPool,
+                         umf_region_walk_cb_t cb, void *arg);
+
+///
+/// @brief Walk all memory regions tracked by UMF in the process, in address order.
+///        It gives the same guarantees as umfPoolWalk.
+/// @param cb callback called for each region
+/// @param arg user argument passed to the callback
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///
+umf_result_t umfTrackerWalk(umf_region_walk_cb_t cb, void *arg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,7 +20,8 @@ extern "C" {
 /// @brief Version of the Memory Pool ops structure.
 /// NOTE: This is equal to the latest UMF version, in which the ops structure
 /// has been modified.
-#define UMF_POOL_OPS_VERSION_CURRENT UMF_MAKE_VERSION(0, 11)
+/// Memory pools of version 0.11 (without get_block_range) are still accepted.
+#define UMF_POOL_OPS_VERSION_CURRENT UMF_MAKE_VERSION(0, 12)
 
 ///
 /// @brief This structure comprises function pointers used by corresponding umfPool*
@@ -125,6 +126,24 @@ typedef struct umf_memory_pool_ops_t {
     ///         The value is undefined if the previous allocation was successful.
     ///
     umf_result_t (*get_last_allocation_error)(void *pool);
+
+    ///
+    /// @brief Obtains the block of memory allocated from the \p pool that contains \p ptr,
+    ///        where \p ptr does not have to be the beginning of the block. IPC handles use it
+    ///        to share only the part of a large memory provider allocation that contains the block.
+    ///        This function is optional and can be NULL, then IPC handles of pointers that are not
+    ///        the beginning of a memory provider allocation share the whole allocation.
+    ///        Added in the ops version 0.12.
+    /// @param pool pointer to the memory pool
+    /// @param ptr pointer to the allocated memory, possibly inside of the block
+    /// @param base [out] beginning of the block, or \p ptr if the pool can tell only
+    ///        the part of the block from \p ptr to its end
+    /// @param size [out] size of the block from \p base to its end
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+    ///         UMF_RESULT_ERROR_NOT_SUPPORTED if the pool cannot tell the block of \p ptr.
+    ///
+    umf_result_t (*get_block_range)(void *pool, const void *ptr, void **base,
+                                    size_t *size);
 } umf_memory_pool_ops_t;
 
 #ifdef __cplusplus
@@ -260,6 +260,31 @@ umf_result_t
 umfMemoryProviderAllocationMerge(umf_memory_provider_handle_t hProvider,
                                  void *lowPtr, void *highPtr, size_t totalSize);
 
+///
+/// @brief Resizes a coarse grain allocation in place, without moving it.
+/// @param hProvider handle to the memory provider
+/// @param ptr pointer to the beginning of the allocation
+/// @param oldSize current size of the allocation
+/// @param newSize new size of the allocation
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+///         UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY if the allocation cannot be grown in place.
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if the provider does not support resizing.
+///
+umf_result_t
+umfMemoryProviderAllocationResize(umf_memory_provider_handle_t hProvider,
+                                  void *ptr, size_t oldSize, size_t newSize);
+
+///
+/// @brief Releases the free memory cached by the memory provider until at most
+///        \p keepBytes bytes of it are left.
+/// @param hProvider handle to the memory provider
+/// @param keepBytes size of the free memory that can stay cached
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if the provider does not support trimming.
+///
+umf_result_t umfMemoryProviderTrim(umf_memory_provider_handle_t hProvider,
+                                   size_t keepBytes);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,7 +19,9 @@ extern "C" {
 /// @brief Version of the Memory Provider ops structure.
 /// NOTE: This is equal to the latest UMF version, in which the ops structure
 /// has been modified.
-#define UMF_PROVIDER_OPS_VERSION_CURRENT UMF_MAKE_VERSION(0, 11)
+/// Memory providers of version 0.11 (without ext.allocation_resize, ext.trim
+/// and ipc.get_ipc_handle_range) are still accepted, older versions are not.
+#define UMF_PROVIDER_OPS_VERSION_CURRENT UMF_MAKE_VERSION(0, 12)
 
 ///
 /// @brief This structure comprises optional function pointers used
@@ -83,6 +85,36 @@ typedef struct umf_memory_provider_ext_ops_t {
     umf_result_t (*allocation_split)(void *hProvider, void *ptr,
                                      size_t totalSize, size_t firstSize);
 
+    ///
+    /// @brief Resizes a coarse grain allocation in place, without moving it.
+    ///        The allocation is shrunk by releasing its tail and grown
+    ///        by taking the memory directly following it, if it is free.
+    ///        allocation_resize should NOT be called concurrently with
+    ///        allocation_split() or allocation_merge() with the same pointer.
+    ///        Added in the ops version 0.12.
+    /// @param hProvider handle to the memory provider
+    /// @param ptr pointer to the beginning of the allocation
+    /// @param oldSize current size of the allocation
+    /// @param newSize new size of the allocation
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+    ///         UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY if the allocation cannot be grown in place.
+    ///         UMF_RESULT_ERROR_NOT_SUPPORTED if operation is not supported by this provider.
+    ///
+    umf_result_t (*allocation_resize)(void *hProvider, void *ptr,
+                                      size_t oldSize, size_t newSize);
+
+    ///
+    /// @brief Releases the free memory cached by the provider (e.g. by a coarse-grain provider
+    ///        between its allocations) until at most \p keepBytes bytes of it are left.
+    ///        The memory is returned to the system or purged.
+    ///        Added in the ops version 0.12.
+    /// @param hProvider handle to the memory provider
+    /// @param keepBytes size of the free memory that can stay cached
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+    ///         UMF_RESULT_ERROR_NOT_SUPPORTED if operation is not supported by this provider.
+    ///
+    umf_result_t (*trim)(void *hProvider, size_t keepBytes);
+
 } umf_memory_provider_ext_ops_t;
 
 ///
@@ -139,6 +171,24 @@ typedef struct umf_memory_provider_ipc_ops_t {
     ///         UMF_RESULT_ERROR_INVALID_ARGUMENT if invalid \p ptr is passed.
     ///         UMF_RESULT_ERROR_NOT_SUPPORTED if IPC functionality is not supported by this provider.
     umf_result_t (*close_ipc_handle)(void *provider, void *ptr, size_t size);
+
+    ///
+    /// @brief Retrieve an IPC memory handle for a part of an allocation. The handle is opened
+    ///        and closed with open_ipc_handle and close_ipc_handle like the handles retrieved with
+    ///        get_ipc_handle, but it does not have to be released with put_ipc_handle. It stays
+    ///        valid until the allocation is freed. This function is optional and can be NULL,
+    ///        then IPC handles always describe whole allocations. Added in the ops version 0.12.
+    /// @param provider pointer to the memory provider.
+    /// @param ptr beginning of the virtual memory range, aligned to the minimum page size.
+    ///        It does not have to be the beginning of an allocation.
+    /// @param size size of the memory address range, a multiple of the minimum page size.
+    ///        The range has to be contained in a single allocation.
+    /// @param providerIpcData [out] pointer to the preallocated opaque data structure to store IPC handle.
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+    ///         UMF_RESULT_ERROR_INVALID_ARGUMENT if the range was not allocated by this provider.
+    ///         UMF_RESULT_ERROR_NOT_SUPPORTED if sharing a part of an allocation is not supported.
+    umf_result_t (*get_ipc_handle_range)(void *provider, const void *ptr,
+                                         size_t size, void *providerIpcData);
 } umf_memory_provider_ipc_ops_t;
 
 ///
@@ -0,0 +1,110 @@
+/*
+ *
+ * Copyright (C) 2025 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#ifndef UMF_SHARED_HEAP_MEMORY_POOL_H
+#define UMF_SHARED_HEAP_MEMORY_POOL_H 1
+
+#include <umf/ipc.h>
+#include <umf/memory_pool.h>
+#include <umf/memory_provider.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The shared heap pool allocates memory from a single heap whose metadata
+// (free lists) lives in the heap itself and is updated with atomic operations
+// only, so processes that share the heap can allocate and free memory
+// from it directly. Free blocks are merged with their buddies when
+// an allocation cannot be satisfied otherwise. The heap is a single
+// allocation of an IPC-capable memory provider, e.g. the OS memory provider
+// with UMF_MEM_MAP_SHARED.
+// The pool that created the heap shares it with umfSharedHeapPoolGetIPCHandle
+// and other processes create pools attached to the heap with
+// umfSharedHeapPoolParamsSetIPCHandle. Memory allocated by one process
+// can be freed by another one after translating the pointer with
+// umfSharedHeapPoolGetOffset and umfSharedHeapPoolGetPtr.
+
+/// @brief default size of the heap of the shared heap pool
+#define UMF_SHARED_HEAP_POOL_DEFAULT_SIZE ((size_t)256 * 1024 * 1024)
+
+struct umf_shared_heap_pool_params_t;
+
+/// @brief handle to the parameters of the shared heap pool.
+typedef struct umf_shared_heap_pool_params_t
+    *umf_shared_heap_pool_params_handle_t;
+
+/// @brief  Create a struct to store parameters of the shared heap pool.
+/// @param  hParams [out] handle to the newly created parameters struct.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t
+umfSharedHeapPoolParamsCreate(umf_shared_heap_pool_params_handle_t *hParams);
+
+/// @brief  Destroy parameters struct.
+/// @param  hParams handle to the parameters of the shared heap pool.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t
+umfSharedHeapPoolParamsDestroy(umf_shared_heap_pool_params_handle_t hParams);
+
+/// @brief  Set the size of the heap allocated from the memory provider.
+/// @param  hParams handle to the parameters of the shared heap pool.
+/// @param  heapSize size of the heap in bytes,
+///         UMF_SHARED_HEAP_POOL_DEFAULT_SIZE by default.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t
+umfSharedHeapPoolParamsSetHeapSize(umf_shared_heap_pool_params_handle_t hParams,
+                                   size_t heapSize);
+
+/// @brief  Attach the pool to the heap of another pool instead of creating
+///         a new heap. The heap is opened with the memory provider of the pool,
+///         which has to be able to open IPC handles of the other pool.
+/// @param  hParams handle to the parameters of the shared heap pool.
+/// @param  ipcHandle IPC handle returned by umfSharedHeapPoolGetIPCHandle.
+///         It has to be valid until the pool is created.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfSharedHeapPoolParamsSetIPCHandle(
+    umf_shared_heap_pool_params_handle_t hParams, umf_ipc_handle_t ipcHandle);
+
+/// @brief  Create an IPC handle of the heap of the pool. It has to be released
+///         with umfPutIPCHandle.
+/// @param  hPool handle to the shared heap pool that created the heap.
+/// @param  ipcHandle [out] returned IPC handle.
+/// @param  size [out] size of IPC handle in bytes.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfSharedHeapPoolGetIPCHandle(umf_memory_pool_handle_t hPool,
+                                           umf_ipc_handle_t *ipcHandle,
+                                           size_t *size);
+
+/// @brief  Get the offset of the memory allocated from the shared heap
+///         from the start of the heap. The heap is mapped at different
+///         addresses in different processes, so pointers to the heap are
+///         passed between processes as offsets.
+/// @param  hPool handle to the shared heap pool.
+/// @param  ptr pointer to the memory allocated from the heap.
+/// @param  offset [out] offset of the memory from the start of the heap.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfSharedHeapPoolGetOffset(umf_memory_pool_handle_t hPool,
+                                        const void *ptr, size_t *offset);
+
+/// @brief  Get the pointer to the memory of the shared heap at the given offset
+///         in the current process.
+/// @param  hPool handle to the shared heap pool.
+/// @param  offset offset returned by umfSharedHeapPoolGetOffset.
+/// @param  ptr [out] pointer to the memory in the current process.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfSharedHeapPoolGetPtr(umf_memory_pool_handle_t hPool,
+                                     size_t offset, void **ptr);
+
+umf_memory_pool_ops_t *umfSharedHeapPoolOps(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UMF_SHARED_HEAP_MEMORY_POOL_H */
@@ -56,6 +56,18 @@ umf_result_t umfDevDaxMemoryProviderParamsSetDeviceDax(
 umf_result_t umfDevDaxMemoryProviderParamsSetProtection(
     umf_devdax_memory_provider_params_handle_t hParams, unsigned protection);
 
+/// @brief  Set the free high water mark in the parameters struct.
+///         When the size of the free memory cached by the provider exceeds
+///         the mark, it is purged to a half of the mark,
+///         see umfMemoryProviderTrim().
+/// @param  hParams [in] handle to the parameters of the Devdax Memory Provider.
+/// @param  freeHighWaterMark [in] the mark in bytes (0, which disables it,
+///         by default).
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfDevDaxMemoryProviderParamsSetFreeHighWaterMark(
+    umf_devdax_memory_provider_params_handle_t hParams,
+    size_t freeHighWaterMark);
+
 /// @brief Devdax Memory Provider operation results
 typedef enum umf_devdax_memory_provider_native_error {
     UMF_DEVDAX_RESULT_SUCCESS = UMF_DEVDAX_RESULTS_START_FROM, ///< Success
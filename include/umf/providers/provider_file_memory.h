@@ -58,6 +58,27 @@ umf_result_t umfFileMemoryProviderParamsSetVisibility(
     umf_file_memory_provider_params_handle_t hParams,
     umf_memory_visibility_t visibility);
 
+/// @brief  Set the number of arenas in the parameters struct.
+///         The memory of the provider is split between arenas with separate
+///         locks and every thread allocates from its own arena, so multiple
+///         threads can allocate and free memory concurrently.
+/// @param  hParams handle to the parameters of the File Memory Provider.
+/// @param  numArenas number of arenas (1 by default).
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfFileMemoryProviderParamsSetNumArenas(
+    umf_file_memory_provider_params_handle_t hParams, unsigned numArenas);
+
+/// @brief  Set the free high water mark in the parameters struct.
+///         When the size of the free memory cached by the provider exceeds
+///         the mark, it is purged to a half of the mark,
+///         see umfMemoryProviderTrim().
+/// @param  hParams handle to the parameters of the File Memory Provider.
+/// @param  freeHighWaterMark the mark in bytes (0, which disables it,
+///         by default).
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfFileMemoryProviderParamsSetFreeHighWaterMark(
+    umf_file_memory_provider_params_handle_t hParams, size_t freeHighWaterMark);
+
 /// @brief File Memory Provider operation results
 typedef enum umf_file_memory_provider_native_error {
     UMF_FILE_RESULT_SUCCESS = UMF_FILE_RESULTS_START_FROM, ///< Success
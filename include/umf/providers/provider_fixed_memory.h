@@ -31,7 +31,8 @@ typedef struct umf_fixed_memory_provider_params_t
 umf_result_t umfFixedMemoryProviderParamsCreate(
     umf_fixed_memory_provider_params_handle_t *hParams, void *ptr, size_t size);
 
-/// @brief  Set the memory region in params struct. Overwrites the previous value.
+/// @brief  Set the memory region in params struct. Overwrites the previous value
+///         (all memory regions added before).
 ///         It provides an ability to use the same instance of params to create multiple
 ///         instances of the provider for different memory regions.
 /// @param  hParams [in] handle to the parameters of the Fixed Memory Provider.
@@ -41,6 +42,43 @@ umf_result_t umfFixedMemoryProviderParamsCreate(
 umf_result_t umfFixedMemoryProviderParamsSetMemory(
     umf_fixed_memory_provider_params_handle_t hParams, void *ptr, size_t size);
 
+/// @brief  Add another memory region to the params struct.
+///         A single provider manages all memory regions, e.g. buffers
+///         reserved on different NUMA nodes. If the NUMA nodes of the regions
+///         are given, allocations prefer the regions located on the NUMA node
+///         of the calling thread and use the remote ones only when the local
+///         regions are exhausted.
+/// @param  hParams [in] handle to the parameters of the Fixed Memory Provider.
+/// @param  ptr [in] pointer to the memory region.
+/// @param  size [in] size of the memory region in bytes.
+/// @param  numaNode [in] NUMA node of the memory region or -1 if unknown.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfFixedMemoryProviderParamsAddMemory(
+    umf_fixed_memory_provider_params_handle_t hParams, void *ptr, size_t size,
+    int numaNode);
+
+/// @brief  Set the number of arenas in the params struct.
+///         Every memory region is split evenly between arenas with separate
+///         locks and every thread allocates from its own arena, taking memory
+///         from the other arenas only when its arena is exhausted.
+/// @param  hParams [in] handle to the parameters of the Fixed Memory Provider.
+/// @param  numArenas [in] number of arenas (1 by default).
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfFixedMemoryProviderParamsSetNumArenas(
+    umf_fixed_memory_provider_params_handle_t hParams, unsigned numArenas);
+
+/// @brief  Set the free high water mark in the parameters struct.
+///         When the size of the free memory cached by the provider exceeds
+///         the mark, it is purged to a half of the mark,
+///         see umfMemoryProviderTrim().
+/// @param  hParams [in] handle to the parameters of the Fixed Memory Provider.
+/// @param  freeHighWaterMark [in] the mark in bytes (0, which disables it,
+///         by default).
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfFixedMemoryProviderParamsSetFreeHighWaterMark(
+    umf_fixed_memory_provider_params_handle_t hParams,
+    size_t freeHighWaterMark);
+
 /// @brief  Destroy parameters struct.
 /// @param  hParams [in] handle to the parameters of the Fixed Memory Provider.
 /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
@@ -16,11 +16,14 @@
 
 #include "base_alloc_global.h"
 #include "coarse.h"
+#include "critnib.h"
 #include "libumf.h"
 #include "ravl.h"
 #include "utils_common.h"
 #include "utils_concurrency.h"
 #include "utils_log.h"
+#include "utils_sanitizers.h"
+#include "utlist.h"
 
 #ifdef _WIN32
 UTIL_ONCE_FLAG Log_initialized = UTIL_ONCE_FLAG_INIT;
@@ -29,6 +32,26 @@ void __attribute__((constructor)) coarse_init(void) { utils_log_init(); }
 void __attribute__((destructor)) coarse_destroy(void) {}
 #endif /* _WIN32 */
 
+// number of objects in one slab of the cache of metadata objects
+#define COARSE_CACHE_SLAB_OBJECTS 64
+
+typedef struct coarse_cache_slab_t {
+    struct coarse_cache_slab_t *next;
+    // followed by COARSE_CACHE_SLAB_OBJECTS objects
+} coarse_cache_slab_t;
+
+// Cache of free metadata objects of one type (block_t etc.).
+// Objects are allocated from the global base allocator in slabs,
+// reused under coarse->lock and released only in coarse_delete(),
+// so splitting and merging blocks does not use the global base allocator.
+typedef struct coarse_cache_t {
+    size_t obj_size;
+    size_t slab_size;
+    // list of free objects linked through their first bytes
+    void *free_list;
+    coarse_cache_slab_t *slabs;
+} coarse_cache_t;
+
 typedef struct coarse_t {
     // handle of the memory provider
     void *provider;
@@ -42,21 +65,83 @@ typedef struct coarse_t {
     // page size of the memory provider
     size_t page_size;
 
+    // free memory above this size is trimmed in coarse_free() (0 - never)
+    size_t free_high_water_mark;
+
+    // lazy purging of free blocks (purge_min_size == 0 - disabled)
+    size_t purge_min_size;
+    uint64_t purge_delay_ms;
+
+    // dirty_blocks - list of free blocks (not purged) of at least
+    // purge_min_size bytes, sorted by the time they were freed
+    struct block_t *dirty_blocks;
+
     // all_blocks - tree of all blocks - sorted by an address of data
     struct ravl *all_blocks;
 
     // free_blocks - tree of free blocks - sorted by a size of data,
     // each node contains a pointer (ravl_free_blocks_head_t)
     // to the head of the list of free blocks of the same size
+    // (not used by the UMF_COARSE_MEMORY_STRATEGY_TLSF strategy)
     struct ravl *free_blocks;
 
+    // TLSF index of free blocks
+    // (used only by the UMF_COARSE_MEMORY_STRATEGY_TLSF strategy)
+    struct tlsf_index_t *tlsf;
+
+    // best_fit - tree of free blocks sorted by a size and then by an address
+    // of data (used only by the UMF_COARSE_MEMORY_STRATEGY_BEST_FIT strategy):
+    // key - size of the block, value - pointer to the block (block_t)
+    struct ravl *best_fit;
+
+    // regions - tree of the regions allocated with the alloc() callback
+    // (only if the free() callback is set, so they can be returned
+    // to the memory provider by coarse_trim()):
+    // key - the address of the region, value - the size of the region
+    struct ravl *regions;
+
+    // caches of block_t, ravl_free_blocks_elem_t
+    // and ravl_free_blocks_head_t objects
+    coarse_cache_t block_cache;
+    coarse_cache_t elem_cache;
+    coarse_cache_t head_cache;
+
     struct utils_mutex_t lock;
 
     // statistics
     size_t used_size;
     size_t alloc_size;
+    size_t purged_size;
+    size_t num_all_blocks;
+    size_t num_free_blocks;
+    // histogram of sizes of free blocks (see coarse_stats_t)
+    size_t free_hist[COARSE_STATS_FREE_HIST_SIZE];
+
+    // arenas - if num_arenas > 1, the coarse does not manage any memory
+    // itself, but passes all calls to one of its num_arenas arenas
+    // (coarse instances with their own locks owning disjoint address ranges)
+    struct coarse_t **arenas;
+    unsigned num_arenas;
+    // number of arenas that got memory with coarse_add_memory_fixed_node()
+    unsigned num_arenas_used;
+    // true if the NUMA node of any arena is known
+    bool numa_aware;
+
+    // arena_ranges - map of the address ranges owned by the arenas:
+    // key - the start address of the range, value - the arena.
+    // It is looked up without any lock in every free, merge and split.
+    critnib *arena_ranges;
+
+    // the coarse this arena belongs to (NULL if it is not an arena)
+    struct coarse_t *parent;
+    // the NUMA node of the memory of this arena (-1 if unknown)
+    int numa_node;
 } coarse_t;
 
+// index of the arena of the calling thread increased by 1 (0 - not assigned)
+static __TLS unsigned Thread_arena_id = 0;
+static uint64_t Threads_counter = 0;
+
 typedef struct ravl_node ravl_node_t;
 
 typedef enum check_free_blocks_t {
@@ -68,12 +153,45 @@ typedef struct block_t {
     size_t size;
     unsigned char *data;
     bool used;
+    // the free block was purged with the purge() callback
+    bool purged;
+
+    // The list of dirty free blocks waiting to be purged (coarse->dirty_blocks)
+    // and the time the block was added to it.
+    struct block_t *dirty_prev, *dirty_next;
+    uint64_t freed_at;
+    bool dirty_listed;
 
     // Node in the list of free blocks of the same size pointing to this block.
     // The list is located in the (coarse->free_blocks) RAVL tree.
     struct ravl_free_blocks_elem_t *free_list_ptr;
+
+    // The list of free blocks of the same size class of the TLSF index
+    // (only for the UMF_COARSE_MEMORY_STRATEGY_TLSF strategy).
+    struct block_t *tlsf_prev, *tlsf_next;
+    bool tlsf_listed;
+
+    // the block is in the (coarse->best_fit) RAVL tree
+    // (only for the UMF_COARSE_MEMORY_STRATEGY_BEST_FIT strategy)
+    bool best_fit_listed;
 } block_t;
 
+// The TLSF index splits sizes into first-level classes of powers of 2
+// and every first-level class into TLSF_SL_COUNT second-level classes
+// of the same width. Sizes below TLSF_SL_COUNT have their own classes.
+#define TLSF_SL_LOG2 4
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+#define TLSF_FL_COUNT (64 - TLSF_SL_LOG2 + 1)
+
+typedef struct tlsf_index_t {
+    // bit (fl) is set if any list of the (fl) first-level class is not empty
+    uint64_t fl_bitmap;
+    // bit (sl) of sl_bitmap[fl] is set if lists[fl][sl] is not empty
+    uint32_t sl_bitmap[TLSF_FL_COUNT];
+    block_t *lists[TLSF_FL_COUNT][TLSF_SL_COUNT];
+    size_t num_blocks;
+} tlsf_index_t;
+
 // A general node in a RAVL tree.
 // 1) coarse->all_blocks RAVL tree (tree of all blocks - sorted by an address of data):
 //    key   - pointer (block_t->data) to the beginning of the block data
@@ -98,6 +216,71 @@ typedef struct ravl_free_blocks_elem_t {
     struct ravl_free_blocks_elem_t *prev;
 } ravl_free_blocks_elem_t;
 
+// The functions "coarse_cache_*" handle the caches of metadata objects.
+//
+// coarse_cache_init - initialize the cache of objects of the given size
+static void coarse_cache_init(coarse_cache_t *cache, size_t obj_size) {
+    // a free object has to hold the pointer to the next one
+    obj_size = ALIGN_UP(obj_size, sizeof(void *));
+
+    cache->obj_size = obj_size;
+    cache->slab_size =
+        sizeof(coarse_cache_slab_t) + COARSE_CACHE_SLAB_OBJECTS * obj_size;
+    cache->free_list = NULL;
+    cache->slabs = NULL;
+}
+
+// coarse_cache_alloc - get an object from the cache,
+// allocating a new slab if the cache is empty
+static void *coarse_cache_alloc(coarse_cache_t *cache) {
+    if (cache->free_list == NULL) {
+        coarse_cache_slab_t *slab = umf_ba_global_alloc(cache->slab_size);
+        if (slab == NULL) {
+            return NULL;
+        }
+
+        slab->next = cache->slabs;
+        cache->slabs = slab;
+
+        unsigned char *obj = (unsigned char *)(slab + 1);
+        for (size_t i = 0; i < COARSE_CACHE_SLAB_OBJECTS; i++) {
+            *(void **)obj = cache->free_list;
+            cache->free_list = obj;
+            utils_annotate_memory_inaccessible(obj, cache->obj_size);
+            obj += cache->obj_size;
+        }
+    }
+
+    void *obj = cache->free_list;
+    utils_annotate_memory_defined(obj, sizeof(void *));
+    cache->free_list = *(void **)obj;
+    utils_annotate_memory_undefined(obj, cache->obj_size);
+
+    return obj;
+}
+
+// coarse_cache_free - return the object to the cache
+static void coarse_cache_free(coarse_cache_t *cache, void *obj) {
+    utils_annotate_memory_undefined(obj, cache->obj_size);
+    *(void **)obj = cache->free_list;
+    cache->free_list = obj;
+    utils_annotate_memory_inaccessible(obj, cache->obj_size);
+}
+
+// coarse_cache_destroy - release all slabs of the cache
+static void coarse_cache_destroy(coarse_cache_t *cache) {
+    coarse_cache_slab_t *slab = cache->slabs;
+    while (slab) {
+        coarse_cache_slab_t *next = slab->next;
+        utils_annotate_memory_undefined(slab, cache->slab_size);
+        umf_ba_global_free(slab);
+        slab = next;
+    }
+
+    cache->free_list = NULL;
+    cache->slabs = NULL;
+}
+
 // The compare function of a RAVL tree
 static int coarse_ravl_comp(const void *lhs, const void *rhs) {
     const ravl_data_t *lhs_ravl = (const ravl_data_t *)lhs;
@@ -115,6 +298,57 @@ static int coarse_ravl_comp(const void *lhs, const void *rhs) {
     return 0;
 }
 
+// The compare function of the coarse->best_fit RAVL tree:
+// blocks are sorted by the size (key) and then by the address of data.
+// A searched element with a NULL value precedes all blocks of its size.
+static int coarse_ravl_comp_best_fit(const void *lhs, const void *rhs) {
+    const ravl_data_t *lhs_ravl = (const ravl_data_t *)lhs;
+    const ravl_data_t *rhs_ravl = (const ravl_data_t *)rhs;
+
+    int ret = coarse_ravl_comp(lhs, rhs);
+    if (ret) {
+        return ret;
+    }
+
+    uintptr_t lhs_data = 0;
+    if (lhs_ravl->value) {
+        lhs_data = (uintptr_t)((block_t *)lhs_ravl->value)->data;
+    }
+
+    uintptr_t rhs_data = 0;
+    if (rhs_ravl->value) {
+        rhs_data = (uintptr_t)((block_t *)rhs_ravl->value)->data;
+    }
+
+    if (lhs_data < rhs_data) {
+        return -1;
+    }
+
+    if (lhs_data > rhs_data) {
+        return 1;
+    }
+
+    return 0;
+}
+
+// block_fits - check if the properly aligned data of the given size
+// can be cut out of the free block
+static bool block_fits(block_t *block, size_t size, size_t alignment) {
+    uintptr_t data = (uintptr_t)block->data;
+    size_t padding = ALIGN_UP(data, alignment) - data;
+    if (block->size < size || block->size - size < padding) {
+        return false;
+    }
+
+    // the aligned part cannot fill the rest of the block exactly,
+    // because the block would be split into three parts then
+    if (padding && block->size - size == padding) {
+        return false;
+    }
+
+    return true;
+}
+
 static inline block_t *get_node_block(ravl_node_t *node) {
     ravl_data_t *node_data = ravl_data(node);
     assert(node_data);
@@ -155,33 +389,43 @@ static block_t *get_block_next(ravl_node_t *node) {
 //
 // coarse_ravl_add_new - allocate and add a new block to the tree
 // and link this block to the next and the previous one.
-static block_t *coarse_ravl_add_new(struct ravl *rtree, unsigned char *data,
+static block_t *coarse_ravl_add_new(coarse_t *coarse, unsigned char *data,
                                     size_t size, ravl_node_t **node) {
+    struct ravl *rtree = coarse->all_blocks;
     assert(rtree);
     assert(data);
     assert(size);
 
-    // TODO add valgrind annotations
-    block_t *block = umf_ba_global_alloc(sizeof(*block));
+    block_t *block = coarse_cache_alloc(&coarse->block_cache);
     if (block == NULL) {
         return NULL;
     }
 
     block->data = data;
     block->size = size;
+    block->purged = false;
+    block->dirty_prev = NULL;
+    block->dirty_next = NULL;
+    block->dirty_listed = false;
     block->free_list_ptr = NULL;
+    block->tlsf_prev = NULL;
+    block->tlsf_next = NULL;
+    block->tlsf_listed = false;
+    block->best_fit_listed = false;
 
     ravl_data_t rdata = {(uintptr_t)block->data, block};
     assert(NULL == ravl_find(rtree, &data, RAVL_PREDICATE_EQUAL));
     int ret = ravl_emplace_copy(rtree, &rdata);
     if (ret) {
-        umf_ba_global_free(block);
+        coarse_cache_free(&coarse->block_cache, block);
         return NULL;
     }
 
     ravl_node_t *new_node = ravl_find(rtree, &rdata, RAVL_PREDICATE_EQUAL);
     assert(NULL != new_node);
 
+    coarse->num_all_blocks++;
+
     if (node) {
         *node = new_node;
     }
@@ -218,11 +462,12 @@ static block_t *coarse_ravl_rm(struct ravl *rtree, void *ptr) {
 //
 // node_list_add - add a free block to the list of free blocks of the same size
 static ravl_free_blocks_elem_t *
-node_list_add(ravl_free_blocks_head_t *head_node, struct block_t *block) {
+node_list_add(coarse_t *coarse, ravl_free_blocks_head_t *head_node,
+              struct block_t *block) {
     assert(head_node);
     assert(block);
 
-    ravl_free_blocks_elem_t *node = umf_ba_global_alloc(sizeof(*node));
+    ravl_free_blocks_elem_t *node = coarse_cache_alloc(&coarse->elem_cache);
     if (node == NULL) {
         return NULL;
     }
@@ -240,7 +485,8 @@ node_list_add(ravl_free_blocks_head_t *head_node, struct block_t *block) {
 }
 
 // node_list_rm - remove the given free block from the list of free blocks of the same size
-static block_t *node_list_rm(ravl_free_blocks_head_t *head_node,
+static block_t *node_list_rm(coarse_t *coarse,
+                             ravl_free_blocks_head_t *head_node,
                              ravl_free_blocks_elem_t *node) {
     assert(head_node);
     assert(node);
@@ -263,13 +509,14 @@ static block_t *node_list_rm(ravl_free_blocks_head_t *head_node,
 
     struct block_t *block = node->block;
     block->free_list_ptr = NULL;
-    umf_ba_global_free(node);
+    coarse_cache_free(&coarse->elem_cache, node);
 
     return block;
 }
 
 // node_list_rm_first - remove the first free block from the list of free blocks of the same size only if it can be properly aligned
-static block_t *node_list_rm_first(ravl_free_blocks_head_t *head_node,
+static block_t *node_list_rm_first(coarse_t *coarse,
+                                   ravl_free_blocks_head_t *head_node,
                                    size_t alignment) {
     assert(head_node);
     assert(head_node->head);
@@ -288,13 +535,14 @@ static block_t *node_list_rm_first(ravl_free_blocks_head_t *head_node,
 
     head_node->head = node->next;
     block->free_list_ptr = NULL;
-    umf_ba_global_free(node);
+    coarse_cache_free(&coarse->elem_cache, node);
 
     return block;
 }
 
 // node_list_rm_with_alignment - remove the first free block with the correct alignment from the list of free blocks of the same size
-static block_t *node_list_rm_with_alignment(ravl_free_blocks_head_t *head_node,
+static block_t *node_list_rm_with_alignment(coarse_t *coarse,
+                                            ravl_free_blocks_head_t *head_node,
                                             size_t alignment) {
     assert(head_node);
     assert(head_node->head);
@@ -304,7 +552,7 @@ static block_t *node_list_rm_with_alignment(ravl_free_blocks_head_t *head_node,
     ravl_free_blocks_elem_t *node;
     for (node = head_node->head; node != NULL; node = node->next) {
         if (IS_ALIGNED(((uintptr_t)node->block->data), alignment)) {
-            return node_list_rm(head_node, node);
+            return node_list_rm(coarse, head_node, node);
         }
     }
 
@@ -316,7 +564,8 @@ static block_t *node_list_rm_with_alignment(ravl_free_blocks_head_t *head_node,
 // This is a tree of heads (ravl_free_blocks_head_t) of lists of free blocks of the same size.
 //
 // free_blocks_add - add a free block to the list of free blocks of the same size
-static int free_blocks_add(struct ravl *free_blocks, block_t *block) {
+static int free_blocks_add(coarse_t *coarse, block_t *block) {
+    struct ravl *free_blocks = coarse->free_blocks;
     ravl_free_blocks_head_t *head_node = NULL;
     int rv;
 
@@ -329,7 +578,7 @@ static int free_blocks_add(struct ravl *free_blocks, block_t *block) {
         head_node = node_data->value;
         assert(head_node);
     } else { // no head_node
-        head_node = umf_ba_global_alloc(sizeof(*head_node));
+        head_node = coarse_cache_alloc(&coarse->head_cache);
         if (!head_node) {
             return -1;
         }
@@ -339,12 +588,12 @@ static int free_blocks_add(struct ravl *free_blocks, block_t *block) {
         ravl_data_t data = {(uintptr_t)block->size, head_node};
         rv = ravl_emplace_copy(free_blocks, &data);
         if (rv) {
-            umf_ba_global_free(head_node);
+            coarse_cache_free(&coarse->head_cache, head_node);
             return -1;
         }
     }
 
-    block->free_list_ptr = node_list_add(head_node, block);
+    block->free_list_ptr = node_list_add(coarse, head_node, block);
     if (!block->free_list_ptr) {
         return -1; // out of memory
     }
@@ -357,9 +606,10 @@ static int free_blocks_add(struct ravl *free_blocks, block_t *block) {
 // free_blocks_rm_ge - remove the first free block of a size greater or equal to the given size only if it can be properly aligned
 // If it was the last block, the head node is freed and removed from the tree.
 // It is used during memory allocation (looking for a free block).
-static block_t *free_blocks_rm_ge(struct ravl *free_blocks, size_t size,
+static block_t *free_blocks_rm_ge(coarse_t *coarse, size_t size,
                                   size_t alignment,
                                   check_free_blocks_t check_blocks) {
+    struct ravl *free_blocks = coarse->free_blocks;
     ravl_data_t data = {(uintptr_t)size, NULL};
     ravl_node_t *node;
     node = ravl_find(free_blocks, &data, RAVL_PREDICATE_GREATER_EQUAL);
@@ -377,15 +627,15 @@ static block_t *free_blocks_rm_ge(struct ravl *free_blocks, size_t size,
     block_t *block = NULL;
     switch (check_blocks) {
     case CHECK_ONLY_THE_FIRST_BLOCK:
-        block = node_list_rm_first(head_node, alignment);
+        block = node_list_rm_first(coarse, head_node, alignment);
         break;
     case CHECK_ALL_BLOCKS_OF_SIZE:
-        block = node_list_rm_with_alignment(head_node, alignment);
+        block = node_list_rm_with_alignment(coarse, head_node, alignment);
         break;
     }
 
     if (head_node->head == NULL) {
-        umf_ba_global_free(head_node);
+        coarse_cache_free(&coarse->head_cache, head_node);
         ravl_remove(free_blocks, node);
     }
 
@@ -395,8 +645,9 @@ static block_t *free_blocks_rm_ge(struct ravl *free_blocks, size_t size,
 // free_blocks_rm_node - remove the free block pointed by the given node.
 // If it was the last block, the head node is freed and removed from the tree.
 // It is used during merging free blocks and destroying the coarse->free_blocks tree.
-static block_t *free_blocks_rm_node(struct ravl *free_blocks,
+static block_t *free_blocks_rm_node(coarse_t *coarse,
                                     ravl_free_blocks_elem_t *node) {
+    struct ravl *free_blocks = coarse->free_blocks;
     assert(free_blocks);
     assert(node);
     size_t size = node->block->size;
@@ -412,16 +663,359 @@ static block_t *free_blocks_rm_node(struct ravl *free_blocks,
     ravl_free_blocks_head_t *head_node = node_data->value;
     assert(head_node);
 
-    block_t *block = node_list_rm(head_node, node);
+    block_t *block = node_list_rm(coarse, head_node, node);
 
     if (head_node->head == NULL) {
-        umf_ba_global_free(head_node);
+        coarse_cache_free(&coarse->head_cache, head_node);
         ravl_remove(free_blocks, ravl_node);
     }
 
     return block;
 }
 
+// The functions "tlsf_*" handle the TLSF index of free blocks
+// (coarse->tlsf) used by the UMF_COARSE_MEMORY_STRATEGY_TLSF strategy.
+//
+// tlsf_mapping - get the size class (fl, sl) the given size belongs to
+static void tlsf_mapping(size_t size, unsigned *fl, unsigned *sl) {
+    assert(size);
+
+    if (size < TLSF_SL_COUNT) {
+        *fl = 0;
+        *sl = (unsigned)size;
+        return;
+    }
+
+    unsigned msb = utils_mssb_index(size);
+    *fl = msb - TLSF_SL_LOG2 + 1;
+    *sl = (unsigned)(size >> (msb - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+}
+
+// tlsf_add - add a free block to the list of its size class
+static void tlsf_add(tlsf_index_t *tlsf, block_t *block) {
+    assert(!block->tlsf_listed);
+
+    unsigned fl, sl;
+    tlsf_mapping(block->size, &fl, &sl);
+
+    block_t *head = tlsf->lists[fl][sl];
+    block->tlsf_prev = NULL;
+    block->tlsf_next = head;
+    if (head) {
+        head->tlsf_prev = block;
+    }
+
+    tlsf->lists[fl][sl] = block;
+    tlsf->sl_bitmap[fl] |= (1U << sl);
+    tlsf->fl_bitmap |= (1ULL << fl);
+    tlsf->num_blocks++;
+    block->tlsf_listed = true;
+}
+
+// tlsf_rm - remove a free block from the list of its size class
+static void tlsf_rm(tlsf_index_t *tlsf, block_t *block) {
+    assert(block->tlsf_listed);
+
+    unsigned fl, sl;
+    tlsf_mapping(block->size, &fl, &sl);
+
+    if (block->tlsf_next) {
+        block->tlsf_next->tlsf_prev = block->tlsf_prev;
+    }
+
+    if (block->tlsf_prev) {
+        block->tlsf_prev->tlsf_next = block->tlsf_next;
+    } else {
+        assert(tlsf->lists[fl][sl] == block);
+        tlsf->lists[fl][sl] = block->tlsf_next;
+        if (tlsf->lists[fl][sl] == NULL) {
+            tlsf->sl_bitmap[fl] &= ~(1U << sl);
+            if (tlsf->sl_bitmap[fl] == 0) {
+                tlsf->fl_bitmap &= ~(1ULL << fl);
+            }
+        }
+    }
+
+    block->tlsf_prev = NULL;
+    block->tlsf_next = NULL;
+    block->tlsf_listed = false;
+    assert(tlsf->num_blocks > 0);
+    tlsf->num_blocks--;
+}
+
+// tlsf_find_ge - find a free block of a size greater or equal to the given size
+// in constant time. The size is rounded up to the next size class,
+// so all blocks of the found list are large enough.
+static block_t *tlsf_find_ge(tlsf_index_t *tlsf, size_t size) {
+    assert(size);
+
+    size_t search_size = size;
+    if (size >= TLSF_SL_COUNT) {
+        size_t round =
+            ((size_t)1 << (utils_mssb_index(size) - TLSF_SL_LOG2)) - 1;
+        if (size + round < size) {
+            return NULL; // arithmetic overflow
+        }
+        search_size += round;
+    }
+
+    unsigned fl, sl;
+    tlsf_mapping(search_size, &fl, &sl);
+
+    uint32_t sl_map = tlsf->sl_bitmap[fl] & (~0U << sl);
+    if (sl_map == 0) {
+        uint64_t fl_map = 0;
+        if (fl + 1 < TLSF_FL_COUNT) {
+            fl_map = tlsf->fl_bitmap & (~0ULL << (fl + 1));
+        }
+
+        if (fl_map == 0) {
+            return NULL;
+        }
+
+        fl = utils_lssb_index(fl_map);
+        sl_map = tlsf->sl_bitmap[fl];
+        assert(sl_map);
+    }
+
+    sl = utils_lssb_index(sl_map);
+    assert(tlsf->lists[fl][sl]);
+    assert(tlsf->lists[fl][sl]->size >= size);
+
+    return tlsf->lists[fl][sl];
+}
+
+// tlsf_find_in_class - look through the list of the size class of the given size
+// and find the first block that can hold the properly aligned data of that size.
+static block_t *tlsf_find_in_class(tlsf_index_t *tlsf, size_t size,
+                                   size_t alignment) {
+    unsigned fl, sl;
+    tlsf_mapping(size, &fl, &sl);
+
+    for (block_t *block = tlsf->lists[fl][sl]; block != NULL;
+         block = block->tlsf_next) {
+        if (block_fits(block, size, alignment)) {
+            return block;
+        }
+    }
+
+    return NULL;
+}
+
+// tlsf_rm_ge - remove a free block that can hold the properly aligned data
+// of the given size from the TLSF index
+static block_t *tlsf_rm_ge(tlsf_index_t *tlsf, size_t size, size_t alignment) {
+    // first check if the first good-fit block has the correct alignment
+    block_t *block = tlsf_find_ge(tlsf, size);
+    if (block && IS_NOT_ALIGNED(((uintptr_t)block->data), alignment)) {
+        block = NULL;
+    }
+
+    // if not, look for a block of the (size + alignment) size
+    // and later cut out the properly aligned part
+    if (block == NULL && size + alignment > size) {
+        block = tlsf_find_ge(tlsf, size + alignment);
+    }
+
+    // the good-fit search skips the blocks of the size class
+    // of the requested size, which may be large enough too
+    if (block == NULL) {
+        block = tlsf_find_in_class(tlsf, size, alignment);
+    }
+
+    if (block) {
+        tlsf_rm(tlsf, block);
+    }
+
+    return block;
+}
+
+// The functions "best_fit_*" handle the coarse->best_fit RAVL tree
+// of free blocks used by the UMF_COARSE_MEMORY_STRATEGY_BEST_FIT strategy.
+//
+// best_fit_add - add a free block to the tree
+static int best_fit_add(struct ravl *best_fit, block_t *block) {
+    ravl_data_t data = {(uintptr_t)block->size, block};
+    if (ravl_emplace_copy(best_fit, &data)) {
+        return -1;
+    }
+
+    block->best_fit_listed = true;
+
+    return 0;
+}
+
+// best_fit_rm - remove the free block from the tree
+static void best_fit_rm(struct ravl *best_fit, block_t *block) {
+    ravl_data_t data = {(uintptr_t)block->size, block};
+    ravl_node_t *node = ravl_find(best_fit, &data, RAVL_PREDICATE_EQUAL);
+    assert(node);
+    ravl_remove(best_fit, node);
+    block->best_fit_listed = false;
+}
+
+// the number of too small blocks of a size from the range
+// [size, size + alignment) looked through before the blocks
+// of at least (size + alignment) bytes, which always fit
+#define BEST_FIT_MAX_SCAN 32
+
+// best_fit_rm_ge - remove the smallest free block (the one with the lowest
+// address of the smallest ones) that can hold the properly aligned data
+// of the given size, so no (size + alignment) block has to be carved
+static block_t *best_fit_rm_ge(struct ravl *best_fit, size_t size,
+                               size_t alignment) {
+    ravl_data_t data = {(uintptr_t)size, NULL};
+    ravl_node_t *node =
+        ravl_find(best_fit, &data, RAVL_PREDICATE_GREATER_EQUAL);
+    unsigned scanned = 0;
+
+    while (node) {
+        block_t *block = ((ravl_data_t *)ravl_data(node))->value;
+        if (block_fits(block, size, alignment)) {
+            ravl_remove(best_fit, node);
+            block->best_fit_listed = false;
+            return block;
+        }
+
+        if (++scanned == BEST_FIT_MAX_SCAN && size + alignment > size &&
+            block->size < size + alignment) {
+            data.key = (uintptr_t)(size + alignment);
+            node = ravl_find(best_fit, &data, RAVL_PREDICATE_GREATER_EQUAL);
+            continue;
+        }
+
+        node = ravl_node_successor(node);
+    }
+
+    return NULL;
+}
+
+// The functions "dirty_list_*" handle the coarse->dirty_blocks list
+// of free blocks waiting to be purged lazily.
+//
+// dirty_list_add - add the free block to the list if it should be purged
+static void dirty_list_add(coarse_t *coarse, block_t *block) {
+    assert(!block->dirty_listed);
+
+    if (!coarse->purge_min_size || block->purged ||
+        block->size < coarse->purge_min_size) {
+        return;
+    }
+
+    block->freed_at = utils_get_time_ms();
+    DL_APPEND2(coarse->dirty_blocks, block, dirty_prev, dirty_next);
+    block->dirty_listed = true;
+}
+
+// dirty_list_rm - remove the block from the list if it is there
+static void dirty_list_rm(coarse_t *coarse, block_t *block) {
+    if (block->dirty_listed) {
+        DL_DELETE2(coarse->dirty_blocks, block, dirty_prev, dirty_next);
+        block->dirty_listed = false;
+    }
+}
+
+// The functions "free_index_*" handle the index of free blocks
+// of the allocation strategy of the coarse: either the coarse->free_blocks
+// RAVL tree or the coarse->tlsf TLSF index.
+// The counters of free blocks are updated whenever a block is added to
+// or removed from the index, so the statistics do not need a tree walk.
+//
+// free_stats_add - count the free block added to the index
+static void free_stats_add(coarse_t *coarse, size_t size) {
+    coarse->num_free_blocks++;
+    coarse->free_hist[utils_mssb_index(size)]++;
+}
+
+// free_stats_rm - count the free block removed from the index
+static void free_stats_rm(coarse_t *coarse, size_t size) {
+    assert(coarse->num_free_blocks > 0);
+    assert(coarse->free_hist[utils_mssb_index(size)] > 0);
+    coarse->num_free_blocks--;
+    coarse->free_hist[utils_mssb_index(size)]--;
+}
+
+// free_index_add - add a free block to the index of free blocks
+static int free_index_add(coarse_t *coarse, block_t *block) {
+    dirty_list_add(coarse, block);
+
+    if (coarse->tlsf) {
+        tlsf_add(coarse->tlsf, block);
+    } else if (coarse->best_fit) {
+        if (best_fit_add(coarse->best_fit, block)) {
+            return -1;
+        }
+    } else if (free_blocks_add(coarse, block)) {
+        return -1;
+    }
+
+    free_stats_add(coarse, block->size);
+
+    return 0;
+}
+
+// free_index_rm - remove the block from the index of free blocks if it is there
+static void free_index_rm(coarse_t *coarse, block_t *block) {
+    dirty_list_rm(coarse, block);
+
+    if (block->tlsf_listed) {
+        tlsf_rm(coarse->tlsf, block);
+        free_stats_rm(coarse, block->size);
+    }
+
+    if (block->best_fit_listed) {
+        best_fit_rm(coarse->best_fit, block);
+        free_stats_rm(coarse, block->size);
+    }
+
+    if (block->free_list_ptr) {
+        free_blocks_rm_node(coarse, block->free_list_ptr);
+        block->free_list_ptr = NULL;
+        free_stats_rm(coarse, block->size);
+    }
+}
+
+// free_index_largest - get the size of the largest free block
+static size_t free_index_largest(coarse_t *coarse) {
+    if (coarse->tlsf) {
+        tlsf_index_t *tlsf = coarse->tlsf;
+        if (tlsf->fl_bitmap == 0) {
+            return 0;
+        }
+
+        // only the list of the highest size class has to be looked through
+        unsigned fl = utils_mssb_index(tlsf->fl_bitmap);
+        unsigned sl = utils_mssb_index(tlsf->sl_bitmap[fl]);
+        size_t largest = 0;
+        for (block_t *block = tlsf->lists[fl][sl]; block;
+             block = block->tlsf_next) {
+            if (block->size > largest) {
+                largest = block->size;
+            }
+        }
+
+        return largest;
+    }
+
+    if (coarse->best_fit) {
+        ravl_node_t *node = ravl_last(coarse->best_fit);
+        if (node == NULL) {
+            return 0;
+        }
+
+        return (size_t)((ravl_data_t *)ravl_data(node))->key;
+    }
+
+    ravl_data_t data = {(uintptr_t)SIZE_MAX, NULL};
+    ravl_node_t *node =
+        ravl_find(coarse->free_blocks, &data, RAVL_PREDICATE_LESS_EQUAL);
+    if (node == NULL) {
+        return 0;
+    }
+
+    return (size_t)((ravl_data_t *)ravl_data(node))->key;
+}
+
 // user_block_merge - merge two blocks from one of two lists of user blocks: all_blocks or free_blocks
 static umf_result_t user_block_merge(coarse_t *coarse, ravl_node_t *node1,
                                      ravl_node_t *node2, bool used,
@@ -435,7 +1029,6 @@ static umf_result_t user_block_merge(coarse_t *coarse, ravl_node_t *node1,
     *merged_node = NULL;
 
     struct ravl *all_blocks = coarse->all_blocks;
-    struct ravl *free_blocks = coarse->free_blocks;
 
     block_t *block1 = get_node_block(node1);
     block_t *block2 = get_node_block(node2);
@@ -460,14 +1053,14 @@ static umf_result_t user_block_merge(coarse_t *coarse, ravl_node_t *node1,
         return umf_result;
     }
 
-    if (block1->free_list_ptr) {
-        free_blocks_rm_node(free_blocks, block1->free_list_ptr);
-        block1->free_list_ptr = NULL;
-    }
+    free_index_rm(coarse, block1);
+    free_index_rm(coarse, block2);
 
-    if (block2->free_list_ptr) {
-        free_blocks_rm_node(free_blocks, block2->free_list_ptr);
-        block2->free_list_ptr = NULL;
+    // the merged block is purged only if both blocks were purged
+    if (block1->purged != block2->purged) {
+        coarse->purged_size -=
+            (block1->purged) ? block1->size : block2->size;
+        block1->purged = false;
     }
 
     // update the size
@@ -476,7 +1069,8 @@ static umf_result_t user_block_merge(coarse_t *coarse, ravl_node_t *node1,
     block_t *block_rm = coarse_ravl_rm(all_blocks, block2->data);
     assert(block_rm == block2);
     (void)block_rm; // WA for unused variable error
-    umf_ba_global_free(block2);
+    coarse_cache_free(&coarse->block_cache, block2);
+    coarse->num_all_blocks--;
 
     *merged_node = node1;
 
@@ -532,9 +1126,12 @@ static ravl_node_t *free_block_merge_with_next(coarse_t *coarse,
 typedef struct debug_cb_args_t {
     coarse_t *provider;
     size_t sum_used;
+    size_t sum_purged;
     size_t sum_blocks_size;
     size_t num_all_blocks;
     size_t num_free_blocks;
+    size_t largest_free_block;
+    size_t free_hist[COARSE_STATS_FREE_HIST_SIZE];
 } debug_cb_args_t;
 
 static void debug_verify_all_blocks_cb(void *data, void *arg) {
@@ -558,6 +1155,10 @@ static void debug_verify_all_blocks_cb(void *data, void *arg) {
     cb_args->num_all_blocks++;
     if (!block->used) {
         cb_args->num_free_blocks++;
+        cb_args->free_hist[utils_mssb_index(block->size)]++;
+        if (block->size > cb_args->largest_free_block) {
+            cb_args->largest_free_block = block->size;
+        }
     }
 
     assert(block->data);
@@ -580,6 +1181,15 @@ static void debug_verify_all_blocks_cb(void *data, void *arg) {
     cb_args->sum_blocks_size += block->size;
     if (block->used) {
         cb_args->sum_used += block->size;
+        assert(!block->purged);
+    }
+
+    if (block->purged) {
+        cb_args->sum_purged += block->size;
+    }
+
+    if (block->dirty_listed) {
+        assert(!block->used && !block->purged);
     }
 }
 
@@ -600,7 +1210,11 @@ static bool debug_check(coarse_t *provider) {
 
     assert(cb_args.num_all_blocks == stats.num_all_blocks);
     assert(cb_args.num_free_blocks == stats.num_free_blocks);
+    assert(cb_args.largest_free_block == stats.largest_free_block);
+    assert(memcmp(cb_args.free_hist, stats.free_hist,
+                  sizeof(stats.free_hist)) == 0);
     assert(cb_args.sum_used == provider->used_size);
+    assert(cb_args.sum_purged == provider->purged_size);
     assert(cb_args.sum_blocks_size == provider->alloc_size);
     assert(provider->alloc_size >= provider->used_size);
 
@@ -610,8 +1224,7 @@ static bool debug_check(coarse_t *provider) {
 
 static umf_result_t coarse_add_used_block(coarse_t *coarse, void *addr,
                                           size_t size) {
-    block_t *new_block =
-        coarse_ravl_add_new(coarse->all_blocks, addr, size, NULL);
+    block_t *new_block = coarse_ravl_add_new(coarse, addr, size, NULL);
     if (new_block == NULL) {
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
@@ -641,18 +1254,22 @@ static void coarse_ravl_cb_rm_all_blocks_node(void *data, void *arg) {
         coarse->used_size -= block->size;
     }
 
-    if (block->free_list_ptr) {
-        free_blocks_rm_node(coarse->free_blocks, block->free_list_ptr);
+    if (block->purged) {
+        assert(coarse->purged_size >= block->size);
+        coarse->purged_size -= block->size;
     }
 
+    free_index_rm(coarse, block);
+
     if (coarse->cb.free) {
         coarse->cb.free(coarse->provider, block->data, block->size);
     }
 
     assert(coarse->alloc_size >= block->size);
     coarse->alloc_size -= block->size;
+    coarse->num_all_blocks--;
 
-    umf_ba_global_free(block);
+    coarse_cache_free(&coarse->block_cache, block);
 }
 
 static umf_result_t can_provider_split(coarse_t *coarse, void *ptr,
@@ -688,17 +1305,17 @@ static umf_result_t create_aligned_block(coarse_t *coarse, size_t orig_size,
             return umf_result;
         }
 
-        block_t *aligned_block =
-            coarse_ravl_add_new(coarse->all_blocks, curr->data + padding,
-                                curr->size - padding, NULL);
+        block_t *aligned_block = coarse_ravl_add_new(
+            coarse, curr->data + padding, curr->size - padding, NULL);
         if (aligned_block == NULL) {
             return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
         }
 
+        aligned_block->purged = curr->purged;
         curr->used = false;
         curr->size = padding;
 
-        rv = free_blocks_add(coarse->free_blocks, curr);
+        rv = free_index_add(coarse, curr);
         if (rv) {
             return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
         }
@@ -724,15 +1341,16 @@ static umf_result_t split_current_block(coarse_t *coarse, block_t *curr,
 
     ravl_node_t *new_node = NULL;
 
-    block_t *new_block = coarse_ravl_add_new(
-        coarse->all_blocks, curr->data + size, curr->size - size, &new_node);
+    block_t *new_block = coarse_ravl_add_new(coarse, curr->data + size,
+                                             curr->size - size, &new_node);
     if (new_block == NULL) {
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
     new_block->used = false;
+    new_block->purged = curr->purged;
 
-    int rv = free_blocks_add(coarse->free_blocks, get_node_block(new_node));
+    int rv = free_index_add(coarse, get_node_block(new_node));
     if (rv) {
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
@@ -740,13 +1358,12 @@ static umf_result_t split_current_block(coarse_t *coarse, block_t *curr,
     return UMF_RESULT_SUCCESS;
 }
 
-static block_t *find_free_block(struct ravl *free_blocks, size_t size,
-                                size_t alignment,
-                                coarse_strategy_t allocation_strategy) {
+static block_t *find_free_block(coarse_t *coarse, size_t size,
+                                size_t alignment) {
     block_t *block;
     size_t new_size = size + alignment;
 
-    switch (allocation_strategy) {
+    switch (coarse->allocation_strategy) {
     case UMF_COARSE_MEMORY_STRATEGY_FASTEST:
         // Always allocate a free block of the (size + alignment) size
         // and later cut out the properly aligned part leaving two remaining parts.
@@ -755,12 +1372,12 @@ static block_t *find_free_block(struct ravl *free_blocks, size_t size,
             return NULL;
         }
 
-        return free_blocks_rm_ge(free_blocks, new_size, 0,
+        return free_blocks_rm_ge(coarse, new_size, 0,
                                  CHECK_ONLY_THE_FIRST_BLOCK);
 
     case UMF_COARSE_MEMORY_STRATEGY_FASTEST_BUT_ONE:
         // First check if the first free block of the 'size' size has the correct alignment.
-        block = free_blocks_rm_ge(free_blocks, size, alignment,
+        block = free_blocks_rm_ge(coarse, size, alignment,
                                   CHECK_ONLY_THE_FIRST_BLOCK);
         if (block) {
             return block;
@@ -772,13 +1389,13 @@ static block_t *find_free_block(struct ravl *free_blocks, size_t size,
         }
 
         // If not, use the `UMF_COARSE_MEMORY_STRATEGY_FASTEST` strategy.
-        return free_blocks_rm_ge(free_blocks, new_size, 0,
+        return free_blocks_rm_ge(coarse, new_size, 0,
                                  CHECK_ONLY_THE_FIRST_BLOCK);
 
     case UMF_COARSE_MEMORY_STRATEGY_CHECK_ALL_SIZE:
         // First look through all free blocks of the 'size' size
         // and choose the first one with the correct alignment.
-        block = free_blocks_rm_ge(free_blocks, size, alignment,
+        block = free_blocks_rm_ge(coarse, size, alignment,
                                   CHECK_ALL_BLOCKS_OF_SIZE);
         if (block) {
             return block;
@@ -791,8 +1408,14 @@ static block_t *find_free_block(struct ravl *free_blocks, size_t size,
 
         // If none of them had the correct alignment,
         // use the `UMF_COARSE_MEMORY_STRATEGY_FASTEST` strategy.
-        return free_blocks_rm_ge(free_blocks, new_size, 0,
+        return free_blocks_rm_ge(coarse, new_size, 0,
                                  CHECK_ONLY_THE_FIRST_BLOCK);
+
+    case UMF_COARSE_MEMORY_STRATEGY_TLSF:
+        return tlsf_rm_ge(coarse->tlsf, size, alignment);
+
+    case UMF_COARSE_MEMORY_STRATEGY_BEST_FIT:
+        return best_fit_rm_ge(coarse->best_fit, size, alignment);
     }
 
     return NULL;
@@ -808,87 +1431,305 @@ static int free_blocks_re_add(coarse_t *coarse, block_t *block) {
     node = free_block_merge_with_prev(coarse, node);
     node = free_block_merge_with_next(coarse, node);
 
-    return free_blocks_add(coarse->free_blocks, get_node_block(node));
-}
-
-static void ravl_cb_count(void *data, void *arg) {
-    assert(arg);
-    (void)data; // unused
-
-    size_t *num_all_blocks = arg;
-    (*num_all_blocks)++;
-}
-
-static void ravl_cb_count_free(void *data, void *arg) {
-    assert(data);
-    assert(arg);
-
-    ravl_data_t *node_data = data;
-    assert(node_data);
-    ravl_free_blocks_head_t *head_node = node_data->value;
-    assert(head_node);
-    struct ravl_free_blocks_elem_t *free_block = head_node->head;
-    assert(free_block);
-
-    size_t *num_all_blocks = arg;
-    while (free_block) {
-        (*num_all_blocks)++;
-        free_block = free_block->next;
-    }
+    return free_index_add(coarse, get_node_block(node));
 }
 
 static umf_result_t coarse_get_stats_no_lock(coarse_t *coarse,
                                              coarse_stats_t *stats) {
     assert(coarse);
 
-    size_t num_all_blocks = 0;
-    ravl_foreach(coarse->all_blocks, ravl_cb_count, &num_all_blocks);
-
-    size_t num_free_blocks = 0;
-    ravl_foreach(coarse->free_blocks, ravl_cb_count_free, &num_free_blocks);
-
     stats->alloc_size = coarse->alloc_size;
     stats->used_size = coarse->used_size;
-    stats->num_all_blocks = num_all_blocks;
-    stats->num_free_blocks = num_free_blocks;
+    stats->purged_size = coarse->purged_size;
+    stats->num_all_blocks = coarse->num_all_blocks;
+    stats->num_free_blocks = coarse->num_free_blocks;
+    stats->largest_free_block = free_index_largest(coarse);
+    memcpy(stats->free_hist, coarse->free_hist, sizeof(stats->free_hist));
 
     return UMF_RESULT_SUCCESS;
 }
 
-// PUBLIC API
-
-umf_result_t coarse_new(coarse_params_t *coarse_params, coarse_t **pcoarse) {
-#ifdef _WIN32
-    utils_init_once(&Log_initialized, utils_log_init);
-#endif /* _WIN32 */
+// free_block_split - split the free block into two free blocks
+static umf_result_t free_block_split(coarse_t *coarse, block_t *block,
+                                     size_t first_size, block_t **second) {
+    assert(!block->used);
+    assert(first_size < block->size);
 
-    if (coarse_params == NULL || pcoarse == NULL) {
-        LOG_ERR("coarse parameters or handle is missing");
-        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    umf_result_t umf_result =
+        can_provider_split(coarse, block->data, block->size, first_size);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
     }
 
-    if (!coarse_params->provider) {
-        LOG_ERR("memory provider is not set");
-        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    block_t *new_block = coarse_ravl_add_new(coarse, block->data + first_size,
+                                             block->size - first_size, NULL);
+    if (new_block == NULL) {
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    if (!coarse_params->page_size) {
-        LOG_ERR("page size of the memory provider is not set");
-        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
-    }
+    new_block->used = false;
+    new_block->purged = block->purged;
 
-    if (!coarse_params->cb.split) {
-        LOG_ERR("coarse split callback is not set");
-        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    free_index_rm(coarse, block);
+    block->size = first_size;
+
+    if (free_index_add(coarse, block) || free_index_add(coarse, new_block)) {
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    if (!coarse_params->cb.merge) {
+    *second = new_block;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// The functions "arena_*" handle the arenas of the coarse (num_arenas > 1).
+//
+// arena_range_add - assign the address range starting at addr to the arena
+static umf_result_t arena_range_add(coarse_t *arena, void *addr) {
+    coarse_t *coarse = arena->parent;
+
+    int ret = critnib_insert(coarse->arena_ranges, (uintptr_t)addr, arena,
+                             0 /* update */);
+    if (ret) {
+        LOG_ERR("cannot add the range %p to the tree of arena ranges", addr);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// arena_range_rm - remove the address range starting at addr from the arena
+static void arena_range_rm(coarse_t *arena, void *addr) {
+    coarse_t *coarse = arena->parent;
+
+    (void)critnib_remove(coarse->arena_ranges, (uintptr_t)addr);
+}
+
+// arena_find - find the arena owning the given address (lock-free)
+static coarse_t *arena_find(coarse_t *coarse, const void *ptr) {
+    return critnib_find_le(coarse->arena_ranges, (uintptr_t)ptr);
+}
+
+// arena_get_id - get the index of the arena of the calling thread
+static unsigned arena_get_id(coarse_t *coarse) {
+    if (Thread_arena_id == 0) {
+        Thread_arena_id = (unsigned)utils_atomic_increment(&Threads_counter);
+    }
+
+    return (Thread_arena_id - 1) % coarse->num_arenas;
+}
+
+// trim_release_regions - return the regions allocated from the memory provider
+// that lie entirely within the free block back to the provider
+static umf_result_t trim_release_regions(coarse_t *coarse, block_t *block,
+                                         size_t keep_bytes) {
+    uintptr_t block_end = (uintptr_t)block->data + block->size;
+    uintptr_t addr = (uintptr_t)block->data;
+    umf_result_t umf_result;
+
+    while (block &&
+           coarse->alloc_size - coarse->used_size - coarse->purged_size >
+               keep_bytes) {
+        ravl_data_t data = {addr, NULL};
+        ravl_node_t *node =
+            ravl_find(coarse->regions, &data, RAVL_PREDICATE_GREATER_EQUAL);
+        if (node == NULL) {
+            break;
+        }
+
+        ravl_data_t *region = ravl_data(node);
+        uintptr_t region_start = region->key;
+        size_t region_size = (size_t)region->value;
+        if (region_start + region_size > block_end) {
+            break;
+        }
+
+        addr = region_start + region_size;
+
+        // cut the region out of the block
+        if (region_start > (uintptr_t)block->data) {
+            umf_result = free_block_split(
+                coarse, block, region_start - (uintptr_t)block->data, &block);
+            if (umf_result != UMF_RESULT_SUCCESS) {
+                return umf_result;
+            }
+        }
+
+        block_t *next_block = NULL;
+        if (block->size > region_size) {
+            umf_result =
+                free_block_split(coarse, block, region_size, &next_block);
+            if (umf_result != UMF_RESULT_SUCCESS) {
+                return umf_result;
+            }
+        }
+
+        // the provider can return this range to another arena at once
+        if (coarse->parent) {
+            arena_range_rm(coarse, block->data);
+        }
+
+        umf_result =
+            coarse->cb.free(coarse->provider, block->data, block->size);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            LOG_ERR("coarse_free_cb(ptr=%p, size=%zu) failed",
+                    (void *)block->data, block->size);
+            if (coarse->parent) {
+                (void)arena_range_add(coarse, block->data);
+            }
+            return umf_result;
+        }
+
+        LOG_DEBUG("coarse_TRIM (free) %zu used %zu alloc %zu", block->size,
+                  coarse->used_size, coarse->alloc_size - block->size);
+
+        free_index_rm(coarse, block);
+        if (block->purged) {
+            coarse->purged_size -= block->size;
+        }
+
+        block_t *block_rm = coarse_ravl_rm(coarse->all_blocks, block->data);
+        assert(block_rm == block);
+        (void)block_rm; // WA for unused variable error
+        coarse->num_all_blocks--;
+
+        assert(coarse->alloc_size >= block->size);
+        coarse->alloc_size -= block->size;
+        coarse_cache_free(&coarse->block_cache, block);
+
+        ravl_remove(coarse->regions, node);
+
+        block = next_block;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// trim_purge_block - purge the free block with the purge() callback
+static umf_result_t trim_purge_block(coarse_t *coarse, block_t *block) {
+    dirty_list_rm(coarse, block);
+
+    umf_result_t umf_result =
+        coarse->cb.purge(coarse->provider, block->data, block->size);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        LOG_ERR("coarse_purge_cb(ptr=%p, size=%zu) failed",
+                (void *)block->data, block->size);
+        return umf_result;
+    }
+
+    block->purged = true;
+    coarse->purged_size += block->size;
+
+    LOG_DEBUG("coarse_TRIM (purge) %zu used %zu alloc %zu", block->size,
+              coarse->used_size, coarse->alloc_size);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// maximum number of expired blocks purged in one coarse_alloc()
+// or coarse_free() call (every call adds at most one dirty block),
+// coarse_trim() purges all of them
+#define PURGE_EXPIRED_MAX_BLOCKS_PER_CALL 1
+
+// purge_expired_blocks - purge at most max_blocks dirty free blocks
+// that have been free for at least purge_delay_ms milliseconds
+static void purge_expired_blocks(coarse_t *coarse, size_t max_blocks) {
+    if (coarse->dirty_blocks == NULL) {
+        return;
+    }
+
+    uint64_t now = utils_get_time_ms();
+
+    // the oldest blocks are at the beginning of the list
+    block_t *block;
+    while (max_blocks-- && (block = coarse->dirty_blocks) != NULL &&
+           now - block->freed_at >= coarse->purge_delay_ms) {
+        // the block is removed from the list even if purging fails
+        (void)trim_purge_block(coarse, block);
+    }
+}
+
+static umf_result_t coarse_trim_no_lock(coarse_t *coarse, size_t keep_bytes) {
+    assert(coarse->cb.free || coarse->cb.purge);
+
+    umf_result_t umf_result = UMF_RESULT_SUCCESS;
+    uintptr_t addr = 0;
+
+    // size of the free memory that is not purged yet
+    while (coarse->alloc_size - coarse->used_size - coarse->purged_size >
+           keep_bytes) {
+        ravl_data_t data = {addr, NULL};
+        ravl_node_t *node =
+            ravl_find(coarse->all_blocks, &data, RAVL_PREDICATE_GREATER_EQUAL);
+        if (node == NULL) {
+            break;
+        }
+
+        // the block can be split or removed from the tree,
+        // so the next one is looked up by the address
+        block_t *block = get_node_block(node);
+        addr = (uintptr_t)block->data + block->size;
+
+        if (block->used || block->purged) {
+            continue;
+        }
+
+        umf_result_t ret;
+        if (coarse->cb.free) {
+            ret = trim_release_regions(coarse, block, keep_bytes);
+        } else {
+            ret = trim_purge_block(coarse, block);
+        }
+
+        if (ret != UMF_RESULT_SUCCESS) {
+            umf_result = ret;
+        }
+    }
+
+    return umf_result;
+}
+
+// PUBLIC API
+
+static umf_result_t arenas_new(coarse_params_t *coarse_params,
+                               coarse_t **pcoarse);
+
+umf_result_t coarse_new(coarse_params_t *coarse_params, coarse_t **pcoarse) {
+#ifdef _WIN32
+    utils_init_once(&Log_initialized, utils_log_init);
+#endif /* _WIN32 */
+
+    if (coarse_params == NULL || pcoarse == NULL) {
+        LOG_ERR("coarse parameters or handle is missing");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!coarse_params->provider) {
+        LOG_ERR("memory provider is not set");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!coarse_params->page_size) {
+        LOG_ERR("page size of the memory provider is not set");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!coarse_params->cb.split) {
+        LOG_ERR("coarse split callback is not set");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!coarse_params->cb.merge) {
         LOG_ERR("coarse merge callback is not set");
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
     // alloc() and free() callbacks are optional
 
+    if (coarse_params->num_arenas > 1) {
+        return arenas_new(coarse_params, pcoarse);
+    }
+
     coarse_t *coarse = umf_ba_global_alloc(sizeof(*coarse));
     if (!coarse) {
         LOG_ERR("out of the host memory");
@@ -901,6 +1742,16 @@ umf_result_t coarse_new(coarse_params_t *coarse_params, coarse_t **pcoarse) {
     coarse->page_size = coarse_params->page_size;
     coarse->cb = coarse_params->cb;
     coarse->allocation_strategy = coarse_params->allocation_strategy;
+    coarse->free_high_water_mark = coarse_params->free_high_water_mark;
+    coarse->numa_node = -1;
+    if (coarse_params->cb.purge) {
+        coarse->purge_min_size = coarse_params->purge_min_size;
+        coarse->purge_delay_ms = coarse_params->purge_delay_ms;
+    }
+
+    coarse_cache_init(&coarse->block_cache, sizeof(block_t));
+    coarse_cache_init(&coarse->elem_cache, sizeof(ravl_free_blocks_elem_t));
+    coarse_cache_init(&coarse->head_cache, sizeof(ravl_free_blocks_head_t));
 
     umf_result_t umf_result = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
 
@@ -916,6 +1767,31 @@ umf_result_t coarse_new(coarse_params_t *coarse_params, coarse_t **pcoarse) {
         goto err_delete_ravl_free_blocks;
     }
 
+    if (coarse->allocation_strategy == UMF_COARSE_MEMORY_STRATEGY_TLSF) {
+        coarse->tlsf = umf_ba_global_alloc(sizeof(*coarse->tlsf));
+        if (coarse->tlsf == NULL) {
+            LOG_ERR("out of the host memory");
+            goto err_delete_ravl_all_blocks;
+        }
+
+        memset(coarse->tlsf, 0, sizeof(*coarse->tlsf));
+    }
+
+    coarse->regions = ravl_new_sized(coarse_ravl_comp, sizeof(ravl_data_t));
+    if (coarse->regions == NULL) {
+        LOG_ERR("out of the host memory");
+        goto err_free_tlsf;
+    }
+
+    if (coarse->allocation_strategy == UMF_COARSE_MEMORY_STRATEGY_BEST_FIT) {
+        coarse->best_fit =
+            ravl_new_sized(coarse_ravl_comp_best_fit, sizeof(ravl_data_t));
+        if (coarse->best_fit == NULL) {
+            LOG_ERR("out of the host memory");
+            goto err_delete_ravl_regions;
+        }
+    }
+
     coarse->alloc_size = 0;
     coarse->used_size = 0;
 
@@ -923,7 +1799,7 @@ umf_result_t coarse_new(coarse_params_t *coarse_params, coarse_t **pcoarse) {
 
     if (utils_mutex_init(&coarse->lock) == NULL) {
         LOG_ERR("lock initialization failed");
-        goto err_delete_ravl_all_blocks;
+        goto err_delete_ravl_best_fit;
     }
 
     assert(coarse->used_size == 0);
@@ -934,6 +1810,14 @@ umf_result_t coarse_new(coarse_params_t *coarse_params, coarse_t **pcoarse) {
 
     return UMF_RESULT_SUCCESS;
 
+err_delete_ravl_best_fit:
+    if (coarse->best_fit) {
+        ravl_delete(coarse->best_fit);
+    }
+err_delete_ravl_regions:
+    ravl_delete(coarse->regions);
+err_free_tlsf:
+    umf_ba_global_free(coarse->tlsf);
 err_delete_ravl_all_blocks:
     ravl_delete(coarse->all_blocks);
 err_delete_ravl_free_blocks:
@@ -943,12 +1827,89 @@ err_free_coarse:
     return umf_result;
 }
 
+// arenas_new - create a coarse passing all calls to its arenas
+static umf_result_t arenas_new(coarse_params_t *coarse_params,
+                               coarse_t **pcoarse) {
+    unsigned num_arenas = coarse_params->num_arenas;
+    umf_result_t umf_result = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+
+    coarse_t *coarse = umf_ba_global_alloc(sizeof(*coarse));
+    if (!coarse) {
+        LOG_ERR("out of the host memory");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    memset(coarse, 0, sizeof(*coarse));
+
+    coarse->provider = coarse_params->provider;
+    coarse->page_size = coarse_params->page_size;
+    coarse->cb = coarse_params->cb;
+    coarse->allocation_strategy = coarse_params->allocation_strategy;
+
+    coarse->arenas = umf_ba_global_alloc(num_arenas * sizeof(coarse_t *));
+    if (coarse->arenas == NULL) {
+        LOG_ERR("out of the host memory");
+        goto err_free_coarse;
+    }
+
+    memset(coarse->arenas, 0, num_arenas * sizeof(coarse_t *));
+
+    coarse->arena_ranges = critnib_new();
+    if (coarse->arena_ranges == NULL) {
+        LOG_ERR("out of the host memory");
+        goto err_free_arenas;
+    }
+
+    // the free memory is trimmed in every arena separately
+    coarse_params_t arena_params = *coarse_params;
+    arena_params.num_arenas = 0;
+    arena_params.free_high_water_mark /= num_arenas;
+
+    for (unsigned i = 0; i < num_arenas; i++) {
+        umf_result = coarse_new(&arena_params, &coarse->arenas[i]);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            LOG_ERR("creating the arena #%u failed", i);
+            goto err_delete_arenas;
+        }
+
+        coarse->arenas[i]->parent = coarse;
+    }
+
+    coarse->num_arenas = num_arenas;
+
+    *pcoarse = coarse;
+
+    return UMF_RESULT_SUCCESS;
+
+err_delete_arenas:
+    for (unsigned i = 0; i < num_arenas && coarse->arenas[i]; i++) {
+        coarse_delete(coarse->arenas[i]);
+    }
+    critnib_delete(coarse->arena_ranges);
+err_free_arenas:
+    umf_ba_global_free(coarse->arenas);
+err_free_coarse:
+    umf_ba_global_free(coarse);
+    return umf_result;
+}
+
 void coarse_delete(coarse_t *coarse) {
     if (coarse == NULL) {
         LOG_ERR("coarse handle is missing");
         return;
     }
 
+    if (coarse->num_arenas) {
+        for (unsigned i = 0; i < coarse->num_arenas; i++) {
+            coarse_delete(coarse->arenas[i]);
+        }
+
+        critnib_delete(coarse->arena_ranges);
+        umf_ba_global_free(coarse->arenas);
+        umf_ba_global_free(coarse);
+        return;
+    }
+
     utils_mutex_destroy_not_free(&coarse->lock);
 
     ravl_foreach(coarse->all_blocks, coarse_ravl_cb_rm_all_blocks_node, coarse);
@@ -957,6 +1918,15 @@ void coarse_delete(coarse_t *coarse) {
 
     ravl_delete(coarse->all_blocks);
     ravl_delete(coarse->free_blocks);
+    ravl_delete(coarse->regions);
+    umf_ba_global_free(coarse->tlsf);
+    if (coarse->best_fit) {
+        ravl_delete(coarse->best_fit);
+    }
+
+    coarse_cache_destroy(&coarse->block_cache);
+    coarse_cache_destroy(&coarse->elem_cache);
+    coarse_cache_destroy(&coarse->head_cache);
 
     umf_ba_global_free(coarse);
 }
@@ -984,6 +1954,64 @@ umf_result_t coarse_add_memory_from_provider(coarse_t *coarse, size_t size) {
     return coarse_free(coarse, ptr, size);
 }
 
+// arenas_add_memory_fixed - split the memory evenly between num_arenas arenas
+// starting from the arena #first
+static umf_result_t arenas_add_memory_fixed(coarse_t *coarse, unsigned first,
+                                            unsigned num_arenas, void *addr,
+                                            size_t size) {
+    size_t part_size = ALIGN_DOWN(size / num_arenas, coarse->page_size);
+    umf_result_t umf_result = UMF_RESULT_SUCCESS;
+
+    // a too small memory is given to the arena of the calling thread
+    if (part_size == 0) {
+        first += arena_get_id(coarse) % num_arenas;
+        num_arenas = 1;
+        part_size = size;
+    }
+
+    uintptr_t *keys = umf_ba_global_alloc(num_arenas * sizeof(*keys));
+    if (keys == NULL) {
+        LOG_ERR("cannot allocate the keys of the arena ranges");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    for (unsigned i = 0; i < num_arenas; i++) {
+        keys[i] = (uintptr_t)addr + i * part_size;
+    }
+
+    // all ranges are added at once, the arenas #first.. are their values
+    int ret = critnib_insert_bulk(coarse->arena_ranges, keys,
+                                  (void *const *)&coarse->arenas[first],
+                                  num_arenas);
+    if (ret) {
+        LOG_ERR("cannot add the ranges %p-%p to the tree of arena ranges",
+                addr, (void *)((uintptr_t)addr + size));
+        umf_ba_global_free(keys);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    for (unsigned i = 0; i < num_arenas; i++) {
+        coarse_t *arena = coarse->arenas[first + i];
+        size_t arena_size = part_size;
+        if (i == num_arenas - 1) {
+            arena_size = size - (size_t)(keys[i] - (uintptr_t)addr);
+        }
+
+        umf_result = coarse_add_memory_fixed(arena, (void *)keys[i],
+                                             arena_size);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            // drop the ranges of this and all next arenas
+            (void)critnib_remove_range(coarse->arena_ranges, keys[i],
+                                       keys[num_arenas - 1], NULL, NULL);
+            break;
+        }
+    }
+
+    umf_ba_global_free(keys);
+
+    return umf_result;
+}
+
 umf_result_t coarse_add_memory_fixed(coarse_t *coarse, void *addr,
                                      size_t size) {
     umf_result_t umf_result;
@@ -997,6 +2025,11 @@ umf_result_t coarse_add_memory_fixed(coarse_t *coarse, void *addr,
         return UMF_RESULT_ERROR_NOT_SUPPORTED;
     }
 
+    if (coarse->num_arenas) {
+        return arenas_add_memory_fixed(coarse, 0, coarse->num_arenas, addr,
+                                       size);
+    }
+
     if (utils_mutex_lock(&coarse->lock) != 0) {
         LOG_ERR("locking the lock failed");
         return UMF_RESULT_ERROR_UNKNOWN;
@@ -1024,14 +2057,58 @@ umf_result_t coarse_add_memory_fixed(coarse_t *coarse, void *addr,
     return UMF_RESULT_SUCCESS;
 }
 
-umf_result_t coarse_alloc(coarse_t *coarse, size_t size, size_t alignment,
-                          void **resultPtr) {
-    umf_result_t umf_result = UMF_RESULT_ERROR_UNKNOWN;
+umf_result_t coarse_add_memory_fixed_node(coarse_t *coarse, void *addr,
+                                          size_t size, unsigned num_arenas,
+                                          int numa_node) {
+    if (coarse == NULL || addr == NULL || size == 0 || num_arenas == 0) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
 
-    if (coarse == NULL || resultPtr == NULL) {
+    if (!coarse->num_arenas) {
+        return coarse_add_memory_fixed(coarse, addr, size);
+    }
+
+    if (coarse->cb.alloc || coarse->cb.free) {
+        LOG_ERR("error: alloc or free callback is set");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    unsigned first = coarse->num_arenas_used;
+    if (num_arenas > coarse->num_arenas - first) {
+        LOG_ERR("not enough arenas left (requested: %u, left: %u)", num_arenas,
+                coarse->num_arenas - first);
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
+    umf_result_t umf_result =
+        arenas_add_memory_fixed(coarse, first, num_arenas, addr, size);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    for (unsigned i = first; i < first + num_arenas; i++) {
+        coarse->arenas[i]->numa_node = numa_node;
+    }
+
+    coarse->num_arenas_used += num_arenas;
+    if (numa_node >= 0) {
+        coarse->numa_aware = true;
+    }
+
+    LOG_DEBUG("added memory %p of size %zu (NUMA node: %i) to arenas #%u-#%u",
+              addr, size, numa_node, first, first + num_arenas - 1);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// arena_alloc - allocate memory from the coarse without arenas
+// or from one of the arenas, getting more memory from the memory provider
+// only if use_provider is true
+static umf_result_t arena_alloc(coarse_t *coarse, size_t size,
+                                size_t alignment, bool use_provider,
+                                void **resultPtr) {
+    umf_result_t umf_result = UMF_RESULT_ERROR_UNKNOWN;
+
     // alignment must be a power of two and a multiple or a divider of the page size
     if (alignment == 0) {
         alignment = coarse->page_size;
@@ -1054,8 +2131,11 @@ umf_result_t coarse_alloc(coarse_t *coarse, size_t size, size_t alignment,
     assert(debug_check(coarse));
 
     // Find a block with greater or equal size using the given memory allocation strategy
-    block_t *curr = find_free_block(coarse->free_blocks, size, alignment,
-                                    coarse->allocation_strategy);
+    block_t *curr = find_free_block(coarse, size, alignment);
+    if (curr) {
+        dirty_list_rm(coarse, curr);
+        free_stats_rm(coarse, curr->size);
+    }
 
     // If the block that we want to reuse has a greater size, split it.
     // Try to merge the split part with the successor if it is not used.
@@ -1098,9 +2178,17 @@ umf_result_t coarse_alloc(coarse_t *coarse, size_t size, size_t alignment,
         }
 
         curr->used = true;
+        if (curr->purged) {
+            assert(coarse->purged_size >= curr->size);
+            coarse->purged_size -= curr->size;
+            curr->purged = false;
+        }
+
         *resultPtr = curr->data;
         coarse->used_size += size;
 
+        purge_expired_blocks(coarse, PURGE_EXPIRED_MAX_BLOCKS_PER_CALL);
+
         assert(debug_check(coarse));
         utils_mutex_unlock(&coarse->lock);
 
@@ -1112,6 +2200,11 @@ umf_result_t coarse_alloc(coarse_t *coarse, size_t size, size_t alignment,
 
     *resultPtr = NULL;
 
+    if (!use_provider) {
+        // the caller tries the other arenas
+        goto err_unlock;
+    }
+
     if (!coarse->cb.alloc) {
         LOG_ERR("out of memory");
         goto err_unlock;
@@ -1125,14 +2218,36 @@ umf_result_t coarse_alloc(coarse_t *coarse, size_t size, size_t alignment,
 
     ASSERT_IS_ALIGNED(((uintptr_t)(*resultPtr)), alignment);
 
+    if (coarse->parent) {
+        umf_result = arena_range_add(coarse, *resultPtr);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            if (coarse->cb.free) {
+                coarse->cb.free(coarse->provider, *resultPtr, size);
+            }
+            goto err_unlock;
+        }
+    }
+
     umf_result = coarse_add_used_block(coarse, *resultPtr, size);
     if (umf_result != UMF_RESULT_SUCCESS) {
+        if (coarse->parent) {
+            arena_range_rm(coarse, *resultPtr);
+        }
         if (coarse->cb.free) {
             coarse->cb.free(coarse->provider, *resultPtr, size);
         }
         goto err_unlock;
     }
 
+    if (coarse->cb.free) {
+        ravl_data_t region = {(uintptr_t)*resultPtr, (void *)size};
+        if (ravl_emplace_copy(coarse->regions, &region)) {
+            // the region will not be trimmed
+            LOG_WARN("cannot add the region (%p, %zu) to the tree of regions",
+                     *resultPtr, size);
+        }
+    }
+
     LOG_DEBUG("coarse_ALLOC (memory_provider) %zu used %zu alloc %zu", size,
               coarse->used_size, coarse->alloc_size);
 
@@ -1145,6 +2260,47 @@ err_unlock:
     return umf_result;
 }
 
+umf_result_t coarse_alloc(coarse_t *coarse, size_t size, size_t alignment,
+                          void **resultPtr) {
+    umf_result_t umf_result;
+
+    if (coarse == NULL || resultPtr == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!coarse->num_arenas) {
+        return arena_alloc(coarse, size, alignment, true, resultPtr);
+    }
+
+    // Try the arena of the calling thread first and steal free memory
+    // from the other arenas only when it is exhausted. If the NUMA nodes
+    // of the arenas are known, the arenas located on the NUMA node
+    // of the calling thread are tried first and the remote ones
+    // only when all local arenas are exhausted.
+    unsigned id = arena_get_id(coarse);
+    int node = coarse->numa_aware ? utils_get_current_numa_node() : -1;
+    for (int remote = (node < 0); remote < 2; remote++) {
+        for (unsigned i = 0; i < coarse->num_arenas; i++) {
+            coarse_t *arena = coarse->arenas[(id + i) % coarse->num_arenas];
+            if (node >= 0 && (arena->numa_node != node) != remote) {
+                continue;
+            }
+
+            umf_result = arena_alloc(arena, size, alignment, false, resultPtr);
+            if (umf_result != UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY) {
+                return umf_result;
+            }
+        }
+    }
+
+    if (!coarse->cb.alloc) {
+        LOG_ERR("out of memory");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    return arena_alloc(coarse->arenas[id], size, alignment, true, resultPtr);
+}
+
 umf_result_t coarse_free(coarse_t *coarse, void *ptr, size_t bytes) {
     if (coarse == NULL) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
@@ -1154,6 +2310,15 @@ umf_result_t coarse_free(coarse_t *coarse, void *ptr, size_t bytes) {
         return UMF_RESULT_SUCCESS;
     }
 
+    if (coarse->num_arenas) {
+        coarse = arena_find(coarse, ptr);
+        if (coarse == NULL) {
+            LOG_ERR("memory block not found (ptr = %p, size = %zu)", ptr,
+                    bytes);
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
     if (utils_mutex_lock(&coarse->lock) != 0) {
         LOG_ERR("locking the lock failed");
         return UMF_RESULT_ERROR_UNKNOWN;
@@ -1194,12 +2359,23 @@ umf_result_t coarse_free(coarse_t *coarse, void *ptr, size_t bytes) {
     node = free_block_merge_with_prev(coarse, node);
     node = free_block_merge_with_next(coarse, node);
 
-    int rv = free_blocks_add(coarse->free_blocks, get_node_block(node));
+    int rv = free_index_add(coarse, get_node_block(node));
     if (rv) {
         utils_mutex_unlock(&coarse->lock);
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
+    // trim the free memory to a half of the high water mark
+    // when it exceeds the mark
+    if (coarse->free_high_water_mark &&
+        (coarse->cb.free || coarse->cb.purge) &&
+        coarse->alloc_size - coarse->used_size - coarse->purged_size >
+            coarse->free_high_water_mark) {
+        (void)coarse_trim_no_lock(coarse, coarse->free_high_water_mark / 2);
+    }
+
+    purge_expired_blocks(coarse, PURGE_EXPIRED_MAX_BLOCKS_PER_CALL);
+
     assert(debug_check(coarse));
     utils_mutex_unlock(&coarse->lock);
 
@@ -1216,6 +2392,21 @@ umf_result_t coarse_merge(coarse_t *coarse, void *lowPtr, void *highPtr,
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
+    if (coarse->num_arenas) {
+        coarse_t *arena = arena_find(coarse, lowPtr);
+        if (arena == NULL) {
+            LOG_ERR("the lowPtr memory block not found");
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+
+        if (arena_find(coarse, highPtr) != arena) {
+            LOG_DEBUG("blocks of different arenas cannot be merged");
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+
+        coarse = arena;
+    }
+
     if (utils_mutex_lock(&coarse->lock) != 0) {
         LOG_ERR("locking the lock failed");
         return UMF_RESULT_ERROR_UNKNOWN;
@@ -1293,6 +2484,14 @@ umf_result_t coarse_split(coarse_t *coarse, void *ptr, size_t totalSize,
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
+    if (coarse->num_arenas) {
+        coarse = arena_find(coarse, ptr);
+        if (coarse == NULL) {
+            LOG_ERR("memory block not found");
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
     if (utils_mutex_lock(&coarse->lock) != 0) {
         LOG_ERR("locking the lock failed");
         return UMF_RESULT_ERROR_UNKNOWN;
@@ -1329,9 +2528,8 @@ umf_result_t coarse_split(coarse_t *coarse, void *ptr, size_t totalSize,
 
     umf_result = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
 
-    block_t *new_block =
-        coarse_ravl_add_new(coarse->all_blocks, block->data + firstSize,
-                            block->size - firstSize, NULL);
+    block_t *new_block = coarse_ravl_add_new(coarse, block->data + firstSize,
+                                             block->size - firstSize, NULL);
     if (new_block == NULL) {
         goto err_mutex_unlock;
     }
@@ -1350,6 +2548,228 @@ err_mutex_unlock:
     return umf_result;
 }
 
+// used_block_shrink - shrink the used block to new_size
+// returning its tail to the free blocks
+static umf_result_t used_block_shrink(coarse_t *coarse, ravl_node_t *node,
+                                      size_t new_size) {
+    block_t *block = get_node_block(node);
+    size_t tail_size = block->size - new_size;
+
+    // check if block can be split by the memory provider
+    umf_result_t umf_result =
+        can_provider_split(coarse, block->data, block->size, new_size);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    // the tail is added to the index of free blocks before the block
+    // is shrunk, so the shrink can be undone if it fails
+    ravl_node_t *tail_node = NULL;
+    block_t *tail = coarse_ravl_add_new(coarse, block->data + new_size,
+                                        tail_size, &tail_node);
+    if (tail == NULL) {
+        goto err_merge;
+    }
+
+    tail->used = false;
+    if (free_index_add(coarse, tail)) {
+        free_index_rm(coarse, tail);
+        block_t *block_rm = coarse_ravl_rm(coarse->all_blocks, tail->data);
+        assert(block_rm == tail);
+        (void)block_rm; // WA for unused variable error
+        coarse_cache_free(&coarse->block_cache, tail);
+        coarse->num_all_blocks--;
+        goto err_merge;
+    }
+
+    block->size = new_size;
+    coarse->used_size -= tail_size;
+
+    // merge the tail with the next block if it is free,
+    // the merged block has to be added to the index again
+    (void)free_block_merge_with_next(coarse, tail_node);
+    if (tail->size != tail_size && free_index_add(coarse, tail)) {
+        // the block is shrunk already, the merged free block will be
+        // added to the index again when one of its neighbours is freed
+        LOG_WARN("cannot add the free block %p of size %zu to the index",
+                 (void *)tail->data, tail->size);
+    }
+
+    return UMF_RESULT_SUCCESS;
+
+err_merge:
+    // undo the split of the block by the memory provider
+    if (coarse->cb.merge(coarse->provider, block->data, block->data + new_size,
+                         block->size) != UMF_RESULT_SUCCESS) {
+        LOG_ERR("coarse_merge_cb(lowPtr=%p, highPtr=%p, totalSize=%zu) failed",
+                (void *)block->data, (void *)(block->data + new_size),
+                block->size);
+    }
+
+    return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+}
+
+// used_block_grow - grow the used block to new_size in place
+// using the beginning of the next block if it is free and large enough
+static umf_result_t used_block_grow(coarse_t *coarse, ravl_node_t *node,
+                                    size_t new_size) {
+    block_t *block = get_node_block(node);
+    size_t grow_size = new_size - block->size;
+    umf_result_t umf_result;
+
+    ravl_node_t *next_node = get_node_next(node);
+    block_t *next = next_node ? get_node_block(next_node) : NULL;
+    if (next == NULL || next->used ||
+        block->data + block->size != next->data || next->size < grow_size) {
+        LOG_DEBUG("cannot grow the block %p in place from %zu to %zu",
+                  (void *)block->data, block->size, new_size);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    if (next->size > grow_size) {
+        block_t *rest = NULL;
+        umf_result = free_block_split(coarse, next, grow_size, &rest);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            return umf_result;
+        }
+    }
+
+    umf_result = coarse->cb.merge(coarse->provider, block->data, next->data,
+                                  new_size);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        LOG_ERR("coarse_merge_cb(lowPtr=%p, highPtr=%p, totalSize=%zu) failed",
+                (void *)block->data, (void *)next->data, new_size);
+        // merge the split free block back
+        (void)free_block_merge_with_next(coarse, next_node);
+        if (next->size != grow_size) {
+            // the merged block has to be added to the index again
+            (void)free_index_add(coarse, next);
+        }
+        return umf_result;
+    }
+
+    free_index_rm(coarse, next);
+    if (next->purged) {
+        assert(coarse->purged_size >= next->size);
+        coarse->purged_size -= next->size;
+    }
+
+    block->size = new_size;
+    coarse->used_size += grow_size;
+
+    block_t *block_rm = coarse_ravl_rm(coarse->all_blocks, next->data);
+    assert(block_rm == next);
+    (void)block_rm; // WA for unused variable error
+    coarse_cache_free(&coarse->block_cache, next);
+    coarse->num_all_blocks--;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t coarse_resize(coarse_t *coarse, void *ptr, size_t old_size,
+                           size_t new_size) {
+    umf_result_t umf_result;
+
+    if (coarse == NULL || ptr == NULL || old_size == 0 || new_size == 0) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (coarse->num_arenas) {
+        coarse = arena_find(coarse, ptr);
+        if (coarse == NULL) {
+            LOG_ERR("memory block not found");
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    if (utils_mutex_lock(&coarse->lock) != 0) {
+        LOG_ERR("locking the lock failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    assert(debug_check(coarse));
+
+    umf_result = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+
+    ravl_node_t *node = coarse_ravl_find_node(coarse->all_blocks, ptr);
+    if (node == NULL) {
+        LOG_ERR("memory block not found");
+        goto err_mutex_unlock;
+    }
+
+    block_t *block = get_node_block(node);
+
+    if (!block->used) {
+        LOG_ERR("block is not allocated");
+        goto err_mutex_unlock;
+    }
+
+    if (block->size != old_size) {
+        LOG_ERR("wrong old_size: %zu != %zu", old_size, block->size);
+        goto err_mutex_unlock;
+    }
+
+    if (new_size < old_size) {
+        umf_result = used_block_shrink(coarse, node, new_size);
+    } else if (new_size > old_size) {
+        umf_result = used_block_grow(coarse, node, new_size);
+    } else {
+        umf_result = UMF_RESULT_SUCCESS;
+    }
+
+    if (umf_result == UMF_RESULT_SUCCESS) {
+        LOG_DEBUG("coarse_RESIZE %p from %zu to %zu used %zu alloc %zu", ptr,
+                  old_size, new_size, coarse->used_size, coarse->alloc_size);
+    }
+
+err_mutex_unlock:
+    assert(debug_check(coarse));
+    utils_mutex_unlock(&coarse->lock);
+
+    return umf_result;
+}
+
+umf_result_t coarse_trim(coarse_t *coarse, size_t keep_bytes) {
+    if (coarse == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!coarse->cb.free && !coarse->cb.purge) {
+        LOG_ERR("error: neither free nor purge callback is set");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    if (coarse->num_arenas) {
+        umf_result_t umf_result = UMF_RESULT_SUCCESS;
+        for (unsigned i = 0; i < coarse->num_arenas; i++) {
+            umf_result_t ret =
+                coarse_trim(coarse->arenas[i], keep_bytes / coarse->num_arenas);
+            if (ret != UMF_RESULT_SUCCESS) {
+                umf_result = ret;
+            }
+        }
+
+        return umf_result;
+    }
+
+    if (utils_mutex_lock(&coarse->lock) != 0) {
+        LOG_ERR("locking the lock failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    assert(debug_check(coarse));
+
+    // off the hot path all the expired blocks can be purged
+    purge_expired_blocks(coarse, SIZE_MAX);
+
+    umf_result_t umf_result = coarse_trim_no_lock(coarse, keep_bytes);
+
+    assert(debug_check(coarse));
+    utils_mutex_unlock(&coarse->lock);
+
+    return umf_result;
+}
+
 coarse_stats_t coarse_get_stats(coarse_t *coarse) {
     coarse_stats_t stats = {0};
 
@@ -1357,6 +2777,25 @@ coarse_stats_t coarse_get_stats(coarse_t *coarse) {
         return stats;
     }
 
+    if (coarse->num_arenas) {
+        for (unsigned i = 0; i < coarse->num_arenas; i++) {
+            coarse_stats_t arena_stats = coarse_get_stats(coarse->arenas[i]);
+            stats.alloc_size += arena_stats.alloc_size;
+            stats.used_size += arena_stats.used_size;
+            stats.num_all_blocks += arena_stats.num_all_blocks;
+            stats.num_free_blocks += arena_stats.num_free_blocks;
+            stats.purged_size += arena_stats.purged_size;
+            if (arena_stats.largest_free_block > stats.largest_free_block) {
+                stats.largest_free_block = arena_stats.largest_free_block;
+            }
+            for (int j = 0; j < COARSE_STATS_FREE_HIST_SIZE; j++) {
+                stats.free_hist[j] += arena_stats.free_hist[j];
+            }
+        }
+
+        return stats;
+    }
+
     if (utils_mutex_lock(&coarse->lock) != 0) {
         LOG_ERR("locking the lock failed");
         return stats;
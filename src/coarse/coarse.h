@@ -30,6 +30,10 @@ typedef struct coarse_callbacks_t {
                           size_t firstSize);
     umf_result_t (*merge)(void *provider, void *lowPtr, void *highPtr,
                           size_t totalSize);
+    // purge() is optional (can be NULL), it releases the physical memory
+    // of a free block, which stays allocated and can be used again.
+    // It is used to trim free memory if the free() callback is not set.
+    umf_result_t (*purge)(void *provider, void *ptr, size_t size);
 } coarse_callbacks_t;
 
 // coarse library allocation strategy
@@ -50,8 +54,29 @@ typedef enum coarse_strategy_t {
     // If none of them had the correct alignment,
     // use the `UMF_COARSE_MEMORY_STRATEGY_FASTEST` strategy.
     UMF_COARSE_MEMORY_STRATEGY_CHECK_ALL_SIZE,
+
+    // Keep free blocks in a two-level segregated fit (TLSF) index:
+    // lists of free blocks of size classes found with bitmaps,
+    // so a free block of a size greater or equal to the requested one
+    // is found in constant time, without allocating any index nodes.
+    // If no block is found this way, the list of the size class
+    // of the requested size is looked through.
+    UMF_COARSE_MEMORY_STRATEGY_TLSF,
+
+    // Keep free blocks in a tree sorted by the size and then by the address
+    // and choose the smallest free block that can hold the properly aligned
+    // data of the requested size (the one with the lowest address
+    // of the equal ones). Large alignments do not require
+    // a (size + alignment) block, so this strategy causes the lowest
+    // memory fragmentation of long-running heaps at the cost of
+    // a logarithmic search time.
+    UMF_COARSE_MEMORY_STRATEGY_BEST_FIT,
 } coarse_strategy_t;
 
+// default lazy purging settings of the memory providers using coarse
+#define COARSE_PURGE_MIN_SIZE_DEFAULT ((size_t)2 * 1024 * 1024)
+#define COARSE_PURGE_DELAY_MS_DEFAULT 1000
+
 // coarse library settings structure
 typedef struct coarse_params_t {
     // handle of the memory provider
@@ -66,9 +91,33 @@ typedef struct coarse_params_t {
 
     // page size of the memory provider
     size_t page_size;
+
+    // If not 0, the free memory (not purged yet) is trimmed to a half
+    // of this size in coarse_free() when it exceeds this size,
+    // see coarse_trim() for details.
+    size_t free_high_water_mark;
+
+    // Lazy purging: if purge_min_size is not 0 and the purge() callback
+    // is set, free blocks of at least purge_min_size bytes are purged
+    // after they stay free for purge_delay_ms milliseconds.
+    // One such block is purged in every coarse_alloc() and coarse_free()
+    // and all of them are purged in coarse_trim().
+    size_t purge_min_size;
+    uint64_t purge_delay_ms;
+
+    // If greater than 1, the coarse is partitioned into num_arenas arenas
+    // with separate locks, which own disjoint address ranges.
+    // Every thread allocates memory from its own arena and takes free
+    // memory from the other arenas only when its arena is exhausted.
+    // Blocks of different arenas are never merged.
+    unsigned num_arenas;
 } coarse_params_t;
 
-// coarse library statistics
+// number of buckets of the histogram of sizes of free blocks
+#define COARSE_STATS_FREE_HIST_SIZE 64
+
+// coarse library statistics,
+// all of them are maintained incrementally (no tree walk is needed)
 typedef struct coarse_stats_t {
     // total allocation size
     size_t alloc_size;
@@ -81,6 +130,16 @@ typedef struct coarse_stats_t {
 
     // number of free memory blocks
     size_t num_free_blocks;
+
+    // size of free memory purged with the purge() callback
+    size_t purged_size;
+
+    // size of the largest free block
+    size_t largest_free_block;
+
+    // histogram of sizes of free blocks: free_hist[i] is the number
+    // of free blocks of sizes from the range [2^i, 2^(i+1))
+    size_t free_hist[COARSE_STATS_FREE_HIST_SIZE];
 } coarse_stats_t;
 
 umf_result_t coarse_new(coarse_params_t *coarse_params, coarse_t **pcoarse);
@@ -95,6 +154,13 @@ umf_result_t coarse_merge(coarse_t *coarse, void *lowPtr, void *highPtr,
 umf_result_t coarse_split(coarse_t *coarse, void *ptr, size_t totalSize,
                           size_t firstSize);
 
+// Resizes the allocated block in place. The block is shrunk by returning
+// its tail to the free blocks and it is grown using the beginning
+// of the next block if it is free and large enough. Returns
+// UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY if the block cannot be grown in place.
+umf_result_t coarse_resize(coarse_t *coarse, void *ptr, size_t old_size,
+                           size_t new_size);
+
 // supported only if the alloc callback is set,
 // returns UMF_RESULT_ERROR_NOT_SUPPORTED otherwise
 umf_result_t coarse_add_memory_from_provider(coarse_t *coarse, size_t size);
@@ -103,6 +169,26 @@ umf_result_t coarse_add_memory_from_provider(coarse_t *coarse, size_t size);
 // returns UMF_RESULT_ERROR_NOT_SUPPORTED otherwise
 umf_result_t coarse_add_memory_fixed(coarse_t *coarse, void *addr, size_t size);
 
+// Adds the fixed memory region located on the given NUMA node (-1 if unknown)
+// to the next num_arenas arenas that did not get any memory this way yet.
+// coarse_alloc() prefers the arenas located on the NUMA node
+// of the calling thread and uses the remote ones only when the local arenas
+// are exhausted. If the coarse has no arenas, numa_node is ignored.
+// It must not be called concurrently with other calls of the coarse.
+// Supported only if the alloc and the free callbacks are NOT set.
+umf_result_t coarse_add_memory_fixed_node(coarse_t *coarse, void *addr,
+                                          size_t size, unsigned num_arenas,
+                                          int numa_node);
+
+// Releases the free memory blocks, which are not purged yet,
+// until the size of such memory does not exceed keep_bytes.
+// The blocks are returned to the memory provider with the free() callback
+// or, if it is not set, purged with the purge() callback.
+// The blocks waiting for lazy purging that have expired are purged first,
+// so coarse_trim(coarse, SIZE_MAX) purges only them.
+// Returns UMF_RESULT_ERROR_NOT_SUPPORTED if none of those callbacks is set.
+umf_result_t coarse_trim(coarse_t *coarse, size_t keep_bytes);
+
 coarse_stats_t coarse_get_stats(coarse_t *coarse);
 
 #ifdef __cplusplus
@@ -23,13 +23,20 @@
  * Critnib is a hybrid between a radix tree and DJ Bernstein's critbit:
  * it skips nodes for uninteresting radix nodes (ie, ones that would have
  * exactly one child), this requires adding to every node a field that
- * describes the slice (4-bit in our case) that this radix level is for.
+ * describes the slice (4, 6 or 8-bit, depending on the variant of the
+ * critnib) that this radix level is for.
  *
  * This implementation also stores each node's path (ie, bits that are
  * common to every key in that subtree) -- this doesn't help with lookups
  * at all (unused in == match, could be reconstructed at no cost in <=
  * after first dive) but simplifies inserts and removes.  If we ever want
  * that piece of memory it's easy to trim it down.
+ *
+ * The node layout is selected per critnib instance (see enum
+ * critnib_variant_t): 4-bit nodes keep all 16 children in place, wider
+ * nodes keep a population bitmap and only the existing children, indexed
+ * by the popcount of the preceding bitmap bits.  Operations for each layout
+ * are generated from critnib_template.h.
  */
 
 /*
@@ -84,49 +91,69 @@
  */
 #define DELETED_LIFE 16
 
-#define SLICE 4
-#define NIB ((1ULL << SLICE) - 1)
-#define SLNODES (1 << SLICE)
+/* the maximum number of node capacity classes of all variants */
+#define CRITNIB_NODE_CLASSES 8
 
 typedef uintptr_t word;
 typedef unsigned char sh_t;
 
-struct critnib_node {
-    /*
-	 * path is the part of a tree that's already traversed (be it through
-	 * explicit nodes or collapsed links) -- ie, any subtree below has all
-	 * those bits set to this value.
-	 *
-	 * nib is a 4-bit slice that's an index into the node's children.
-	 *
-	 * shift is the length (in bits) of the part of the key below this node.
-	 *
-	 *            nib
-	 * |XXXXXXXXXX|?|*****|
-	 *    path      ^
-	 *              +-----+
-	 *               shift
-	 */
-    struct critnib_node *child[SLNODES];
-    word path;
-    sh_t shift;
-};
+/* opaque type of a (tagged) pointer to a node or a leaf of any variant */
+struct critnib_node;
 
 struct critnib_leaf {
     word key;
     void *value;
 };
 
+/*
+ * Nodes and leaves retired in a single generation (remove count bump) which
+ * do not fit into pending_del_nodes/pending_del_leaves, e.g. by
+ * critnib_remove_range(). Leaves are tagged like in the tree.
+ */
+struct critnib_retired {
+    size_t count;
+    size_t capacity;
+    struct critnib_node *items[];
+};
+
+/* no generation has been started by the current write operation yet */
+#define NO_GENERATION ((word)-1)
+
+struct critnib;
+
+struct critnib_ops {
+    int (*insert)(struct critnib *c, word key, void *value, int update);
+    int (*insert_bulk)(struct critnib *c, const word *keys,
+                       void *const *values, size_t n);
+    void *(*remove)(struct critnib *c, word key);
+    size_t (*remove_range)(struct critnib *c, word min, word max,
+                           void (*func)(word key, void *value,
+                                        void *privdata),
+                           void *privdata);
+    void *(*get)(struct critnib *c, word key);
+    void *(*find_le)(struct critnib *c, word key);
+    int (*find)(struct critnib *c, word key, enum find_dir_t dir, word *rkey,
+                void **rvalue);
+    void (*iter)(struct critnib *c, word min, word max,
+                 int (*func)(word key, void *value, void *privdata),
+                 void *privdata);
+    void (*destroy)(struct critnib *c);
+};
+
 struct critnib {
+    const struct critnib_ops *ops;
+
     struct critnib_node *root;
 
-    /* pool of freed nodes: singly linked list, next at child[0] */
-    struct critnib_node *deleted_node;
+    /* pools of freed nodes (per capacity class): singly linked lists,
+     * next at child[0] */
+    struct critnib_node *deleted_node[CRITNIB_NODE_CLASSES];
     struct critnib_leaf *deleted_leaf;
 
     /* nodes removed but not yet eligible for reuse */
     struct critnib_node *pending_del_nodes[DELETED_LIFE];
     struct critnib_leaf *pending_del_leaves[DELETED_LIFE];
+    struct critnib_retired *pending_del_more[DELETED_LIFE];
 
     uint64_t remove_count;
 
@@ -164,28 +191,90 @@ static inline struct critnib_leaf *to_leaf(struct critnib_node *n) {
 }
 
 /*
- * internal: path_mask -- return bit mask of a path above a subtree [shift]
- * bits tall
+ * internal: free_leaf -- free (to internal pool, not malloc) a leaf.
+ *
+ * See free_node().
  */
-static inline word path_mask(sh_t shift) { return ~NIB << shift; }
+static void free_leaf(struct critnib *__restrict c,
+                      struct critnib_leaf *__restrict k) {
+    if (!k) {
+        return;
+    }
+
+    k->value = c->deleted_leaf;
+    c->deleted_leaf = k;
+}
 
 /*
- * internal: slice_index -- return index of child at the given nib
+ * internal: alloc_leaf -- allocate a leaf from our pool or from malloc
  */
-static inline unsigned slice_index(word key, sh_t shift) {
-    return (unsigned)((key >> shift) & NIB);
+static struct critnib_leaf *alloc_leaf(struct critnib *__restrict c) {
+    if (!c->deleted_leaf) {
+        return umf_ba_global_alloc(sizeof(struct critnib_leaf));
+    }
+
+    struct critnib_leaf *k = c->deleted_leaf;
+
+    c->deleted_leaf = k->value;
+    VALGRIND_ANNOTATE_NEW_MEMORY(k, sizeof(*k));
+
+    return k;
 }
 
+/* 16-way nodes with all children in place */
+#define CRITNIB_SLICE 4
+#define CRITNIB_COMPRESSED 0
+#define CRITNIB_SUFFIX 4
+#include "critnib_template.h"
+#undef CRITNIB_SUFFIX
+#undef CRITNIB_COMPRESSED
+#undef CRITNIB_SLICE
+
+/* 64-way compressed nodes */
+#define CRITNIB_SLICE 6
+#define CRITNIB_COMPRESSED 1
+#define CRITNIB_SUFFIX 6
+#include "critnib_template.h"
+#undef CRITNIB_SUFFIX
+#undef CRITNIB_COMPRESSED
+#undef CRITNIB_SLICE
+
+/* 256-way compressed nodes */
+#define CRITNIB_SLICE 8
+#define CRITNIB_COMPRESSED 1
+#define CRITNIB_SUFFIX 8
+#include "critnib_template.h"
+#undef CRITNIB_SUFFIX
+#undef CRITNIB_COMPRESSED
+#undef CRITNIB_SLICE
+
 /*
- * critnib_new -- allocates a new critnib structure
+ * critnib_new_variant -- allocates a new critnib structure
+ * with the given node layout
  */
-struct critnib *critnib_new(void) {
+struct critnib *critnib_new_variant(enum critnib_variant_t variant) {
+    const struct critnib_ops *ops;
+    switch (variant) {
+    case CRITNIB_VARIANT_4BIT:
+        ops = &critnib_ops_4;
+        break;
+    case CRITNIB_VARIANT_6BIT:
+        ops = &critnib_ops_6;
+        break;
+    case CRITNIB_VARIANT_8BIT:
+        ops = &critnib_ops_8;
+        break;
+    default:
+        return NULL;
+    }
+
     struct critnib *c = umf_ba_global_alloc(sizeof(struct critnib));
     if (!c) {
         return NULL;
     }
 
     memset(c, 0, sizeof(struct critnib));
+    c->ops = ops;
 
     void *mutex_ptr = utils_mutex_init(&c->mutex);
     if (!mutex_ptr) {
@@ -202,38 +291,20 @@ err_free_critnib:
 }
 
 /*
- * internal: delete_node -- recursively free (to malloc) a subtree
+ * critnib_new -- allocates a new critnib structure
  */
-static void delete_node(struct critnib *c, struct critnib_node *__restrict n) {
-    if (is_leaf(n)) {
-        umf_ba_global_free(to_leaf(n));
-    } else {
-        for (int i = 0; i < SLNODES; i++) {
-            if (n->child[i]) {
-                delete_node(c, n->child[i]);
-            }
-        }
-
-        umf_ba_global_free(n);
-    }
+struct critnib *critnib_new(void) {
+    return critnib_new_variant(CRITNIB_VARIANT_4BIT);
 }
 
 /*
  * critnib_delete -- destroy and free a critnib struct
  */
 void critnib_delete(struct critnib *c) {
-    if (c->root) {
-        delete_node(c, c->root);
-    }
+    c->ops->destroy(c);
 
     utils_mutex_destroy_not_free(&c->mutex);
 
-    for (struct critnib_node *m = c->deleted_node; m;) {
-        struct critnib_node *mm = m->child[0];
-        umf_ba_global_free(m);
-        m = mm;
-    }
-
     for (struct critnib_leaf *k = c->deleted_leaf; k;) {
         struct critnib_leaf *kk = k->value;
         umf_ba_global_free(k);
@@ -241,79 +312,12 @@ void critnib_delete(struct critnib *c) {
     }
 
     for (int i = 0; i < DELETED_LIFE; i++) {
-        umf_ba_global_free(c->pending_del_nodes[i]);
         umf_ba_global_free(c->pending_del_leaves[i]);
     }
 
     umf_ba_global_free(c);
 }
 
-/*
- * internal: free_node -- free (to internal pool, not malloc) a node.
- *
- * We cannot free them to malloc as a stalled reader thread may still walk
- * through such nodes; it will notice the result being bogus but only after
- * completing the walk, thus we need to ensure any freed nodes still point
- * to within the critnib structure.
- */
-static void free_node(struct critnib *__restrict c,
-                      struct critnib_node *__restrict n) {
-    if (!n) {
-        return;
-    }
-
-    ASSERT(!is_leaf(n));
-    n->child[0] = c->deleted_node;
-    c->deleted_node = n;
-}
-
-/*
- * internal: alloc_node -- allocate a node from our pool or from malloc
- */
-static struct critnib_node *alloc_node(struct critnib *__restrict c) {
-    if (!c->deleted_node) {
-        return umf_ba_global_alloc(sizeof(struct critnib_node));
-    }
-
-    struct critnib_node *n = c->deleted_node;
-
-    c->deleted_node = n->child[0];
-    VALGRIND_ANNOTATE_NEW_MEMORY(n, sizeof(*n));
-
-    return n;
-}
-
-/*
- * internal: free_leaf -- free (to internal pool, not malloc) a leaf.
- *
- * See free_node().
- */
-static void free_leaf(struct critnib *__restrict c,
-                      struct critnib_leaf *__restrict k) {
-    if (!k) {
-        return;
-    }
-
-    k->value = c->deleted_leaf;
-    c->deleted_leaf = k;
-}
-
-/*
- * internal: alloc_leaf -- allocate a leaf from our pool or from malloc
- */
-static struct critnib_leaf *alloc_leaf(struct critnib *__restrict c) {
-    if (!c->deleted_leaf) {
-        return umf_ba_global_alloc(sizeof(struct critnib_leaf));
-    }
-
-    struct critnib_leaf *k = c->deleted_leaf;
-
-    c->deleted_leaf = k->value;
-    VALGRIND_ANNOTATE_NEW_MEMORY(k, sizeof(*k));
-
-    return k;
-}
-
 /*
  * critnib_insert -- write a key:value pair to the critnib structure
  *
@@ -325,173 +329,49 @@ static struct critnib_leaf *alloc_leaf(struct critnib *__restrict c) {
  * Takes a global write lock but doesn't stall any readers.
  */
 int critnib_insert(struct critnib *c, word key, void *value, int update) {
-    utils_mutex_lock(&c->mutex);
-
-    struct critnib_leaf *k = alloc_leaf(c);
-    if (!k) {
-        utils_mutex_unlock(&c->mutex);
-
-        return ENOMEM;
-    }
-
-    VALGRIND_HG_DRD_DISABLE_CHECKING(k, sizeof(struct critnib_leaf));
-
-    k->key = key;
-    k->value = value;
-
-    struct critnib_node *kn = (void *)((word)k | 1);
-
-    struct critnib_node *n = c->root;
-    if (!n) {
-        store(&c->root, kn);
-
-        utils_mutex_unlock(&c->mutex);
-
-        return 0;
-    }
-
-    struct critnib_node **parent = &c->root;
-    struct critnib_node *prev = c->root;
-
-    while (n && !is_leaf(n) && (key & path_mask(n->shift)) == n->path) {
-        prev = n;
-        parent = &n->child[slice_index(key, n->shift)];
-        n = *parent;
-    }
-
-    if (!n) {
-        n = prev;
-        store(&n->child[slice_index(key, n->shift)], kn);
-
-        utils_mutex_unlock(&c->mutex);
-
-        return 0;
-    }
-
-    word path = is_leaf(n) ? to_leaf(n)->key : n->path;
-    /* Find where the path differs from our key. */
-    word at = path ^ key;
-    if (!at) {
-        ASSERT(is_leaf(n));
-        free_leaf(c, to_leaf(kn));
-
-        if (update) {
-            to_leaf(n)->value = value;
-            utils_mutex_unlock(&c->mutex);
-            return 0;
-        } else {
-            utils_mutex_unlock(&c->mutex);
-            return EEXIST;
-        }
-    }
-
-    /* and convert that to an index. */
-    sh_t sh = utils_mssb_index(at) & (sh_t) ~(SLICE - 1);
-
-    struct critnib_node *m = alloc_node(c);
-    if (!m) {
-        free_leaf(c, to_leaf(kn));
-
-        utils_mutex_unlock(&c->mutex);
-
-        return ENOMEM;
-    }
-    VALGRIND_HG_DRD_DISABLE_CHECKING(m, sizeof(struct critnib_node));
-
-    for (int i = 0; i < SLNODES; i++) {
-        m->child[i] = NULL;
-    }
-
-    m->child[slice_index(key, sh)] = kn;
-    m->child[slice_index(path, sh)] = n;
-    m->shift = sh;
-    m->path = key & path_mask(sh);
-    store(parent, m);
-
-    utils_mutex_unlock(&c->mutex);
+    return c->ops->insert(c, key, value, update);
+}
 
-    return 0;
+/*
+ * critnib_insert_bulk -- write n key:value pairs to the critnib structure
+ *
+ * All the pairs are inserted under a single write lock hold and either all
+ * of them are inserted or none.  Keys sorted in ascending order give
+ * the best locality of the tree walks.
+ *
+ * Returns:
+ *  • 0 on success
+ *  • EEXIST if any of the keys already exists
+ *  • ENOMEM if we're out of memory
+ */
+int critnib_insert_bulk(struct critnib *c, const word *keys,
+                        void *const *values, size_t n) {
+    return c->ops->insert_bulk(c, keys, values, n);
 }
 
 /*
  * critnib_remove -- delete a key from the critnib structure, return its value
  */
 void *critnib_remove(struct critnib *c, word key) {
-    struct critnib_leaf *k;
-    void *value = NULL;
-
-    utils_mutex_lock(&c->mutex);
-
-    struct critnib_node *n = c->root;
-    if (!n) {
-        goto not_found;
-    }
-
-    word del = (utils_atomic_increment(&c->remove_count) - 1) % DELETED_LIFE;
-    free_node(c, c->pending_del_nodes[del]);
-    free_leaf(c, c->pending_del_leaves[del]);
-    c->pending_del_nodes[del] = NULL;
-    c->pending_del_leaves[del] = NULL;
-
-    if (is_leaf(n)) {
-        k = to_leaf(n);
-        if (k->key == key) {
-            store(&c->root, NULL);
-            goto del_leaf;
-        }
-
-        goto not_found;
-    }
-    /*
-	 * n and k are a parent:child pair (after the first iteration); k is the
-	 * leaf that holds the key we're deleting.
-	 */
-    struct critnib_node **k_parent = &c->root;
-    struct critnib_node **n_parent = &c->root;
-    struct critnib_node *kn = n;
-
-    while (!is_leaf(kn)) {
-        n_parent = k_parent;
-        n = kn;
-        k_parent = &kn->child[slice_index(key, kn->shift)];
-        kn = *k_parent;
-
-        if (!kn) {
-            goto not_found;
-        }
-    }
-
-    k = to_leaf(kn);
-    if (k->key != key) {
-        goto not_found;
-    }
-
-    store(&n->child[slice_index(key, n->shift)], NULL);
-
-    /* Remove the node if there's only one remaining child. */
-    int ochild = -1;
-    for (int i = 0; i < SLNODES; i++) {
-        if (n->child[i]) {
-            if (ochild != -1) {
-                goto del_leaf;
-            }
-
-            ochild = i;
-        }
-    }
-
-    ASSERTne(ochild, -1);
-
-    store(n_parent, n->child[ochild]);
-    c->pending_del_nodes[del] = n;
-
-del_leaf:
-    value = k->value;
-    c->pending_del_leaves[del] = k;
+    return c->ops->remove(c, key);
+}
 
-not_found:
-    utils_mutex_unlock(&c->mutex);
-    return value;
+/*
+ * critnib_remove_range -- delete all keys in [min..max], calls
+ * func(key, value, privdata) (if not NULL) for each removed key
+ *
+ * The keys are removed under a single write lock hold and a single bump of
+ * the remove count, so concurrent readers are not forced to restart more
+ * often than by a single critnib_remove().  func() is called with the write
+ * lock held, so it must not call any critnib_* functions of this critnib.
+ *
+ * Returns the number of removed keys.
+ */
+size_t critnib_remove_range(struct critnib *c, word min, word max,
+                            void (*func)(word key, void *value,
+                                         void *privdata),
+                            void *privdata) {
+    return c->ops->remove_range(c, min, max, func, privdata);
 }
 
 /*
@@ -504,126 +384,7 @@ not_found:
  * Counterintuitively, it's pointless to return the most current answer,
  * we need only one that was valid at any point after the call started.
  */
-void *critnib_get(struct critnib *c, word key) {
-    uint64_t wrs1, wrs2;
-    void *res;
-
-    do {
-        struct critnib_node *n;
-
-        load64(&c->remove_count, &wrs1);
-        load(&c->root, &n);
-
-        /*
-		 * critbit algorithm: dive into the tree, looking at nothing but
-		 * each node's critical bit^H^H^Hnibble.  This means we risk
-		 * going wrong way if our path is missing, but that's ok...
-		 */
-        while (n && !is_leaf(n)) {
-            load(&n->child[slice_index(key, n->shift)], &n);
-        }
-
-        /* ... as we check it at the end. */
-        struct critnib_leaf *k = to_leaf(n);
-        res = (n && k->key == key) ? k->value : NULL;
-        load64(&c->remove_count, &wrs2);
-    } while (wrs1 + DELETED_LIFE <= wrs2);
-
-    return res;
-}
-
-/*
- * internal: find_predecessor -- return the rightmost leaf in a subtree
- */
-static struct critnib_leaf *
-find_predecessor(struct critnib_node *__restrict n) {
-    while (1) {
-        int nib;
-        for (nib = NIB; nib >= 0; nib--) {
-            if (n->child[nib]) {
-                break;
-            }
-        }
-
-        if (nib < 0) {
-            return NULL;
-        }
-
-        n = n->child[nib];
-        if (is_leaf(n)) {
-            return to_leaf(n);
-        }
-    }
-}
-
-/*
- * internal: find_le -- recursively search <= in a subtree
- */
-static struct critnib_leaf *find_le(struct critnib_node *__restrict n,
-                                    word key) {
-    if (!n) {
-        return NULL;
-    }
-
-    if (is_leaf(n)) {
-        struct critnib_leaf *k = to_leaf(n);
-        return (k->key <= key) ? k : NULL;
-    }
-
-    /*
-	 * is our key outside the subtree we're in?
-	 *
-	 * If we're inside, all bits above the nib will be identical; note
-	 * that shift points at the nib's lower rather than upper edge, so it
-	 * needs to be masked away as well.
-	 */
-    if ((key ^ n->path) >> (n->shift) & ~NIB) {
-        /*
-		 * subtree is too far to the left?
-		 * -> its rightmost value is good
-		 */
-        if (n->path < key) {
-            return find_predecessor(n);
-        }
-
-        /*
-		 * subtree is too far to the right?
-		 * -> it has nothing of interest to us
-		 */
-        return NULL;
-    }
-
-    unsigned nib = slice_index(key, n->shift);
-    /* recursive call: follow the path */
-    {
-        struct critnib_node *m;
-        load(&n->child[nib], &m);
-        struct critnib_leaf *k = find_le(m, key);
-        if (k) {
-            return k;
-        }
-    }
-
-    /*
-	 * nothing in that subtree?  We strayed from the path at this point,
-	 * thus need to search every subtree to our left in this node.  No
-	 * need to dive into any but the first non-null, though.
-	 */
-    for (; nib > 0; nib--) {
-        struct critnib_node *m;
-        load(&n->child[nib - 1], &m);
-        if (m) {
-            n = m;
-            if (is_leaf(n)) {
-                return to_leaf(n);
-            }
-
-            return find_predecessor(n);
-        }
-    }
-
-    return NULL;
-}
+void *critnib_get(struct critnib *c, word key) { return c->ops->get(c, key); }
 
 /*
  * critnib_find_le -- query for a key ("<=" match), returns value or NULL
@@ -631,90 +392,7 @@ static struct critnib_leaf *find_le(struct critnib_node *__restrict n,
  * Same guarantees as critnib_get().
  */
 void *critnib_find_le(struct critnib *c, word key) {
-    uint64_t wrs1, wrs2;
-    void *res;
-
-    do {
-        load64(&c->remove_count, &wrs1);
-        struct critnib_node *n; /* avoid a subtle TOCTOU */
-        load(&c->root, &n);
-        struct critnib_leaf *k = n ? find_le(n, key) : NULL;
-        res = k ? k->value : NULL;
-        load64(&c->remove_count, &wrs2);
-    } while (wrs1 + DELETED_LIFE <= wrs2);
-
-    return res;
-}
-
-/*
- * internal: find_successor -- return the rightmost leaf in a subtree
- */
-static struct critnib_leaf *find_successor(struct critnib_node *__restrict n) {
-    while (1) {
-        unsigned nib;
-        for (nib = 0; nib <= NIB; nib++) {
-            if (n->child[nib]) {
-                break;
-            }
-        }
-
-        if (nib > NIB) {
-            return NULL;
-        }
-
-        n = n->child[nib];
-        if (is_leaf(n)) {
-            return to_leaf(n);
-        }
-    }
-}
-
-/*
- * internal: find_ge -- recursively search >= in a subtree
- */
-static struct critnib_leaf *find_ge(struct critnib_node *__restrict n,
-                                    word key) {
-    if (!n) {
-        return NULL;
-    }
-
-    if (is_leaf(n)) {
-        struct critnib_leaf *k = to_leaf(n);
-        return (k->key >= key) ? k : NULL;
-    }
-
-    if ((key ^ n->path) >> (n->shift) & ~NIB) {
-        if (n->path > key) {
-            return find_successor(n);
-        }
-
-        return NULL;
-    }
-
-    unsigned nib = slice_index(key, n->shift);
-    {
-        struct critnib_node *m;
-        load(&n->child[nib], &m);
-        struct critnib_leaf *k = find_ge(m, key);
-        if (k) {
-            return k;
-        }
-    }
-
-    for (; nib < NIB; nib++) {
-        struct critnib_node *m;
-        load(&n->child[nib + 1], &m);
-        if (m) {
-            n = m;
-            if (is_leaf(n)) {
-                return to_leaf(n);
-            }
-
-            return find_successor(n);
-        }
-    }
-
-    return NULL;
+    return c->ops->find_le(c, key);
 }
 
 /*
@@ -722,59 +400,7 @@ static struct critnib_leaf *find_ge(struct critnib_node *__restrict n,
  */
 int critnib_find(struct critnib *c, uintptr_t key, enum find_dir_t dir,
                  uintptr_t *rkey, void **rvalue) {
-    uint64_t wrs1, wrs2;
-    struct critnib_leaf *k;
-    uintptr_t _rkey = (uintptr_t)0x0;
-    void **_rvalue = NULL;
-
-    /* <42 ≡ ≤41 */
-    if (dir < -1) {
-        if (!key) {
-            return 0; /* no key is <0 */
-        }
-        key--;
-    } else if (dir > +1) {
-        if (key == (uintptr_t)-1) {
-            return 0; /* no key is >(unsigned)∞ */
-        }
-        key++;
-    }
-
-    do {
-        load64(&c->remove_count, &wrs1);
-        struct critnib_node *n;
-        load(&c->root, &n);
-
-        if (dir < 0) {
-            k = find_le(n, key);
-        } else if (dir > 0) {
-            k = find_ge(n, key);
-        } else {
-            while (n && !is_leaf(n)) {
-                load(&n->child[slice_index(key, n->shift)], &n);
-            }
-
-            struct critnib_leaf *kk = to_leaf(n);
-            k = (n && kk->key == key) ? kk : NULL;
-        }
-        if (k) {
-            _rkey = k->key;
-            _rvalue = k->value;
-        }
-        load64(&c->remove_count, &wrs2);
-    } while (wrs1 + DELETED_LIFE <= wrs2);
-
-    if (k) {
-        if (rkey) {
-            *rkey = _rkey;
-        }
-        if (rvalue) {
-            *rvalue = _rvalue;
-        }
-        return 1;
-    }
-
-    return 0;
+    return c->ops->find(c, key, dir, rkey, rvalue);
 }
 
 /*
@@ -782,40 +408,10 @@ int critnib_find(struct critnib *c, uintptr_t key, enum find_dir_t dir,
  *
  * If func() returns non-zero, the search is aborted.
  */
-static int iter(struct critnib_node *__restrict n, word min, word max,
-                int (*func)(word key, void *value, void *privdata),
-                void *privdata) {
-    if (is_leaf(n)) {
-        word k = to_leaf(n)->key;
-        if (k >= min && k <= max) {
-            return func(to_leaf(n)->key, to_leaf(n)->value, privdata);
-        }
-        return 0;
-    }
-
-    if (n->path > max) {
-        return 1;
-    }
-    if ((n->path | path_mask(n->shift)) < min) {
-        return 0;
-    }
-
-    for (int i = 0; i < SLNODES; i++) {
-        struct critnib_node *__restrict m = n->child[i];
-        if (m && iter(m, min, max, func, privdata)) {
-            return 1;
-        }
-    }
-
-    return 0;
-}
-
 void critnib_iter(critnib *c, uintptr_t min, uintptr_t max,
                   int (*func)(uintptr_t key, void *value, void *privdata),
                   void *privdata) {
     utils_mutex_lock(&c->mutex);
-    if (c->root) {
-        iter(c->root, min, max, func, privdata);
-    }
+    c->ops->iter(c, min, max, func, privdata);
     utils_mutex_unlock(&c->mutex);
 }
@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (C) 2023-2024 Intel Corporation
+ * Copyright (C) 2023-2025 Intel Corporation
  *
  * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
  * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
@@ -10,6 +10,7 @@
 #ifndef UMF_CRITNIB_H
 #define UMF_CRITNIB_H 1
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -27,11 +28,27 @@ enum find_dir_t {
     FIND_G = +2,
 };
 
+// Layout of the internal nodes of a critnib. Wider nodes make the tree
+// shallower (fewer pointers to chase on lookups) at the cost of slower
+// inserts, as adding a child to a compressed node requires copying it.
+enum critnib_variant_t {
+    CRITNIB_VARIANT_4BIT, // 16-way nodes with all children in place (default)
+    CRITNIB_VARIANT_6BIT, // 64-way nodes, bitmap + compressed children
+    CRITNIB_VARIANT_8BIT, // 256-way nodes, bitmap + compressed children
+};
+
 critnib *critnib_new(void);
+critnib *critnib_new_variant(enum critnib_variant_t variant);
 void critnib_delete(critnib *c);
 
 int critnib_insert(critnib *c, uintptr_t key, void *value, int update);
+int critnib_insert_bulk(critnib *c, const uintptr_t *keys, void *const *values,
+                        size_t n);
 void *critnib_remove(critnib *c, uintptr_t key);
+size_t critnib_remove_range(critnib *c, uintptr_t min, uintptr_t max,
+                            void (*func)(uintptr_t key, void *value,
+                                         void *privdata),
+                            void *privdata);
 void *critnib_get(critnib *c, uintptr_t key);
 void *critnib_find_le(critnib *c, uintptr_t key);
 int critnib_find(critnib *c, uintptr_t key, enum find_dir_t dir,
@@ -0,0 +1,1145 @@
+/*
+ *
+ * Copyright (C) 2023-2025 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+/*
+ * critnib_template.h -- critnib operations for a single node layout
+ *
+ * This file is included by critnib.c once per critnib variant, with
+ * the following macros defined:
+ *
+ *  CRITNIB_SLICE      - number of key bits consumed by a single node level
+ *  CRITNIB_COMPRESSED - 0: a node has an array of all 2^SLICE children,
+ *                       1: a node has a population bitmap and an array
+ *                          of slots only for children present in the bitmap
+ *  CRITNIB_SUFFIX     - suffix of the names of the generated functions
+ *
+ * Compressed nodes are immutable except for the contents of their slots:
+ * a slot can be set to NULL (remove) or to a new subtree (insert), but
+ * adding a child which is not in the bitmap yet requires copying the node
+ * (copy-on-write). The old copy is retired exactly like a removed node,
+ * so stalled readers notice the change through the remove_count.
+ * Slots that became NULL are dropped when the node is copied.
+ */
+
+#ifndef CRITNIB_SLICE
+#error "CRITNIB_SLICE has to be defined before including critnib_template.h"
+#endif
+
+#define CN_CAT_(name, suffix) name##_##suffix
+#define CN_CAT(name, suffix) CN_CAT_(name, suffix)
+#define CN(name) CN_CAT(name, CRITNIB_SUFFIX)
+
+#define SLICE CRITNIB_SLICE
+#define NIB ((1ULL << SLICE) - 1)
+#define SLNODES (1 << SLICE)
+#define BITMAP_WORDS ((SLNODES + 63) / 64)
+
+#define NODE struct CN(critnib_node)
+#define AS_NODE(n) ((NODE *)(n))
+
+NODE {
+    /*
+	 * path is the part of a tree that's already traversed (be it through
+	 * explicit nodes or collapsed links) -- ie, any subtree below has all
+	 * those bits set to this value.
+	 *
+	 * nib is a SLICE-bit slice that's an index into the node's children.
+	 *
+	 * shift is the length (in bits) of the part of the key below this node.
+	 *
+	 *            nib
+	 * |XXXXXXXXXX|?|*****|
+	 *    path      ^
+	 *              +-----+
+	 *               shift
+	 */
+#if CRITNIB_COMPRESSED
+    word path;
+    sh_t shift;
+    /* capacity class of the node, the node has (2 << cls) slots */
+    unsigned char cls;
+    uint64_t bitmap[BITMAP_WORDS];
+    /* the free list link is kept at child[0] */
+    struct critnib_node *child[];
+#else
+    struct critnib_node *child[SLNODES];
+    word path;
+    sh_t shift;
+#endif
+};
+
+/*
+ * internal: path_mask -- return bit mask of a path above a subtree [shift]
+ * bits tall
+ */
+static inline word CN(path_mask)(sh_t shift) { return ~NIB << shift; }
+
+/*
+ * internal: slice_index -- return index of child at the given nib
+ */
+static inline unsigned CN(slice_index)(word key, sh_t shift) {
+    return (unsigned)((key >> shift) & NIB);
+}
+
+/*
+ * internal: slice_shift -- return the shift of the slice containing
+ * the most significant set bit
+ */
+static inline sh_t CN(slice_shift)(word at) {
+    return (sh_t)(utils_mssb_index(at) / SLICE * SLICE);
+}
+
+/*
+ * internal: node_capacity -- return the number of slots of a node
+ */
+static inline unsigned CN(node_capacity)(const NODE *n) {
+#if CRITNIB_COMPRESSED
+    return 2U << n->cls;
+#else
+    (void)n;
+    return SLNODES;
+#endif
+}
+
+/*
+ * internal: node_slots -- return the number of used slots of a node
+ *
+ * A stalled reader may see a node that is being reused, so the result
+ * is limited to the node's capacity.
+ */
+static inline unsigned CN(node_slots)(const NODE *n) {
+#if CRITNIB_COMPRESSED
+    unsigned count = 0;
+    for (int i = 0; i < BITMAP_WORDS; i++) {
+        count += utils_popcount64(n->bitmap[i]);
+    }
+
+    unsigned capacity = CN(node_capacity)(n);
+    return count < capacity ? count : capacity;
+#else
+    (void)n;
+    return SLNODES;
+#endif
+}
+
+/*
+ * internal: has_slot -- check if a node has a slot for the given nib
+ */
+static inline bool CN(has_slot)(const NODE *n, unsigned nib) {
+#if CRITNIB_COMPRESSED
+    return (n->bitmap[nib / 64] >> (nib % 64)) & 1;
+#else
+    (void)n;
+    (void)nib;
+    return true;
+#endif
+}
+
+/*
+ * internal: slot_pos -- return the number of slots for nibs lower than
+ * the given one, which is the position of the slot of this nib if present
+ */
+static inline unsigned CN(slot_pos)(const NODE *n, unsigned nib) {
+#if CRITNIB_COMPRESSED
+    unsigned pos = 0;
+    for (unsigned i = 0; i < nib / 64; i++) {
+        pos += utils_popcount64(n->bitmap[i]);
+    }
+
+    if (nib % 64) {
+        pos += utils_popcount64(n->bitmap[nib / 64] &
+                                ((1ULL << (nib % 64)) - 1));
+    }
+
+    return pos;
+#else
+    (void)n;
+    return nib;
+#endif
+}
+
+/*
+ * internal: child_slot -- return the slot of the child at the given nib
+ * or NULL if the node has no such slot
+ */
+static inline struct critnib_node **CN(child_slot)(NODE *n, unsigned nib) {
+    if (!CN(has_slot)(n, nib)) {
+        return NULL;
+    }
+
+    unsigned pos = CN(slot_pos)(n, nib);
+    if (pos >= CN(node_capacity)(n)) {
+        return NULL;
+    }
+
+    return &n->child[pos];
+}
+
+/*
+ * internal: load_child -- atomically read the child at the given nib
+ */
+static inline struct critnib_node *CN(load_child)(NODE *n, unsigned nib) {
+    struct critnib_node *m = NULL;
+    struct critnib_node **slot = CN(child_slot)(n, nib);
+    if (slot) {
+        load(slot, &m);
+    }
+
+    return m;
+}
+
+/*
+ * internal: node_class -- return the capacity class for a node of n slots
+ */
+static inline unsigned char CN(node_class)(unsigned n) {
+#if CRITNIB_COMPRESSED
+    return (n <= 2) ? 0 : utils_mssb_index(n - 1);
+#else
+    (void)n;
+    return 0;
+#endif
+}
+
+/*
+ * internal: free_node -- free (to internal pool, not malloc) a node.
+ *
+ * We cannot free them to malloc as a stalled reader thread may still walk
+ * through such nodes; it will notice the result being bogus but only after
+ * completing the walk, thus we need to ensure any freed nodes still point
+ * to within the critnib structure.
+ */
+static void CN(free_node)(struct critnib *__restrict c,
+                          struct critnib_node *__restrict node) {
+    if (!node) {
+        return;
+    }
+
+    ASSERT(!is_leaf(node));
+    NODE *n = AS_NODE(node);
+#if CRITNIB_COMPRESSED
+    unsigned char cls = n->cls;
+#else
+    unsigned char cls = 0;
+#endif
+    n->child[0] = c->deleted_node[cls];
+    c->deleted_node[cls] = node;
+}
+
+/*
+ * internal: alloc_node -- allocate a node with at least nslots slots
+ * from our pool or from malloc; all slots are set to NULL
+ */
+static NODE *CN(alloc_node)(struct critnib *__restrict c, unsigned nslots) {
+    unsigned char cls = CN(node_class)(nslots);
+    NODE *n = AS_NODE(c->deleted_node[cls]);
+#if CRITNIB_COMPRESSED
+    size_t size = sizeof(NODE) + (2U << cls) * sizeof(struct critnib_node *);
+#else
+    size_t size = sizeof(NODE);
+#endif
+
+    if (!n) {
+        n = umf_ba_global_alloc(size);
+        if (!n) {
+            return NULL;
+        }
+    } else {
+        c->deleted_node[cls] = n->child[0];
+        VALGRIND_ANNOTATE_NEW_MEMORY(n, size);
+    }
+    VALGRIND_HG_DRD_DISABLE_CHECKING(n, size);
+
+#if CRITNIB_COMPRESSED
+    n->cls = cls;
+    memset(n->bitmap, 0, sizeof(n->bitmap));
+#endif
+    for (unsigned i = 0; i < CN(node_capacity)(n); i++) {
+        n->child[i] = NULL;
+    }
+
+    return n;
+}
+
+/*
+ * internal: free_retired -- free (to internal pool) nodes and leaves of
+ * the overflow list of a generation
+ */
+static void CN(free_retired)(struct critnib *__restrict c,
+                             struct critnib_retired *r) {
+    if (!r) {
+        return;
+    }
+
+    for (size_t i = 0; i < r->count; i++) {
+        if (is_leaf(r->items[i])) {
+            free_leaf(c, to_leaf(r->items[i]));
+        } else {
+            CN(free_node)(c, r->items[i]);
+        }
+    }
+
+    umf_ba_global_free(r);
+}
+
+/*
+ * internal: new_generation -- bump the remove count; nodes and leaves
+ * retired DELETED_LIFE generations ago become free for reuse
+ */
+static word CN(new_generation)(struct critnib *__restrict c) {
+    word del = (utils_atomic_increment(&c->remove_count) - 1) % DELETED_LIFE;
+    CN(free_node)(c, c->pending_del_nodes[del]);
+    free_leaf(c, c->pending_del_leaves[del]);
+    CN(free_retired)(c, c->pending_del_more[del]);
+    c->pending_del_nodes[del] = NULL;
+    c->pending_del_leaves[del] = NULL;
+    c->pending_del_more[del] = NULL;
+
+    return del;
+}
+
+/*
+ * internal: retire -- free a node or a (tagged) leaf unlinked from the tree
+ * after the grace period
+ *
+ * All the items retired by a single write operation share one generation,
+ * which is started by the first call (with *del == NO_GENERATION).
+ */
+static void CN(retire)(struct critnib *__restrict c, word *del,
+                       struct critnib_node *item) {
+    if (*del == NO_GENERATION) {
+        *del = CN(new_generation)(c);
+    }
+
+    if (is_leaf(item) && !c->pending_del_leaves[*del]) {
+        c->pending_del_leaves[*del] = to_leaf(item);
+        return;
+    }
+
+    if (!is_leaf(item) && !c->pending_del_nodes[*del]) {
+        c->pending_del_nodes[*del] = item;
+        return;
+    }
+
+    struct critnib_retired *r = c->pending_del_more[*del];
+    if (!r || r->count == r->capacity) {
+        size_t capacity = r ? 2 * r->capacity : 16;
+        struct critnib_retired *nr = umf_ba_global_alloc(
+            sizeof(*nr) + capacity * sizeof(struct critnib_node *));
+        if (!nr) {
+            // retire the item in a new generation of its own then
+            *del = CN(new_generation)(c);
+            CN(retire)(c, del, item);
+            return;
+        }
+
+        nr->count = 0;
+        nr->capacity = capacity;
+        if (r) {
+            memcpy(nr->items, r->items, r->count * sizeof(r->items[0]));
+            nr->count = r->count;
+            umf_ba_global_free(r);
+        }
+        c->pending_del_more[*del] = r = nr;
+    }
+
+    r->items[r->count++] = item;
+}
+
+/*
+ * internal: new_node -- create a node with two children, kn (with key)
+ * and n (with path)
+ */
+static NODE *CN(new_node)(struct critnib *__restrict c, sh_t sh, word key,
+                          struct critnib_node *kn, word path,
+                          struct critnib_node *n) {
+    NODE *m = CN(alloc_node)(c, 2);
+    if (!m) {
+        return NULL;
+    }
+
+    unsigned knib = CN(slice_index)(key, sh);
+    unsigned nnib = CN(slice_index)(path, sh);
+#if CRITNIB_COMPRESSED
+    m->bitmap[knib / 64] |= 1ULL << (knib % 64);
+    m->bitmap[nnib / 64] |= 1ULL << (nnib % 64);
+    m->child[knib > nnib] = kn;
+    m->child[nnib > knib] = n;
+#else
+    m->child[knib] = kn;
+    m->child[nnib] = n;
+#endif
+    m->shift = sh;
+    m->path = key & CN(path_mask)(sh);
+
+    return m;
+}
+
+#if CRITNIB_COMPRESSED
+/*
+ * internal: add_child -- replace node n (stored at parent) with its copy
+ * having an additional child kn at the given nib
+ */
+static int CN(add_child)(struct critnib *__restrict c, word *del,
+                         struct critnib_node **parent, NODE *n, unsigned nib,
+                         struct critnib_node *kn) {
+    unsigned nslots = CN(node_slots)(n);
+    unsigned used = 1;
+    for (unsigned i = 0; i < nslots; i++) {
+        used += (n->child[i] != NULL);
+    }
+
+    NODE *m = CN(alloc_node)(c, used);
+    if (!m) {
+        return ENOMEM;
+    }
+
+    m->shift = n->shift;
+    m->path = n->path;
+
+    /* copy the children in order, dropping empty slots */
+    unsigned pos = 0;
+    bool added = false;
+    for (unsigned w = 0; w < BITMAP_WORDS; w++) {
+        uint64_t bits = n->bitmap[w];
+        if (w == nib / 64) {
+            bits |= 1ULL << (nib % 64);
+        }
+
+        unsigned npos = CN(slot_pos)(n, w * 64);
+        while (bits) {
+            unsigned b = utils_lssb_index(bits);
+            bits &= bits - 1;
+
+            struct critnib_node *child;
+            if (w * 64 + b == nib) {
+                child = kn;
+                added = true;
+            } else {
+                child = n->child[npos++];
+            }
+
+            if (child) {
+                m->bitmap[w] |= 1ULL << b;
+                m->child[pos++] = child;
+            }
+        }
+    }
+    ASSERT(added);
+    (void)added;
+
+    store(parent, m);
+    CN(retire)(c, del, (struct critnib_node *)n);
+
+    return 0;
+}
+#endif
+
+/*
+ * internal: delete_node -- recursively free (to malloc) a subtree
+ */
+static void CN(delete_node)(struct critnib *c,
+                            struct critnib_node *__restrict node) {
+    if (is_leaf(node)) {
+        umf_ba_global_free(to_leaf(node));
+    } else {
+        NODE *n = AS_NODE(node);
+        unsigned nslots = CN(node_slots)(n);
+        for (unsigned i = 0; i < nslots; i++) {
+            if (n->child[i]) {
+                CN(delete_node)(c, n->child[i]);
+            }
+        }
+
+        umf_ba_global_free(n);
+    }
+}
+
+/*
+ * internal: destroy -- free (to malloc) all nodes of the critnib
+ */
+static void CN(destroy)(struct critnib *c) {
+    if (c->root) {
+        CN(delete_node)(c, c->root);
+    }
+
+    for (int cls = 0; cls < CRITNIB_NODE_CLASSES; cls++) {
+        for (NODE *m = AS_NODE(c->deleted_node[cls]); m;) {
+            NODE *mm = AS_NODE(m->child[0]);
+            umf_ba_global_free(m);
+            m = mm;
+        }
+    }
+
+    for (int i = 0; i < DELETED_LIFE; i++) {
+        umf_ba_global_free(c->pending_del_nodes[i]);
+
+        struct critnib_retired *r = c->pending_del_more[i];
+        if (r) {
+            for (size_t j = 0; j < r->count; j++) {
+                /* untag leaves */
+                umf_ba_global_free((void *)((word)r->items[j] & ~1ULL));
+            }
+            umf_ba_global_free(r);
+        }
+    }
+}
+
+/*
+ * internal: insert_locked -- write a key:value pair to the critnib structure,
+ * must be called with the write lock held
+ */
+static int CN(insert_locked)(struct critnib *c, word key, void *value,
+                             int update, word *del) {
+    struct critnib_leaf *k = alloc_leaf(c);
+    if (!k) {
+        return ENOMEM;
+    }
+
+    VALGRIND_HG_DRD_DISABLE_CHECKING(k, sizeof(struct critnib_leaf));
+
+    k->key = key;
+    k->value = value;
+
+    struct critnib_node *kn = (void *)((word)k | 1);
+
+    struct critnib_node *n = c->root;
+    if (!n) {
+        store(&c->root, kn);
+
+        return 0;
+    }
+
+    struct critnib_node **parent = &c->root;
+    struct critnib_node **prev_parent = &c->root;
+    NODE *prev = AS_NODE(c->root);
+
+    while (n && !is_leaf(n) &&
+           (key & CN(path_mask)(AS_NODE(n)->shift)) == AS_NODE(n)->path) {
+        prev = AS_NODE(n);
+        prev_parent = parent;
+        parent = CN(child_slot)(prev, CN(slice_index)(key, prev->shift));
+        n = parent ? *parent : NULL;
+    }
+
+    if (!n) {
+        if (parent) {
+            store(parent, kn);
+        } else {
+#if CRITNIB_COMPRESSED
+            int ret = CN(add_child)(c, del, prev_parent, prev,
+                                    CN(slice_index)(key, prev->shift), kn);
+            if (ret) {
+                free_leaf(c, k);
+                return ret;
+            }
+#else
+            ASSERT(0);
+            (void)prev_parent;
+            (void)del;
+#endif
+        }
+
+        return 0;
+    }
+
+    word path = is_leaf(n) ? to_leaf(n)->key : AS_NODE(n)->path;
+    /* Find where the path differs from our key. */
+    word at = path ^ key;
+    if (!at) {
+        ASSERT(is_leaf(n));
+        free_leaf(c, to_leaf(kn));
+
+        if (update) {
+            to_leaf(n)->value = value;
+            return 0;
+        }
+
+        return EEXIST;
+    }
+
+    /* and convert that to an index. */
+    sh_t sh = CN(slice_shift)(at);
+
+    NODE *m = CN(new_node)(c, sh, key, kn, path, n);
+    if (!m) {
+        free_leaf(c, to_leaf(kn));
+
+        return ENOMEM;
+    }
+
+    store(parent, m);
+
+    return 0;
+}
+
+/*
+ * internal: remove_locked -- delete a key from the critnib structure,
+ * return its value; must be called with the write lock held
+ */
+static void *CN(remove_locked)(struct critnib *c, word key, word *del) {
+    struct critnib_leaf *k;
+
+    struct critnib_node *n = c->root;
+    if (!n) {
+        return NULL;
+    }
+
+    if (is_leaf(n)) {
+        k = to_leaf(n);
+        if (k->key == key) {
+            store(&c->root, NULL);
+            goto del_leaf;
+        }
+
+        return NULL;
+    }
+    /*
+	 * n and k are a parent:child pair (after the first iteration); k is the
+	 * leaf that holds the key we're deleting.
+	 */
+    struct critnib_node **k_parent = &c->root;
+    struct critnib_node **n_parent = &c->root;
+    struct critnib_node *kn = n;
+
+    while (!is_leaf(kn)) {
+        n_parent = k_parent;
+        n = kn;
+        k_parent = CN(child_slot)(AS_NODE(kn),
+                                  CN(slice_index)(key, AS_NODE(kn)->shift));
+        kn = k_parent ? *k_parent : NULL;
+
+        if (!kn) {
+            return NULL;
+        }
+    }
+
+    k = to_leaf(kn);
+    if (k->key != key) {
+        return NULL;
+    }
+
+    store(k_parent, NULL);
+
+    /* Remove the node if there's only one remaining child. */
+    NODE *nn = AS_NODE(n);
+    unsigned nslots = CN(node_slots)(nn);
+    int ochild = -1;
+    for (unsigned i = 0; i < nslots; i++) {
+        if (nn->child[i]) {
+            if (ochild != -1) {
+                goto del_leaf;
+            }
+
+            ochild = (int)i;
+        }
+    }
+
+    ASSERTne(ochild, -1);
+
+    store(n_parent, nn->child[ochild]);
+    CN(retire)(c, del, n);
+
+del_leaf:
+    CN(retire)(c, del, (struct critnib_node *)((word)k | 1));
+    return k->value;
+}
+
+/*
+ * internal: insert -- write a key:value pair to the critnib structure
+ */
+static int CN(insert)(struct critnib *c, word key, void *value, int update) {
+    word del = NO_GENERATION;
+
+    utils_mutex_lock(&c->mutex);
+    int ret = CN(insert_locked)(c, key, value, update, &del);
+    utils_mutex_unlock(&c->mutex);
+
+    return ret;
+}
+
+/*
+ * internal: insert_bulk -- write n key:value pairs under a single lock hold,
+ * all of them or none
+ */
+static int CN(insert_bulk)(struct critnib *c, const word *keys,
+                           void *const *values, size_t n) {
+    word del = NO_GENERATION;
+    int ret = 0;
+
+    utils_mutex_lock(&c->mutex);
+
+    for (size_t i = 0; i < n; i++) {
+        ret = CN(insert_locked)(c, keys[i], values[i], 0, &del);
+        if (ret) {
+            /* roll back the keys inserted so far */
+            while (i--) {
+                CN(remove_locked)(c, keys[i], &del);
+            }
+            break;
+        }
+    }
+
+    utils_mutex_unlock(&c->mutex);
+
+    return ret;
+}
+
+/*
+ * internal: remove -- delete a key from the critnib structure, return its value
+ */
+static void *CN(remove)(struct critnib *c, word key) {
+    word del = NO_GENERATION;
+
+    utils_mutex_lock(&c->mutex);
+    void *value = CN(remove_locked)(c, key, &del);
+    utils_mutex_unlock(&c->mutex);
+
+    return value;
+}
+
+/*
+ * internal: get -- query for a key ("==" match), returns value or NULL
+ */
+static void *CN(get)(struct critnib *c, word key) {
+    uint64_t wrs1, wrs2;
+    void *res;
+
+    do {
+        struct critnib_node *n;
+
+        load64(&c->remove_count, &wrs1);
+        load(&c->root, &n);
+
+        /*
+		 * critbit algorithm: dive into the tree, looking at nothing but
+		 * each node's critical bit^H^H^Hnibble.  This means we risk
+		 * going wrong way if our path is missing, but that's ok...
+		 */
+        while (n && !is_leaf(n)) {
+            n = CN(load_child)(AS_NODE(n),
+                               CN(slice_index)(key, AS_NODE(n)->shift));
+        }
+
+        /* ... as we check it at the end. */
+        struct critnib_leaf *k = to_leaf(n);
+        res = (n && k->key == key) ? k->value : NULL;
+        load64(&c->remove_count, &wrs2);
+    } while (wrs1 + DELETED_LIFE <= wrs2);
+
+    return res;
+}
+
+/*
+ * internal: find_predecessor -- return the rightmost leaf in a subtree
+ */
+static struct critnib_leaf *
+CN(find_predecessor)(struct critnib_node *__restrict node) {
+    while (1) {
+        NODE *n = AS_NODE(node);
+        int pos;
+        for (pos = (int)CN(node_slots)(n) - 1; pos >= 0; pos--) {
+            if (n->child[pos]) {
+                break;
+            }
+        }
+
+        if (pos < 0) {
+            return NULL;
+        }
+
+        node = n->child[pos];
+        if (is_leaf(node)) {
+            return to_leaf(node);
+        }
+    }
+}
+
+/*
+ * internal: find_le -- recursively search <= in a subtree
+ */
+static struct critnib_leaf *CN(find_le)(struct critnib_node *__restrict node,
+                                        word key) {
+    if (!node) {
+        return NULL;
+    }
+
+    if (is_leaf(node)) {
+        struct critnib_leaf *k = to_leaf(node);
+        return (k->key <= key) ? k : NULL;
+    }
+
+    NODE *n = AS_NODE(node);
+
+    /*
+	 * is our key outside the subtree we're in?
+	 *
+	 * If we're inside, all bits above the nib will be identical; note
+	 * that shift points at the nib's lower rather than upper edge, so it
+	 * needs to be masked away as well.
+	 */
+    if ((key ^ n->path) >> (n->shift) & ~NIB) {
+        /*
+		 * subtree is too far to the left?
+		 * -> its rightmost value is good
+		 */
+        if (n->path < key) {
+            return CN(find_predecessor)(node);
+        }
+
+        /*
+		 * subtree is too far to the right?
+		 * -> it has nothing of interest to us
+		 */
+        return NULL;
+    }
+
+    unsigned nib = CN(slice_index)(key, n->shift);
+    /* recursive call: follow the path */
+    {
+        struct critnib_node *m = CN(load_child)(n, nib);
+        struct critnib_leaf *k = CN(find_le)(m, key);
+        if (k) {
+            return k;
+        }
+    }
+
+    /*
+	 * nothing in that subtree?  We strayed from the path at this point,
+	 * thus need to search every subtree to our left in this node.  No
+	 * need to dive into any but the first non-null, though.
+	 */
+    unsigned pos = CN(slot_pos)(n, nib);
+    unsigned capacity = CN(node_capacity)(n);
+    for (pos = pos < capacity ? pos : capacity; pos > 0; pos--) {
+        struct critnib_node *m;
+        load(&n->child[pos - 1], &m);
+        if (m) {
+            if (is_leaf(m)) {
+                return to_leaf(m);
+            }
+
+            return CN(find_predecessor)(m);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * internal: find_successor -- return the leftmost leaf in a subtree
+ */
+static struct critnib_leaf *
+CN(find_successor)(struct critnib_node *__restrict node) {
+    while (1) {
+        NODE *n = AS_NODE(node);
+        unsigned nslots = CN(node_slots)(n);
+        unsigned pos;
+        for (pos = 0; pos < nslots; pos++) {
+            if (n->child[pos]) {
+                break;
+            }
+        }
+
+        if (pos == nslots) {
+            return NULL;
+        }
+
+        node = n->child[pos];
+        if (is_leaf(node)) {
+            return to_leaf(node);
+        }
+    }
+}
+
+/*
+ * internal: find_ge -- recursively search >= in a subtree
+ */
+static struct critnib_leaf *CN(find_ge)(struct critnib_node *__restrict node,
+                                        word key) {
+    if (!node) {
+        return NULL;
+    }
+
+    if (is_leaf(node)) {
+        struct critnib_leaf *k = to_leaf(node);
+        return (k->key >= key) ? k : NULL;
+    }
+
+    NODE *n = AS_NODE(node);
+
+    if ((key ^ n->path) >> (n->shift) & ~NIB) {
+        if (n->path > key) {
+            return CN(find_successor)(node);
+        }
+
+        return NULL;
+    }
+
+    unsigned nib = CN(slice_index)(key, n->shift);
+    {
+        struct critnib_node *m = CN(load_child)(n, nib);
+        struct critnib_leaf *k = CN(find_ge)(m, key);
+        if (k) {
+            return k;
+        }
+    }
+
+    unsigned nslots = CN(node_slots)(n);
+    for (unsigned pos = CN(slot_pos)(n, nib) + CN(has_slot)(n, nib);
+         pos < nslots; pos++) {
+        struct critnib_node *m;
+        load(&n->child[pos], &m);
+        if (m) {
+            if (is_leaf(m)) {
+                return to_leaf(m);
+            }
+
+            return CN(find_successor)(m);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * internal: remove_subtree_range -- delete all keys in [min..max] from
+ * the subtree linked from *parent in a single walk, skipping subtrees
+ * outside of the range
+ *
+ * The subtree is modified bottom-up: a removed leaf is unlinked first and
+ * a node left with one child is replaced by it (or unlinked if it has no
+ * children left), so the tree is valid for lock-free readers at every step.
+ */
+static size_t CN(remove_subtree_range)(
+    struct critnib *c, struct critnib_node **parent, word min, word max,
+    word *del, void (*func)(word key, void *value, void *privdata),
+    void *privdata) {
+    struct critnib_node *node = *parent;
+
+    if (is_leaf(node)) {
+        struct critnib_leaf *k = to_leaf(node);
+        if (k->key < min || k->key > max) {
+            return 0;
+        }
+
+        store(parent, NULL);
+        CN(retire)(c, del, (struct critnib_node *)((word)k | 1));
+
+        if (func) {
+            func(k->key, k->value, privdata);
+        }
+
+        return 1;
+    }
+
+    NODE *n = AS_NODE(node);
+    if (n->path > max || (n->path | ~CN(path_mask)(n->shift)) < min) {
+        return 0;
+    }
+
+    size_t count = 0;
+    unsigned nslots = CN(node_slots)(n);
+    for (unsigned i = 0; i < nslots; i++) {
+        if (n->child[i]) {
+            count += CN(remove_subtree_range)(c, &n->child[i], min, max, del,
+                                              func, privdata);
+        }
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    int ochild = -1;
+    for (unsigned i = 0; i < nslots; i++) {
+        if (n->child[i]) {
+            if (ochild != -1) {
+                return count;
+            }
+
+            ochild = (int)i;
+        }
+    }
+
+    store(parent, ochild == -1 ? NULL : n->child[ochild]);
+    CN(retire)(c, del, node);
+
+    return count;
+}
+
+/*
+ * internal: remove_range -- delete all keys in [min..max] under a single lock
+ * hold and a single remove count bump, calls func(key, value, privdata)
+ * for each removed key in the ascending order of keys; returns the number
+ * of removed keys
+ */
+static size_t CN(remove_range)(struct critnib *c, word min, word max,
+                               void (*func)(word key, void *value,
+                                            void *privdata),
+                               void *privdata) {
+    word del = NO_GENERATION;
+    size_t count = 0;
+
+    utils_mutex_lock(&c->mutex);
+
+    if (c->root && min <= max) {
+        count = CN(remove_subtree_range)(c, &c->root, min, max, &del, func,
+                                         privdata);
+    }
+
+    utils_mutex_unlock(&c->mutex);
+
+    return count;
+}
+
+/*
+ * internal: find_le_value -- query for a key ("<=" match), returns value
+ * or NULL
+ */
+static void *CN(find_le_value)(struct critnib *c, word key) {
+    uint64_t wrs1, wrs2;
+    void *res;
+
+    do {
+        load64(&c->remove_count, &wrs1);
+        struct critnib_node *n; /* avoid a subtle TOCTOU */
+        load(&c->root, &n);
+        struct critnib_leaf *k = n ? CN(find_le)(n, key) : NULL;
+        res = k ? k->value : NULL;
+        load64(&c->remove_count, &wrs2);
+    } while (wrs1 + DELETED_LIFE <= wrs2);
+
+    return res;
+}
+
+/*
+ * internal: find -- parametrized query, returns 1 if found
+ */
+static int CN(find)(struct critnib *c, word key, enum find_dir_t dir,
+                    word *rkey, void **rvalue) {
+    uint64_t wrs1, wrs2;
+    struct critnib_leaf *k;
+    word _rkey = (word)0x0;
+    void **_rvalue = NULL;
+
+    /* <42 ≡ ≤41 */
+    if (dir < -1) {
+        if (!key) {
+            return 0; /* no key is <0 */
+        }
+        key--;
+    } else if (dir > +1) {
+        if (key == (word)-1) {
+            return 0; /* no key is >(unsigned)∞ */
+        }
+        key++;
+    }
+
+    do {
+        load64(&c->remove_count, &wrs1);
+        struct critnib_node *n;
+        load(&c->root, &n);
+
+        if (dir < 0) {
+            k = CN(find_le)(n, key);
+        } else if (dir > 0) {
+            k = CN(find_ge)(n, key);
+        } else {
+            while (n && !is_leaf(n)) {
+                n = CN(load_child)(AS_NODE(n),
+                                   CN(slice_index)(key, AS_NODE(n)->shift));
+            }
+
+            struct critnib_leaf *kk = to_leaf(n);
+            k = (n && kk->key == key) ? kk : NULL;
+        }
+        if (k) {
+            _rkey = k->key;
+            _rvalue = k->value;
+        }
+        load64(&c->remove_count, &wrs2);
+    } while (wrs1 + DELETED_LIFE <= wrs2);
+
+    if (k) {
+        if (rkey) {
+            *rkey = _rkey;
+        }
+        if (rvalue) {
+            *rvalue = _rvalue;
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * internal: iter -- iterator, [min..max], calls func(key, value, privdata)
+ *
+ * If func() returns non-zero, the search is aborted.
+ */
+static int CN(iter)(struct critnib_node *__restrict node, word min, word max,
+                    int (*func)(word key, void *value, void *privdata),
+                    void *privdata) {
+    if (is_leaf(node)) {
+        word k = to_leaf(node)->key;
+        if (k >= min && k <= max) {
+            return func(to_leaf(node)->key, to_leaf(node)->value, privdata);
+        }
+        return 0;
+    }
+
+    NODE *n = AS_NODE(node);
+    if (n->path > max) {
+        return 1;
+    }
+    if ((n->path | ~CN(path_mask)(n->shift)) < min) {
+        return 0;
+    }
+
+    unsigned nslots = CN(node_slots)(n);
+    for (unsigned i = 0; i < nslots; i++) {
+        struct critnib_node *__restrict m = n->child[i];
+        if (m && CN(iter)(m, min, max, func, privdata)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void CN(iter_all)(struct critnib *c, word min, word max,
+                         int (*func)(word key, void *value, void *privdata),
+                         void *privdata) {
+    if (c->root) {
+        CN(iter)(c->root, min, max, func, privdata);
+    }
+}
+
+static const struct critnib_ops CN(critnib_ops) = {
+    .insert = CN(insert),
+    .insert_bulk = CN(insert_bulk),
+    .remove = CN(remove),
+    .remove_range = CN(remove_range),
+    .get = CN(get),
+    .find_le = CN(find_le_value),
+    .find = CN(find),
+    .iter = CN(iter_all),
+    .destroy = CN(destroy),
+};
+
+#undef AS_NODE
+#undef NODE
+#undef BITMAP_WORDS
+#undef SLNODES
+#undef NIB
+#undef SLICE
+#undef CN
+#undef CN_CAT
+#undef CN_CAT_
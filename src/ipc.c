@@ -8,7 +8,9 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <umf/ipc.h>
 
@@ -50,6 +52,155 @@ umf_result_t umfPoolGetIPCHandleSize(umf_memory_pool_handle_t hPool,
     return ret;
 }
 
+// An IPC handle of a buffer in a large allocation (e.g. an extent of a pool)
+// shares only the part of the allocation that contains the buffer, aligned
+// to this number of the minimum pages of the memory provider (2 MiB for 4 KiB
+// pages), so the consumer does not have to map the whole allocation. Handles
+// of buffers in the same part are opened as the same mapping by the consumer.
+#define IPC_RANGE_PAGES 512
+
+// Finds the buffer containing ptr. Returns false if the pool cannot tell it.
+// umfPoolMallocUsableSize() is defined only for the start of a buffer,
+// so a pointer inside of a buffer needs the optional get_block_range op.
+static bool getBufferRange(const void *ptr, const umf_alloc_info_t *allocInfo,
+                           uintptr_t *bufferBase, size_t *bufferSize) {
+    umf_memory_pool_handle_t pool = allocInfo->pool;
+
+    if (ptr == allocInfo->base) {
+        // a buffer containing the start of a memory provider allocation
+        // has to start there
+        *bufferBase = (uintptr_t)ptr;
+        *bufferSize = umfPoolMallocUsableSize(pool, (void *)(uintptr_t)ptr);
+        return *bufferSize != 0;
+    }
+
+    if (pool->ops.get_block_range == NULL) {
+        return false;
+    }
+
+    void *blockBase = NULL;
+    size_t blockSize = 0;
+    if (pool->ops.get_block_range(pool->pool_priv, ptr, &blockBase,
+                                  &blockSize) != UMF_RESULT_SUCCESS) {
+        return false;
+    }
+
+    // do not trust a block that does not contain ptr
+    if ((uintptr_t)ptr < (uintptr_t)blockBase ||
+        (uintptr_t)ptr - (uintptr_t)blockBase >= blockSize) {
+        return false;
+    }
+
+    *bufferBase = (uintptr_t)blockBase;
+    *bufferSize = blockSize;
+    return true;
+}
+
+// Computes the part of the allocation shared by the IPC handle of ptr.
+// Returns false if it is the whole allocation.
+static bool getIPCRange(const void *ptr, const umf_alloc_info_t *allocInfo,
+                        uintptr_t *rangeBase, size_t *rangeSize) {
+    uintptr_t base = (uintptr_t)allocInfo->base;
+    uintptr_t end = base + allocInfo->baseSize;
+
+    uintptr_t bufferBase = 0;
+    size_t bufferSize = 0;
+    if (!getBufferRange(ptr, allocInfo, &bufferBase, &bufferSize)) {
+        return false;
+    }
+
+    size_t pageSize = 0;
+    if (umfMemoryProviderGetMinPageSize(allocInfo->pool->provider,
+                                        allocInfo->base,
+                                        &pageSize) != UMF_RESULT_SUCCESS ||
+        pageSize == 0 || !IS_ALIGNED(base, pageSize)) {
+        return false;
+    }
+
+    size_t granularity = IPC_RANGE_PAGES * pageSize;
+    if (allocInfo->baseSize <= granularity) {
+        return false;
+    }
+
+    uintptr_t rangeStart =
+        utils_max(ALIGN_DOWN(bufferBase, granularity), base);
+    uintptr_t rangeEnd =
+        utils_min(ALIGN_UP(bufferBase + bufferSize, granularity), end);
+
+    if (rangeStart == base && rangeEnd == end) {
+        return false;
+    }
+
+    *rangeBase = rangeStart;
+    *rangeSize = rangeEnd - rangeStart;
+
+    return true;
+}
+
+static umf_result_t fillIPCHandle(const void *ptr,
+                                  const umf_alloc_info_t *allocInfo,
+                                  bool shareRange, umf_ipc_data_t *ipcData) {
+    // We cannot use umfPoolGetMemoryProvider function because it returns
+    // upstream provider but we need tracking one
+    umf_memory_provider_handle_t provider = allocInfo->pool->provider;
+    assert(provider);
+
+    // do not pass uninitialized padding bytes to other processes
+    memset(ipcData, 0, sizeof(*ipcData));
+
+    umf_result_t ret = UMF_RESULT_ERROR_NOT_SUPPORTED;
+    uintptr_t rangeBase = 0;
+    size_t rangeSize = 0;
+    if (shareRange && getIPCRange(ptr, allocInfo, &rangeBase, &rangeSize)) {
+        ret = umfMemoryProviderGetIPCHandleRange(
+            provider, (void *)rangeBase, rangeSize,
+            (void *)ipcData->providerIpcData);
+    }
+
+    if (ret == UMF_RESULT_ERROR_NOT_SUPPORTED) {
+        // share the whole allocation
+        rangeBase = (uintptr_t)allocInfo->base;
+        rangeSize = allocInfo->baseSize;
+        ret = umfMemoryProviderGetIPCHandle(provider, allocInfo->base,
+                                            allocInfo->baseSize,
+                                            (void *)ipcData->providerIpcData);
+    }
+
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("failed to get IPC handle.");
+        return ret;
+    }
+
+    // ipcData->handle_id is filled by tracking provider
+    ipcData->base = (void *)rangeBase;
+    ipcData->pid = utils_getpid();
+    ipcData->baseSize = rangeSize;
+    ipcData->offset = (uintptr_t)ptr - rangeBase;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t createIPCHandle(const void *ptr,
+                                    const umf_alloc_info_t *allocInfo,
+                                    bool shareRange, size_t ipcHandleSize,
+                                    umf_ipc_handle_t *umfIPCHandle) {
+    umf_ipc_data_t *ipcData = umf_ba_global_alloc(ipcHandleSize);
+    if (!ipcData) {
+        LOG_ERR("failed to allocate ipcData");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    umf_result_t ret = fillIPCHandle(ptr, allocInfo, shareRange, ipcData);
+    if (ret != UMF_RESULT_SUCCESS) {
+        umf_ba_global_free(ipcData);
+        return ret;
+    }
+
+    *umfIPCHandle = ipcData;
+
+    return UMF_RESULT_SUCCESS;
+}
+
 umf_result_t umfGetIPCHandle(const void *ptr, umf_ipc_handle_t *umfIPCHandle,
                              size_t *size) {
     if (ptr == NULL || umfIPCHandle == NULL || size == NULL) {
@@ -71,50 +222,220 @@ umf_result_t umfGetIPCHandle(const void *ptr, umf_ipc_handle_t *umfIPCHandle,
         return ret;
     }
 
-    umf_ipc_data_t *ipcData = umf_ba_global_alloc(ipcHandleSize);
-    if (!ipcData) {
-        LOG_ERR("failed to allocate ipcData");
-        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    ret = createIPCHandle(ptr, &allocInfo, true, ipcHandleSize, umfIPCHandle);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
     }
 
-    // We cannot use umfPoolGetMemoryProvider function because it returns
-    // upstream provider but we need tracking one
-    umf_memory_provider_handle_t provider = allocInfo.pool->provider;
-    assert(provider);
+    *size = ipcHandleSize;
+
+    return ret;
+}
 
-    ret = umfMemoryProviderGetIPCHandle(provider, allocInfo.base,
-                                        allocInfo.baseSize,
-                                        (void *)ipcData->providerIpcData);
+umf_result_t umfGetIPCHandleOfAllocation(const void *ptr,
+                                         umf_ipc_handle_t *umfIPCHandle,
+                                         size_t *size) {
+    size_t ipcHandleSize = 0;
+    umf_alloc_info_t allocInfo;
+    umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
     if (ret != UMF_RESULT_SUCCESS) {
-        LOG_ERR("failed to get IPC handle.");
-        umf_ba_global_free(ipcData);
+        LOG_ERR("cannot get alloc info for ptr = %p.", ptr);
         return ret;
     }
 
-    // ipcData->handle_id is filled by tracking provider
-    ipcData->base = allocInfo.base;
-    ipcData->pid = utils_getpid();
-    ipcData->baseSize = allocInfo.baseSize;
-    ipcData->offset = (uintptr_t)ptr - (uintptr_t)allocInfo.base;
+    ret = umfPoolGetIPCHandleSize(allocInfo.pool, &ipcHandleSize);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("cannot get IPC handle size.");
+        return ret;
+    }
+
+    ret = createIPCHandle(ptr, &allocInfo, false, ipcHandleSize, umfIPCHandle);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
 
-    *umfIPCHandle = ipcData;
     *size = ipcHandleSize;
 
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfGetIPCHandleInBuffer(const void *ptr, void *buffer,
+                                     size_t bufferSize,
+                                     umf_ipc_handle_t *umfIPCHandle) {
+    if (ptr == NULL || buffer == NULL || umfIPCHandle == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!IS_ALIGNED((uintptr_t)buffer, sizeof(uint64_t))) {
+        LOG_ERR("buffer %p is not aligned to %zu bytes.", buffer,
+                sizeof(uint64_t));
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    size_t ipcHandleSize = 0;
+    umf_alloc_info_t allocInfo;
+    umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("cannot get alloc info for ptr = %p.", ptr);
+        return ret;
+    }
+
+    ret = umfPoolGetIPCHandleSize(allocInfo.pool, &ipcHandleSize);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("cannot get IPC handle size.");
+        return ret;
+    }
+
+    if (bufferSize < ipcHandleSize) {
+        LOG_ERR("buffer is too small for the IPC handle (%zu < %zu).",
+                bufferSize, ipcHandleSize);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    ret = fillIPCHandle(ptr, &allocInfo, true, (umf_ipc_data_t *)buffer);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    *umfIPCHandle = (umf_ipc_handle_t)buffer;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// Returns true if the part of the allocation shared by the IPC handle
+// contains the part that would be shared by a handle of ptr.
+static bool ipcRangeContains(umf_ipc_handle_t ipcHandle, const void *ptr,
+                             const umf_alloc_info_t *allocInfo) {
+    uintptr_t rangeBase = (uintptr_t)allocInfo->base;
+    size_t rangeSize = allocInfo->baseSize;
+    (void)getIPCRange(ptr, allocInfo, &rangeBase, &rangeSize);
+
+    return rangeBase >= (uintptr_t)ipcHandle->base &&
+           rangeBase + rangeSize <=
+               (uintptr_t)ipcHandle->base + ipcHandle->baseSize;
+}
+
+umf_result_t umfGetIPCHandles(void *const *ptrs, size_t count,
+                              umf_ipc_handle_t *ipcHandles, size_t *sizes) {
+    if (ptrs == NULL || ipcHandles == NULL || sizes == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_result_t ret = UMF_RESULT_SUCCESS;
+    umf_alloc_info_t allocInfo = {NULL, 0, NULL};
+    size_t ipcHandleSize = 0;
+    umf_ipc_data_t *prevIpcData = NULL;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        const void *ptr = ptrs[i];
+        if (ptr == NULL) {
+            LOG_ERR("ptrs[%zu] is NULL.", i);
+            ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+            goto err_put_handles;
+        }
+
+        if (prevIpcData && (uintptr_t)ptr >= (uintptr_t)allocInfo.base &&
+            (uintptr_t)ptr < (uintptr_t)allocInfo.base + allocInfo.baseSize &&
+            ipcRangeContains(prevIpcData, ptr, &allocInfo)) {
+            // The pointer belongs to the same allocation as the previous one
+            // and to the part of it shared by the previous handle, so its
+            // handle differs only in the offset and the tracker and
+            // the provider do not have to be asked again.
+            umf_ipc_data_t *ipcData = umf_ba_global_alloc(ipcHandleSize);
+            if (!ipcData) {
+                LOG_ERR("failed to allocate ipcData");
+                ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+                goto err_put_handles;
+            }
+            memcpy(ipcData, prevIpcData, ipcHandleSize);
+            ipcData->offset = (uintptr_t)ptr - (uintptr_t)ipcData->base;
+            // every copy is put separately
+            ret = umfTrackingMemoryProviderDupIPCHandle(
+                allocInfo.pool->provider, (void *)ipcData->providerIpcData);
+            if (ret != UMF_RESULT_SUCCESS) {
+                umf_ba_global_free(ipcData);
+                goto err_put_handles;
+            }
+            ipcHandles[i] = ipcData;
+            sizes[i] = ipcHandleSize;
+            continue;
+        }
+
+        ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("cannot get alloc info for ptr = %p.", ptr);
+            goto err_put_handles;
+        }
+
+        ret = umfPoolGetIPCHandleSize(allocInfo.pool, &ipcHandleSize);
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("cannot get IPC handle size.");
+            goto err_put_handles;
+        }
+
+        ret = createIPCHandle(ptr, &allocInfo, true, ipcHandleSize,
+                              &ipcHandles[i]);
+        if (ret != UMF_RESULT_SUCCESS) {
+            goto err_put_handles;
+        }
+
+        prevIpcData = ipcHandles[i];
+        sizes[i] = ipcHandleSize;
+    }
+
+    return UMF_RESULT_SUCCESS;
+
+err_put_handles:
+    while (i--) {
+        umfPutIPCHandle(ipcHandles[i]);
+        ipcHandles[i] = NULL;
+    }
+
     return ret;
 }
 
+// Puts the IPC handle to the tracking provider of the pool of the shared
+// memory, which keeps the upstream handle cached until it is evicted
+// or the memory is freed.
+static umf_result_t putIPCHandle(umf_ipc_handle_t umfIPCHandle) {
+    if (umfIPCHandle->pid != utils_getpid()) {
+        LOG_ERR("IPC handle was got by another process.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_alloc_info_t allocInfo;
+    if (umfMemoryTrackerGetAllocInfo(umfIPCHandle->base, &allocInfo) !=
+        UMF_RESULT_SUCCESS) {
+        // the memory has been freed together with its cached IPC handle
+        return UMF_RESULT_SUCCESS;
+    }
+
+    // We cannot use umfPoolGetMemoryProvider function because it returns
+    // upstream provider but we need tracking one
+    return umfMemoryProviderPutIPCHandle(
+        allocInfo.pool->provider, (void *)umfIPCHandle->providerIpcData);
+}
+
+umf_result_t umfPutIPCHandleInBuffer(umf_ipc_handle_t umfIPCHandle) {
+    if (umfIPCHandle == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // The buffer is owned by the caller.
+    return putIPCHandle(umfIPCHandle);
+}
+
 umf_result_t umfPutIPCHandle(umf_ipc_handle_t umfIPCHandle) {
-    umf_result_t ret = UMF_RESULT_SUCCESS;
+    if (umfIPCHandle == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
 
-    // TODO: Just return SUCCESS because current tracking memory provider
-    //       implementation does nothing in Put function. Tracking memory
-    //       provider relies on IPC cache and actually Put IPC handle back
-    //       to upstream memory provider when umfMemoryProviderFree is called.
-    //       To support encapsulation we should not take into account
-    //       implementation details of tracking memory provider and find the
-    //       appropriate pool, get memory provider of that pool and call
-    //       umfMemoryProviderPutIPCHandle(hProvider,
-    //                                     umfIPCHandle->providerIpcData);
+    umf_result_t ret = putIPCHandle(umfIPCHandle);
     umf_ba_global_free(umfIPCHandle);
 
     return ret;
@@ -145,6 +466,91 @@ umf_result_t umfOpenIPCHandle(umf_ipc_handler_handle_t hIPCHandler,
     return UMF_RESULT_SUCCESS;
 }
 
+umf_result_t umfPrefetchIPCHandle(umf_ipc_handler_handle_t hIPCHandler,
+                                  umf_ipc_handle_t ipcHandle) {
+    if (hIPCHandler == NULL || ipcHandle == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // IPC handler is an instance of tracking memory provider
+    umf_memory_provider_handle_t hProvider = hIPCHandler;
+    if (hProvider->ops.version != UMF_PROVIDER_OPS_VERSION_CURRENT) {
+        LOG_ERR("Invalid IPC handler.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return umfTrackingMemoryProviderPrefetchIPCHandle(
+        hProvider, (void *)ipcHandle->providerIpcData);
+}
+
+// Returns true if both IPC handles refer to the same remote allocation,
+// so they are opened as the same mapping.
+static bool sameIPCMapping(umf_ipc_handle_t a, umf_ipc_handle_t b) {
+    return a->base == b->base && a->baseSize == b->baseSize &&
+           a->pid == b->pid && a->handle_id == b->handle_id;
+}
+
+umf_result_t umfOpenIPCHandles(umf_ipc_handler_handle_t hIPCHandler,
+                               const umf_ipc_handle_t *ipcHandles, size_t count,
+                               void **ptrs) {
+    if (hIPCHandler == NULL || ipcHandles == NULL || ptrs == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // IPC handler is an instance of tracking memory provider
+    umf_memory_provider_handle_t hProvider = hIPCHandler;
+    if (hProvider->ops.version != UMF_PROVIDER_OPS_VERSION_CURRENT) {
+        LOG_ERR("Invalid IPC handler.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_result_t ret = UMF_RESULT_SUCCESS;
+    size_t i = 0;
+
+    while (i < count) {
+        if (ipcHandles[i] == NULL) {
+            LOG_ERR("ipcHandles[%zu] is NULL.", i);
+            ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+            goto err_close_handles;
+        }
+
+        // Handles of the same remote allocation (e.g. buffers allocated from
+        // the same pool chunk) that follow each other are opened at once:
+        // with a single lookup in the cache of opened handles and a single
+        // mapping, which takes a reference for each of them.
+        size_t n = 1;
+        while (i + n < count && ipcHandles[i + n] != NULL &&
+               sameIPCMapping(ipcHandles[i], ipcHandles[i + n])) {
+            n++;
+        }
+
+        void *base = NULL;
+        ret = umfTrackingMemoryProviderOpenIPCHandle(
+            hProvider, (void *)ipcHandles[i]->providerIpcData, n, &base);
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("memory provider failed to open the IPC handle.");
+            goto err_close_handles;
+        }
+
+        for (size_t j = i; j < i + n; j++) {
+            ptrs[j] = (void *)((uintptr_t)base + ipcHandles[j]->offset);
+        }
+        i += n;
+    }
+
+    return UMF_RESULT_SUCCESS;
+
+err_close_handles:
+    while (i--) {
+        umfCloseIPCHandle(ptrs[i]);
+        ptrs[i] = NULL;
+    }
+
+    return ret;
+}
+
 umf_result_t umfCloseIPCHandle(void *ptr) {
     umf_alloc_info_t allocInfo;
     umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
@@ -183,3 +589,20 @@ umf_result_t umfPoolGetIPCHandler(umf_memory_pool_handle_t hPool,
 
     return UMF_RESULT_SUCCESS;
 }
+
+umf_result_t
+umfPoolGetIPCHandleCacheStats(umf_memory_pool_handle_t hPool,
+                              umf_ipc_handle_cache_stats_t *stats) {
+    if (hPool == NULL || stats == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (hPool->flags & UMF_POOL_CREATE_FLAG_DISABLE_TRACKING) {
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    umfTrackingMemoryProviderGetIPCCacheStats(hPool->provider, stats);
+
+    return UMF_RESULT_SUCCESS;
+}
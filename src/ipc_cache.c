@@ -7,7 +7,11 @@
  *
  */
 
+#include <ctype.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "base_alloc_global.h"
 #include "ipc_cache.h"
@@ -22,10 +26,14 @@
 #pragma warning(disable : 4702)
 #endif
 
+// number of shards of the cache, must be a power of 2
+#define IPC_OPENED_CACHE_SHARDS 16
+
 struct ipc_opened_cache_entry_t;
+struct ipc_opened_cache_shard_t;
 
 typedef struct ipc_opened_cache_entry_t *hash_map_t;
-typedef struct ipc_opened_cache_entry_t *lru_list_t;
+typedef struct ipc_opened_cache_entry_t *clock_list_t;
 
 typedef struct ipc_opened_cache_entry_t {
     UT_hash_handle hh;
@@ -33,29 +41,74 @@ typedef struct ipc_opened_cache_entry_t {
     ipc_opened_cache_key_t key;
     uint64_t ref_count;
     uint64_t handle_id;
-    hash_map_t
-        *hash_table; // pointer to the hash table to which the entry belongs
+    // Set on every cache hit and cleared by the clock hand,
+    // it gives a recently used entry a second chance before eviction.
+    uint64_t accessed;
+    size_t size; // size of the mapping accounted in the size of the cache
+    struct ipc_opened_cache_t *cache;        // the cache the entry belongs to
+    struct ipc_opened_cache_shard_t *shard; // the shard the entry is stored in
+    // The entry was replaced in the cache by a newer handle of the same
+    // remote buffer while it was still referenced. It is kept on the stale
+    // list of its shard until the last reference is dropped.
+    bool stale;
     ipc_opened_cache_value_t value;
 } ipc_opened_cache_entry_t;
 
+// Entries of all caches are spread over the shards by the hash of their key.
+// Cache hits and releases of entries take the lock of the shard for reading
+// only, insertions and evictions take it for writing.
+typedef struct ipc_opened_cache_shard_t {
+    utils_rwlock_t lock;
+    hash_map_t hash_table;
+    // entries of the hash table in the insertion order,
+    // scanned in a circle by the clock hand when entries are evicted
+    clock_list_t clock_list;
+    ipc_opened_cache_entry_t *clock_hand;
+    clock_list_t stale_list;
+} ipc_opened_cache_shard_t;
+
 typedef struct ipc_opened_cache_global_t {
-    utils_mutex_t cache_lock;
     umf_ba_pool_t *cache_allocator;
-    size_t max_size;
-    size_t cur_size;
-    lru_list_t lru_list;
+    size_t max_entries;   // max number of entries, 0 means unlimited
+    size_t max_bytes;     // max size of the mappings, 0 means unlimited
+    uint64_t cur_entries; // updated atomically
+    uint64_t cur_bytes;   // updated atomically
+    ipc_opened_cache_shard_t shards[IPC_OPENED_CACHE_SHARDS];
 } ipc_opened_cache_global_t;
 
 typedef struct ipc_opened_cache_t {
     ipc_opened_cache_global_t *global;
-    hash_map_t hash_table;
     ipc_opened_cache_eviction_cb_t eviction_cb;
 } ipc_opened_cache_t;
 
 ipc_opened_cache_global_t *IPC_OPENED_CACHE_GLOBAL = NULL;
 
+// The size of the cache of opened IPC handles can be limited with the
+// UMF_IPC_CACHE="max_entries=<number>;max_size=<bytes>" environment variable.
+// Both limits are disabled by default.
+size_t umfIpcCacheEnvLimit(const char *option, size_t default_limit) {
+    char *str = utils_env_var_get_str("UMF_IPC_CACHE", option);
+    if (!str) {
+        return default_limit;
+    }
+
+    str += strlen(option);
+    if (!isdigit(str[0])) {
+        LOG_ERR("incorrect UMF_IPC_CACHE[%s] value, expected numerical "
+                "value >= 0: %s",
+                option, str);
+        return default_limit;
+    }
+
+    size_t limit = (size_t)strtoull(str, NULL, 10);
+    LOG_DEBUG("UMF_IPC_CACHE[%s] = %zu", option, limit);
+
+    return limit;
+}
+
 umf_result_t umfIpcCacheGlobalInit(void) {
     umf_result_t ret = UMF_RESULT_SUCCESS;
+    size_t i = 0;
     ipc_opened_cache_global_t *cache_global =
         umf_ba_global_alloc(sizeof(*cache_global));
     if (!cache_global) {
@@ -64,10 +117,17 @@ umf_result_t umfIpcCacheGlobalInit(void) {
         goto err_exit;
     }
 
-    if (NULL == utils_mutex_init(&(cache_global->cache_lock))) {
-        LOG_ERR("Failed to initialize mutex for the IPC global cache");
-        ret = UMF_RESULT_ERROR_UNKNOWN;
-        goto err_cache_global_free;
+    for (i = 0; i < IPC_OPENED_CACHE_SHARDS; i++) {
+        ipc_opened_cache_shard_t *shard = &cache_global->shards[i];
+        if (NULL == utils_rwlock_init(&shard->lock)) {
+            LOG_ERR("Failed to initialize lock for the IPC cache shard");
+            ret = UMF_RESULT_ERROR_UNKNOWN;
+            goto err_locks_destroy;
+        }
+        shard->hash_table = NULL;
+        shard->clock_list = NULL;
+        shard->clock_hand = NULL;
+        shard->stale_list = NULL;
     }
 
     cache_global->cache_allocator =
@@ -75,34 +135,26 @@ umf_result_t umfIpcCacheGlobalInit(void) {
     if (!cache_global->cache_allocator) {
         LOG_ERR("Failed to create IPC cache allocator");
         ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
-        goto err_mutex_destroy;
+        goto err_locks_destroy;
     }
 
-    // TODO: make max_size configurable via environment variable
-    cache_global->max_size = 0;
-    cache_global->cur_size = 0;
-    cache_global->lru_list = NULL;
+    cache_global->max_entries = umfIpcCacheEnvLimit("max_entries=", 0);
+    cache_global->max_bytes = umfIpcCacheEnvLimit("max_size=", 0);
+    cache_global->cur_entries = 0;
+    cache_global->cur_bytes = 0;
 
     IPC_OPENED_CACHE_GLOBAL = cache_global;
     goto err_exit;
 
-err_mutex_destroy:
-    utils_mutex_destroy_not_free(&(cache_global->cache_lock));
-err_cache_global_free:
+err_locks_destroy:
+    while (i--) {
+        utils_rwlock_destroy_not_free(&cache_global->shards[i].lock);
+    }
     umf_ba_global_free(cache_global);
 err_exit:
     return ret;
 }
 
-#ifndef NDEBUG
-static size_t getGlobalLruListSize(lru_list_t lru_list) {
-    size_t size = 0;
-    ipc_opened_cache_entry_t *tmp;
-    DL_COUNT(lru_list, tmp, size);
-    return size;
-}
-#endif /* NDEBUG */
-
 void umfIpcCacheGlobalTearDown(void) {
     ipc_opened_cache_global_t *cache_global = IPC_OPENED_CACHE_GLOBAL;
     IPC_OPENED_CACHE_GLOBAL = NULL;
@@ -111,11 +163,16 @@ void umfIpcCacheGlobalTearDown(void) {
         return;
     }
 
-    assert(cache_global->cur_size == 0);
-    assert(getGlobalLruListSize(cache_global->lru_list) == 0);
+    assert(cache_global->cur_entries == 0);
+    assert(cache_global->cur_bytes == 0);
+
+    for (size_t i = 0; i < IPC_OPENED_CACHE_SHARDS; i++) {
+        assert(cache_global->shards[i].clock_list == NULL);
+        assert(cache_global->shards[i].stale_list == NULL);
+        utils_rwlock_destroy_not_free(&cache_global->shards[i].lock);
+    }
 
     umf_ba_destroy(cache_global->cache_allocator);
-    utils_mutex_destroy_not_free(&(cache_global->cache_lock));
     umf_ba_global_free(cache_global);
 }
 
@@ -136,111 +193,277 @@ umfIpcOpenedCacheCreate(ipc_opened_cache_eviction_cb_t eviction_cb) {
     assert(IPC_OPENED_CACHE_GLOBAL != NULL);
 
     cache->global = IPC_OPENED_CACHE_GLOBAL;
-    cache->hash_table = NULL;
     cache->eviction_cb = eviction_cb;
 
     return cache;
 }
 
+static inline size_t shard_index(unsigned hashv) {
+    // uthash uses the low bits of the hash to select a bucket,
+    // so take the high ones to select a shard
+    return (hashv >> 24) & (IPC_OPENED_CACHE_SHARDS - 1);
+}
+
+// Removes the entry from the hash table and from the clock list.
+// The lock of the shard has to be held for writing.
+static void shard_entry_unlink(ipc_opened_cache_global_t *global,
+                               ipc_opened_cache_entry_t *entry) {
+    ipc_opened_cache_shard_t *shard = entry->shard;
+    if (shard->clock_hand == entry) {
+        shard->clock_hand = entry->next;
+    }
+    DL_DELETE(shard->clock_list, entry);
+    HASH_DEL(shard->hash_table, entry);
+    utils_fetch_and_add64(&global->cur_entries, -1);
+    utils_fetch_and_add64(&global->cur_bytes, -(int64_t)entry->size);
+}
+
+// Closes the mapping of the unlinked entry and frees the entry.
+// The eviction callback is called with the lock of the shard held,
+// so that the cache the entry belongs to cannot be destroyed in the meantime.
+static void shard_entry_evict(ipc_opened_cache_global_t *global,
+                              ipc_opened_cache_entry_t *entry) {
+    entry->cache->eviction_cb(&entry->key, &entry->value);
+    utils_mutex_destroy_not_free(&(entry->value.mmap_lock));
+    umf_ba_free(global->cache_allocator, entry);
+}
+
+static bool cache_over_limit(ipc_opened_cache_global_t *global) {
+    uint64_t cur_entries, cur_bytes;
+    utils_atomic_load_acquire(&global->cur_entries, &cur_entries);
+    utils_atomic_load_acquire(&global->cur_bytes, &cur_bytes);
+    return (global->max_entries && cur_entries > global->max_entries) ||
+           (global->max_bytes && cur_bytes > global->max_bytes);
+}
+
+// Runs the clock hand over the shard and evicts entries that are neither
+// referenced nor recently used, until the cache fits its limits.
+// The lock of the shard has to be held for writing.
+static void shard_trim(ipc_opened_cache_global_t *global,
+                       ipc_opened_cache_shard_t *shard) {
+    // every entry is visited at most twice: the first visit clears
+    // its accessed bit and the second one evicts it
+    size_t steps = 2 * HASH_COUNT(shard->hash_table);
+
+    while (steps-- && shard->clock_list && cache_over_limit(global)) {
+        ipc_opened_cache_entry_t *entry =
+            shard->clock_hand ? shard->clock_hand : shard->clock_list;
+        shard->clock_hand = entry->next;
+
+        if (entry->ref_count) {
+            continue;
+        }
+
+        if (entry->accessed) {
+            entry->accessed = 0;
+            continue;
+        }
+
+        shard_entry_unlink(global, entry);
+        shard_entry_evict(global, entry);
+    }
+}
+
+// Evicts entries starting from the given shard until the cache fits its
+// limits. Referenced entries are never evicted, so the cache can exceed
+// its limits when all of its entries are in use.
+// Only one lock of a shard is held at a time.
+static void cache_trim(ipc_opened_cache_global_t *global, size_t first) {
+    for (size_t i = 0; i < IPC_OPENED_CACHE_SHARDS; i++) {
+        if (!cache_over_limit(global)) {
+            break;
+        }
+
+        ipc_opened_cache_shard_t *shard =
+            &global->shards[(first + i) & (IPC_OPENED_CACHE_SHARDS - 1)];
+        utils_write_lock(&shard->lock);
+        shard_trim(global, shard);
+        utils_write_unlock(&shard->lock);
+    }
+}
+
 void umfIpcOpenedCacheDestroy(ipc_opened_cache_handle_t cache) {
     ipc_opened_cache_entry_t *entry, *tmp;
+    ipc_opened_cache_global_t *global = cache->global;
+
+    for (size_t i = 0; i < IPC_OPENED_CACHE_SHARDS; i++) {
+        ipc_opened_cache_shard_t *shard = &global->shards[i];
 
-    utils_mutex_lock(&(cache->global->cache_lock));
-    HASH_ITER(hh, cache->hash_table, entry, tmp) {
-        DL_DELETE(cache->global->lru_list, entry);
-        HASH_DEL(cache->hash_table, entry);
-        cache->global->cur_size -= 1;
-        cache->eviction_cb(&entry->key, &entry->value);
-        utils_mutex_destroy_not_free(&(entry->value.mmap_lock));
-        umf_ba_free(cache->global->cache_allocator, entry);
+        utils_write_lock(&shard->lock);
+        HASH_ITER(hh, shard->hash_table, entry, tmp) {
+            if (entry->cache != cache) {
+                continue;
+            }
+            if (entry->ref_count) {
+                LOG_DEBUG("IPC handle of remote ptr %p is still opened",
+                          entry->key.remote_base_ptr);
+            }
+            shard_entry_unlink(global, entry);
+            shard_entry_evict(global, entry);
+        }
+        DL_FOREACH_SAFE(shard->stale_list, entry, tmp) {
+            if (entry->cache != cache) {
+                continue;
+            }
+            DL_DELETE(shard->stale_list, entry);
+            shard_entry_evict(global, entry);
+        }
+        utils_write_unlock(&shard->lock);
     }
-    HASH_CLEAR(hh, cache->hash_table);
-    utils_mutex_unlock(&(cache->global->cache_lock));
 
     umf_ba_global_free(cache);
 }
 
+static void entry_get_refs(ipc_opened_cache_entry_t *entry, uint64_t refs) {
+    utils_fetch_and_add64(&entry->ref_count, refs);
+
+    // avoid writing to the shared cache line when the bit is already set
+    uint64_t accessed;
+    utils_atomic_load_acquire(&entry->accessed, &accessed);
+    if (!accessed) {
+        utils_atomic_store_release(&entry->accessed, 1);
+    }
+}
+
 umf_result_t umfIpcOpenedCacheGet(ipc_opened_cache_handle_t cache,
                                   const ipc_opened_cache_key_t *key,
-                                  uint64_t handle_id,
+                                  uint64_t handle_id, size_t size,
+                                  uint64_t refs,
                                   ipc_opened_cache_value_t **retEntry) {
     ipc_opened_cache_entry_t *entry = NULL;
     umf_result_t ret = UMF_RESULT_SUCCESS;
-    bool evicted = false;
-    ipc_opened_cache_value_t evicted_value;
+    unsigned hashv;
 
-    if (!cache || !key || !retEntry) {
-        LOG_ERR("Some arguments are NULL, cache=%p, key=%p, retEntry=%p",
-                (void *)cache, (const void *)key, (void *)retEntry);
+    if (!cache || !key || !retEntry || !refs) {
+        LOG_ERR("Invalid arguments, cache=%p, key=%p, retEntry=%p, refs=%zu",
+                (void *)cache, (const void *)key, (void *)retEntry,
+                (size_t)refs);
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    assert(cache->global != NULL);
+    ipc_opened_cache_global_t *global = cache->global;
+    assert(global != NULL);
 
-    utils_mutex_lock(&(cache->global->cache_lock));
+    HASH_VALUE(key, sizeof(*key), hashv);
+    size_t idx = shard_index(hashv);
+    ipc_opened_cache_shard_t *shard = &global->shards[idx];
 
-    HASH_FIND(hh, cache->hash_table, key, sizeof(*key), entry);
-    if (entry && entry->handle_id == handle_id) { // cache hit
-        // update frequency list
-        // remove the entry from the current position
-        DL_DELETE(cache->global->lru_list, entry);
-        // add the entry to the head of the list
-        DL_PREPEND(cache->global->lru_list, entry);
-    } else { //cache miss
-        // Look for eviction candidate
-        if (entry == NULL && cache->global->max_size != 0 &&
-            cache->global->cur_size >= cache->global->max_size) {
-            // If max_size is set and the cache is full, evict the least recently used entry.
-            entry = cache->global->lru_list->prev;
-        }
+    // fast path: a cache hit takes the lock of the shard for reading only
+    utils_read_lock(&shard->lock);
+    HASH_FIND_BYHASHVALUE(hh, shard->hash_table, key, sizeof(*key), hashv,
+                          entry);
+    if (entry && entry->handle_id == handle_id) {
+        entry_get_refs(entry, refs);
+        *retEntry = &entry->value;
+        utils_read_unlock(&shard->lock);
+        return UMF_RESULT_SUCCESS;
+    }
+    utils_read_unlock(&shard->lock);
 
-        if (entry) { // we have eviction candidate
-            // remove the entry from the frequency list
-            DL_DELETE(cache->global->lru_list, entry);
-            // remove the entry from the hash table it belongs to
-            HASH_DEL(*(entry->hash_table), entry);
-            cache->global->cur_size -= 1;
-            evicted_value.mapped_base_ptr = entry->value.mapped_base_ptr;
-            evicted_value.mapped_size = entry->value.mapped_size;
-            evicted = true;
-        } else { // allocate the new entry
-            entry = umf_ba_alloc(cache->global->cache_allocator);
-            if (!entry) {
-                ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
-                LOG_ERR("Failed to allocate memory for a new IPC cache entry");
-                goto exit;
-            }
-            if (NULL == utils_mutex_init(&(entry->value.mmap_lock))) {
-                LOG_ERR("Failed to initialize mutex for the IPC cache entry");
-                umf_ba_global_free(entry);
-                ret = UMF_RESULT_ERROR_UNKNOWN;
-                goto exit;
-            }
-        }
+    utils_write_lock(&shard->lock);
 
-        entry->key = *key;
-        entry->ref_count = 0;
-        entry->handle_id = handle_id;
-        entry->hash_table = &cache->hash_table;
-        entry->value.mapped_size = 0;
-        entry->value.mapped_base_ptr = NULL;
+    // the entry could have been added in the meantime
+    HASH_FIND_BYHASHVALUE(hh, shard->hash_table, key, sizeof(*key), hashv,
+                          entry);
+    if (entry && entry->handle_id == handle_id) {
+        entry_get_refs(entry, refs);
+        *retEntry = &entry->value;
+        goto exit;
+    }
 
-        HASH_ADD(hh, cache->hash_table, key, sizeof(entry->key), entry);
-        DL_PREPEND(cache->global->lru_list, entry);
-        cache->global->cur_size += 1;
+    if (entry) {
+        // The remote buffer was freed and the address was reused for
+        // a new allocation, so the cached mapping is out of date.
+        shard_entry_unlink(global, entry);
+        if (entry->ref_count == 0) {
+            shard_entry_evict(global, entry);
+        } else {
+            entry->stale = true;
+            DL_APPEND(shard->stale_list, entry);
+        }
     }
 
-exit:
-    if (ret == UMF_RESULT_SUCCESS) {
-        utils_atomic_increment(&entry->ref_count);
-        *retEntry = &entry->value;
+    entry = umf_ba_alloc(global->cache_allocator);
+    if (!entry) {
+        ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        LOG_ERR("Failed to allocate memory for a new IPC cache entry");
+        goto exit;
+    }
+    if (NULL == utils_mutex_init(&(entry->value.mmap_lock))) {
+        LOG_ERR("Failed to initialize mutex for the IPC cache entry");
+        umf_ba_free(global->cache_allocator, entry);
+        ret = UMF_RESULT_ERROR_UNKNOWN;
+        goto exit;
     }
 
-    utils_mutex_unlock(&(cache->global->cache_lock));
+    entry->key = *key;
+    entry->ref_count = refs;
+    entry->handle_id = handle_id;
+    entry->accessed = 1;
+    entry->size = size;
+    entry->cache = cache;
+    entry->shard = shard;
+    entry->stale = false;
+    entry->value.mapped_size = 0;
+    entry->value.mapped_base_ptr = NULL;
+
+    HASH_ADD_BYHASHVALUE(hh, shard->hash_table, key, sizeof(entry->key), hashv,
+                         entry);
+    DL_APPEND(shard->clock_list, entry);
+    utils_fetch_and_add64(&global->cur_entries, 1);
+    utils_fetch_and_add64(&global->cur_bytes, size);
+
+    *retEntry = &entry->value;
+
+exit:
+    utils_write_unlock(&shard->lock);
 
-    if (evicted) {
-        cache->eviction_cb(key, &evicted_value);
+    // make room for the new entry, it is referenced so it is not evicted
+    if (ret == UMF_RESULT_SUCCESS && cache_over_limit(global)) {
+        cache_trim(global, idx);
     }
 
     return ret;
 }
+
+umf_result_t umfIpcOpenedCacheRelease(ipc_opened_cache_handle_t cache,
+                                      ipc_opened_cache_value_t *value) {
+    if (!cache || !value) {
+        LOG_ERR("Some arguments are NULL, cache=%p, value=%p", (void *)cache,
+                (void *)value);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    ipc_opened_cache_entry_t *entry =
+        (ipc_opened_cache_entry_t *)((char *)value -
+                                     offsetof(ipc_opened_cache_entry_t, value));
+    ipc_opened_cache_global_t *global = cache->global;
+    ipc_opened_cache_shard_t *shard = entry->shard;
+    assert(entry->cache == cache);
+
+    // The entry is marked stale and evicted only with the lock held
+    // for writing, so the read lock is enough to drop the reference.
+    utils_read_lock(&shard->lock);
+    assert(entry->ref_count > 0);
+    uint64_t ref_count = utils_atomic_decrement(&entry->ref_count);
+    bool stale = entry->stale;
+    utils_read_unlock(&shard->lock);
+
+    if (ref_count) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (stale) {
+        // nobody else can reach the stale entry anymore
+        utils_write_lock(&shard->lock);
+        DL_DELETE(shard->stale_list, entry);
+        shard_entry_evict(global, entry);
+        utils_write_unlock(&shard->lock);
+    } else if (cache_over_limit(global)) {
+        // the cache might have exceeded its limits
+        // when all of its entries were referenced
+        cache_trim(global, (size_t)(shard - global->shards));
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
@@ -16,6 +16,7 @@
 
 typedef struct ipc_opened_cache_key_t {
     void *remote_base_ptr;
+    size_t remote_size; // size of the shared (part of the) allocation
     umf_memory_provider_handle_t local_provider;
     int remote_pid;
 } ipc_opened_cache_key_t;
@@ -33,6 +34,10 @@ typedef struct ipc_opened_cache_t *ipc_opened_cache_handle_t;
 umf_result_t umfIpcCacheGlobalInit(void);
 void umfIpcCacheGlobalTearDown(void);
 
+// Returns the value of the `option` (e.g. "max_entries=") of the UMF_IPC_CACHE
+// environment variable, or default_limit if the option is not set.
+size_t umfIpcCacheEnvLimit(const char *option, size_t default_limit);
+
 // define pointer to the eviction callback function
 typedef void (*ipc_opened_cache_eviction_cb_t)(
     const ipc_opened_cache_key_t *key, const ipc_opened_cache_value_t *value);
@@ -42,9 +47,17 @@ umfIpcOpenedCacheCreate(ipc_opened_cache_eviction_cb_t eviction_cb);
 
 void umfIpcOpenedCacheDestroy(ipc_opened_cache_handle_t cache);
 
+// Returns the cache entry for the key and takes `refs` references to it.
+// The size of the mapping is accounted in the size of the cache.
 umf_result_t umfIpcOpenedCacheGet(ipc_opened_cache_handle_t cache,
                                   const ipc_opened_cache_key_t *key,
-                                  uint64_t handle_id,
+                                  uint64_t handle_id, size_t size,
+                                  uint64_t refs,
                                   ipc_opened_cache_value_t **retEntry);
 
+// Drops one of the references to the cache entry taken by umfIpcOpenedCacheGet.
+// Only entries that are not referenced can be evicted from the cache.
+umf_result_t umfIpcOpenedCacheRelease(ipc_opened_cache_handle_t cache,
+                                      ipc_opened_cache_value_t *value);
+
 #endif /* UMF_IPC_CACHE_H */
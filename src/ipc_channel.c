@@ -0,0 +1,355 @@
+/*
+ *
+ * Copyright (C) 2025 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <umf/ipc.h>
+#include <umf/memory_pool.h>
+
+#include "base_alloc_global.h"
+#include "utils_common.h"
+#include "utils_concurrency.h"
+#include "utils_log.h"
+
+#define IPC_CHANNEL_MAGIC 0x4c454e4e414843ULL // "CHANNEL"
+#define IPC_CHANNEL_CACHE_LINE 64
+#define IPC_CHANNEL_MAX_CAPACITY ((size_t)1 << 24)
+#define IPC_CHANNEL_MAX_HANDLE_SIZE ((size_t)1 << 20)
+
+// maximum number of IPC handles opened at once by umfIPCChannelReceive
+#define IPC_CHANNEL_RECEIVE_BATCH 64
+
+// The ring buffer of the channel is shared between processes, so it contains
+// no pointers. It is a bounded queue with a sequence number in every slot:
+// the slot at position pos is free for producers when its sequence number
+// is pos and it is ready for consumers when its sequence number is pos + 1.
+// Producers and consumers claim ranges of consecutive slots by moving
+// the tail and the head with compare-and-swap, then they copy the IPC handles
+// and publish the slots by updating their sequence numbers.
+typedef struct ipc_channel_ring_t {
+    uint64_t magic;
+    uint64_t capacity;  // number of slots, a power of 2
+    uint64_t slot_size; // size of a slot including its header
+    uint64_t max_handle_size;
+    char pad0[IPC_CHANNEL_CACHE_LINE - 4 * sizeof(uint64_t)];
+    uint64_t tail; // position of the next slot to fill
+    char pad1[IPC_CHANNEL_CACHE_LINE - sizeof(uint64_t)];
+    uint64_t head; // position of the next slot to read
+    char pad2[IPC_CHANNEL_CACHE_LINE - sizeof(uint64_t)];
+    // slots follow
+} ipc_channel_ring_t;
+
+typedef struct ipc_channel_slot_t {
+    uint64_t seq;
+    char data[]; // IPC handle
+} ipc_channel_slot_t;
+
+typedef struct umf_ipc_channel_t {
+    ipc_channel_ring_t *ring;
+    // the pool the ring was allocated from, NULL if the channel was opened
+    umf_memory_pool_handle_t pool;
+    // the layout of the ring, validated when the channel is opened
+    uint64_t capacity;
+    uint64_t slot_size;
+    uint64_t max_handle_size;
+} umf_ipc_channel_t;
+
+static ipc_channel_slot_t *channel_slot(umf_ipc_channel_t *channel,
+                                        uint64_t pos) {
+    uint64_t idx = pos & (channel->capacity - 1);
+    return (ipc_channel_slot_t *)((char *)(channel->ring + 1) +
+                                  idx * channel->slot_size);
+}
+
+// Claims up to count consecutive slots whose sequence numbers are
+// the positions of the slots plus seq_offset (0 for free slots,
+// 1 for filled ones) by moving *end (the tail or the head of the ring).
+// Returns the number of claimed slots, the first one is at *pos.
+static size_t channel_claim(umf_ipc_channel_t *channel, uint64_t *end,
+                            uint64_t seq_offset, size_t count, uint64_t *pos) {
+    uint64_t cur;
+    utils_atomic_load_acquire(end, &cur);
+
+    while (1) {
+        size_t n = 0;
+        while (n < count) {
+            uint64_t seq;
+            utils_atomic_load_acquire(&channel_slot(channel, cur + n)->seq,
+                                      &seq);
+            if (seq != cur + n + seq_offset) {
+                break;
+            }
+            n++;
+        }
+
+        if (n == 0) {
+            // the ring is full (or empty) unless the slot at cur was
+            // claimed by another thread in the meantime
+            uint64_t last = cur;
+            utils_atomic_load_acquire(end, &cur);
+            if (cur == last) {
+                return 0;
+            }
+            continue;
+        }
+
+        uint64_t next = cur + n;
+        if (utils_compare_exchange(end, &cur, &next)) {
+            *pos = cur;
+            return n;
+        }
+        // cur holds the new value of *end
+    }
+}
+
+umf_result_t umfIPCChannelCreate(umf_memory_pool_handle_t hPool,
+                                 size_t capacity, size_t maxHandleSize,
+                                 umf_ipc_channel_handle_t *hChannel) {
+    if (hPool == NULL || hChannel == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (capacity == 0 || capacity > IPC_CHANNEL_MAX_CAPACITY) {
+        LOG_ERR("invalid capacity of the IPC channel: %zu", capacity);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (maxHandleSize == 0 || maxHandleSize > IPC_CHANNEL_MAX_HANDLE_SIZE) {
+        LOG_ERR("invalid maximum size of IPC handles: %zu", maxHandleSize);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    size_t numSlots = 1;
+    while (numSlots < capacity) {
+        numSlots <<= 1;
+    }
+
+    size_t slotSize = ALIGN_UP(sizeof(ipc_channel_slot_t) + maxHandleSize,
+                               IPC_CHANNEL_CACHE_LINE);
+    size_t ringSize = sizeof(ipc_channel_ring_t) + numSlots * slotSize;
+
+    umf_ipc_channel_t *channel = umf_ba_global_alloc(sizeof(*channel));
+    if (channel == NULL) {
+        LOG_ERR("failed to allocate the IPC channel.");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    ipc_channel_ring_t *ring = umfPoolMalloc(hPool, ringSize);
+    if (ring == NULL) {
+        LOG_ERR("failed to allocate the ring buffer of the IPC channel.");
+        umf_ba_global_free(channel);
+        umf_result_t ret = umfPoolGetLastAllocationError(hPool);
+        return ret != UMF_RESULT_SUCCESS ? ret : UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    ring->capacity = numSlots;
+    ring->slot_size = slotSize;
+    ring->max_handle_size = maxHandleSize;
+
+    channel->ring = ring;
+    channel->pool = hPool;
+    channel->capacity = numSlots;
+    channel->slot_size = slotSize;
+    channel->max_handle_size = maxHandleSize;
+
+    for (uint64_t i = 0; i < numSlots; i++) {
+        channel_slot(channel, i)->seq = i;
+    }
+
+    utils_atomic_store_release(&ring->magic, IPC_CHANNEL_MAGIC);
+
+    *hChannel = channel;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfIPCChannelGetIPCHandle(umf_ipc_channel_handle_t hChannel,
+                                       umf_ipc_handle_t *ipcHandle,
+                                       size_t *size) {
+    if (hChannel == NULL || ipcHandle == NULL || size == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (hChannel->pool == NULL) {
+        LOG_ERR("the IPC channel was not created by this process.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return umfGetIPCHandle(hChannel->ring, ipcHandle, size);
+}
+
+umf_result_t umfIPCChannelOpen(umf_ipc_handler_handle_t hIPCHandler,
+                               umf_ipc_handle_t ipcHandle,
+                               umf_ipc_channel_handle_t *hChannel) {
+    if (hIPCHandler == NULL || ipcHandle == NULL || hChannel == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_ipc_channel_t *channel = umf_ba_global_alloc(sizeof(*channel));
+    if (channel == NULL) {
+        LOG_ERR("failed to allocate the IPC channel.");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    void *ptr = NULL;
+    umf_result_t ret = umfOpenIPCHandle(hIPCHandler, ipcHandle, &ptr);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("failed to open the ring buffer of the IPC channel.");
+        umf_ba_global_free(channel);
+        return ret;
+    }
+
+    // the layout of the ring is read once, so a corrupted ring
+    // cannot make this process access memory out of its bounds
+    ipc_channel_ring_t *ring = ptr;
+    uint64_t magic;
+    utils_atomic_load_acquire(&ring->magic, &magic);
+    channel->ring = ring;
+    channel->pool = NULL;
+    channel->capacity = ring->capacity;
+    channel->slot_size = ring->slot_size;
+    channel->max_handle_size = ring->max_handle_size;
+
+    if (magic != IPC_CHANNEL_MAGIC || !IS_POWER_OF_2(channel->capacity) ||
+        channel->capacity > IPC_CHANNEL_MAX_CAPACITY ||
+        channel->max_handle_size > IPC_CHANNEL_MAX_HANDLE_SIZE ||
+        channel->slot_size !=
+            ALIGN_UP(sizeof(ipc_channel_slot_t) + channel->max_handle_size,
+                     IPC_CHANNEL_CACHE_LINE)) {
+        LOG_ERR("the IPC handle is not a handle of an IPC channel.");
+        umfCloseIPCHandle(ptr);
+        umf_ba_global_free(channel);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    *hChannel = channel;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfIPCChannelDestroy(umf_ipc_channel_handle_t hChannel) {
+    if (hChannel == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_result_t ret;
+    if (hChannel->pool) {
+        ret = umfPoolFree(hChannel->pool, hChannel->ring);
+    } else {
+        ret = umfCloseIPCHandle(hChannel->ring);
+    }
+
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("failed to release the ring buffer of the IPC channel.");
+    }
+
+    umf_ba_global_free(hChannel);
+
+    return ret;
+}
+
+umf_result_t umfIPCChannelSend(umf_ipc_channel_handle_t hChannel,
+                               const umf_ipc_handle_t *ipcHandles,
+                               const size_t *sizes, size_t count,
+                               size_t *sent) {
+    if (hChannel == NULL || sent == NULL ||
+        (count && (ipcHandles == NULL || sizes == NULL))) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (ipcHandles[i] == NULL || sizes[i] == 0 ||
+            sizes[i] > hChannel->max_handle_size) {
+            LOG_ERR("invalid IPC handle %zu of size %zu, the maximum size of "
+                    "IPC handles in the channel is %zu",
+                    i, sizes[i], (size_t)hChannel->max_handle_size);
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    *sent = 0;
+    if (count == 0) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    uint64_t pos = 0;
+    size_t n = channel_claim(hChannel, &hChannel->ring->tail, 0, count, &pos);
+    for (size_t i = 0; i < n; i++) {
+        ipc_channel_slot_t *slot = channel_slot(hChannel, pos + i);
+        memcpy(slot->data, ipcHandles[i], sizes[i]);
+        utils_atomic_store_release(&slot->seq, pos + i + 1);
+    }
+
+    *sent = n;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfIPCChannelReceive(umf_ipc_channel_handle_t hChannel,
+                                  umf_ipc_handler_handle_t hIPCHandler,
+                                  void **ptrs, size_t maxCount,
+                                  size_t *count) {
+    if (hChannel == NULL || hIPCHandler == NULL || count == NULL ||
+        (maxCount && ptrs == NULL)) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    *count = 0;
+    while (*count < maxCount) {
+        size_t batch = maxCount - *count;
+        if (batch > IPC_CHANNEL_RECEIVE_BATCH) {
+            batch = IPC_CHANNEL_RECEIVE_BATCH;
+        }
+
+        uint64_t pos = 0;
+        size_t n =
+            channel_claim(hChannel, &hChannel->ring->head, 1, batch, &pos);
+        if (n == 0) {
+            break;
+        }
+
+        // the IPC handles are opened directly from the ring
+        umf_ipc_handle_t ipcHandles[IPC_CHANNEL_RECEIVE_BATCH];
+        for (size_t i = 0; i < n; i++) {
+            ipcHandles[i] =
+                (umf_ipc_handle_t)channel_slot(hChannel, pos + i)->data;
+        }
+
+        umf_result_t ret =
+            umfOpenIPCHandles(hIPCHandler, ipcHandles, n, ptrs + *count);
+
+        // the slots are free for the next round of the ring
+        for (size_t i = 0; i < n; i++) {
+            utils_atomic_store_release(&channel_slot(hChannel, pos + i)->seq,
+                                       pos + i + hChannel->capacity);
+        }
+
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("failed to open %zu IPC handles received from the channel",
+                    n);
+            return ret;
+        }
+
+        *count += n;
+        if (n < batch) {
+            break;
+        }
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
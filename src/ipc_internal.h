@@ -11,6 +11,7 @@
 #define UMF_IPC_INTERNAL_H 1
 
 #include <umf/base.h>
+#include <umf/ipc.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,13 +23,21 @@ extern "C" {
 // depending on the provider.
 typedef struct umf_ipc_data_t {
     uint64_t handle_id; // unique ID of this handle
-    void *base;         // base address of the memory
+    void *base;         // base address of the shared memory
     int pid;            // process ID of the process that allocated the memory
-    size_t baseSize;    // size of base (coarse-grain) allocation
-    uint64_t offset;
+    // size of the shared memory: the base (coarse-grain) allocation
+    // or a page-aligned part of it
+    size_t baseSize;
+    uint64_t offset; // offset of the buffer from base
     char providerIpcData[];
 } umf_ipc_data_t;
 
+// Creates an IPC handle of ptr that shares the whole memory provider
+// allocation containing ptr, even if the allocation is large.
+umf_result_t umfGetIPCHandleOfAllocation(const void *ptr,
+                                         umf_ipc_handle_t *ipcHandle,
+                                         size_t *size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,7 +15,9 @@
 #include <umf/memory_pool_ops.h>
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "base_alloc_global.h"
 #include "memory_pool_internal.h"
@@ -38,7 +40,15 @@ static umf_result_t umfPoolCreateInternal(const umf_memory_pool_ops_t *ops,
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    if (ops->version != UMF_POOL_OPS_VERSION_CURRENT) {
+    umf_memory_pool_ops_t ops_current;
+    if (ops->version == UMF_MAKE_VERSION(0, 11)) {
+        // the ops of version 0.11 end before get_block_range
+        memset(&ops_current, 0, sizeof(ops_current));
+        memcpy(&ops_current, ops,
+               offsetof(umf_memory_pool_ops_t, get_block_range));
+        ops_current.version = UMF_POOL_OPS_VERSION_CURRENT;
+        ops = &ops_current;
+    } else if (ops->version != UMF_POOL_OPS_VERSION_CURRENT) {
         LOG_WARN("Memory Pool ops version \"%d\" is different than the current "
                  "version \"%d\"",
                  ops->version, UMF_POOL_OPS_VERSION_CURRENT);
@@ -208,3 +218,20 @@ umf_result_t umfPoolGetTag(umf_memory_pool_handle_t hPool, void **tag) {
     utils_mutex_unlock(&hPool->lock);
     return UMF_RESULT_SUCCESS;
 }
+
+umf_result_t umfPoolWalk(umf_memory_pool_handle_t hPool,
+                         umf_region_walk_cb_t cb, void *arg) {
+    UMF_CHECK((hPool != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    UMF_CHECK((cb != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    if (hPool->flags & UMF_POOL_CREATE_FLAG_DISABLE_TRACKING) {
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    return umfTrackingMemoryProviderWalk(hPool->provider, cb, arg);
+}
+
+umf_result_t umfTrackerWalk(umf_region_walk_cb_t cb, void *arg) {
+    UMF_CHECK((cb != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    return umfMemoryTrackerWalk(cb, arg);
+}
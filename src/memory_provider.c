@@ -11,6 +11,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <umf/memory_provider.h>
 
@@ -55,6 +56,21 @@ static umf_result_t umfDefaultAllocationMerge(void *provider, void *lowPtr,
     return UMF_RESULT_ERROR_NOT_SUPPORTED;
 }
 
+static umf_result_t umfDefaultAllocationResize(void *provider, void *ptr,
+                                               size_t oldSize, size_t newSize) {
+    (void)provider;
+    (void)ptr;
+    (void)oldSize;
+    (void)newSize;
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
+static umf_result_t umfDefaultTrim(void *provider, size_t keepBytes) {
+    (void)provider;
+    (void)keepBytes;
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
 static umf_result_t umfDefaultGetIPCHandleSize(void *provider, size_t *size) {
     (void)provider;
     (void)size;
@@ -106,6 +122,12 @@ void assignOpsExtDefaults(umf_memory_provider_ops_t *ops) {
     if (!ops->ext.allocation_merge) {
         ops->ext.allocation_merge = umfDefaultAllocationMerge;
     }
+    if (!ops->ext.allocation_resize) {
+        ops->ext.allocation_resize = umfDefaultAllocationResize;
+    }
+    if (!ops->ext.trim) {
+        ops->ext.trim = umfDefaultTrim;
+    }
 }
 
 void assignOpsIpcDefaults(umf_memory_provider_ops_t *ops) {
@@ -140,13 +162,14 @@ static bool validateOpsExt(const umf_memory_provider_ext_ops_t *ext) {
 }
 
 static bool validateOpsIpc(const umf_memory_provider_ipc_ops_t *ipc) {
-    // valid if all ops->ipc.* are non-NULL or all are NULL
+    // valid if all ops->ipc.* (except the optional get_ipc_handle_range)
+    // are non-NULL or all are NULL
     return (ipc->get_ipc_handle_size && ipc->get_ipc_handle &&
             ipc->put_ipc_handle && ipc->open_ipc_handle &&
             ipc->close_ipc_handle) ||
            (!ipc->get_ipc_handle_size && !ipc->get_ipc_handle &&
             !ipc->put_ipc_handle && !ipc->open_ipc_handle &&
-            !ipc->close_ipc_handle);
+            !ipc->close_ipc_handle && !ipc->get_ipc_handle_range);
 }
 
 static bool validateOps(const umf_memory_provider_ops_t *ops) {
@@ -154,18 +177,53 @@ static bool validateOps(const umf_memory_provider_ops_t *ops) {
            validateOpsIpc(&(ops->ipc));
 }
 
+// Copies the ops of version 0.11 member by member,
+// the members added later are left NULL.
+static void convertOps_0_11(const umf_memory_provider_ops_0_11_t *old,
+                            umf_memory_provider_ops_t *ops) {
+    memset(ops, 0, sizeof(*ops));
+    ops->version = UMF_PROVIDER_OPS_VERSION_CURRENT;
+    ops->initialize = old->initialize;
+    ops->finalize = old->finalize;
+    ops->alloc = old->alloc;
+    ops->free = old->free;
+    ops->get_last_native_error = old->get_last_native_error;
+    ops->get_recommended_page_size = old->get_recommended_page_size;
+    ops->get_min_page_size = old->get_min_page_size;
+    ops->get_name = old->get_name;
+    ops->ext.purge_lazy = old->ext.purge_lazy;
+    ops->ext.purge_force = old->ext.purge_force;
+    ops->ext.allocation_merge = old->ext.allocation_merge;
+    ops->ext.allocation_split = old->ext.allocation_split;
+    ops->ipc.get_ipc_handle_size = old->ipc.get_ipc_handle_size;
+    ops->ipc.get_ipc_handle = old->ipc.get_ipc_handle;
+    ops->ipc.put_ipc_handle = old->ipc.put_ipc_handle;
+    ops->ipc.open_ipc_handle = old->ipc.open_ipc_handle;
+    ops->ipc.close_ipc_handle = old->ipc.close_ipc_handle;
+}
+
 umf_result_t umfMemoryProviderCreate(const umf_memory_provider_ops_t *ops,
                                      void *params,
                                      umf_memory_provider_handle_t *hProvider) {
     libumfInit();
-    if (!ops || !hProvider || !validateOps(ops)) {
+    if (!ops || !hProvider) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    if (ops->version != UMF_PROVIDER_OPS_VERSION_CURRENT) {
-        LOG_WARN("Memory Provider ops version \"%d\" is different than the "
-                 "current version \"%d\"",
-                 ops->version, UMF_PROVIDER_OPS_VERSION_CURRENT);
+    umf_memory_provider_ops_t ops_current;
+    if (ops->version == UMF_MAKE_VERSION(0, 11)) {
+        convertOps_0_11((const umf_memory_provider_ops_0_11_t *)ops,
+                        &ops_current);
+        ops = &ops_current;
+    } else if (ops->version != UMF_PROVIDER_OPS_VERSION_CURRENT) {
+        LOG_ERR("Memory Provider ops version \"%d\" is not supported, "
+                "the current version is \"%d\"",
+                ops->version, UMF_PROVIDER_OPS_VERSION_CURRENT);
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    if (!validateOps(ops)) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
     umf_memory_provider_handle_t provider =
@@ -324,6 +382,34 @@ umfMemoryProviderAllocationMerge(umf_memory_provider_handle_t hProvider,
     return res;
 }
 
+umf_result_t
+umfMemoryProviderAllocationResize(umf_memory_provider_handle_t hProvider,
+                                  void *ptr, size_t oldSize, size_t newSize) {
+    UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    UMF_CHECK((ptr != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    UMF_CHECK((oldSize != 0 && newSize != 0),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    if (oldSize == newSize) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    umf_result_t res = hProvider->ops.ext.allocation_resize(
+        hProvider->provider_priv, ptr, oldSize, newSize);
+    checkErrorAndSetLastProvider(res, hProvider);
+    return res;
+}
+
+umf_result_t umfMemoryProviderTrim(umf_memory_provider_handle_t hProvider,
+                                   size_t keepBytes) {
+    UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result_t res =
+        hProvider->ops.ext.trim(hProvider->provider_priv, keepBytes);
+    checkErrorAndSetLastProvider(res, hProvider);
+    return res;
+}
+
 umf_result_t
 umfMemoryProviderGetIPCHandleSize(umf_memory_provider_handle_t hProvider,
                                   size_t *size) {
@@ -344,6 +430,20 @@ umfMemoryProviderGetIPCHandle(umf_memory_provider_handle_t hProvider,
                                              size, providerIpcData);
 }
 
+umf_result_t
+umfMemoryProviderGetIPCHandleRange(umf_memory_provider_handle_t hProvider,
+                                   const void *ptr, size_t size,
+                                   void *providerIpcData) {
+    UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    UMF_CHECK((ptr != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    UMF_CHECK((providerIpcData != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    if (!hProvider->ops.ipc.get_ipc_handle_range) {
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+    return hProvider->ops.ipc.get_ipc_handle_range(hProvider->provider_priv,
+                                                   ptr, size, providerIpcData);
+}
+
 umf_result_t
 umfMemoryProviderPutIPCHandle(umf_memory_provider_handle_t hProvider,
                               void *providerIpcData) {
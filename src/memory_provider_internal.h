@@ -26,6 +26,51 @@ typedef struct umf_memory_provider_t {
 void *umfMemoryProviderGetPriv(umf_memory_provider_handle_t hProvider);
 umf_memory_provider_handle_t *umfGetLastFailedMemoryProviderPtr(void);
 
+// Retrieves an IPC handle for a page-aligned part of an allocation,
+// see get_ipc_handle_range in umf_memory_provider_ipc_ops_t.
+// Returns UMF_RESULT_ERROR_NOT_SUPPORTED if the provider does not implement it.
+umf_result_t
+umfMemoryProviderGetIPCHandleRange(umf_memory_provider_handle_t hProvider,
+                                   const void *ptr, size_t size,
+                                   void *providerIpcData);
+
+// The ops structure of version 0.11, before ext.allocation_resize, ext.trim
+// and ipc.get_ipc_handle_range were added. umfMemoryProviderCreate()
+// accepts it and copies it member by member.
+typedef struct umf_memory_provider_ops_0_11_t {
+    uint32_t version;
+    umf_result_t (*initialize)(void *params, void **provider);
+    void (*finalize)(void *provider);
+    umf_result_t (*alloc)(void *provider, size_t size, size_t alignment,
+                          void **ptr);
+    umf_result_t (*free)(void *provider, void *ptr, size_t size);
+    void (*get_last_native_error)(void *provider, const char **ppMessage,
+                                  int32_t *pError);
+    umf_result_t (*get_recommended_page_size)(void *provider, size_t size,
+                                              size_t *pageSize);
+    umf_result_t (*get_min_page_size)(void *provider, void *ptr,
+                                      size_t *pageSize);
+    const char *(*get_name)(void *provider);
+    struct {
+        umf_result_t (*purge_lazy)(void *provider, void *ptr, size_t size);
+        umf_result_t (*purge_force)(void *provider, void *ptr, size_t size);
+        umf_result_t (*allocation_merge)(void *hProvider, void *lowPtr,
+                                         void *highPtr, size_t totalSize);
+        umf_result_t (*allocation_split)(void *hProvider, void *ptr,
+                                         size_t totalSize, size_t firstSize);
+    } ext;
+    struct {
+        umf_result_t (*get_ipc_handle_size)(void *provider, size_t *size);
+        umf_result_t (*get_ipc_handle)(void *provider, const void *ptr,
+                                       size_t size, void *providerIpcData);
+        umf_result_t (*put_ipc_handle)(void *provider, void *providerIpcData);
+        umf_result_t (*open_ipc_handle)(void *provider, void *providerIpcData,
+                                        void **ptr);
+        umf_result_t (*close_ipc_handle)(void *provider, void *ptr,
+                                         size_t size);
+    } ipc;
+} umf_memory_provider_ops_0_11_t;
+
 #ifdef __cplusplus
 }
 #endif
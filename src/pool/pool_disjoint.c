@@ -37,6 +37,8 @@ static bool bucket_can_pool(bucket_t *bucket);
 static void bucket_decrement_pool(bucket_t *bucket);
 static slab_list_item_t *bucket_get_avail_slab(bucket_t *bucket,
                                                bool *from_pool);
+size_t disjoint_pool_malloc_usable_size(void *pool, void *ptr);
+umf_result_t disjoint_pool_free(void *pool, void *ptr);
 
 static __TLS umf_result_t TLS_last_allocation_error;
 
@@ -678,11 +680,49 @@ void *disjoint_pool_calloc(void *pool, size_t num, size_t size) {
 }
 
 void *disjoint_pool_realloc(void *pool, void *ptr, size_t size) {
-    (void)pool;
-    (void)ptr;
-    (void)size;
+    disjoint_pool_t *disjoint_pool = (disjoint_pool_t *)pool;
+
+    if (ptr == NULL) {
+        return disjoint_pool_allocate(disjoint_pool, size);
+    }
+
+    if (size == 0) {
+        disjoint_pool_free(pool, ptr);
+        return NULL;
+    }
+
+    // The memory can be inaccessible on the host, so it cannot be copied
+    // and allocations are resized only in place: chunks of slabs within
+    // their usable size and allocations taken directly from the memory
+    // provider with its allocation_resize op (e.g. coarse-backed providers
+    // grow an allocation into the free memory following it).
+    slab_t *slab =
+        (slab_t *)critnib_find_le(disjoint_pool->known_slabs, (uintptr_t)ptr);
+    if (slab == NULL || ptr >= slab_get_end(slab)) {
+        umf_alloc_info_t allocInfo = {NULL, 0, NULL};
+        umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
+        if (ret != UMF_RESULT_SUCCESS) {
+            TLS_last_allocation_error = ret;
+            LOG_ERR("failed to get allocation info from the memory tracker");
+            return NULL;
+        }
+
+        if (allocInfo.base == ptr) {
+            size_t old_size = allocInfo.baseSize;
+            ret = umfMemoryProviderAllocationResize(disjoint_pool->provider,
+                                                    ptr, old_size, size);
+            if (ret == UMF_RESULT_SUCCESS) {
+                if (size > old_size) {
+                    utils_annotate_memory_undefined(
+                        (char *)ptr + old_size, size - old_size);
+                }
+                return ptr;
+            }
+        }
+    } else if (size <= disjoint_pool_malloc_usable_size(pool, ptr)) {
+        return ptr;
+    }
 
-    // Not supported
     TLS_last_allocation_error = UMF_RESULT_ERROR_NOT_SUPPORTED;
     return NULL;
 }
@@ -799,6 +839,34 @@ size_t disjoint_pool_malloc_usable_size(void *pool, void *ptr) {
     return slab->bucket->size - diff;
 }
 
+umf_result_t disjoint_pool_get_block_range(void *pool, const void *ptr,
+                                           void **base, size_t *size) {
+    disjoint_pool_t *disjoint_pool = (disjoint_pool_t *)pool;
+
+    slab_t *slab =
+        (slab_t *)critnib_find_le(disjoint_pool->known_slabs, (uintptr_t)ptr);
+    if (slab == NULL || ptr >= slab_get_end(slab)) {
+        // memory comes directly from the provider
+        umf_alloc_info_t allocInfo = {NULL, 0, NULL};
+        umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
+        if (ret != UMF_RESULT_SUCCESS) {
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+
+        *base = allocInfo.base;
+        *size = allocInfo.baseSize;
+        return UMF_RESULT_SUCCESS;
+    }
+
+    // the chunk containing ptr
+    size_t chunk_idx =
+        ((uintptr_t)ptr - (uintptr_t)slab->mem_ptr) / slab->bucket->size;
+    *base = (void *)((uintptr_t)slab->mem_ptr + chunk_idx * slab->bucket->size);
+    *size = slab->bucket->size;
+
+    return UMF_RESULT_SUCCESS;
+}
+
 umf_result_t disjoint_pool_free(void *pool, void *ptr) {
     disjoint_pool_t *disjoint_pool = (disjoint_pool_t *)pool;
     if (ptr == NULL) {
@@ -902,7 +970,7 @@ void disjoint_pool_finalize(void *pool) {
 }
 
 static umf_memory_pool_ops_t UMF_DISJOINT_POOL_OPS = {
-    .version = UMF_VERSION_CURRENT,
+    .version = UMF_POOL_OPS_VERSION_CURRENT,
     .initialize = disjoint_pool_initialize,
     .finalize = disjoint_pool_finalize,
     .malloc = disjoint_pool_malloc,
@@ -912,6 +980,7 @@ static umf_memory_pool_ops_t UMF_DISJOINT_POOL_OPS = {
     .malloc_usable_size = disjoint_pool_malloc_usable_size,
     .free = disjoint_pool_free,
     .get_last_allocation_error = disjoint_pool_get_last_allocation_error,
+    .get_block_range = disjoint_pool_get_block_range,
 };
 
 umf_memory_pool_ops_t *umfDisjointPoolOps(void) {
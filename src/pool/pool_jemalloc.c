@@ -448,6 +448,30 @@ static size_t op_malloc_usable_size(void *pool, void *ptr) {
     return je_malloc_usable_size(ptr);
 }
 
+// jemalloc does not expose the beginning of the buffer containing a pointer,
+// so the returned block starts at ptr. It is exact for the beginning of
+// a buffer; for a pointer inside of a small buffer it may cover the next
+// buffers of the same slab. ptr must not point inside of a large buffer
+// beyond its first page, where jemalloc does not register its extent.
+static umf_result_t op_get_block_range(void *pool, const void *ptr,
+                                       void **base, size_t *size) {
+    assert(pool);
+    jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
+
+    unsigned arena_index = 0;
+    size_t unsigned_size = sizeof(arena_index);
+    int err = je_mallctl("arenas.lookup", &arena_index, &unsigned_size,
+                         (void *)&ptr, sizeof(ptr));
+    if (err || arena_index != je_pool->arena_index) {
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    *base = (void *)ptr;
+    *size = je_malloc_usable_size((void *)ptr);
+
+    return UMF_RESULT_SUCCESS;
+}
+
 static umf_result_t op_get_last_allocation_error(void *pool) {
     (void)pool; // not used
     return TLS_last_allocation_error;
@@ -464,6 +488,7 @@ static umf_memory_pool_ops_t UMF_JEMALLOC_POOL_OPS = {
     .malloc_usable_size = op_malloc_usable_size,
     .free = op_free,
     .get_last_allocation_error = op_get_last_allocation_error,
+    .get_block_range = op_get_block_range,
 };
 
 umf_memory_pool_ops_t *umfJemallocPoolOps(void) {
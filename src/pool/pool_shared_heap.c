@@ -0,0 +1,818 @@
+/*
+ *
+ * Copyright (C) 2025 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <umf/memory_pool_ops.h>
+#include <umf/pools/pool_shared_heap.h>
+
+#include "base_alloc_global.h"
+#include "ipc_internal.h"
+#include "memory_pool_internal.h"
+#include "utils_common.h"
+#include "utils_concurrency.h"
+#include "utils_log.h"
+
+#define SHARED_HEAP_MAGIC 0x50414548444853ULL // "SHDHEAP"
+
+// blocks of the heap have sizes of powers of 2 from 16 bytes and are aligned
+// to their size relative to the start of the data of the heap, so every block
+// has a single buddy it can be merged with, offsets of blocks are stored
+// in 32 bits in units of the smallest block
+#define SHARED_HEAP_MIN_SHIFT 4
+#define SHARED_HEAP_MIN_BLOCK ((size_t)1 << SHARED_HEAP_MIN_SHIFT)
+#define SHARED_HEAP_NUM_CLASSES 32
+#define SHARED_HEAP_MAX_SIZE ((uint64_t)UINT32_MAX << SHARED_HEAP_MIN_SHIFT)
+
+// the heap is divided into pages of a fixed size (the same in all processes),
+// the data of the heap starts at a page boundary
+#define SHARED_HEAP_PAGE_SHIFT 12
+#define SHARED_HEAP_PAGE_SIZE ((size_t)1 << SHARED_HEAP_PAGE_SHIFT)
+#define SHARED_HEAP_PAGE_CLASS (SHARED_HEAP_PAGE_SHIFT - SHARED_HEAP_MIN_SHIFT)
+
+// an allocation of at least a page with an alignment of at most a page
+// takes a whole block starting at a page boundary and its size class is
+// stored in the page map, every other allocation is preceded by a 64-bit tag:
+// the offset of the allocation from the start of its block,
+// the tag magic and the size class of the block
+#define SHARED_HEAP_TAG_MAGIC 0x5348
+#define SHARED_HEAP_TAG(offset, cls)                                           \
+    (((uint64_t)(offset) << 24) | (SHARED_HEAP_TAG_MAGIC << 8) | (cls))
+#define SHARED_HEAP_TAG_OFFSET(tag) ((tag) >> 24)
+#define SHARED_HEAP_TAG_IS_VALID(tag)                                          \
+    ((((tag) >> 8) & 0xffff) == SHARED_HEAP_TAG_MAGIC)
+#define SHARED_HEAP_TAG_CLASS(tag) ((unsigned)((tag)&0xff))
+
+// The header of the heap. The heap is mapped at different addresses
+// in different processes, so it contains offsets from the start of the heap
+// only. The heads of the free lists contain the offset of the first free
+// block (in units of SHARED_HEAP_MIN_BLOCK) in the lower 32 bits and
+// a counter of modifications in the upper 32 bits, which prevents the ABA
+// problem when a block is popped and pushed again concurrently.
+// The header is followed by the page map: a byte for every page of the heap,
+// the size class + 1 of the page allocation starting at the page or 0.
+typedef struct shared_heap_header_t {
+    uint64_t magic;
+    uint64_t size;
+    uint64_t top; // offset of the part of the heap never allocated yet
+    uint64_t free_lists[SHARED_HEAP_NUM_CLASSES];
+    uint8_t page_map[];
+} shared_heap_header_t;
+
+typedef struct umf_shared_heap_pool_params_t {
+    size_t heap_size;
+    umf_ipc_handle_t ipc_handle;
+} umf_shared_heap_pool_params_t;
+
+typedef struct shared_heap_pool_t {
+    umf_memory_provider_handle_t provider;
+    shared_heap_header_t *heap;
+    // the size of the heap, validated when the heap is opened
+    uint64_t size;
+    // offset of the data of the heap (after the header and the page map)
+    uint64_t data;
+    // the heap was opened from an IPC handle of another pool
+    bool attached;
+    // size of the memory opened from the IPC handle
+    size_t mapped_size;
+} shared_heap_pool_t;
+
+static __TLS umf_result_t TLS_last_allocation_error;
+
+static inline size_t block_size(unsigned cls) {
+    return SHARED_HEAP_MIN_BLOCK << cls;
+}
+
+static inline uint64_t heap_data_offset(uint64_t size) {
+    return ALIGN_UP(sizeof(shared_heap_header_t) +
+                        (size >> SHARED_HEAP_PAGE_SHIFT),
+                    SHARED_HEAP_PAGE_SIZE);
+}
+
+static inline uint64_t *heap_block(shared_heap_pool_t *pool, uint64_t offset) {
+    return (uint64_t *)((uintptr_t)pool->heap + offset);
+}
+
+// returns the smallest size class whose blocks have at least size bytes
+static inline unsigned size_to_class(size_t size) {
+    if (size <= SHARED_HEAP_MIN_BLOCK) {
+        return 0;
+    }
+
+    return utils_mssb_index(size - 1) + 1 - SHARED_HEAP_MIN_SHIFT;
+}
+
+static uint64_t heap_pop(shared_heap_pool_t *pool, unsigned cls) {
+    uint64_t *list = &pool->heap->free_lists[cls];
+    uint64_t head;
+    utils_atomic_load_acquire(list, &head);
+
+    while (head & UINT32_MAX) {
+        uint64_t offset = (head & UINT32_MAX) << SHARED_HEAP_MIN_SHIFT;
+
+        // the block can be popped and reused by another thread in the meantime,
+        // then the counter of the head changes and the exchange fails
+        uint64_t next;
+        utils_atomic_load_acquire(heap_block(pool, offset), &next);
+
+        uint64_t new_head = (((head >> 32) + 1) << 32) | (next & UINT32_MAX);
+        if (utils_compare_exchange(list, &head, &new_head)) {
+            return offset;
+        }
+    }
+
+    return 0;
+}
+
+// pushes the list of blocks from first to last linked by their first words
+static void heap_push_list(shared_heap_pool_t *pool, unsigned cls,
+                           uint64_t first, uint64_t last) {
+    uint64_t *list = &pool->heap->free_lists[cls];
+    uint64_t *next = heap_block(pool, last);
+    uint64_t head;
+    utils_atomic_load_acquire(list, &head);
+
+    uint64_t new_head;
+    do {
+        utils_atomic_store_release(next, head & UINT32_MAX);
+        new_head =
+            (((head >> 32) + 1) << 32) | (first >> SHARED_HEAP_MIN_SHIFT);
+    } while (!utils_compare_exchange(list, &head, &new_head));
+}
+
+static void heap_push(shared_heap_pool_t *pool, unsigned cls,
+                      uint64_t offset) {
+    heap_push_list(pool, cls, offset, offset);
+}
+
+// allocates a block from the never allocated part of the heap,
+// the part skipped to align the block is pushed to the free lists
+static uint64_t heap_bump(shared_heap_pool_t *pool, unsigned cls) {
+    size_t size = block_size(cls);
+    uint64_t top;
+    utils_atomic_load_acquire(&pool->heap->top, &top);
+
+    uint64_t start, new_top;
+    do {
+        start = pool->data + ALIGN_UP(top - pool->data, size);
+        if (start > pool->size || pool->size - start < size) {
+            return 0;
+        }
+        new_top = start + size;
+    } while (!utils_compare_exchange(&pool->heap->top, &top, &new_top));
+
+    // the skipped part is split into the largest aligned blocks
+    while (top < start) {
+        unsigned c = utils_lssb_index(top - pool->data) - SHARED_HEAP_MIN_SHIFT;
+        while (top + block_size(c) > start) {
+            c--;
+        }
+        heap_push(pool, c, top);
+        top += block_size(c);
+    }
+
+    return start;
+}
+
+static inline uint64_t list_next(shared_heap_pool_t *pool, uint64_t offset) {
+    uint64_t next;
+    utils_atomic_load_acquire(heap_block(pool, offset), &next);
+    return (next & UINT32_MAX) << SHARED_HEAP_MIN_SHIFT;
+}
+
+static inline void list_set_next(shared_heap_pool_t *pool, uint64_t offset,
+                                 uint64_t next) {
+    utils_atomic_store_release(heap_block(pool, offset),
+                               next >> SHARED_HEAP_MIN_SHIFT);
+}
+
+// sorts the list of free blocks by their offsets (merge sort)
+static uint64_t list_sort(shared_heap_pool_t *pool, uint64_t first) {
+    if (first == 0 || list_next(pool, first) == 0) {
+        return first;
+    }
+
+    // split the list in halves
+    uint64_t slow = first;
+    uint64_t fast = list_next(pool, first);
+    while (fast && list_next(pool, fast)) {
+        slow = list_next(pool, slow);
+        fast = list_next(pool, list_next(pool, fast));
+    }
+    uint64_t second = list_next(pool, slow);
+    list_set_next(pool, slow, 0);
+
+    first = list_sort(pool, first);
+    second = list_sort(pool, second);
+
+    uint64_t head = 0, tail = 0;
+    while (first || second) {
+        uint64_t offset;
+        if (second == 0 || (first && first < second)) {
+            offset = first;
+            first = list_next(pool, first);
+        } else {
+            offset = second;
+            second = list_next(pool, second);
+        }
+
+        if (tail) {
+            list_set_next(pool, tail, offset);
+        } else {
+            head = offset;
+        }
+        tail = offset;
+    }
+    list_set_next(pool, tail, 0);
+
+    return head;
+}
+
+// Merges the free buddies. The free lists are taken over one at a time,
+// starting from the smallest class, and the merged blocks are pushed to
+// the list of the next class before it is taken over, so they can be merged
+// further. Only the taken list is missing from the heap meanwhile, and only
+// the blocks taken over are modified, so any number of processes can merge
+// concurrently without waiting for each other (buddies taken over by
+// different processes are merged next time) and a process that dies while
+// merging loses only the blocks of a single list.
+static void heap_coalesce(shared_heap_pool_t *pool) {
+    for (unsigned c = 0; c + 1 < SHARED_HEAP_NUM_CLASSES; c++) {
+        uint64_t *list = &pool->heap->free_lists[c];
+        uint64_t head, empty;
+        utils_atomic_load_acquire(list, &head);
+        do {
+            if ((head & UINT32_MAX) == 0) {
+                break;
+            }
+            empty = ((head >> 32) + 1) << 32;
+        } while (!utils_compare_exchange(list, &head, &empty));
+
+        if ((head & UINT32_MAX) == 0) {
+            continue;
+        }
+
+        size_t size = block_size(c);
+        uint64_t offset =
+            list_sort(pool, (head & UINT32_MAX) << SHARED_HEAP_MIN_SHIFT);
+        uint64_t first = 0, last = 0;
+        uint64_t merged_first = 0, merged_last = 0;
+
+        while (offset) {
+            uint64_t next = list_next(pool, offset);
+            if (next == offset + size &&
+                IS_ALIGNED(offset - pool->data, 2 * size)) {
+                // the block and its buddy make a block of the next class
+                uint64_t merged = offset;
+                offset = list_next(pool, next);
+                list_set_next(pool, merged, merged_first);
+                merged_first = merged;
+                if (merged_last == 0) {
+                    merged_last = merged_first;
+                }
+                continue;
+            }
+
+            if (last) {
+                list_set_next(pool, last, offset);
+            } else {
+                first = offset;
+            }
+            last = offset;
+            offset = next;
+        }
+
+        if (first) {
+            heap_push_list(pool, c, first, last);
+        }
+        if (merged_first) {
+            heap_push_list(pool, c + 1, merged_first, merged_last);
+        }
+    }
+}
+
+static uint64_t heap_alloc_block(shared_heap_pool_t *pool, unsigned cls) {
+    uint64_t offset = heap_pop(pool, cls);
+    if (offset) {
+        return offset;
+    }
+
+    offset = heap_bump(pool, cls);
+    if (offset) {
+        return offset;
+    }
+
+    // split a larger free block in halves down to the requested size class
+    for (unsigned c = cls + 1; c < SHARED_HEAP_NUM_CLASSES; c++) {
+        offset = heap_pop(pool, c);
+        if (offset == 0) {
+            continue;
+        }
+
+        while (c > cls) {
+            c--;
+            heap_push(pool, c, offset + block_size(c));
+        }
+
+        return offset;
+    }
+
+    return 0;
+}
+
+// Returns the size class of the page allocation at offset
+// or -1 if there is none.
+static int heap_get_page_class(shared_heap_pool_t *pool, uint64_t offset) {
+    if (offset < pool->data || offset >= pool->size ||
+        pool->size - offset < SHARED_HEAP_PAGE_SIZE ||
+        IS_NOT_ALIGNED(offset, SHARED_HEAP_PAGE_SIZE)) {
+        return -1;
+    }
+
+    int cls = (int)pool->heap->page_map[offset >> SHARED_HEAP_PAGE_SHIFT] - 1;
+    if (cls < (int)SHARED_HEAP_PAGE_CLASS || cls >= SHARED_HEAP_NUM_CLASSES ||
+        IS_NOT_ALIGNED(offset - pool->data, block_size(cls)) ||
+        offset > pool->size - block_size(cls)) {
+        return -1;
+    }
+
+    return cls;
+}
+
+// Returns the tag of the allocation or 0 if ptr was not allocated
+// from the heap. A page allocation gets a tag with offset 0.
+static uint64_t heap_get_tag(shared_heap_pool_t *pool, void *ptr) {
+    uintptr_t heap = (uintptr_t)pool->heap;
+    uintptr_t user = (uintptr_t)ptr;
+
+    if (user < heap + pool->data || user >= heap + pool->size ||
+        IS_NOT_ALIGNED(user, sizeof(uint64_t))) {
+        return 0;
+    }
+
+    int page_cls = heap_get_page_class(pool, user - heap);
+    if (page_cls >= 0) {
+        return SHARED_HEAP_TAG(0, page_cls);
+    }
+
+    if (user < heap + pool->data + SHARED_HEAP_MIN_BLOCK) {
+        return 0;
+    }
+
+    uint64_t tag = *(uint64_t *)(user - sizeof(uint64_t));
+    if (!SHARED_HEAP_TAG_IS_VALID(tag) ||
+        SHARED_HEAP_TAG_CLASS(tag) >= SHARED_HEAP_NUM_CLASSES) {
+        return 0;
+    }
+
+    uint64_t offset = SHARED_HEAP_TAG_OFFSET(tag);
+    size_t size = block_size(SHARED_HEAP_TAG_CLASS(tag));
+    if (offset < SHARED_HEAP_MIN_BLOCK || offset >= size ||
+        user - offset < heap + pool->data ||
+        user - offset - heap > pool->size - size) {
+        return 0;
+    }
+
+    return tag;
+}
+
+static void *shared_heap_aligned_malloc(void *pool, size_t size,
+                                        size_t alignment) {
+    assert(pool);
+    shared_heap_pool_t *p = (shared_heap_pool_t *)pool;
+
+    if (alignment < SHARED_HEAP_MIN_BLOCK) {
+        alignment = SHARED_HEAP_MIN_BLOCK;
+    }
+
+    if (!IS_POWER_OF_2(alignment)) {
+        LOG_ERR("alignment %zu is not a power of 2", alignment);
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ALIGNMENT;
+        return NULL;
+    }
+
+    if (size > p->size || alignment > p->size - size) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+
+    // an empty allocation still has to end inside its block
+    if (size == 0) {
+        size = 1;
+    }
+
+    // a page allocation takes a block of its size, blocks of the page class
+    // and larger ones start at page boundaries, otherwise the tag of the
+    // allocation fits in the first 16 bytes of the block or in the padding
+    // before the aligned allocation
+    unsigned cls = size_to_class(utils_max(size, alignment));
+    bool page_alloc =
+        cls >= SHARED_HEAP_PAGE_CLASS && alignment <= SHARED_HEAP_PAGE_SIZE;
+    if (!page_alloc) {
+        cls = size_to_class(size + alignment);
+    }
+    if (cls >= SHARED_HEAP_NUM_CLASSES) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+
+    uint64_t offset = heap_alloc_block(p, cls);
+    if (offset == 0) {
+        // merge the free buddies and try again
+        heap_coalesce(p);
+        offset = heap_alloc_block(p, cls);
+    }
+    if (offset == 0) {
+        LOG_DEBUG("the shared heap is exhausted, cannot allocate %zu bytes",
+                  size);
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+
+    uintptr_t block = (uintptr_t)heap_block(p, offset);
+    uintptr_t user = block;
+    if (page_alloc) {
+        p->heap->page_map[offset >> SHARED_HEAP_PAGE_SHIFT] = (uint8_t)cls + 1;
+    } else {
+        user = ALIGN_UP(block + SHARED_HEAP_MIN_BLOCK, alignment);
+        *(uint64_t *)(user - sizeof(uint64_t)) =
+            SHARED_HEAP_TAG(user - block, cls);
+    }
+
+    TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+    return (void *)user;
+}
+
+static void *shared_heap_malloc(void *pool, size_t size) {
+    return shared_heap_aligned_malloc(pool, size, 0);
+}
+
+static void *shared_heap_calloc(void *pool, size_t num, size_t size) {
+    if (size && num > SIZE_MAX / size) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+
+    void *ptr = shared_heap_aligned_malloc(pool, num * size, 0);
+    if (ptr) {
+        memset(ptr, 0, num * size);
+    }
+
+    return ptr;
+}
+
+static size_t shared_heap_malloc_usable_size(void *pool, void *ptr) {
+    assert(pool);
+    shared_heap_pool_t *p = (shared_heap_pool_t *)pool;
+
+    if (ptr == NULL) {
+        return 0;
+    }
+
+    uint64_t tag = heap_get_tag(p, ptr);
+    if (tag == 0) {
+        LOG_ERR("pointer %p was not allocated from the shared heap", ptr);
+        return 0;
+    }
+
+    return block_size(SHARED_HEAP_TAG_CLASS(tag)) - SHARED_HEAP_TAG_OFFSET(tag);
+}
+
+static umf_result_t shared_heap_free(void *pool, void *ptr) {
+    assert(pool);
+    shared_heap_pool_t *p = (shared_heap_pool_t *)pool;
+
+    if (ptr == NULL) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    uint64_t tag = heap_get_tag(p, ptr);
+    if (tag == 0) {
+        LOG_ERR("pointer %p was not allocated from the shared heap or it was "
+                "already freed",
+                ptr);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // clear the tag, so a double free is detected
+    if (SHARED_HEAP_TAG_OFFSET(tag) == 0) {
+        p->heap->page_map[((uintptr_t)ptr - (uintptr_t)p->heap) >>
+                          SHARED_HEAP_PAGE_SHIFT] = 0;
+    } else {
+        *((uint64_t *)ptr - 1) = 0;
+    }
+
+    uint64_t offset = (uintptr_t)ptr - SHARED_HEAP_TAG_OFFSET(tag) -
+                      (uintptr_t)p->heap;
+    heap_push(p, SHARED_HEAP_TAG_CLASS(tag), offset);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static void *shared_heap_realloc(void *pool, void *ptr, size_t size) {
+    if (ptr == NULL) {
+        return shared_heap_aligned_malloc(pool, size, 0);
+    }
+
+    if (size == 0) {
+        shared_heap_free(pool, ptr);
+        TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+        return NULL;
+    }
+
+    size_t old_size = shared_heap_malloc_usable_size(pool, ptr);
+    if (old_size == 0) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    if (size <= old_size) {
+        TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+        return ptr;
+    }
+
+    void *new_ptr = shared_heap_aligned_malloc(pool, size, 0);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+
+    memcpy(new_ptr, ptr, old_size);
+    shared_heap_free(pool, ptr);
+
+    return new_ptr;
+}
+
+static umf_result_t shared_heap_get_last_allocation_error(void *pool) {
+    (void)pool; // not used
+    return TLS_last_allocation_error;
+}
+
+static umf_result_t shared_heap_attach(shared_heap_pool_t *pool,
+                                       umf_ipc_handle_t ipcHandle) {
+    void *ptr = NULL;
+    umf_result_t ret = umfOpenIPCHandle(pool->provider, ipcHandle, &ptr);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("cannot open the IPC handle of the shared heap");
+        return ret;
+    }
+
+    // the size of the heap is read once, so a corrupted header
+    // cannot make this process access memory out of the mapping
+    shared_heap_header_t *heap = ptr;
+    uint64_t magic;
+    utils_atomic_load_acquire(&heap->magic, &magic);
+    uint64_t size = heap->size;
+
+    if (ipcHandle->offset != 0 || magic != SHARED_HEAP_MAGIC ||
+        size > ipcHandle->baseSize || size > SHARED_HEAP_MAX_SIZE ||
+        size <= heap_data_offset(size)) {
+        LOG_ERR("the IPC handle is not a handle of a shared heap");
+        umfMemoryProviderCloseIPCHandle(pool->provider, ptr,
+                                        ipcHandle->baseSize);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pool->heap = heap;
+    pool->size = size;
+    pool->data = heap_data_offset(size);
+    pool->attached = true;
+    pool->mapped_size = ipcHandle->baseSize;
+
+    LOG_DEBUG("attached to the shared heap of size %zu at %p", (size_t)size,
+              ptr);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t shared_heap_create(shared_heap_pool_t *pool,
+                                       size_t heap_size) {
+    if (heap_size > SHARED_HEAP_MAX_SIZE ||
+        heap_size <= heap_data_offset(heap_size)) {
+        LOG_ERR("invalid size of the shared heap: %zu", heap_size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    void *ptr = NULL;
+    umf_result_t ret =
+        umfMemoryProviderAlloc(pool->provider, heap_size, 0, &ptr);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("cannot allocate the shared heap of size %zu", heap_size);
+        return ret;
+    }
+
+    shared_heap_header_t *heap = ptr;
+    uint64_t data = heap_data_offset(heap_size);
+    memset(heap, 0, data);
+    heap->size = heap_size;
+    heap->top = data;
+    utils_atomic_store_release(&heap->magic, SHARED_HEAP_MAGIC);
+
+    pool->heap = heap;
+    pool->size = heap_size;
+    pool->data = data;
+    pool->attached = false;
+    pool->mapped_size = 0;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t
+shared_heap_initialize(umf_memory_provider_handle_t provider, void *params,
+                       void **ppPool) {
+    umf_shared_heap_pool_params_t *hParams =
+        (umf_shared_heap_pool_params_t *)params;
+
+    shared_heap_pool_t *pool = umf_ba_global_alloc(sizeof(*pool));
+    if (!pool) {
+        LOG_ERR("cannot allocate memory for the shared heap pool");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    pool->provider = provider;
+
+    umf_result_t ret;
+    if (hParams && hParams->ipc_handle) {
+        ret = shared_heap_attach(pool, hParams->ipc_handle);
+    } else {
+        ret = shared_heap_create(pool, hParams
+                                           ? hParams->heap_size
+                                           : UMF_SHARED_HEAP_POOL_DEFAULT_SIZE);
+    }
+
+    if (ret != UMF_RESULT_SUCCESS) {
+        umf_ba_global_free(pool);
+        return ret;
+    }
+
+    *ppPool = (void *)pool;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static void shared_heap_finalize(void *pool) {
+    shared_heap_pool_t *p = (shared_heap_pool_t *)pool;
+
+    umf_result_t ret;
+    if (p->attached) {
+        ret = umfMemoryProviderCloseIPCHandle(p->provider, p->heap,
+                                              p->mapped_size);
+    } else {
+        ret = umfMemoryProviderFree(p->provider, p->heap, p->size);
+    }
+
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("cannot release the shared heap at %p", (void *)p->heap);
+    }
+
+    umf_ba_global_free(p);
+}
+
+static umf_memory_pool_ops_t UMF_SHARED_HEAP_POOL_OPS = {
+    .version = UMF_POOL_OPS_VERSION_CURRENT,
+    .initialize = shared_heap_initialize,
+    .finalize = shared_heap_finalize,
+    .malloc = shared_heap_malloc,
+    .calloc = shared_heap_calloc,
+    .realloc = shared_heap_realloc,
+    .aligned_malloc = shared_heap_aligned_malloc,
+    .malloc_usable_size = shared_heap_malloc_usable_size,
+    .free = shared_heap_free,
+    .get_last_allocation_error = shared_heap_get_last_allocation_error};
+
+umf_memory_pool_ops_t *umfSharedHeapPoolOps(void) {
+    return &UMF_SHARED_HEAP_POOL_OPS;
+}
+
+static shared_heap_pool_t *get_shared_heap_pool(umf_memory_pool_handle_t hPool) {
+    if (hPool == NULL || hPool->ops.initialize != shared_heap_initialize) {
+        LOG_ERR("the pool is not a shared heap pool");
+        return NULL;
+    }
+
+    return (shared_heap_pool_t *)hPool->pool_priv;
+}
+
+umf_result_t umfSharedHeapPoolGetIPCHandle(umf_memory_pool_handle_t hPool,
+                                           umf_ipc_handle_t *ipcHandle,
+                                           size_t *size) {
+    shared_heap_pool_t *pool = get_shared_heap_pool(hPool);
+    if (pool == NULL || ipcHandle == NULL || size == NULL) {
+        LOG_ERR("invalid argument");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (pool->attached) {
+        LOG_ERR("only the pool that created the shared heap can share it");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // share the whole heap, not only the part containing its header
+    return umfGetIPCHandleOfAllocation(pool->heap, ipcHandle, size);
+}
+
+umf_result_t umfSharedHeapPoolGetOffset(umf_memory_pool_handle_t hPool,
+                                        const void *ptr, size_t *offset) {
+    shared_heap_pool_t *pool = get_shared_heap_pool(hPool);
+    if (pool == NULL || offset == NULL) {
+        LOG_ERR("invalid argument");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    uintptr_t heap = (uintptr_t)pool->heap;
+    if ((uintptr_t)ptr < heap + pool->data ||
+        (uintptr_t)ptr >= heap + pool->size) {
+        LOG_ERR("pointer %p is out of the shared heap", ptr);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    *offset = (uintptr_t)ptr - heap;
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfSharedHeapPoolGetPtr(umf_memory_pool_handle_t hPool,
+                                     size_t offset, void **ptr) {
+    shared_heap_pool_t *pool = get_shared_heap_pool(hPool);
+    if (pool == NULL || ptr == NULL) {
+        LOG_ERR("invalid argument");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (offset < pool->data || offset >= pool->size) {
+        LOG_ERR("offset %zu is out of the shared heap", offset);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    *ptr = (void *)((uintptr_t)pool->heap + offset);
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t
+umfSharedHeapPoolParamsCreate(umf_shared_heap_pool_params_handle_t *hParams) {
+    if (!hParams) {
+        LOG_ERR("shared heap pool params handle is NULL");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_shared_heap_pool_params_handle_t params =
+        umf_ba_global_alloc(sizeof(*params));
+    if (params == NULL) {
+        LOG_ERR("cannot allocate memory for shared heap pool params");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    params->heap_size = UMF_SHARED_HEAP_POOL_DEFAULT_SIZE;
+    params->ipc_handle = NULL;
+
+    *hParams = params;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t
+umfSharedHeapPoolParamsDestroy(umf_shared_heap_pool_params_handle_t hParams) {
+    // NOTE: dereferencing hParams when BA is already destroyed leads to crash
+    if (hParams && !umf_ba_global_is_destroyed()) {
+        umf_ba_global_free(hParams);
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t
+umfSharedHeapPoolParamsSetHeapSize(umf_shared_heap_pool_params_handle_t hParams,
+                                   size_t heapSize) {
+    if (!hParams) {
+        LOG_ERR("shared heap pool params handle is NULL");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (heapSize > SHARED_HEAP_MAX_SIZE ||
+        heapSize <= heap_data_offset(heapSize)) {
+        LOG_ERR("invalid size of the shared heap: %zu", heapSize);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    hParams->heap_size = heapSize;
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfSharedHeapPoolParamsSetIPCHandle(
+    umf_shared_heap_pool_params_handle_t hParams, umf_ipc_handle_t ipcHandle) {
+    if (!hParams) {
+        LOG_ERR("shared heap pool params handle is NULL");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    hParams->ipc_handle = ipcHandle;
+    return UMF_RESULT_SUCCESS;
+}
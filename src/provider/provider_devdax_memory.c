@@ -62,6 +62,15 @@ umf_result_t umfDevDaxMemoryProviderParamsSetProtection(
     return UMF_RESULT_ERROR_NOT_SUPPORTED;
 }
 
+umf_result_t umfDevDaxMemoryProviderParamsSetFreeHighWaterMark(
+    umf_devdax_memory_provider_params_handle_t hParams,
+    size_t freeHighWaterMark) {
+    (void)hParams;
+    (void)freeHighWaterMark;
+    LOG_ERR("DevDax memory provider is disabled!");
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
 #else // !defined(_WIN32) && !defined(UMF_NO_HWLOC)
 
 #include "base_alloc_global.h"
@@ -90,6 +99,7 @@ typedef struct umf_devdax_memory_provider_params_t {
     char *path;
     size_t size;
     unsigned protection;
+    size_t free_high_water_mark;
 } umf_devdax_memory_provider_params_t;
 
 typedef struct devdax_last_native_error_t {
@@ -147,6 +157,7 @@ static umf_result_t devdax_allocation_split_cb(void *provider, void *ptr,
                                                size_t firstSize);
 static umf_result_t devdax_allocation_merge_cb(void *provider, void *lowPtr,
                                                void *highPtr, size_t totalSize);
+static umf_result_t devdax_purge_force(void *provider, void *ptr, size_t size);
 
 static umf_result_t devdax_initialize(void *params, void **provider) {
     umf_result_t ret;
@@ -187,6 +198,11 @@ static umf_result_t devdax_initialize(void *params, void **provider) {
     coarse_params.cb.free = NULL; // not available for the devdax provider
     coarse_params.cb.split = devdax_allocation_split_cb;
     coarse_params.cb.merge = devdax_allocation_merge_cb;
+    coarse_params.cb.purge = devdax_purge_force;
+    coarse_params.purge_min_size = COARSE_PURGE_MIN_SIZE_DEFAULT;
+    coarse_params.purge_delay_ms = COARSE_PURGE_DELAY_MS_DEFAULT;
+    coarse_params.free_high_water_mark = in_params->free_high_water_mark;
+    coarse_params.allocation_strategy = UMF_COARSE_MEMORY_STRATEGY_TLSF;
 
     coarse_t *coarse = NULL;
     ret = coarse_new(&coarse_params, &coarse);
@@ -396,6 +412,13 @@ static umf_result_t devdax_allocation_merge_cb(void *provider, void *lowPtr,
     return UMF_RESULT_SUCCESS;
 }
 
+static umf_result_t devdax_allocation_resize(void *provider, void *ptr,
+                                             size_t oldSize, size_t newSize) {
+    devdax_memory_provider_t *devdax_provider =
+        (devdax_memory_provider_t *)provider;
+    return coarse_resize(devdax_provider->coarse, ptr, oldSize, newSize);
+}
+
 typedef struct devdax_ipc_data_t {
     char path[PATH_MAX]; // path to the /dev/dax
     unsigned protection; // combination of OS-specific memory protection flags
@@ -529,6 +552,13 @@ static umf_result_t devdax_free(void *provider, void *ptr, size_t size) {
     return coarse_free(devdax_provider->coarse, ptr, size);
 }
 
+static umf_result_t devdax_trim(void *provider, size_t keep_bytes) {
+    devdax_memory_provider_t *devdax_provider =
+        (devdax_memory_provider_t *)provider;
+    // the free memory is purged, because the device DAX cannot be unmapped
+    return coarse_trim(devdax_provider->coarse, keep_bytes);
+}
+
 static umf_memory_provider_ops_t UMF_DEVDAX_MEMORY_PROVIDER_OPS = {
     .version = UMF_PROVIDER_OPS_VERSION_CURRENT,
     .initialize = devdax_initialize,
@@ -543,6 +573,8 @@ static umf_memory_provider_ops_t UMF_DEVDAX_MEMORY_PROVIDER_OPS = {
     .ext.purge_force = devdax_purge_force,
     .ext.allocation_merge = devdax_allocation_merge,
     .ext.allocation_split = devdax_allocation_split,
+    .ext.allocation_resize = devdax_allocation_resize,
+    .ext.trim = devdax_trim,
     .ipc.get_ipc_handle_size = devdax_get_ipc_handle_size,
     .ipc.get_ipc_handle = devdax_get_ipc_handle,
     .ipc.put_ipc_handle = devdax_put_ipc_handle,
@@ -578,6 +610,7 @@ umf_result_t umfDevDaxMemoryProviderParamsCreate(
     params->path = NULL;
     params->size = 0;
     params->protection = UMF_PROTECTION_READ | UMF_PROTECTION_WRITE;
+    params->free_high_water_mark = 0;
 
     umf_result_t res =
         umfDevDaxMemoryProviderParamsSetDeviceDax(params, path, size);
@@ -659,4 +692,17 @@ umf_result_t umfDevDaxMemoryProviderParamsSetProtection(
     return UMF_RESULT_SUCCESS;
 }
 
+umf_result_t umfDevDaxMemoryProviderParamsSetFreeHighWaterMark(
+    umf_devdax_memory_provider_params_handle_t hParams,
+    size_t freeHighWaterMark) {
+    if (hParams == NULL) {
+        LOG_ERR("DevDax Memory Provider params handle is NULL");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    hParams->free_high_water_mark = freeHighWaterMark;
+
+    return UMF_RESULT_SUCCESS;
+}
+
 #endif // !defined(_WIN32) && !defined(UMF_NO_HWLOC)
@@ -68,6 +68,23 @@ umf_result_t umfFileMemoryProviderParamsSetVisibility(
     return UMF_RESULT_ERROR_NOT_SUPPORTED;
 }
 
+umf_result_t umfFileMemoryProviderParamsSetNumArenas(
+    umf_file_memory_provider_params_handle_t hParams, unsigned numArenas) {
+    (void)hParams;
+    (void)numArenas;
+    LOG_ERR("File memory provider is disabled!");
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
+umf_result_t umfFileMemoryProviderParamsSetFreeHighWaterMark(
+    umf_file_memory_provider_params_handle_t hParams,
+    size_t freeHighWaterMark) {
+    (void)hParams;
+    (void)freeHighWaterMark;
+    LOG_ERR("File memory provider is disabled!");
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
 #else // !defined(_WIN32) && !defined(UMF_NO_HWLOC)
 
 #include "base_alloc_global.h"
@@ -119,6 +136,8 @@ typedef struct umf_file_memory_provider_params_t {
     char *path;
     unsigned protection;
     umf_memory_visibility_t visibility;
+    unsigned num_arenas;
+    size_t free_high_water_mark;
 } umf_file_memory_provider_params_t;
 
 typedef struct file_last_native_error_t {
@@ -184,6 +203,7 @@ static umf_result_t file_allocation_split_cb(void *provider, void *ptr,
                                              size_t firstSize);
 static umf_result_t file_allocation_merge_cb(void *provider, void *lowPtr,
                                              void *highPtr, size_t totalSize);
+static umf_result_t file_purge_cb(void *provider, void *ptr, size_t size);
 
 static umf_result_t file_initialize(void *params, void **provider) {
     umf_result_t ret;
@@ -259,6 +279,12 @@ static umf_result_t file_initialize(void *params, void **provider) {
     coarse_params.cb.free = NULL; // not available for the file provider
     coarse_params.cb.split = file_allocation_split_cb;
     coarse_params.cb.merge = file_allocation_merge_cb;
+    coarse_params.cb.purge = file_purge_cb;
+    coarse_params.purge_min_size = COARSE_PURGE_MIN_SIZE_DEFAULT;
+    coarse_params.purge_delay_ms = COARSE_PURGE_DELAY_MS_DEFAULT;
+    coarse_params.num_arenas = in_params->num_arenas;
+    coarse_params.free_high_water_mark = in_params->free_high_water_mark;
+    coarse_params.allocation_strategy = UMF_COARSE_MEMORY_STRATEGY_TLSF;
 
     coarse_t *coarse = NULL;
     ret = coarse_new(&coarse_params, &coarse);
@@ -306,18 +332,16 @@ err_free_file_provider:
     return ret;
 }
 
+static void file_munmap_cb(uintptr_t key, void *value, void *privdata) {
+    (void)privdata;
+    utils_munmap((void *)key, (size_t)value);
+}
+
 static void file_finalize(void *provider) {
     file_memory_provider_t *file_provider = provider;
 
-    uintptr_t key = 0;
-    uintptr_t rkey = 0;
-    void *rvalue = NULL;
-    while (1 ==
-           critnib_find(file_provider->mmaps, key, FIND_G, &rkey, &rvalue)) {
-        utils_munmap((void *)rkey, (size_t)rvalue);
-        critnib_remove(file_provider->mmaps, rkey);
-        key = rkey;
-    }
+    critnib_remove_range(file_provider->mmaps, 0, UINTPTR_MAX, file_munmap_cb,
+                         NULL);
 
     utils_mutex_destroy_not_free(&file_provider->lock);
     utils_close_fd(file_provider->fd);
@@ -700,6 +724,46 @@ static umf_result_t file_allocation_merge_cb(void *provider, void *lowPtr,
     return UMF_RESULT_SUCCESS;
 }
 
+static umf_result_t file_allocation_resize(void *provider, void *ptr,
+                                           size_t oldSize, size_t newSize) {
+    file_memory_provider_t *file_provider = (file_memory_provider_t *)provider;
+    return coarse_resize(file_provider->coarse, ptr, oldSize, newSize);
+}
+
+// Releases the physical memory of a free coarse block.
+// Pages of a shared mapping stay in the page cache after MADV_DONTNEED,
+// so a hole is punched in the file in this case.
+static umf_result_t file_purge_cb(void *provider, void *ptr, size_t size) {
+    file_memory_provider_t *file_provider = (file_memory_provider_t *)provider;
+
+    if (file_provider->fd <= 0 || !file_provider->IPC_enabled) {
+        return file_purge_force(provider, ptr, size);
+    }
+
+    void *value = critnib_get(file_provider->fd_offset_map, (uintptr_t)ptr);
+    if (value == NULL) {
+        LOG_ERR("file descriptor offset not found (addr=%p)", ptr);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    size_t fd_offset = (size_t)value - 1;
+
+    errno = 0;
+    if (utils_punch_hole(file_provider->fd, fd_offset, size)) {
+        file_store_last_native_error(UMF_FILE_RESULT_ERROR_PURGE_FORCE_FAILED,
+                                     errno);
+        LOG_PERR("punching a hole in the file failed (fd=%i, offset=%zu, "
+                 "size=%zu)",
+                 file_provider->fd, fd_offset, size);
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    LOG_DEBUG("punched a hole in the file (fd=%i, offset=%zu, size=%zu)",
+              file_provider->fd, fd_offset, size);
+
+    return UMF_RESULT_SUCCESS;
+}
+
 typedef struct file_ipc_data_t {
     char path[PATH_MAX];
     size_t offset_fd;
@@ -847,6 +911,12 @@ static umf_result_t file_free(void *provider, void *ptr, size_t size) {
     return coarse_free(file_provider->coarse, ptr, size);
 }
 
+static umf_result_t file_trim(void *provider, size_t keep_bytes) {
+    file_memory_provider_t *file_provider = (file_memory_provider_t *)provider;
+    // the free memory is purged, because the file provider cannot free it
+    return coarse_trim(file_provider->coarse, keep_bytes);
+}
+
 static umf_memory_provider_ops_t UMF_FILE_MEMORY_PROVIDER_OPS = {
     .version = UMF_PROVIDER_OPS_VERSION_CURRENT,
     .initialize = file_initialize,
@@ -861,6 +931,8 @@ static umf_memory_provider_ops_t UMF_FILE_MEMORY_PROVIDER_OPS = {
     .ext.purge_force = file_purge_force,
     .ext.allocation_merge = file_allocation_merge,
     .ext.allocation_split = file_allocation_split,
+    .ext.allocation_resize = file_allocation_resize,
+    .ext.trim = file_trim,
     .ipc.get_ipc_handle_size = file_get_ipc_handle_size,
     .ipc.get_ipc_handle = file_get_ipc_handle,
     .ipc.put_ipc_handle = file_put_ipc_handle,
@@ -894,6 +966,8 @@ umf_result_t umfFileMemoryProviderParamsCreate(
     params->path = NULL;
     params->protection = UMF_PROTECTION_READ | UMF_PROTECTION_WRITE;
     params->visibility = UMF_MEM_MAP_PRIVATE;
+    params->num_arenas = 1;
+    params->free_high_water_mark = 0;
 
     umf_result_t res = umfFileMemoryProviderParamsSetPath(params, path);
     if (res != UMF_RESULT_SUCCESS) {
@@ -975,4 +1049,34 @@ umf_result_t umfFileMemoryProviderParamsSetVisibility(
     return UMF_RESULT_SUCCESS;
 }
 
+umf_result_t umfFileMemoryProviderParamsSetNumArenas(
+    umf_file_memory_provider_params_handle_t hParams, unsigned numArenas) {
+    if (hParams == NULL) {
+        LOG_ERR("File Memory Provider params handle is NULL");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (numArenas == 0) {
+        LOG_ERR("number of arenas must be greater than 0");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    hParams->num_arenas = numArenas;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfFileMemoryProviderParamsSetFreeHighWaterMark(
+    umf_file_memory_provider_params_handle_t hParams,
+    size_t freeHighWaterMark) {
+    if (hParams == NULL) {
+        LOG_ERR("File Memory Provider params handle is NULL");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    hParams->free_high_water_mark = freeHighWaterMark;
+
+    return UMF_RESULT_SUCCESS;
+}
+
 #endif // !defined(_WIN32) && !defined(UMF_NO_HWLOC)
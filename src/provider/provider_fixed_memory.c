@@ -27,15 +27,23 @@
 #define TLS_MSG_BUF_LEN 1024
 
 typedef struct fixed_memory_provider_t {
-    void *base;       // base address of memory
-    size_t size;      // size of the memory region
     coarse_t *coarse; // coarse library handle
 } fixed_memory_provider_t;
 
-// Fixed Memory provider settings struct
-typedef struct umf_fixed_memory_provider_params_t {
+// memory region managed by the Fixed Memory provider
+typedef struct fixed_region_t {
     void *ptr;
     size_t size;
+    int numa_node; // -1 if unknown
+} fixed_region_t;
+
+// Fixed Memory provider settings struct
+typedef struct umf_fixed_memory_provider_params_t {
+    fixed_region_t *regions;
+    size_t num_regions;
+    size_t regions_capacity;
+    unsigned num_arenas;
+    size_t free_high_water_mark;
 } umf_fixed_memory_provider_params_t;
 
 typedef struct fixed_last_native_error_t {
@@ -81,6 +89,27 @@ static umf_result_t fixed_allocation_merge_cb(void *provider, void *lowPtr,
     return UMF_RESULT_SUCCESS;
 }
 
+// The fixed memory does not have to be aligned to pages,
+// so only the whole pages of the free block are purged.
+static umf_result_t fixed_purge_cb(void *provider, void *ptr, size_t size) {
+    (void)provider; // unused
+    size_t page_size = utils_get_page_size();
+    uintptr_t start = ALIGN_UP((uintptr_t)ptr, page_size);
+    uintptr_t end = ALIGN_DOWN((uintptr_t)ptr + size, page_size);
+    if (start >= end) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    errno = 0;
+    if (utils_purge((void *)start, end - start, UMF_PURGE_FORCE)) {
+        fixed_store_last_native_error(UMF_FIXED_RESULT_ERROR_PURGE_FORCE_FAILED,
+                                      errno);
+        LOG_PERR("force purging failed");
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+    return UMF_RESULT_SUCCESS;
+}
+
 static umf_result_t fixed_initialize(void *params, void **provider) {
     umf_result_t ret;
 
@@ -110,6 +139,17 @@ static umf_result_t fixed_initialize(void *params, void **provider) {
     coarse_params.cb.free = NULL; // not available for the fixed provider
     coarse_params.cb.split = fixed_allocation_split_cb;
     coarse_params.cb.merge = fixed_allocation_merge_cb;
+    // the free memory is only purged by coarse_trim(),
+    // it is not purged lazily
+    coarse_params.cb.purge = fixed_purge_cb;
+    coarse_params.free_high_water_mark = in_params->free_high_water_mark;
+    coarse_params.allocation_strategy = UMF_COARSE_MEMORY_STRATEGY_TLSF;
+    // every region gets its own num_arenas arenas,
+    // so allocations can prefer the regions of the local NUMA node
+    coarse_params.num_arenas = in_params->num_arenas;
+    if (in_params->num_regions > 1) {
+        coarse_params.num_arenas *= (unsigned)in_params->num_regions;
+    }
 
     coarse_t *coarse = NULL;
     ret = coarse_new(&coarse_params, &coarse);
@@ -120,15 +160,16 @@ static umf_result_t fixed_initialize(void *params, void **provider) {
 
     fixed_provider->coarse = coarse;
 
-    fixed_provider->base = in_params->ptr;
-    fixed_provider->size = in_params->size;
-
-    // add the entire memory as a single block
-    ret = coarse_add_memory_fixed(coarse, fixed_provider->base,
-                                  fixed_provider->size);
-    if (ret != UMF_RESULT_SUCCESS) {
-        LOG_ERR("adding memory block failed");
-        goto err_coarse_delete;
+    // add every memory region as a single block
+    for (size_t i = 0; i < in_params->num_regions; i++) {
+        fixed_region_t *region = &in_params->regions[i];
+        ret = coarse_add_memory_fixed_node(coarse, region->ptr, region->size,
+                                           in_params->num_arenas,
+                                           region->numa_node);
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("adding memory block #%zu failed", i);
+            goto err_coarse_delete;
+        }
     }
 
     *provider = fixed_provider;
@@ -247,12 +288,26 @@ static umf_result_t fixed_allocation_merge(void *provider, void *lowPtr,
     return coarse_merge(fixed_provider->coarse, lowPtr, highPtr, totalSize);
 }
 
+static umf_result_t fixed_allocation_resize(void *provider, void *ptr,
+                                            size_t oldSize, size_t newSize) {
+    fixed_memory_provider_t *fixed_provider =
+        (fixed_memory_provider_t *)provider;
+    return coarse_resize(fixed_provider->coarse, ptr, oldSize, newSize);
+}
+
 static umf_result_t fixed_free(void *provider, void *ptr, size_t size) {
     fixed_memory_provider_t *fixed_provider =
         (fixed_memory_provider_t *)provider;
     return coarse_free(fixed_provider->coarse, ptr, size);
 }
 
+static umf_result_t fixed_trim(void *provider, size_t keep_bytes) {
+    fixed_memory_provider_t *fixed_provider =
+        (fixed_memory_provider_t *)provider;
+    // the free memory is purged, because it is owned by the user
+    return coarse_trim(fixed_provider->coarse, keep_bytes);
+}
+
 static umf_memory_provider_ops_t UMF_FIXED_MEMORY_PROVIDER_OPS = {
     .version = UMF_PROVIDER_OPS_VERSION_CURRENT,
     .initialize = fixed_initialize,
@@ -267,6 +322,8 @@ static umf_memory_provider_ops_t UMF_FIXED_MEMORY_PROVIDER_OPS = {
     .ext.purge_force = fixed_purge_force,
     .ext.allocation_merge = fixed_allocation_merge,
     .ext.allocation_split = fixed_allocation_split,
+    .ext.allocation_resize = fixed_allocation_resize,
+    .ext.trim = fixed_trim,
     .ipc.get_ipc_handle_size = NULL,
     .ipc.get_ipc_handle = NULL,
     .ipc.put_ipc_handle = NULL,
@@ -293,8 +350,13 @@ umf_result_t umfFixedMemoryProviderParamsCreate(
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
+    memset(params, 0, sizeof(*params));
+    params->num_arenas = 1;
+    params->free_high_water_mark = 0;
+
     umf_result_t ret = umfFixedMemoryProviderParamsSetMemory(params, ptr, size);
     if (ret != UMF_RESULT_SUCCESS) {
+        umf_ba_global_free(params->regions);
         umf_ba_global_free(params);
         return ret;
     }
@@ -307,6 +369,7 @@ umf_result_t umfFixedMemoryProviderParamsCreate(
 umf_result_t umfFixedMemoryProviderParamsDestroy(
     umf_fixed_memory_provider_params_handle_t hParams) {
     if (hParams != NULL) {
+        umf_ba_global_free(hParams->regions);
         umf_ba_global_free(hParams);
     }
 
@@ -321,6 +384,28 @@ umf_result_t umfFixedMemoryProviderParamsSetMemory(
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
+    size_t num_regions = hParams->num_regions;
+
+    // replace all memory regions with the given one
+    hParams->num_regions = 0;
+    umf_result_t ret =
+        umfFixedMemoryProviderParamsAddMemory(hParams, ptr, size, -1);
+    if (ret != UMF_RESULT_SUCCESS) {
+        hParams->num_regions = num_regions;
+    }
+
+    return ret;
+}
+
+umf_result_t umfFixedMemoryProviderParamsAddMemory(
+    umf_fixed_memory_provider_params_handle_t hParams, void *ptr, size_t size,
+    int numaNode) {
+
+    if (hParams == NULL) {
+        LOG_ERR("Memory Provider params handle is NULL");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
     if (ptr == NULL) {
         LOG_ERR("Memory pointer is NULL");
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
@@ -331,7 +416,76 @@ umf_result_t umfFixedMemoryProviderParamsSetMemory(
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    hParams->ptr = ptr;
-    hParams->size = size;
+    if (numaNode < -1) {
+        LOG_ERR("Invalid NUMA node: %i", numaNode);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < hParams->num_regions; i++) {
+        fixed_region_t *region = &hParams->regions[i];
+        if ((uintptr_t)ptr < (uintptr_t)region->ptr + region->size &&
+            (uintptr_t)region->ptr < (uintptr_t)ptr + size) {
+            LOG_ERR("Memory region %p (size: %zu) overlaps with the region "
+                    "%p (size: %zu)",
+                    ptr, size, region->ptr, region->size);
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    if (hParams->num_regions == hParams->regions_capacity) {
+        size_t capacity =
+            hParams->regions_capacity ? 2 * hParams->regions_capacity : 1;
+        fixed_region_t *regions =
+            umf_ba_global_alloc(capacity * sizeof(*regions));
+        if (regions == NULL) {
+            LOG_ERR("Allocating memory for the memory regions failed");
+            return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
+        if (hParams->num_regions) {
+            memcpy(regions, hParams->regions,
+                   hParams->num_regions * sizeof(*regions));
+        }
+
+        umf_ba_global_free(hParams->regions);
+        hParams->regions = regions;
+        hParams->regions_capacity = capacity;
+    }
+
+    fixed_region_t *region = &hParams->regions[hParams->num_regions++];
+    region->ptr = ptr;
+    region->size = size;
+    region->numa_node = numaNode;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfFixedMemoryProviderParamsSetNumArenas(
+    umf_fixed_memory_provider_params_handle_t hParams, unsigned numArenas) {
+
+    if (hParams == NULL) {
+        LOG_ERR("Memory Provider params handle is NULL");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (numArenas == 0) {
+        LOG_ERR("Number of arenas must be greater than 0");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    hParams->num_arenas = numArenas;
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfFixedMemoryProviderParamsSetFreeHighWaterMark(
+    umf_fixed_memory_provider_params_handle_t hParams,
+    size_t freeHighWaterMark) {
+
+    if (hParams == NULL) {
+        LOG_ERR("Memory Provider params handle is NULL");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    hParams->free_high_water_mark = freeHighWaterMark;
     return UMF_RESULT_SUCCESS;
 }
@@ -396,6 +396,10 @@ create_fd_for_mmap(umf_os_memory_provider_params_t *in_params,
 
     LOG_DEBUG("size of the anonymous file set to %zu", provider->max_size_fd);
 
+    if (utils_get_file_id(provider->fd, &provider->fd_file_id)) {
+        provider->fd_file_id = 0;
+    }
+
     return UMF_RESULT_SUCCESS;
 
 err_close_file:
@@ -568,6 +572,42 @@ static umf_result_t translate_params(umf_os_memory_provider_params_t *in_params,
     return UMF_RESULT_SUCCESS;
 }
 
+// An entry of the IPC file descriptor cache. It is referenced by the cache
+// and by the mappings opened from its descriptor. The descriptor is closed
+// when the last mapping is closed, so the file of an exited producer is not
+// kept open. The entry is modified with the ipc_fd_cache_lock held
+// for writing, except for n_mappings, which is incremented atomically
+// with the lock held for reading.
+typedef struct os_ipc_fd_t {
+    int fd;              // the local duplicate of the producer's descriptor
+    uint64_t file_id;    // an identifier of the file it refers to
+    uint64_t n_mappings; // mappings opened from fd and not closed yet
+    uintptr_t key;       // the (pid, fd) key of the entry
+    bool cached;         // the entry is in the ipc_fd_cache
+} os_ipc_fd_t;
+
+static void ipc_fd_cache_entry_destroy(uintptr_t key, void *value,
+                                       void *privdata) {
+    (void)key;      // unused
+    (void)privdata; // unused
+
+    os_ipc_fd_t *entry = (os_ipc_fd_t *)value;
+    (void)utils_close_fd(entry->fd);
+    umf_ba_global_free(entry);
+}
+
+// drops the reference of a mapping left opened when the provider is finalized
+static void ipc_fd_mapping_destroy(uintptr_t key, void *value,
+                                   void *privdata) {
+    (void)key;      // unused
+    (void)privdata; // unused
+
+    os_ipc_fd_t *entry = (os_ipc_fd_t *)value;
+    if (--entry->n_mappings == 0 && !entry->cached) {
+        ipc_fd_cache_entry_destroy(0, entry, NULL);
+    }
+}
+
 static umf_result_t os_initialize(void *params, void **provider) {
     umf_result_t ret;
 
@@ -635,6 +675,28 @@ static umf_result_t os_initialize(void *params, void **provider) {
         }
     }
 
+    if (os_provider->IPC_enabled) {
+        os_provider->ipc_fd_cache = critnib_new();
+        if (!os_provider->ipc_fd_cache) {
+            LOG_ERR("creating the IPC file descriptor cache failed");
+            ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+            goto err_destroy_lock_fd;
+        }
+
+        os_provider->ipc_fd_mappings = critnib_new();
+        if (!os_provider->ipc_fd_mappings) {
+            LOG_ERR("creating the map of IPC mappings failed");
+            ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+            goto err_destroy_ipc_fd_cache;
+        }
+
+        if (utils_rwlock_init(&os_provider->ipc_fd_cache_lock) == NULL) {
+            LOG_ERR("initializing the IPC file descriptor cache lock failed");
+            ret = UMF_RESULT_ERROR_UNKNOWN;
+            goto err_destroy_ipc_fd_mappings;
+        }
+    }
+
     os_provider->nodeset_str_buf = umf_ba_global_alloc(NODESET_STR_BUF_LEN);
     if (!os_provider->nodeset_str_buf) {
         LOG_INFO("allocating memory for printing NUMA nodes failed");
@@ -653,6 +715,14 @@ static umf_result_t os_initialize(void *params, void **provider) {
 
     return UMF_RESULT_SUCCESS;
 
+err_destroy_ipc_fd_mappings:
+    critnib_delete(os_provider->ipc_fd_mappings);
+err_destroy_ipc_fd_cache:
+    critnib_delete(os_provider->ipc_fd_cache);
+err_destroy_lock_fd:
+    if (os_provider->fd > 0) {
+        utils_mutex_destroy_not_free(&os_provider->lock_fd);
+    }
 err_destroy_bitmaps:
     free_bitmaps(os_provider);
 err_destroy_critnib:
@@ -673,6 +743,17 @@ static void os_finalize(void *provider) {
 
     critnib_delete(os_provider->fd_offset_map);
 
+    if (os_provider->IPC_enabled) {
+        // mappings that were not closed, then all entries left in the cache
+        (void)critnib_remove_range(os_provider->ipc_fd_mappings, 0,
+                                   UINTPTR_MAX, ipc_fd_mapping_destroy, NULL);
+        critnib_delete(os_provider->ipc_fd_mappings);
+        (void)critnib_remove_range(os_provider->ipc_fd_cache, 0, UINTPTR_MAX,
+                                   ipc_fd_cache_entry_destroy, NULL);
+        critnib_delete(os_provider->ipc_fd_cache);
+        utils_rwlock_destroy_not_free(&os_provider->ipc_fd_cache_lock);
+    }
+
     free_bitmaps(os_provider);
 
     if (os_provider->partitions) {
@@ -748,19 +829,22 @@ static int utils_mmap_aligned(void *hint_addr, size_t length, size_t alignment,
     *fd_offset = 0;
 
     if (fd > 0) {
+        // the offset of the next mapping of the file has to be page-aligned
+        size_t fd_length = ALIGN_UP(extended_length, page_size);
+
         if (utils_mutex_lock(lock_fd)) {
             LOG_ERR("locking file size failed");
             return -1;
         }
 
-        if (*fd_size + extended_length > max_fd_size) {
+        if (*fd_size + fd_length > max_fd_size) {
             utils_mutex_unlock(lock_fd);
             LOG_ERR("cannot grow a file size beyond %zu", max_fd_size);
             return -1;
         }
 
         *fd_offset = *fd_size;
-        *fd_size += extended_length;
+        *fd_size += fd_length;
         utils_mutex_unlock(lock_fd);
     }
 
@@ -1253,6 +1337,7 @@ static umf_result_t os_allocation_merge(void *provider, void *lowPtr,
 typedef struct os_ipc_data_t {
     int pid;
     int fd;
+    uint64_t file_id; // an identifier of the file referred to by fd
     size_t fd_offset;
     size_t size;
     unsigned protection; // combination of OS-specific protection flags
@@ -1276,6 +1361,25 @@ static umf_result_t os_get_ipc_handle_size(void *provider, size_t *size) {
     return UMF_RESULT_SUCCESS;
 }
 
+static void os_fill_ipc_data(os_memory_provider_t *os_provider,
+                             size_t fd_offset, size_t size,
+                             os_ipc_data_t *os_ipc_data) {
+    os_ipc_data->pid = utils_getpid();
+    os_ipc_data->fd_offset = fd_offset;
+    os_ipc_data->size = size;
+    os_ipc_data->protection = os_provider->protection;
+    os_ipc_data->visibility = os_provider->visibility;
+    os_ipc_data->shm_name_len = strlen(os_provider->shm_name);
+    if (os_ipc_data->shm_name_len > 0) {
+        // NOTE: +1 for '\0' at the end of the string
+        strncpy(os_ipc_data->shm_name, os_provider->shm_name,
+                os_ipc_data->shm_name_len + 1);
+    } else {
+        os_ipc_data->fd = os_provider->fd;
+        os_ipc_data->file_id = os_provider->fd_file_id;
+    }
+}
+
 static umf_result_t os_get_ipc_handle(void *provider, const void *ptr,
                                       size_t size, void *providerIpcData) {
     os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
@@ -1290,21 +1394,36 @@ static umf_result_t os_get_ipc_handle(void *provider, const void *ptr,
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    os_ipc_data_t *os_ipc_data = (os_ipc_data_t *)providerIpcData;
-    os_ipc_data->pid = utils_getpid();
-    os_ipc_data->fd_offset = (size_t)value - 1;
-    os_ipc_data->size = size;
-    os_ipc_data->protection = os_provider->protection;
-    os_ipc_data->visibility = os_provider->visibility;
-    os_ipc_data->shm_name_len = strlen(os_provider->shm_name);
-    if (os_ipc_data->shm_name_len > 0) {
-        // NOTE: +1 for '\0' at the end of the string
-        strncpy(os_ipc_data->shm_name, os_provider->shm_name,
-                os_ipc_data->shm_name_len + 1);
-    } else {
-        os_ipc_data->fd = os_provider->fd;
+    os_fill_ipc_data(os_provider, (size_t)value - 1, size,
+                     (os_ipc_data_t *)providerIpcData);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t os_get_ipc_handle_range(void *provider, const void *ptr,
+                                            size_t size,
+                                            void *providerIpcData) {
+    os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
+    if (!os_provider->IPC_enabled) {
+        LOG_ERR("memory visibility mode is not UMF_MEM_MAP_SHARED")
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
+    // the range is a part of the allocation starting at the greatest
+    // address not greater than ptr, it is mapped from the same file
+    uintptr_t alloc_ptr = 0;
+    void *value = NULL;
+    if (!critnib_find(os_provider->fd_offset_map, (uintptr_t)ptr, FIND_LE,
+                      &alloc_ptr, &value) ||
+        value == NULL) {
+        LOG_ERR("getting a value from the IPC cache failed (addr=%p)", ptr);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    size_t fd_offset = (size_t)value - 1 + ((uintptr_t)ptr - alloc_ptr);
+    os_fill_ipc_data(os_provider, fd_offset, size,
+                     (os_ipc_data_t *)providerIpcData);
+
     return UMF_RESULT_SUCCESS;
 }
 
@@ -1338,6 +1457,107 @@ static umf_result_t os_put_ipc_handle(void *provider, void *providerIpcData) {
     return UMF_RESULT_SUCCESS;
 }
 
+static uintptr_t ipc_fd_cache_key(int pid, int fd) {
+    return ((uintptr_t)(unsigned)pid << 32) | (unsigned)fd;
+}
+
+// Returns the cache entry of the local duplicate of the producer's file
+// descriptor from the IPC handle, duplicating it on the first use. On success
+// the read lock of the cache is held, which keeps the entry alive, and
+// the caller has to release it when done with the entry.
+static umf_result_t ipc_fd_cache_acquire(os_memory_provider_t *os_provider,
+                                         os_ipc_data_t *os_ipc_data,
+                                         os_ipc_fd_t **pentry) {
+    uintptr_t key = ipc_fd_cache_key(os_ipc_data->pid, os_ipc_data->fd);
+
+    for (;;) {
+        utils_read_lock(&os_provider->ipc_fd_cache_lock);
+        os_ipc_fd_t *entry = critnib_get(os_provider->ipc_fd_cache, key);
+        if (entry && entry->file_id == os_ipc_data->file_id) {
+            *pentry = entry;
+            return UMF_RESULT_SUCCESS;
+        }
+        utils_read_unlock(&os_provider->ipc_fd_cache_lock);
+
+        int new_fd;
+        umf_result_t umf_result =
+            utils_duplicate_fd(os_ipc_data->pid, os_ipc_data->fd, &new_fd);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            LOG_PERR("duplicating file descriptor failed");
+            return umf_result;
+        }
+
+        // the producer could have exited and its (pid, fd) pair
+        // could have been reused for another file
+        uint64_t file_id = 0;
+        if (utils_get_file_id(new_fd, &file_id) ||
+            file_id != os_ipc_data->file_id) {
+            LOG_ERR("file descriptor %i of process %i does not refer to the "
+                    "file of the IPC handle",
+                    os_ipc_data->fd, os_ipc_data->pid);
+            (void)utils_close_fd(new_fd);
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+
+        utils_write_lock(&os_provider->ipc_fd_cache_lock);
+        entry = critnib_get(os_provider->ipc_fd_cache, key);
+        if (entry && entry->file_id != file_id) {
+            // a stale entry, it is kept by its mappings until they are closed
+            critnib_remove(os_provider->ipc_fd_cache, key);
+            entry->cached = false;
+            if (entry->n_mappings == 0) {
+                ipc_fd_cache_entry_destroy(key, entry, NULL);
+            }
+            entry = NULL;
+        }
+
+        if (entry) {
+            // another thread has already cached it
+            (void)utils_close_fd(new_fd);
+        } else {
+            entry = umf_ba_global_alloc(sizeof(*entry));
+            if (!entry) {
+                utils_write_unlock(&os_provider->ipc_fd_cache_lock);
+                (void)utils_close_fd(new_fd);
+                return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+            }
+
+            entry->fd = new_fd;
+            entry->file_id = file_id;
+            entry->n_mappings = 0;
+            entry->key = key;
+            entry->cached = true;
+            if (critnib_insert(os_provider->ipc_fd_cache, key, entry, 0)) {
+                utils_write_unlock(&os_provider->ipc_fd_cache_lock);
+                LOG_ERR("inserting to the IPC file descriptor cache failed");
+                ipc_fd_cache_entry_destroy(key, entry, NULL);
+                return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+            }
+
+            LOG_DEBUG("cached file descriptor %i of process %i as %i",
+                      os_ipc_data->fd, os_ipc_data->pid, new_fd);
+        }
+        utils_write_unlock(&os_provider->ipc_fd_cache_lock);
+    }
+}
+
+// Drops the reference of the closed mapping to its cache entry and closes
+// the descriptor of the entry if it was the last one.
+static void ipc_fd_cache_release(os_memory_provider_t *os_provider,
+                                 void *ptr) {
+    utils_write_lock(&os_provider->ipc_fd_cache_lock);
+    os_ipc_fd_t *entry =
+        critnib_remove(os_provider->ipc_fd_mappings, (uintptr_t)ptr);
+    if (entry && --entry->n_mappings == 0) {
+        if (entry->cached) {
+            critnib_remove(os_provider->ipc_fd_cache, entry->key);
+        }
+        LOG_DEBUG("closing cached file descriptor %i", entry->fd);
+        ipc_fd_cache_entry_destroy(0, entry, NULL);
+    }
+    utils_write_unlock(&os_provider->ipc_fd_cache_lock);
+}
+
 static umf_result_t os_open_ipc_handle(void *provider, void *providerIpcData,
                                        void **ptr) {
     os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
@@ -1348,6 +1568,7 @@ static umf_result_t os_open_ipc_handle(void *provider, void *providerIpcData,
 
     os_ipc_data_t *os_ipc_data = (os_ipc_data_t *)providerIpcData;
     umf_result_t ret = UMF_RESULT_SUCCESS;
+    os_ipc_fd_t *entry = NULL;
     int fd;
 
     if (os_ipc_data->shm_name_len) {
@@ -1359,12 +1580,13 @@ static umf_result_t os_open_ipc_handle(void *provider, void *providerIpcData,
         }
         (void)utils_shm_unlink(os_ipc_data->shm_name);
     } else {
+        // the cache read lock is held until the mapping is done
         umf_result_t umf_result =
-            utils_duplicate_fd(os_ipc_data->pid, os_ipc_data->fd, &fd);
+            ipc_fd_cache_acquire(os_provider, os_ipc_data, &entry);
         if (umf_result != UMF_RESULT_SUCCESS) {
-            LOG_PERR("duplicating file descriptor failed");
             return umf_result;
         }
+        fd = entry->fd;
     }
 
     *ptr = utils_mmap(NULL, os_ipc_data->size, os_ipc_data->protection,
@@ -1375,7 +1597,24 @@ static umf_result_t os_open_ipc_handle(void *provider, void *providerIpcData,
         ret = UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
     }
 
-    (void)utils_close_fd(fd);
+    if (entry && *ptr) {
+        // the mapping keeps the entry until it is closed
+        if (critnib_insert(os_provider->ipc_fd_mappings, (uintptr_t)*ptr,
+                           entry, 0)) {
+            LOG_ERR("inserting to the map of IPC mappings failed");
+            (void)utils_munmap(*ptr, os_ipc_data->size);
+            *ptr = NULL;
+            ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        } else {
+            utils_atomic_increment(&entry->n_mappings);
+        }
+    }
+
+    if (os_ipc_data->shm_name_len) {
+        (void)utils_close_fd(fd);
+    } else {
+        utils_read_unlock(&os_provider->ipc_fd_cache_lock);
+    }
 
     return ret;
 }
@@ -1398,6 +1637,8 @@ static umf_result_t os_close_ipc_handle(void *provider, void *ptr,
         return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
     }
 
+    ipc_fd_cache_release(os_provider, ptr);
+
     return UMF_RESULT_SUCCESS;
 }
 
@@ -1419,7 +1660,8 @@ static umf_memory_provider_ops_t UMF_OS_MEMORY_PROVIDER_OPS = {
     .ipc.get_ipc_handle = os_get_ipc_handle,
     .ipc.put_ipc_handle = os_put_ipc_handle,
     .ipc.open_ipc_handle = os_open_ipc_handle,
-    .ipc.close_ipc_handle = os_close_ipc_handle};
+    .ipc.close_ipc_handle = os_close_ipc_handle,
+    .ipc.get_ipc_handle_range = os_get_ipc_handle_range};
 
 umf_memory_provider_ops_t *umfOsMemoryProviderOps(void) {
     return &UMF_OS_MEMORY_PROVIDER_OPS;
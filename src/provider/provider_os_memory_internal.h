@@ -49,6 +49,20 @@ typedef struct os_memory_provider_t {
     // to mmap a specific part of a file.
     critnib *fd_offset_map;
 
+    // an identifier of the file referred to by fd (0 if unknown),
+    // passed in IPC handles to detect reused (pid, fd) pairs
+    uint64_t fd_file_id;
+
+    // A critnib map storing file descriptors duplicated from producer
+    // processes in the open_ipc_handle hook, keyed by the (pid, fd) pair of
+    // the producer's file descriptor. All allocations of one producer share
+    // the same fd, so each of them is mapped from the same duplicate.
+    critnib *ipc_fd_cache;
+    // maps the opened IPC mappings to the entries of the ipc_fd_cache
+    // they were mapped from, the last one closes the duplicate
+    critnib *ipc_fd_mappings;
+    utils_rwlock_t ipc_fd_cache_lock;
+
     // NUMA config
     umf_numa_mode_t mode;
     hwloc_bitmap_t *nodeset;
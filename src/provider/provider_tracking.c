@@ -12,9 +12,11 @@
 #include "critnib.h"
 #include "ipc_cache.h"
 #include "ipc_internal.h"
+#include "memory_provider_internal.h"
 #include "utils_common.h"
 #include "utils_concurrency.h"
 #include "utils_log.h"
+#include "utlist.h"
 
 #include <umf/memory_pool.h>
 #include <umf/memory_provider.h>
@@ -22,29 +24,307 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 uint64_t IPC_HANDLE_ID = 0;
 
+// Number of locks serializing splits and merges of tracked regions.
+// A region is guarded by the lock selected by hashing its base address,
+// so splits and merges of unrelated regions do not contend with each other.
+// Must be a power of 2.
+#define TRACKER_SPLIT_MERGE_LOCKS 64
+
+// The ranges_map is read without any lock, so the values removed from it
+// and the destroyed shards are not freed at once. They are retired and freed
+// only after that many later retirements (the same grace period scheme
+// as the DELETED_LIFE of the critnib), which is much longer than a lookup.
+#define TRACKER_RANGES_DELETED_LIFE 64
+#define TRACKER_SHARDS_DELETED_LIFE 8
+
+// The global tracker does not keep track of every allocation.
+// It is a directory of non-overlapping address ranges, each of them owned
+// by a tracker shard. Every tracking provider (so every pool) owns its own
+// shard holding its allocated regions. A range is added to the directory
+// the first time a shard allocates memory from outside of its ranges
+// and it is kept there after the memory is freed, so allocating the same
+// address range again (the common case) touches only the shard.
+// When another shard allocates memory from that range, the range is carved
+// and the new owner gets the allocated part.
 struct umf_memory_tracker_t {
+    umf_ba_pool_t *range_allocator;
+    critnib *ranges_map;
+    // Values of the ranges_map are never modified in place: they are
+    // replaced and retired when ranges are added or carved, so lookups
+    // do not take any lock. The ranges_lock serializes the writers
+    // and walks take it for reading to keep the shards alive.
+    utils_rwlock_t ranges_lock;
+    // guarded by the ranges_lock held for writing
+    struct tracker_range_t *retired_ranges[TRACKER_RANGES_DELETED_LIFE];
+    size_t retired_ranges_idx;
+    struct umf_memory_tracker_shard_t
+        *retired_shards[TRACKER_SHARDS_DELETED_LIFE];
+    size_t retired_shards_idx;
+};
+
+typedef struct umf_memory_tracker_shard_t {
+    umf_memory_tracker_handle_t hTracker;
+    umf_memory_pool_handle_t pool;
     umf_ba_pool_t *alloc_info_allocator;
     critnib *alloc_segments_map;
-    utils_mutex_t splitMergeMutex;
-};
+    utils_mutex_t splitMergeLocks[TRACKER_SPLIT_MERGE_LOCKS];
+} umf_memory_tracker_shard_t;
+
+typedef umf_memory_tracker_shard_t *umf_memory_tracker_shard_handle_t;
+
+typedef struct tracker_range_t {
+    umf_memory_tracker_shard_handle_t shard;
+    size_t size;
+} tracker_range_t;
 
 typedef struct tracker_alloc_info_t {
     umf_memory_pool_handle_t pool;
     size_t size;
 } tracker_alloc_info_t;
 
-static umf_result_t umfMemoryTrackerAdd(umf_memory_tracker_handle_t hTracker,
-                                        umf_memory_pool_handle_t pool,
-                                        const void *ptr, size_t size) {
+static inline size_t split_merge_lock_index(const void *ptr) {
+    // Tracked regions are at least page-aligned, so drop the low bits
+    // and spread the rest with the Fibonacci hashing multiplier.
+    uint64_t h = ((uint64_t)(uintptr_t)ptr >> 12) * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(h >> 32) & (TRACKER_SPLIT_MERGE_LOCKS - 1);
+}
+
+static inline utils_mutex_t *
+split_merge_lock(umf_memory_tracker_shard_handle_t hShard, const void *ptr) {
+    return &hShard->splitMergeLocks[split_merge_lock_index(ptr)];
+}
+
+// Locks guarding two regions are always taken in the order of their indices
+// to avoid a deadlock between concurrent merges sharing one of the regions.
+static int split_merge_lock_pair(umf_memory_tracker_shard_handle_t hShard,
+                                 const void *ptr1, const void *ptr2) {
+    size_t idx1 = split_merge_lock_index(ptr1);
+    size_t idx2 = split_merge_lock_index(ptr2);
+    if (idx1 > idx2) {
+        size_t tmp = idx1;
+        idx1 = idx2;
+        idx2 = tmp;
+    }
+
+    if (utils_mutex_lock(&hShard->splitMergeLocks[idx1])) {
+        return -1;
+    }
+
+    if (idx1 != idx2 && utils_mutex_lock(&hShard->splitMergeLocks[idx2])) {
+        utils_mutex_unlock(&hShard->splitMergeLocks[idx1]);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void split_merge_unlock_pair(umf_memory_tracker_shard_handle_t hShard,
+                                    const void *ptr1, const void *ptr2) {
+    size_t idx1 = split_merge_lock_index(ptr1);
+    size_t idx2 = split_merge_lock_index(ptr2);
+    if (idx1 != idx2) {
+        utils_mutex_unlock(&hShard->splitMergeLocks[idx2]);
+    }
+    utils_mutex_unlock(&hShard->splitMergeLocks[idx1]);
+}
+
+// Retires a value removed from the ranges_map. A lock-free lookup may still
+// read it, so it is freed only after TRACKER_RANGES_DELETED_LIFE later
+// retirements. Must be called with the ranges_lock held for writing.
+static void tracker_range_retire(umf_memory_tracker_handle_t hTracker,
+                                 tracker_range_t *value) {
+    size_t idx = hTracker->retired_ranges_idx;
+    tracker_range_t *oldest = hTracker->retired_ranges[idx];
+    hTracker->retired_ranges[idx] = value;
+    hTracker->retired_ranges_idx = (idx + 1) % TRACKER_RANGES_DELETED_LIFE;
+
+    if (oldest) {
+        umf_ba_free(hTracker->range_allocator, oldest);
+    }
+}
+
+static int tracker_range_covers(tracker_range_t *range, uintptr_t key,
+                                uintptr_t ptr, size_t size) {
+    return key <= ptr && ptr + size <= key + range->size;
+}
+
+// Sets the range [key, key + size) owned by shard in the ranges_map.
+// Must be called with the ranges_lock held for writing.
+static umf_result_t tracker_range_set(umf_memory_tracker_handle_t hTracker,
+                                      umf_memory_tracker_shard_handle_t shard,
+                                      uintptr_t key, size_t size) {
+    tracker_range_t *value = umf_ba_alloc(hTracker->range_allocator);
+    if (!value) {
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    value->shard = shard;
+    value->size = size;
+
+    tracker_range_t *old = critnib_get(hTracker->ranges_map, key);
+    int ret = critnib_insert(hTracker->ranges_map, key, value, 1 /* update */);
+    if (ret) {
+        umf_ba_free(hTracker->range_allocator, value);
+        return ret == ENOMEM ? UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY
+                             : UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    if (old) {
+        tracker_range_retire(hTracker, old);
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// Makes sure [ptr, ptr + size) belongs to a range owned by the shard.
+// Parts of ranges of other shards overlapping with [ptr, ptr + size)
+// must not contain any live allocations, so they are carved out.
+static umf_result_t
+umfMemoryTrackerRangeAdd(umf_memory_tracker_shard_handle_t hShard,
+                         const void *ptr, size_t size) {
+    umf_memory_tracker_handle_t hTracker = hShard->hTracker;
+    uintptr_t start = (uintptr_t)ptr;
+    uintptr_t end = start + size;
+    uintptr_t rkey;
+    tracker_range_t *rvalue;
+    umf_result_t ret = UMF_RESULT_SUCCESS;
+
+    // fast path - the shard already owns this address range
+    int owned = critnib_find(hTracker->ranges_map, start, FIND_LE, &rkey,
+                             (void **)&rvalue) &&
+                rvalue->shard == hShard &&
+                tracker_range_covers(rvalue, rkey, start, size);
+    if (owned) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (utils_write_lock(&hTracker->ranges_lock)) {
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    // a range starting at or below ptr, overlapping or adjacent
+    if (critnib_find(hTracker->ranges_map, start, FIND_LE, &rkey,
+                     (void **)&rvalue) &&
+        rkey + rvalue->size >= start) {
+        uintptr_t rend = rkey + rvalue->size;
+        if (rvalue->shard == hShard) {
+            if (rend >= end) {
+                // another thread has already added this range
+                goto unlock;
+            }
+            start = rkey;
+        } else if (rend > start) {
+            if (rend > end) {
+                ret = tracker_range_set(hTracker, rvalue->shard, end,
+                                        rend - end);
+                if (ret != UMF_RESULT_SUCCESS) {
+                    goto unlock;
+                }
+            }
+
+            if (rkey < start) {
+                ret = tracker_range_set(hTracker, rvalue->shard, rkey,
+                                        start - rkey);
+                if (ret != UMF_RESULT_SUCCESS) {
+                    goto unlock;
+                }
+            } else {
+                critnib_remove(hTracker->ranges_map, rkey);
+                tracker_range_retire(hTracker, rvalue);
+            }
+        }
+    }
+
+    // ranges starting above ptr, overlapping or adjacent
+    while (critnib_find(hTracker->ranges_map, (uintptr_t)ptr, FIND_G, &rkey,
+                        (void **)&rvalue) &&
+           rkey <= end) {
+        uintptr_t rend = rkey + rvalue->size;
+        if (rvalue->shard == hShard) {
+            // merge it into the new range
+            if (rend > end) {
+                end = rend;
+            }
+            ret = tracker_range_set(hTracker, hShard, start, end - start);
+        } else if (rkey == end) {
+            break;
+        } else if (rend > end) {
+            ret = tracker_range_set(hTracker, rvalue->shard, end, rend - end);
+        }
+
+        if (ret != UMF_RESULT_SUCCESS) {
+            goto unlock;
+        }
+
+        critnib_remove(hTracker->ranges_map, rkey);
+        tracker_range_retire(hTracker, rvalue);
+    }
+
+    ret = tracker_range_set(hTracker, hShard, start, end - start);
+    if (ret == UMF_RESULT_SUCCESS) {
+        LOG_DEBUG("address range added to the tracker, shard=%p, start=%p, "
+                  "size=%zu",
+                  (void *)hShard, (void *)start, (size_t)(end - start));
+    }
+
+unlock:
+    utils_write_unlock(&hTracker->ranges_lock);
+
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("failed to add address range to the tracker, ptr=%p, size=%zu",
+                ptr, size);
+    }
+
+    return ret;
+}
+
+// Removes all ranges owned by the shard from the ranges_map and retires
+// the shard, because a lock-free lookup may still use it. Returns the oldest
+// retired shard, which can be freed now, or NULL.
+static umf_memory_tracker_shard_handle_t
+umfMemoryTrackerShardRetire(umf_memory_tracker_handle_t hTracker,
+                            umf_memory_tracker_shard_handle_t hShard) {
+    uintptr_t rkey;
+    tracker_range_t *rvalue;
+    uintptr_t last_key = 0;
+
+    utils_write_lock(&hTracker->ranges_lock);
+
+    // the key 0 is never used
+    while (1 == critnib_find(hTracker->ranges_map, last_key, FIND_G, &rkey,
+                             (void **)&rvalue)) {
+        if (rvalue->shard == hShard) {
+            critnib_remove(hTracker->ranges_map, rkey);
+            tracker_range_retire(hTracker, rvalue);
+        }
+
+        last_key = rkey;
+    }
+
+    size_t idx = hTracker->retired_shards_idx;
+    umf_memory_tracker_shard_handle_t oldest = hTracker->retired_shards[idx];
+    hTracker->retired_shards[idx] = hShard;
+    hTracker->retired_shards_idx = (idx + 1) % TRACKER_SHARDS_DELETED_LIFE;
+
+    utils_write_unlock(&hTracker->ranges_lock);
+
+    return oldest;
+}
+
+static umf_result_t
+umfMemoryTrackerAdd(umf_memory_tracker_shard_handle_t hShard,
+                    umf_memory_pool_handle_t pool, const void *ptr,
+                    size_t size) {
     assert(ptr);
 
-    tracker_alloc_info_t *value = umf_ba_alloc(hTracker->alloc_info_allocator);
+    tracker_alloc_info_t *value = umf_ba_alloc(hShard->alloc_info_allocator);
     if (value == NULL) {
         LOG_ERR("failed to allocate tracker value, ptr=%p, size=%zu", ptr,
                 size);
@@ -55,19 +335,19 @@ static umf_result_t umfMemoryTrackerAdd(umf_memory_tracker_handle_t hTracker,
     value->size = size;
 
     int ret =
-        critnib_insert(hTracker->alloc_segments_map, (uintptr_t)ptr, value, 0);
+        critnib_insert(hShard->alloc_segments_map, (uintptr_t)ptr, value, 0);
 
     if (ret == 0) {
         LOG_DEBUG(
-            "memory region is added, tracker=%p, ptr=%p, pool=%p, size=%zu",
-            (void *)hTracker, ptr, (void *)pool, size);
+            "memory region is added, shard=%p, ptr=%p, pool=%p, size=%zu",
+            (void *)hShard, ptr, (void *)pool, size);
         return UMF_RESULT_SUCCESS;
     }
 
     LOG_ERR("failed to insert tracker value, ret=%d, ptr=%p, pool=%p, size=%zu",
             ret, ptr, (void *)pool, size);
 
-    umf_ba_free(hTracker->alloc_info_allocator, value);
+    umf_ba_free(hShard->alloc_info_allocator, value);
 
     if (ret == ENOMEM) {
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
@@ -76,8 +356,23 @@ static umf_result_t umfMemoryTrackerAdd(umf_memory_tracker_handle_t hTracker,
     return UMF_RESULT_ERROR_UNKNOWN;
 }
 
-static umf_result_t umfMemoryTrackerRemove(umf_memory_tracker_handle_t hTracker,
-                                           const void *ptr) {
+// Adds a new region allocated from the upstream provider:
+// its address range has to be owned by the shard first.
+static umf_result_t
+umfMemoryTrackerAddRegion(umf_memory_tracker_shard_handle_t hShard,
+                          umf_memory_pool_handle_t pool, const void *ptr,
+                          size_t size) {
+    umf_result_t ret = umfMemoryTrackerRangeAdd(hShard, ptr, size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    return umfMemoryTrackerAdd(hShard, pool, ptr, size);
+}
+
+static umf_result_t
+umfMemoryTrackerRemove(umf_memory_tracker_shard_handle_t hShard,
+                       const void *ptr) {
     assert(ptr);
 
     // TODO: there is no support for removing partial ranges (or multiple entries
@@ -85,18 +380,25 @@ static umf_result_t umfMemoryTrackerRemove(umf_memory_tracker_handle_t hTracker,
     // Every umfMemoryTrackerAdd(..., ptr, ...) should have a corresponding
     // umfMemoryTrackerRemove call with the same ptr value.
 
-    void *value = critnib_remove(hTracker->alloc_segments_map, (uintptr_t)ptr);
+    // values are freed only with the split/merge lock of their key held,
+    // see shard_walk()
+    utils_mutex_t *lock = split_merge_lock(hShard, ptr);
+    utils_mutex_lock(lock);
+
+    void *value = critnib_remove(hShard->alloc_segments_map, (uintptr_t)ptr);
     if (!value) {
+        utils_mutex_unlock(lock);
         LOG_ERR("pointer %p not found in the alloc_segments_map", ptr);
         return UMF_RESULT_ERROR_UNKNOWN;
     }
 
     tracker_alloc_info_t *v = value;
 
-    LOG_DEBUG("memory region removed: tracker=%p, ptr=%p, size=%zu",
-              (void *)hTracker, ptr, v->size);
+    LOG_DEBUG("memory region removed: shard=%p, ptr=%p, size=%zu",
+              (void *)hShard, ptr, v->size);
 
-    umf_ba_free(hTracker->alloc_info_allocator, value);
+    umf_ba_free(hShard->alloc_info_allocator, value);
+    utils_mutex_unlock(lock);
 
     return UMF_RESULT_SUCCESS;
 }
@@ -124,24 +426,172 @@ umf_result_t umfMemoryTrackerGetAllocInfo(const void *ptr,
         return UMF_RESULT_ERROR_NOT_SUPPORTED;
     }
 
-    if (TRACKER->alloc_segments_map == NULL) {
-        LOG_ERR("tracker's alloc_segments_map does not exist");
+    if (TRACKER->ranges_map == NULL) {
+        LOG_ERR("tracker's ranges_map does not exist");
         return UMF_RESULT_ERROR_NOT_SUPPORTED;
     }
 
+    // No lock is taken here: values of the ranges_map and the shards
+    // are retired instead of being freed at once (see tracker_range_retire).
+    umf_result_t ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
     uintptr_t rkey;
+    tracker_range_t *range;
+    int found = critnib_find(TRACKER->ranges_map, (uintptr_t)ptr, FIND_LE,
+                             &rkey, (void **)&range);
+    if (!found || (uintptr_t)ptr >= rkey + range->size) {
+        goto not_found;
+    }
+
     tracker_alloc_info_t *rvalue;
-    int found = critnib_find(TRACKER->alloc_segments_map, (uintptr_t)ptr,
-                             FIND_LE, (void *)&rkey, (void **)&rvalue);
+    found = critnib_find(range->shard->alloc_segments_map, (uintptr_t)ptr,
+                         FIND_LE, &rkey, (void **)&rvalue);
     if (!found || (uintptr_t)ptr >= rkey + rvalue->size) {
-        LOG_DEBUG("pointer %p not found in the tracker, TRACKER=%p", ptr,
-                  (void *)TRACKER);
-        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto not_found;
     }
 
     pAllocInfo->base = (void *)rkey;
     pAllocInfo->baseSize = rvalue->size;
     pAllocInfo->pool = rvalue->pool;
+    ret = UMF_RESULT_SUCCESS;
+
+not_found:
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_DEBUG("pointer %p not found in the tracker, TRACKER=%p", ptr,
+                  (void *)TRACKER);
+    }
+
+    return ret;
+}
+
+// Walks the regions of the shard in the [min, max] address range.
+// Values of the alloc_segments_map are replaced and freed only with
+// the split/merge lock of their key held, so every region is copied
+// with that lock held and the callback is called without any lock.
+// Only the region being copied is blocked. A region split concurrently
+// may be reported twice: as a whole and then as its second part.
+static int shard_walk(umf_memory_tracker_shard_handle_t hShard, uintptr_t min,
+                      uintptr_t max, umf_region_walk_cb_t cb, void *arg) {
+    uintptr_t rkey;
+
+    while (1 == critnib_find(hShard->alloc_segments_map, min, FIND_GE, &rkey,
+                             NULL) &&
+           rkey <= max) {
+        utils_mutex_t *lock = split_merge_lock(hShard, (void *)rkey);
+        utils_mutex_lock(lock);
+
+        tracker_alloc_info_t *value = (tracker_alloc_info_t *)critnib_get(
+            hShard->alloc_segments_map, rkey);
+        umf_tracked_region_t region = {(void *)rkey, 0, NULL};
+        if (value) {
+            region.size = value->size;
+            region.pool = value->pool;
+        }
+
+        utils_mutex_unlock(lock);
+
+        // skip the region if it was freed after it was found
+        if (value) {
+            int ret = cb(&region, arg);
+            if (ret) {
+                return ret;
+            }
+        }
+
+        if (rkey == max) {
+            break;
+        }
+        min = rkey + 1;
+    }
+
+    return 0;
+}
+
+#define TRACKER_WALK_BATCH_SIZE 64
+
+typedef struct tracker_walk_batch_t {
+    umf_tracked_region_t regions[TRACKER_WALK_BATCH_SIZE];
+    size_t n;
+} tracker_walk_batch_t;
+
+static int tracker_walk_batch_add(const umf_tracked_region_t *region,
+                                  void *arg) {
+    tracker_walk_batch_t *batch = (tracker_walk_batch_t *)arg;
+    batch->regions[batch->n++] = *region;
+    return batch->n == TRACKER_WALK_BATCH_SIZE;
+}
+
+// Collects the next batch of regions starting at *cursor and moves
+// the cursor past them. Returns true when there are no more regions.
+// It has to be called with the ranges_lock held for reading, which keeps
+// the ranges and their shards alive.
+static bool tracker_walk_collect(umf_memory_tracker_handle_t hTracker,
+                                 uintptr_t *cursor,
+                                 tracker_walk_batch_t *batch) {
+    uintptr_t rkey;
+    void *rvalue;
+
+    while (batch->n < TRACKER_WALK_BATCH_SIZE) {
+        // the range containing the cursor or the next one
+        int found = critnib_find(hTracker->ranges_map, *cursor, FIND_LE, &rkey,
+                                 &rvalue);
+        if (!found ||
+            *cursor - rkey >= ((tracker_range_t *)rvalue)->size) {
+            found = critnib_find(hTracker->ranges_map, *cursor, FIND_GE,
+                                 &rkey, &rvalue);
+            if (!found) {
+                return true;
+            }
+        }
+
+        tracker_range_t *range = (tracker_range_t *)rvalue;
+        uintptr_t min = rkey > *cursor ? rkey : *cursor;
+        uintptr_t max = rkey + range->size - 1;
+
+        if (shard_walk(range->shard, min, max, tracker_walk_batch_add,
+                       batch)) {
+            // the batch is full, continue after its last region
+            *cursor =
+                (uintptr_t)batch->regions[TRACKER_WALK_BATCH_SIZE - 1].base +
+                1;
+            return false;
+        }
+
+        if (max == UINTPTR_MAX) {
+            return true;
+        }
+        *cursor = max + 1;
+    }
+
+    return false;
+}
+
+umf_result_t umfMemoryTrackerWalk(umf_region_walk_cb_t cb, void *arg) {
+    assert(cb);
+
+    if (TRACKER == NULL) {
+        LOG_ERR("tracker does not exist");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    // The regions are copied in batches under the ranges_lock and the callback
+    // is called without any lock held, so it can use UMF pools.
+    uintptr_t cursor = 0;
+    bool done = false;
+    tracker_walk_batch_t batch;
+
+    while (!done) {
+        batch.n = 0;
+
+        utils_read_lock(&TRACKER->ranges_lock);
+        done = tracker_walk_collect(TRACKER, &cursor, &batch);
+        utils_read_unlock(&TRACKER->ranges_lock);
+
+        for (size_t i = 0; i < batch.n; i++) {
+            if (cb(&batch.regions[i], arg)) {
+                return UMF_RESULT_SUCCESS;
+            }
+        }
+    }
 
     return UMF_RESULT_SUCCESS;
 }
@@ -152,19 +602,198 @@ umf_result_t umfMemoryTrackerGetAllocInfo(const void *ptr,
 typedef struct ipc_cache_value_t {
     uint64_t handle_id;
     uint64_t ipcDataSize;
+    void *ptr;         // the allocation the IPC handle was retrieved for
+    uint64_t accessed; // set on a cache hit, cleared by the clock hand
+    uint64_t n_gets;   // handles got and not put yet, they pin the entry
+    struct ipc_cache_value_t *prev, *next; // the clock list
     char providerIpcData[];
 } ipc_cache_value_t;
 
+// The default limit of the number of IPC handles cached by a provider,
+// it can be changed with UMF_IPC_CACHE="max_handles=<number>" (0 - unlimited).
+#define IPC_HANDLE_CACHE_DEFAULT_MAX_SIZE 16384
+
+// Producer-side cache of the IPC handles of the allocations of a provider.
+// It is bounded and the least recently used entries are evicted with
+// the clock algorithm. The upstream IPC handle of an entry is put lazily,
+// when the entry is evicted or the allocation is freed. Only entries whose
+// handles have all been put are evicted, so a handle held by the user
+// stays valid even if the cache is above its limit.
+typedef struct ipc_handle_cache_t {
+    critnib *map; // maps the allocation pointer to ipc_cache_value_t
+    // Lookups hold the lock for reading while they copy the cached handle,
+    // so entries are unlinked and freed only with the lock held for writing.
+    utils_rwlock_t lock;
+    ipc_cache_value_t *clock_list;
+    ipc_cache_value_t *clock_hand;
+    size_t size;
+    size_t max_size;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} ipc_handle_cache_t;
+
+// The default number of threads opening the prefetched IPC handles,
+// it can be changed with UMF_IPC_CACHE="prefetch_threads=<number>".
+#define IPC_PREFETCH_DEFAULT_THREADS 2
+
+// The maximum number of IPC handles waiting to be prefetched,
+// prefetch requests above the limit are dropped.
+#define IPC_PREFETCH_MAX_QUEUED 1024
+
+// A copy of the IPC handle (umf_ipc_data_t followed by the upstream
+// IPC handle) to be opened by a prefetch thread.
+typedef struct ipc_prefetch_request_t {
+    struct ipc_prefetch_request_t *prev, *next;
+    umf_ipc_data_t *ipcData;
+} ipc_prefetch_request_t;
+
+// Queue of the IPC handles opened in advance by umfPrefetchIPCHandle().
+// The threads are started on the first prefetch request.
+typedef struct ipc_prefetch_queue_t {
+    utils_mutex_t lock;
+    utils_cond_t cond;
+    ipc_prefetch_request_t *requests;
+    size_t n_requests;
+    bool stop;
+    size_t n_threads;
+    utils_thread_t *threads;
+} ipc_prefetch_queue_t;
+
 typedef struct umf_tracking_memory_provider_t {
     umf_memory_provider_handle_t hUpstream;
-    umf_memory_tracker_handle_t hTracker;
+    umf_memory_tracker_shard_handle_t hShard;
     umf_memory_pool_handle_t pool;
-    critnib *ipcCache;
+    ipc_handle_cache_t *ipcCache;
     ipc_opened_cache_handle_t hIpcMappedCache;
+    // maps the base address of an opened IPC handle to its cache entry
+    critnib *ipcMappedPtrs;
+    ipc_prefetch_queue_t *ipcPrefetch;
 } umf_tracking_memory_provider_t;
 
 typedef struct umf_tracking_memory_provider_t umf_tracking_memory_provider_t;
 
+static ipc_handle_cache_t *ipcHandleCacheCreate(void) {
+    ipc_handle_cache_t *cache = umf_ba_global_alloc(sizeof(*cache));
+    if (!cache) {
+        return NULL;
+    }
+
+    memset(cache, 0, sizeof(*cache));
+
+    cache->map = critnib_new();
+    if (!cache->map) {
+        goto err_free_cache;
+    }
+
+    if (utils_rwlock_init(&cache->lock) == NULL) {
+        goto err_delete_map;
+    }
+
+    cache->max_size = umfIpcCacheEnvLimit("max_handles=",
+                                          IPC_HANDLE_CACHE_DEFAULT_MAX_SIZE);
+
+    return cache;
+
+err_delete_map:
+    critnib_delete(cache->map);
+err_free_cache:
+    umf_ba_global_free(cache);
+    return NULL;
+}
+
+static void ipcHandleCachePut(umf_tracking_memory_provider_t *p,
+                              ipc_cache_value_t *cache_value) {
+    umf_result_t ret = umfMemoryProviderPutIPCHandle(
+        p->hUpstream, cache_value->providerIpcData);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("upstream provider failed to put IPC handle, ptr=%p, ret = %d",
+                cache_value->ptr, ret);
+    }
+    umf_ba_global_free(cache_value);
+}
+
+// Unlinks the entry from the cache, the lock has to be held for writing.
+static void ipcHandleCacheUnlink(ipc_handle_cache_t *cache,
+                                 ipc_cache_value_t *cache_value) {
+    critnib_remove(cache->map, (uintptr_t)cache_value->ptr);
+    if (cache->clock_hand == cache_value) {
+        cache->clock_hand = cache_value->next;
+    }
+    DL_DELETE(cache->clock_list, cache_value);
+    cache->size--;
+}
+
+// Runs the clock hand over the cache and unlinks entries that were not used
+// recently and have no outstanding handles until the cache fits its limit.
+// The hand makes at most two turns (the first one may only clear the accessed
+// bits), so the cache stays above the limit if all entries are in use.
+// The unlinked entries are returned in the `evicted` list.
+// The lock has to be held for writing.
+static void ipcHandleCacheTrim(ipc_handle_cache_t *cache,
+                               ipc_cache_value_t **evicted) {
+    size_t steps = 2 * cache->size;
+    while (cache->max_size && cache->size > cache->max_size && steps--) {
+        ipc_cache_value_t *cache_value =
+            cache->clock_hand ? cache->clock_hand : cache->clock_list;
+        cache->clock_hand = cache_value->next;
+
+        if (cache_value->n_gets) {
+            continue;
+        }
+
+        if (cache_value->accessed) {
+            cache_value->accessed = 0;
+            continue;
+        }
+
+        ipcHandleCacheUnlink(cache, cache_value);
+        DL_APPEND(*evicted, cache_value);
+        utils_atomic_increment(&cache->evictions);
+    }
+}
+
+// Removes the IPC handle of the freed allocation from the cache
+// and puts it to the upstream provider.
+static void ipcHandleCacheRemove(umf_tracking_memory_provider_t *p,
+                                 const void *ptr) {
+    ipc_handle_cache_t *cache = p->ipcCache;
+
+    // most allocations never have an IPC handle
+    if (critnib_get(cache->map, (uintptr_t)ptr) == NULL) {
+        return;
+    }
+
+    utils_write_lock(&cache->lock);
+    ipc_cache_value_t *cache_value = critnib_get(cache->map, (uintptr_t)ptr);
+    if (cache_value) {
+        ipcHandleCacheUnlink(cache, cache_value);
+    }
+    utils_write_unlock(&cache->lock);
+
+    if (cache_value) {
+        ipcHandleCachePut(p, cache_value);
+    }
+}
+
+static void ipcHandleCacheDestroy(umf_tracking_memory_provider_t *p) {
+    ipc_handle_cache_t *cache = p->ipcCache;
+    ipc_cache_value_t *cache_value, *tmp;
+
+    LOG_DEBUG("IPC handle cache of pool %p: hits=%" PRIu64 ", misses=%" PRIu64
+              ", evictions=%" PRIu64,
+              (void *)p->pool, cache->hits, cache->misses, cache->evictions);
+
+    DL_FOREACH_SAFE(cache->clock_list, cache_value, tmp) {
+        DL_DELETE(cache->clock_list, cache_value);
+        ipcHandleCachePut(p, cache_value);
+    }
+
+    utils_rwlock_destroy_not_free(&cache->lock);
+    critnib_delete(cache->map);
+    umf_ba_global_free(cache);
+}
+
 static umf_result_t trackingAlloc(void *hProvider, size_t size,
                                   size_t alignment, void **ptr) {
     umf_tracking_memory_provider_t *p =
@@ -178,7 +807,8 @@ static umf_result_t trackingAlloc(void *hProvider, size_t size,
         return ret;
     }
 
-    umf_result_t ret2 = umfMemoryTrackerAdd(p->hTracker, p->pool, *ptr, size);
+    umf_result_t ret2 =
+        umfMemoryTrackerAddRegion(p->hShard, p->pool, *ptr, size);
     if (ret2 != UMF_RESULT_SUCCESS) {
         LOG_ERR("failed to add allocated region to the tracker, ptr = %p, size "
                 "= %zu, ret = %d",
@@ -196,7 +826,7 @@ static umf_result_t trackingAllocationSplit(void *hProvider, void *ptr,
         (umf_tracking_memory_provider_t *)hProvider;
 
     tracker_alloc_info_t *splitValue =
-        umf_ba_alloc(provider->hTracker->alloc_info_allocator);
+        umf_ba_alloc(provider->hShard->alloc_info_allocator);
     if (!splitValue) {
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
@@ -204,13 +834,16 @@ static umf_result_t trackingAllocationSplit(void *hProvider, void *ptr,
     splitValue->pool = provider->pool;
     splitValue->size = firstSize;
 
-    int r = utils_mutex_lock(&provider->hTracker->splitMergeMutex);
+    // Only the region being split is modified (the new high part is not
+    // visible to anyone else yet), so its lock is sufficient.
+    utils_mutex_t *lock = split_merge_lock(provider->hShard, ptr);
+    int r = utils_mutex_lock(lock);
     if (r) {
         goto err_lock;
     }
 
     tracker_alloc_info_t *value = (tracker_alloc_info_t *)critnib_get(
-        provider->hTracker->alloc_segments_map, (uintptr_t)ptr);
+        provider->hShard->alloc_segments_map, (uintptr_t)ptr);
     if (!value) {
         LOG_ERR("region for split is not found in the tracker");
         ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
@@ -235,7 +868,7 @@ static umf_result_t trackingAllocationSplit(void *hProvider, void *ptr,
 
     // We'll have a duplicate entry for the range [highPtr, highValue->size] but this is fine,
     // the value is the same anyway and we forbid removing that range concurrently
-    ret = umfMemoryTrackerAdd(provider->hTracker, provider->pool, highPtr,
+    ret = umfMemoryTrackerAdd(provider->hShard, provider->pool, highPtr,
                               secondSize);
     if (ret != UMF_RESULT_SUCCESS) {
         LOG_ERR("failed to add split region to the tracker, ptr = %p, size "
@@ -248,22 +881,22 @@ static umf_result_t trackingAllocationSplit(void *hProvider, void *ptr,
     }
 
     int cret =
-        critnib_insert(provider->hTracker->alloc_segments_map, (uintptr_t)ptr,
+        critnib_insert(provider->hShard->alloc_segments_map, (uintptr_t)ptr,
                        (void *)splitValue, 1 /* update */);
     // this cannot fail since we know the element exists (nothing to allocate)
     assert(cret == 0);
     (void)cret;
 
     // free the original value
-    umf_ba_free(provider->hTracker->alloc_info_allocator, value);
-    utils_mutex_unlock(&provider->hTracker->splitMergeMutex);
+    umf_ba_free(provider->hShard->alloc_info_allocator, value);
+    utils_mutex_unlock(lock);
 
     return UMF_RESULT_SUCCESS;
 
 err:
-    utils_mutex_unlock(&provider->hTracker->splitMergeMutex);
+    utils_mutex_unlock(lock);
 err_lock:
-    umf_ba_free(provider->hTracker->alloc_info_allocator, splitValue);
+    umf_ba_free(provider->hShard->alloc_info_allocator, splitValue);
     return ret;
 }
 
@@ -274,7 +907,7 @@ static umf_result_t trackingAllocationMerge(void *hProvider, void *lowPtr,
         (umf_tracking_memory_provider_t *)hProvider;
 
     tracker_alloc_info_t *mergedValue =
-        umf_ba_alloc(provider->hTracker->alloc_info_allocator);
+        umf_ba_alloc(provider->hShard->alloc_info_allocator);
 
     if (!mergedValue) {
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
@@ -283,20 +916,20 @@ static umf_result_t trackingAllocationMerge(void *hProvider, void *lowPtr,
     mergedValue->pool = provider->pool;
     mergedValue->size = totalSize;
 
-    int r = utils_mutex_lock(&provider->hTracker->splitMergeMutex);
+    int r = split_merge_lock_pair(provider->hShard, lowPtr, highPtr);
     if (r) {
         goto err_lock;
     }
 
     tracker_alloc_info_t *lowValue = (tracker_alloc_info_t *)critnib_get(
-        provider->hTracker->alloc_segments_map, (uintptr_t)lowPtr);
+        provider->hShard->alloc_segments_map, (uintptr_t)lowPtr);
     if (!lowValue) {
         LOG_FATAL("no left value");
         ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
         goto err_assert;
     }
     tracker_alloc_info_t *highValue = (tracker_alloc_info_t *)critnib_get(
-        provider->hTracker->alloc_segments_map, (uintptr_t)highPtr);
+        provider->hShard->alloc_segments_map, (uintptr_t)highPtr);
     if (!highValue) {
         LOG_FATAL("no right value");
         ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
@@ -323,22 +956,22 @@ static umf_result_t trackingAllocationMerge(void *hProvider, void *lowPtr,
     // We'll have a duplicate entry for the range [highPtr, highValue->size] but this is fine,
     // the value is the same anyway and we forbid removing that range concurrently
     int cret =
-        critnib_insert(provider->hTracker->alloc_segments_map,
+        critnib_insert(provider->hShard->alloc_segments_map,
                        (uintptr_t)lowPtr, (void *)mergedValue, 1 /* update */);
     // this cannot fail since we know the element exists (nothing to allocate)
     assert(cret == 0);
     (void)cret;
 
     // free old value that we just replaced with mergedValue
-    umf_ba_free(provider->hTracker->alloc_info_allocator, lowValue);
+    umf_ba_free(provider->hShard->alloc_info_allocator, lowValue);
 
     void *erasedhighValue = critnib_remove(
-        provider->hTracker->alloc_segments_map, (uintptr_t)highPtr);
+        provider->hShard->alloc_segments_map, (uintptr_t)highPtr);
     assert(erasedhighValue == highValue);
 
-    umf_ba_free(provider->hTracker->alloc_info_allocator, erasedhighValue);
+    umf_ba_free(provider->hShard->alloc_info_allocator, erasedhighValue);
 
-    utils_mutex_unlock(&provider->hTracker->splitMergeMutex);
+    split_merge_unlock_pair(provider->hShard, lowPtr, highPtr);
 
     return UMF_RESULT_SUCCESS;
 
@@ -346,13 +979,114 @@ err_assert:
     assert(0);
 
 not_merged:
-    utils_mutex_unlock(&provider->hTracker->splitMergeMutex);
+    split_merge_unlock_pair(provider->hShard, lowPtr, highPtr);
+
+err_lock:
+    umf_ba_free(provider->hShard->alloc_info_allocator, mergedValue);
+    return ret;
+}
+
+static umf_result_t trackingAllocationResize(void *hProvider, void *ptr,
+                                             size_t oldSize, size_t newSize) {
+    umf_result_t ret = UMF_RESULT_ERROR_UNKNOWN;
+    umf_tracking_memory_provider_t *provider =
+        (umf_tracking_memory_provider_t *)hProvider;
+
+    tracker_alloc_info_t *resizedValue =
+        umf_ba_alloc(provider->hShard->alloc_info_allocator);
+    if (!resizedValue) {
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    resizedValue->pool = provider->pool;
+    resizedValue->size = newSize;
+
+    // Only the region being resized is modified, so its lock is sufficient.
+    utils_mutex_t *lock = split_merge_lock(provider->hShard, ptr);
+    int r = utils_mutex_lock(lock);
+    if (r) {
+        goto err_lock;
+    }
+
+    tracker_alloc_info_t *value = (tracker_alloc_info_t *)critnib_get(
+        provider->hShard->alloc_segments_map, (uintptr_t)ptr);
+    if (!value) {
+        LOG_ERR("region for resize is not found in the tracker");
+        ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto err;
+    }
+    if (value->size != oldSize) {
+        LOG_ERR("tracked size %zu does not match requested size to resize: "
+                "%zu",
+                value->size, oldSize);
+        ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto err;
+    }
+
+    ret = umfMemoryProviderAllocationResize(provider->hUpstream, ptr, oldSize,
+                                            newSize);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_DEBUG("upstream provider failed to resize the region, ptr = %p, "
+                  "size = %zu -> %zu, ret = %d",
+                  ptr, oldSize, newSize, ret);
+        goto err;
+    }
+
+    if (newSize > oldSize) {
+        // The grown part of the region has to be owned by the shard.
+        // It may be taken from other shards only now, when the upstream
+        // provider has given it to this region. The ranges_lock is never
+        // taken with a split/merge lock held, but the region cannot be
+        // modified concurrently, because the caller owns it.
+        utils_mutex_unlock(lock);
+        ret = umfMemoryTrackerRangeAdd(provider->hShard, ptr, newSize);
+        utils_mutex_lock(lock);
+
+        if (ret != UMF_RESULT_SUCCESS) {
+            if (umfMemoryProviderAllocationResize(provider->hUpstream, ptr,
+                                                  newSize, oldSize) !=
+                UMF_RESULT_SUCCESS) {
+                LOG_ERR("cannot shrink the region back, ptr = %p, size = %zu",
+                        ptr, oldSize);
+            }
+            goto err;
+        }
+
+        value = (tracker_alloc_info_t *)critnib_get(
+            provider->hShard->alloc_segments_map, (uintptr_t)ptr);
+        assert(value && value->size == oldSize);
+    }
+
+    // the cached IPC handle describes the old size of the region
+    ipcHandleCacheRemove(provider, ptr);
 
+    int cret =
+        critnib_insert(provider->hShard->alloc_segments_map, (uintptr_t)ptr,
+                       (void *)resizedValue, 1 /* update */);
+    // this cannot fail since we know the element exists (nothing to allocate)
+    assert(cret == 0);
+    (void)cret;
+
+    // free the original value
+    umf_ba_free(provider->hShard->alloc_info_allocator, value);
+    utils_mutex_unlock(lock);
+
+    return UMF_RESULT_SUCCESS;
+
+err:
+    utils_mutex_unlock(lock);
 err_lock:
-    umf_ba_free(provider->hTracker->alloc_info_allocator, mergedValue);
+    umf_ba_free(provider->hShard->alloc_info_allocator, resizedValue);
     return ret;
 }
 
+static umf_result_t trackingTrim(void *hProvider, size_t keepBytes) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)hProvider;
+    // the trimmed memory is free, so it is not tracked
+    return umfMemoryProviderTrim(p->hUpstream, keepBytes);
+}
+
 static umf_result_t trackingFree(void *hProvider, void *ptr, size_t size) {
     umf_result_t ret;
     umf_result_t ret_remove = UMF_RESULT_ERROR_UNKNOWN;
@@ -364,7 +1098,7 @@ static umf_result_t trackingFree(void *hProvider, void *ptr, size_t size) {
     // could allocate the memory at address `ptr` before a call to umfMemoryTrackerRemove
     // resulting in inconsistent state.
     if (ptr) {
-        ret_remove = umfMemoryTrackerRemove(p->hTracker, ptr);
+        ret_remove = umfMemoryTrackerRemove(p->hShard, ptr);
         if (ret_remove != UMF_RESULT_SUCCESS) {
             // DO NOT return an error here, because the tracking provider
             // cannot change behaviour of the upstream provider.
@@ -374,18 +1108,7 @@ static umf_result_t trackingFree(void *hProvider, void *ptr, size_t size) {
         }
     }
 
-    void *value = critnib_remove(p->ipcCache, (uintptr_t)ptr);
-    if (value) {
-        ipc_cache_value_t *cache_value = (ipc_cache_value_t *)value;
-        ret = umfMemoryProviderPutIPCHandle(p->hUpstream,
-                                            cache_value->providerIpcData);
-        if (ret != UMF_RESULT_SUCCESS) {
-            LOG_ERR("upstream provider failed to put IPC handle, ptr=%p, "
-                    "size=%zu, ret = %d",
-                    ptr, size, ret);
-        }
-        umf_ba_global_free(value);
-    }
+    ipcHandleCacheRemove(p, ptr);
 
     ret = umfMemoryProviderFree(p->hUpstream, ptr, size);
     if (ret != UMF_RESULT_SUCCESS) {
@@ -396,7 +1119,7 @@ static umf_result_t trackingFree(void *hProvider, void *ptr, size_t size) {
             return ret;
         }
 
-        if (umfMemoryTrackerAdd(p->hTracker, p->pool, ptr, size) !=
+        if (umfMemoryTrackerAddRegion(p->hShard, p->pool, ptr, size) !=
             UMF_RESULT_SUCCESS) {
             LOG_ERR(
                 "cannot add memory back to the tracker, ptr = %p, size = %zu",
@@ -416,7 +1139,7 @@ static umf_result_t trackingInitialize(void *params, void **ret) {
     }
 
     *provider = *((umf_tracking_memory_provider_t *)params);
-    if (provider->hUpstream == NULL || provider->hTracker == NULL ||
+    if (provider->hUpstream == NULL || provider->hShard == NULL ||
         provider->pool == NULL || provider->ipcCache == NULL) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
@@ -426,21 +1149,45 @@ static umf_result_t trackingInitialize(void *params, void **ret) {
 }
 
 #ifndef NDEBUG
-static void check_if_tracker_is_empty(umf_memory_tracker_handle_t hTracker,
-                                      umf_memory_pool_handle_t pool) {
+// Counts the regions of the shard in the [min, max] address range.
+static size_t count_shard_items(umf_memory_tracker_shard_handle_t hShard,
+                                uintptr_t min, uintptr_t max) {
     uintptr_t rkey;
     void *rvalue;
     size_t n_items = 0;
-    uintptr_t last_key = 0;
 
-    while (1 == critnib_find((critnib *)hTracker->alloc_segments_map, last_key,
-                             FIND_G, &rkey, &rvalue)) {
-        tracker_alloc_info_t *value = (tracker_alloc_info_t *)rvalue;
-        if (value->pool == pool || pool == NULL) {
-            n_items++;
+    while (1 == critnib_find(hShard->alloc_segments_map, min, FIND_GE, &rkey,
+                             &rvalue) &&
+           rkey <= max) {
+        n_items++;
+        if (rkey == max) {
+            break;
         }
+        min = rkey + 1;
+    }
 
-        last_key = rkey;
+    return n_items;
+}
+
+static void
+check_if_tracker_is_empty(umf_memory_tracker_handle_t hTracker,
+                          umf_memory_tracker_shard_handle_t hShard) {
+    uintptr_t rkey;
+    void *rvalue;
+    size_t n_items = 0;
+    uintptr_t last_key = 0;
+
+    if (hShard) {
+        n_items = count_shard_items(hShard, 0, UINTPTR_MAX);
+    } else {
+        // count the regions of all shards still registered in the tracker
+        while (1 == critnib_find(hTracker->ranges_map, last_key, FIND_G, &rkey,
+                                 &rvalue)) {
+            tracker_range_t *range = (tracker_range_t *)rvalue;
+            n_items +=
+                count_shard_items(range->shard, rkey, rkey + range->size - 1);
+            last_key = rkey;
+        }
     }
 
     if (n_items) {
@@ -448,10 +1195,10 @@ static void check_if_tracker_is_empty(umf_memory_tracker_handle_t hTracker,
         // because it may need those resources till
         // the very end of exiting the application.
         if (!utils_is_running_in_proxy_lib()) {
-            if (pool) {
+            if (hShard) {
                 LOG_ERR("tracking provider of pool %p is not empty! (%zu items "
                         "left)",
-                        (void *)pool, n_items);
+                        (void *)hShard->pool, n_items);
             } else {
                 LOG_ERR("tracking provider is not empty! (%zu items left)",
                         n_items);
@@ -465,13 +1212,104 @@ static void check_if_tracker_is_empty(umf_memory_tracker_handle_t hTracker,
 }
 #endif /* NDEBUG */
 
+static umf_memory_tracker_shard_handle_t
+umfMemoryTrackerShardCreate(umf_memory_tracker_handle_t hTracker,
+                            umf_memory_pool_handle_t pool) {
+    umf_memory_tracker_shard_handle_t handle =
+        umf_ba_global_alloc(sizeof(umf_memory_tracker_shard_t));
+    if (!handle) {
+        return NULL;
+    }
+
+    handle->hTracker = hTracker;
+    handle->pool = pool;
+
+    umf_ba_pool_t *alloc_info_allocator =
+        umf_ba_create(sizeof(struct tracker_alloc_info_t));
+    if (!alloc_info_allocator) {
+        goto err_free_handle;
+    }
+
+    handle->alloc_info_allocator = alloc_info_allocator;
+
+    size_t n_locks;
+    for (n_locks = 0; n_locks < TRACKER_SPLIT_MERGE_LOCKS; n_locks++) {
+        if (!utils_mutex_init(&handle->splitMergeLocks[n_locks])) {
+            goto err_destroy_mutex;
+        }
+    }
+
+    // The shard holds all regions of the pool (often a lot of them,
+    // clustered in a few address ranges), so lookups benefit from
+    // a shallower tree with wider nodes.
+    handle->alloc_segments_map = critnib_new_variant(CRITNIB_VARIANT_6BIT);
+    if (!handle->alloc_segments_map) {
+        goto err_destroy_mutex;
+    }
+
+    LOG_DEBUG("tracker shard created, handle=%p, pool=%p, "
+              "alloc_segments_map=%p",
+              (void *)handle, (void *)pool,
+              (void *)handle->alloc_segments_map);
+
+    return handle;
+
+err_destroy_mutex:
+    while (n_locks--) {
+        utils_mutex_destroy_not_free(&handle->splitMergeLocks[n_locks]);
+    }
+    umf_ba_destroy(alloc_info_allocator);
+err_free_handle:
+    umf_ba_global_free(handle);
+    return NULL;
+}
+
+static void
+umfMemoryTrackerShardFree(umf_memory_tracker_shard_handle_t handle) {
+    critnib_delete(handle->alloc_segments_map);
+    for (size_t i = 0; i < TRACKER_SPLIT_MERGE_LOCKS; i++) {
+        utils_mutex_destroy_not_free(&handle->splitMergeLocks[i]);
+    }
+    umf_ba_destroy(handle->alloc_info_allocator);
+    umf_ba_global_free(handle);
+}
+
+static void
+umfMemoryTrackerShardDestroy(umf_memory_tracker_shard_handle_t handle) {
+    // Do not destroy the shard if we are running in the proxy library,
+    // because it may need those resources till
+    // the very end of exiting the application.
+    if (utils_is_running_in_proxy_lib()) {
+        return;
+    }
+
+#ifndef NDEBUG
+    check_if_tracker_is_empty(handle->hTracker, handle);
+#endif /* NDEBUG */
+
+    umf_memory_tracker_shard_handle_t oldest =
+        umfMemoryTrackerShardRetire(handle->hTracker, handle);
+    if (oldest) {
+        umfMemoryTrackerShardFree(oldest);
+    }
+}
+
+static void ipcPrefetchQueueDestroy(ipc_prefetch_queue_t *queue);
+
 static void trackingFinalize(void *provider) {
     umf_tracking_memory_provider_t *p =
         (umf_tracking_memory_provider_t *)provider;
 
+    // the prefetch threads use the cache of opened IPC handles
+    ipcPrefetchQueueDestroy(p->ipcPrefetch);
+
     umfIpcOpenedCacheDestroy(p->hIpcMappedCache);
 
-    critnib_delete(p->ipcCache);
+    critnib_delete(p->ipcMappedPtrs);
+
+    ipcHandleCacheDestroy(p);
+
+    umfMemoryTrackerShardDestroy(p->hShard);
 
     umf_ba_global_free(provider);
 }
@@ -527,118 +1365,257 @@ static inline umf_ipc_data_t *getIpcDataFromIpcHandle(void *providerIpcData) {
                               sizeof(umf_ipc_data_t));
 }
 
+// Copies the cached upstream IPC handle of the allocation to
+// providerIpcData (if not NULL) and its ID to handle_id, getting the handle
+// from the upstream provider on the first use.
+static umf_result_t getCachedIpcHandle(umf_tracking_memory_provider_t *p,
+                                       const void *ptr, size_t size,
+                                       void *providerIpcData,
+                                       uint64_t *handle_id) {
+    ipc_handle_cache_t *cache = p->ipcCache;
+
+    utils_read_lock(&cache->lock);
+    ipc_cache_value_t *cache_value = critnib_get(cache->map, (uintptr_t)ptr);
+    if (cache_value) { // cache hit
+        if (providerIpcData) {
+            memcpy(providerIpcData, cache_value->providerIpcData,
+                   cache_value->ipcDataSize);
+        }
+        *handle_id = cache_value->handle_id;
+        utils_atomic_increment(&cache_value->n_gets);
+        // avoid writing to the shared cache line when the bit is already set
+        uint64_t accessed;
+        utils_atomic_load_acquire(&cache_value->accessed, &accessed);
+        if (!accessed) {
+            utils_atomic_store_release(&cache_value->accessed, 1);
+        }
+        utils_read_unlock(&cache->lock);
+        utils_atomic_increment(&cache->hits);
+        return UMF_RESULT_SUCCESS;
+    }
+    utils_read_unlock(&cache->lock);
+
+    // cache miss
+    size_t ipcDataSize = 0;
+    umf_result_t ret =
+        umfMemoryProviderGetIPCHandleSize(p->hUpstream, &ipcDataSize);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("upstream provider failed to get the size of IPC handle");
+        return ret;
+    }
+
+    size_t value_size = sizeof(ipc_cache_value_t) + ipcDataSize;
+    cache_value = umf_ba_global_alloc(value_size);
+    if (!cache_value) {
+        LOG_ERR("failed to allocate cache_value");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    ret = umfMemoryProviderGetIPCHandle(p->hUpstream, ptr, size,
+                                        cache_value->providerIpcData);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("upstream provider failed to get IPC handle");
+        umf_ba_global_free(cache_value);
+        return ret;
+    }
+
+    cache_value->handle_id = utils_atomic_increment(&IPC_HANDLE_ID);
+    cache_value->ipcDataSize = ipcDataSize;
+    cache_value->ptr = (void *)ptr;
+    cache_value->accessed = 1;
+    cache_value->n_gets = 1;
+
+    ipc_cache_value_t *evicted = NULL;
+    ipc_cache_value_t *found = NULL;
+
+    utils_write_lock(&cache->lock);
+    // another thread could have cached the handle in the meantime
+    found = critnib_get(cache->map, (uintptr_t)ptr);
+    if (found) {
+        *handle_id = found->handle_id;
+        utils_atomic_increment(&found->n_gets);
+        if (providerIpcData) {
+            memcpy(providerIpcData, found->providerIpcData,
+                   found->ipcDataSize);
+        }
+    } else if (critnib_insert(cache->map, (uintptr_t)ptr, cache_value,
+                              0 /* update */) != 0) {
+        utils_write_unlock(&cache->lock);
+        LOG_ERR("insert to IPC cache failed due to OOM");
+        ipcHandleCachePut(p, cache_value);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    } else {
+        *handle_id = cache_value->handle_id;
+        if (providerIpcData) {
+            memcpy(providerIpcData, cache_value->providerIpcData,
+                   ipcDataSize);
+        }
+        DL_APPEND(cache->clock_list, cache_value);
+        cache->size++;
+        ipcHandleCacheTrim(cache, &evicted);
+    }
+    utils_write_unlock(&cache->lock);
+
+    utils_atomic_increment(&cache->misses);
+
+    if (found) {
+        ipcHandleCachePut(p, cache_value);
+    }
+
+    // put the evicted handles outside of the lock
+    ipc_cache_value_t *tmp;
+    DL_FOREACH_SAFE(evicted, cache_value, tmp) {
+        DL_DELETE(evicted, cache_value);
+        ipcHandleCachePut(p, cache_value);
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
 static umf_result_t trackingGetIpcHandle(void *provider, const void *ptr,
                                          size_t size, void *providerIpcData) {
     umf_tracking_memory_provider_t *p =
         (umf_tracking_memory_provider_t *)provider;
-    umf_result_t ret = UMF_RESULT_SUCCESS;
-    size_t ipcDataSize = 0;
-    int cached = 0;
-    ipc_cache_value_t *cache_value = NULL;
     umf_ipc_data_t *ipcUmfData = getIpcDataFromIpcHandle(providerIpcData);
 
-    do {
-        void *value = critnib_get(p->ipcCache, (uintptr_t)ptr);
-        if (value) { //cache hit
-            cache_value = (ipc_cache_value_t *)value;
-            cached = 1;
-        } else { //cache miss
-            ret = umfMemoryProviderGetIPCHandleSize(p->hUpstream, &ipcDataSize);
-            if (ret != UMF_RESULT_SUCCESS) {
-                LOG_ERR("upstream provider failed to get the size of IPC "
-                        "handle");
-                return ret;
-            }
+    return getCachedIpcHandle(p, ptr, size, providerIpcData,
+                              &ipcUmfData->handle_id);
+}
 
-            size_t value_size = sizeof(ipc_cache_value_t) + ipcDataSize;
-            cache_value = umf_ba_global_alloc(value_size);
-            if (!cache_value) {
-                LOG_ERR("failed to allocate cache_value");
-                return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
-            }
+static umf_result_t trackingGetIpcHandleRange(void *provider, const void *ptr,
+                                              size_t size,
+                                              void *providerIpcData) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)provider;
+    umf_ipc_data_t *ipcUmfData = getIpcDataFromIpcHandle(providerIpcData);
 
-            ret = umfMemoryProviderGetIPCHandle(p->hUpstream, ptr, size,
-                                                cache_value->providerIpcData);
-            if (ret != UMF_RESULT_SUCCESS) {
-                LOG_ERR("upstream provider failed to get IPC handle");
-                umf_ba_global_free(cache_value);
-                return ret;
-            }
+    umf_alloc_info_t allocInfo = {NULL, 0, NULL};
+    umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
+    if (ret != UMF_RESULT_SUCCESS || allocInfo.pool != p->pool ||
+        (uintptr_t)ptr + size >
+            (uintptr_t)allocInfo.base + allocInfo.baseSize) {
+        LOG_ERR("range ptr=%p, size=%zu is not a part of an allocation of "
+                "this provider",
+                ptr, size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
 
-            cache_value->handle_id = utils_atomic_increment(&IPC_HANDLE_ID);
-            cache_value->ipcDataSize = ipcDataSize;
+    ret = umfMemoryProviderGetIPCHandleRange(p->hUpstream, ptr, size,
+                                             providerIpcData);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
 
-            int insRes = critnib_insert(p->ipcCache, (uintptr_t)ptr,
-                                        (void *)cache_value, 0 /*update*/);
-            if (insRes == 0) {
-                cached = 1;
-            } else {
-                // critnib_insert might fail in 2 cases:
-                // 1. Another thread created cache entry. So we need to
-                //    clean up allocated handle and try to read again from
-                //    the cache. Alternative approach could be insert empty
-                //    cache_value and only if insert succeed get actual IPC
-                //    handle and fill the cache_value structure under the lock.
-                //    But this case should be rare enough.
-                // 2. critnib failed to allocate memory internally. We need
-                //    to cleanup and return corresponding error.
-                ret = umfMemoryProviderPutIPCHandle(
-                    p->hUpstream, cache_value->providerIpcData);
-                umf_ba_global_free(cache_value);
-                if (ret != UMF_RESULT_SUCCESS) {
-                    LOG_ERR("upstream provider failed to put IPC handle");
-                    return ret;
-                }
-                if (insRes == ENOMEM) {
-                    LOG_ERR("insert to IPC cache failed due to OOM");
-                    return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
-                }
-            }
-        }
-    } while (!cached);
+    // Handles of all ranges of the allocation share the ID of the handle
+    // of the whole allocation, so the consumer can tell that a mapping
+    // of a range is stale when the allocation has been freed.
+    return getCachedIpcHandle(p, allocInfo.base, allocInfo.baseSize, NULL,
+                              &ipcUmfData->handle_id);
+}
 
-    memcpy(providerIpcData, cache_value->providerIpcData,
-           cache_value->ipcDataSize);
-    ipcUmfData->handle_id = cache_value->handle_id;
+// Finds the cache entry the IPC handle was got from. Returns NULL if
+// the allocation has been freed (and its entry removed) in the meantime.
+// The lock of the cache has to be held.
+static ipc_cache_value_t *ipcHandleCacheFind(umf_tracking_memory_provider_t *p,
+                                             const umf_ipc_data_t *ipcData) {
+    // the handle may share only a part of the allocation
+    umf_alloc_info_t allocInfo = {NULL, 0, NULL};
+    if (umfMemoryTrackerGetAllocInfo(ipcData->base, &allocInfo) !=
+            UMF_RESULT_SUCCESS ||
+        allocInfo.pool != p->pool) {
+        return NULL;
+    }
 
-    return ret;
+    ipc_cache_value_t *cache_value =
+        critnib_get(p->ipcCache->map, (uintptr_t)allocInfo.base);
+    if (!cache_value || cache_value->handle_id != ipcData->handle_id) {
+        return NULL;
+    }
+
+    return cache_value;
 }
 
 static umf_result_t trackingPutIpcHandle(void *provider,
                                          void *providerIpcData) {
-    (void)provider;
-    (void)providerIpcData;
-    // We just keep providerIpcData in the provider->ipcCache.
-    // The actual Put is called inside trackingFree
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)provider;
+    ipc_handle_cache_t *cache = p->ipcCache;
+
+    // The upstream handle stays in the cache, it is put when the entry
+    // is evicted or the allocation is freed. Putting the handle only allows
+    // the entry to be evicted once all its handles are put.
+    utils_read_lock(&cache->lock);
+    ipc_cache_value_t *cache_value =
+        ipcHandleCacheFind(p, getIpcDataFromIpcHandle(providerIpcData));
+    uint64_t n_gets = 0;
+    if (cache_value) {
+        uint64_t desired;
+        utils_atomic_load_acquire(&cache_value->n_gets, &n_gets);
+        do {
+            if (n_gets == 0) {
+                // the handle has already been put
+                break;
+            }
+            desired = n_gets - 1;
+        } while (
+            !utils_compare_exchange(&cache_value->n_gets, &n_gets, &desired));
+    }
+    bool trim = n_gets == 1 && cache->max_size && cache->size > cache->max_size;
+    utils_read_unlock(&cache->lock);
+
+    if (!trim) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    // the cache has grown above its limit while the entry was in use
+    ipc_cache_value_t *evicted = NULL;
+    utils_write_lock(&cache->lock);
+    ipcHandleCacheTrim(cache, &evicted);
+    utils_write_unlock(&cache->lock);
+
+    ipc_cache_value_t *tmp;
+    DL_FOREACH_SAFE(evicted, cache_value, tmp) {
+        DL_DELETE(evicted, cache_value);
+        ipcHandleCachePut(p, cache_value);
+    }
+
     return UMF_RESULT_SUCCESS;
 }
 
-static void
-ipcOpenedCacheEvictionCallback(const ipc_opened_cache_key_t *key,
-                               const ipc_opened_cache_value_t *value) {
-    umf_tracking_memory_provider_t *p =
-        (umf_tracking_memory_provider_t *)key->local_provider;
+static void upstreamCloseIPCHandle(umf_tracking_memory_provider_t *p,
+                                   void *mapped_ptr, size_t size) {
     // umfMemoryTrackerRemove should be called before umfMemoryProviderCloseIPCHandle
     // to avoid a race condition. If the order would be different, other thread
     // could allocate the memory at address `ptr` before a call to umfMemoryTrackerRemove
     // resulting in inconsistent state.
-    if (value->mapped_base_ptr) {
-        umf_result_t ret =
-            umfMemoryTrackerRemove(p->hTracker, value->mapped_base_ptr);
-        if (ret != UMF_RESULT_SUCCESS) {
-            // DO NOT return an error here, because the tracking provider
-            // cannot change behaviour of the upstream provider.
-            LOG_ERR("failed to remove the region from the tracker, ptr=%p, "
-                    "size=%zu, ret = %d",
-                    value->mapped_base_ptr, value->mapped_size, ret);
-        }
+    umf_result_t ret = umfMemoryTrackerRemove(p->hShard, mapped_ptr);
+    if (ret != UMF_RESULT_SUCCESS) {
+        // DO NOT return an error here, because the tracking provider
+        // cannot change behaviour of the upstream provider.
+        LOG_ERR("failed to remove the region from the tracker, ptr=%p, "
+                "size=%zu, ret = %d",
+                mapped_ptr, size, ret);
     }
-    umf_result_t ret = umfMemoryProviderCloseIPCHandle(
-        p->hUpstream, value->mapped_base_ptr, value->mapped_size);
+    ret = umfMemoryProviderCloseIPCHandle(p->hUpstream, mapped_ptr, size);
     if (ret != UMF_RESULT_SUCCESS) {
         LOG_ERR("provider failed to close IPC handle, ptr=%p, size=%zu",
-                value->mapped_base_ptr, value->mapped_size);
+                mapped_ptr, size);
+    }
+}
+
+static void
+ipcOpenedCacheEvictionCallback(const ipc_opened_cache_key_t *key,
+                               const ipc_opened_cache_value_t *value) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)key->local_provider;
+
+    if (value->mapped_base_ptr == NULL) {
+        // opening of the IPC handle failed
+        return;
     }
+
+    critnib_remove(p->ipcMappedPtrs, (uintptr_t)value->mapped_base_ptr);
+    upstreamCloseIPCHandle(p, value->mapped_base_ptr, value->mapped_size);
 }
 
 static umf_result_t upstreamOpenIPCHandle(umf_tracking_memory_provider_t *p,
@@ -655,7 +1632,7 @@ static umf_result_t upstreamOpenIPCHandle(umf_tracking_memory_provider_t *p,
     }
     assert(mapped_ptr != NULL);
 
-    ret = umfMemoryTrackerAdd(p->hTracker, p->pool, mapped_ptr, bufferSize);
+    ret = umfMemoryTrackerAddRegion(p->hShard, p->pool, mapped_ptr, bufferSize);
     if (ret != UMF_RESULT_SUCCESS) {
         LOG_ERR("failed to add IPC region to the tracker, ptr=%p, "
                 "size=%zu, "
@@ -674,8 +1651,10 @@ static umf_result_t upstreamOpenIPCHandle(umf_tracking_memory_provider_t *p,
     return UMF_RESULT_SUCCESS;
 }
 
-static umf_result_t trackingOpenIpcHandle(void *provider, void *providerIpcData,
-                                          void **ptr) {
+// Opens the IPC handle and takes `refs` references to the opened mapping.
+static umf_result_t trackingOpenIpcHandleRefs(void *provider,
+                                              void *providerIpcData,
+                                              uint64_t refs, void **ptr) {
     umf_tracking_memory_provider_t *p =
         (umf_tracking_memory_provider_t *)provider;
     umf_result_t ret = UMF_RESULT_SUCCESS;
@@ -689,12 +1668,13 @@ static umf_result_t trackingOpenIpcHandle(void *provider, void *providerIpcData,
     // so we need to zero it out to avoid false cache miss.
     ipc_opened_cache_key_t key = {0};
     key.remote_base_ptr = ipcUmfData->base;
+    key.remote_size = ipcUmfData->baseSize;
     key.local_provider = provider;
     key.remote_pid = ipcUmfData->pid;
 
     ipc_opened_cache_value_t *cache_entry = NULL;
     ret = umfIpcOpenedCacheGet(p->hIpcMappedCache, &key, ipcUmfData->handle_id,
-                               &cache_entry);
+                               ipcUmfData->baseSize, refs, &cache_entry);
     if (ret != UMF_RESULT_SUCCESS) {
         LOG_ERR("failed to get cache entry");
         return ret;
@@ -710,6 +1690,14 @@ static umf_result_t trackingOpenIpcHandle(void *provider, void *providerIpcData,
         if (mapped_ptr == NULL) {
             ret = upstreamOpenIPCHandle(p, providerIpcData,
                                         ipcUmfData->baseSize, &mapped_ptr);
+            if (ret == UMF_RESULT_SUCCESS &&
+                critnib_insert(p->ipcMappedPtrs, (uintptr_t)mapped_ptr,
+                               cache_entry, 0 /* update */) != 0) {
+                LOG_ERR("failed to register opened IPC handle, ptr=%p",
+                        mapped_ptr);
+                upstreamCloseIPCHandle(p, mapped_ptr, ipcUmfData->baseSize);
+                ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+            }
             if (ret == UMF_RESULT_SUCCESS) {
                 // Put to the cache
                 cache_entry->mapped_size = ipcUmfData->baseSize;
@@ -720,28 +1708,41 @@ static umf_result_t trackingOpenIpcHandle(void *provider, void *providerIpcData,
         utils_mutex_unlock(&(cache_entry->mmap_lock));
     }
 
-    if (ret == UMF_RESULT_SUCCESS) {
-        *ptr = mapped_ptr;
+    if (ret != UMF_RESULT_SUCCESS) {
+        for (uint64_t i = 0; i < refs; i++) {
+            umfIpcOpenedCacheRelease(p->hIpcMappedCache, cache_entry);
+        }
+        return ret;
     }
 
-    return ret;
+    *ptr = mapped_ptr;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t trackingOpenIpcHandle(void *provider, void *providerIpcData,
+                                          void **ptr) {
+    return trackingOpenIpcHandleRefs(provider, providerIpcData, 1, ptr);
 }
 
 static umf_result_t trackingCloseIpcHandle(void *provider, void *ptr,
                                            size_t size) {
-    (void)provider;
-    (void)ptr;
     (void)size;
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)provider;
+
     // We keep opened IPC handles in the p->hIpcMappedCache.
     // IPC handle is closed when it is evicted from the cache
-    // or when cache is destroyed.
-    //
-    // TODO: today the size of the IPC cache is infinite.
-    // When the threshold for the cache size is implemented
-    // we need to introduce a reference counting mechanism.
-    // The trackingOpenIpcHandle will increment the refcount for the corresponding entry.
-    // The trackingCloseIpcHandle will decrement the refcount for the corresponding cache entry.
-    return UMF_RESULT_SUCCESS;
+    // or when cache is destroyed. Here we only drop the reference
+    // taken by trackingOpenIpcHandle, so the entry can be evicted.
+    ipc_opened_cache_value_t *cache_entry =
+        critnib_get(p->ipcMappedPtrs, (uintptr_t)ptr);
+    if (cache_entry == NULL) {
+        LOG_ERR("ptr=%p is not a base address of an opened IPC handle", ptr);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return umfIpcOpenedCacheRelease(p->hIpcMappedCache, cache_entry);
 }
 
 umf_memory_provider_ops_t UMF_TRACKING_MEMORY_PROVIDER_OPS = {
@@ -758,11 +1759,214 @@ umf_memory_provider_ops_t UMF_TRACKING_MEMORY_PROVIDER_OPS = {
     .ext.purge_lazy = trackingPurgeLazy,
     .ext.allocation_split = trackingAllocationSplit,
     .ext.allocation_merge = trackingAllocationMerge,
+    .ext.allocation_resize = trackingAllocationResize,
+    .ext.trim = trackingTrim,
     .ipc.get_ipc_handle_size = trackingGetIpcHandleSize,
     .ipc.get_ipc_handle = trackingGetIpcHandle,
     .ipc.put_ipc_handle = trackingPutIpcHandle,
     .ipc.open_ipc_handle = trackingOpenIpcHandle,
-    .ipc.close_ipc_handle = trackingCloseIpcHandle};
+    .ipc.close_ipc_handle = trackingCloseIpcHandle,
+    .ipc.get_ipc_handle_range = trackingGetIpcHandleRange};
+
+static ipc_prefetch_queue_t *ipcPrefetchQueueCreate(void) {
+    ipc_prefetch_queue_t *queue = umf_ba_global_alloc(sizeof(*queue));
+    if (!queue) {
+        return NULL;
+    }
+
+    memset(queue, 0, sizeof(*queue));
+
+    if (utils_mutex_init(&queue->lock) == NULL) {
+        goto err_free_queue;
+    }
+
+    if (utils_cond_init(&queue->cond) == NULL) {
+        goto err_destroy_mutex;
+    }
+
+    return queue;
+
+err_destroy_mutex:
+    utils_mutex_destroy_not_free(&queue->lock);
+err_free_queue:
+    umf_ba_global_free(queue);
+    return NULL;
+}
+
+static void ipcPrefetchQueueDestroy(ipc_prefetch_queue_t *queue) {
+    utils_mutex_lock(&queue->lock);
+    queue->stop = true;
+    utils_cond_broadcast(&queue->cond);
+    utils_mutex_unlock(&queue->lock);
+
+    for (size_t i = 0; i < queue->n_threads; i++) {
+        utils_thread_join(&queue->threads[i]);
+    }
+    umf_ba_global_free(queue->threads);
+
+    // drop the requests that were not handled yet
+    ipc_prefetch_request_t *req, *tmp;
+    DL_FOREACH_SAFE(queue->requests, req, tmp) {
+        DL_DELETE(queue->requests, req);
+        umf_ba_global_free(req);
+    }
+
+    utils_cond_destroy_not_free(&queue->cond);
+    utils_mutex_destroy_not_free(&queue->lock);
+    umf_ba_global_free(queue);
+}
+
+static void *ipcPrefetchThread(void *arg) {
+    umf_tracking_memory_provider_t *p = (umf_tracking_memory_provider_t *)arg;
+    ipc_prefetch_queue_t *queue = p->ipcPrefetch;
+
+    utils_mutex_lock(&queue->lock);
+    while (1) {
+        while (!queue->stop && queue->requests == NULL) {
+            utils_cond_wait(&queue->cond, &queue->lock);
+        }
+
+        if (queue->stop) {
+            break;
+        }
+
+        ipc_prefetch_request_t *req = queue->requests;
+        DL_DELETE(queue->requests, req);
+        queue->n_requests--;
+        utils_mutex_unlock(&queue->lock);
+
+        // Open the IPC handle and drop the reference at once: the mapping
+        // stays in the cache of opened IPC handles until it is evicted,
+        // so the next umfOpenIPCHandle() of the handle finds it there.
+        void *base = NULL;
+        umf_result_t ret = trackingOpenIpcHandle(
+            p, req->ipcData->providerIpcData, &base);
+        if (ret == UMF_RESULT_SUCCESS) {
+            trackingCloseIpcHandle(p, base, req->ipcData->baseSize);
+        } else {
+            LOG_DEBUG("failed to prefetch the IPC handle, base=%p, ret=%d",
+                      req->ipcData->base, ret);
+        }
+
+        umf_ba_global_free(req);
+        utils_mutex_lock(&queue->lock);
+    }
+    utils_mutex_unlock(&queue->lock);
+
+    return NULL;
+}
+
+// Starts the prefetch threads, called with the lock of the queue held.
+static umf_result_t ipcPrefetchStartThreads(umf_tracking_memory_provider_t *p) {
+    ipc_prefetch_queue_t *queue = p->ipcPrefetch;
+    size_t n_threads = umfIpcCacheEnvLimit("prefetch_threads=",
+                                           IPC_PREFETCH_DEFAULT_THREADS);
+    if (n_threads == 0) {
+        n_threads = 1;
+    }
+
+    queue->threads = umf_ba_global_alloc(n_threads * sizeof(utils_thread_t));
+    if (!queue->threads) {
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    for (size_t i = 0; i < n_threads; i++) {
+        if (utils_thread_create(&queue->threads[queue->n_threads],
+                                ipcPrefetchThread, p) != 0) {
+            LOG_ERR("failed to start the IPC prefetch thread");
+            break;
+        }
+        queue->n_threads++;
+    }
+
+    if (queue->n_threads == 0) {
+        umf_ba_global_free(queue->threads);
+        queue->threads = NULL;
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    LOG_DEBUG("started %zu IPC prefetch threads", queue->n_threads);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfTrackingMemoryProviderDupIPCHandle(
+    umf_memory_provider_handle_t hTrackingProvider, void *providerIpcData) {
+    umf_tracking_memory_provider_t *p =
+        umfMemoryProviderGetPriv(hTrackingProvider);
+    ipc_handle_cache_t *cache = p->ipcCache;
+    umf_result_t ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+
+    utils_read_lock(&cache->lock);
+    ipc_cache_value_t *cache_value =
+        ipcHandleCacheFind(p, getIpcDataFromIpcHandle(providerIpcData));
+    if (cache_value) {
+        utils_atomic_increment(&cache_value->n_gets);
+        ret = UMF_RESULT_SUCCESS;
+    }
+    utils_read_unlock(&cache->lock);
+
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("IPC handle is not in the cache of the provider");
+    }
+
+    return ret;
+}
+
+umf_result_t
+umfTrackingMemoryProviderPrefetchIPCHandle(
+    umf_memory_provider_handle_t hTrackingProvider, void *providerIpcData) {
+    umf_tracking_memory_provider_t *p =
+        umfMemoryProviderGetPriv(hTrackingProvider);
+    ipc_prefetch_queue_t *queue = p->ipcPrefetch;
+
+    size_t upstreamIpcDataSize = 0;
+    umf_result_t ret = umfMemoryProviderGetIPCHandleSize(p->hUpstream,
+                                                         &upstreamIpcDataSize);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("upstream provider failed to get the size of IPC handle");
+        return ret;
+    }
+
+    size_t ipcDataSize = sizeof(umf_ipc_data_t) + upstreamIpcDataSize;
+    ipc_prefetch_request_t *req =
+        umf_ba_global_alloc(sizeof(*req) + ipcDataSize);
+    if (!req) {
+        LOG_ERR("failed to allocate the IPC prefetch request");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    req->ipcData = (umf_ipc_data_t *)(req + 1);
+    memcpy(req->ipcData, getIpcDataFromIpcHandle(providerIpcData),
+           ipcDataSize);
+
+    utils_mutex_lock(&queue->lock);
+
+    if (queue->n_threads == 0) {
+        ret = ipcPrefetchStartThreads(p);
+        if (ret != UMF_RESULT_SUCCESS) {
+            goto err_unlock;
+        }
+    }
+
+    if (queue->n_requests >= IPC_PREFETCH_MAX_QUEUED) {
+        // it is only a hint, the handle will be opened on use
+        LOG_DEBUG("IPC prefetch queue is full, dropping the request");
+        goto err_unlock;
+    }
+
+    DL_APPEND(queue->requests, req);
+    queue->n_requests++;
+    utils_cond_signal(&queue->cond);
+    utils_mutex_unlock(&queue->lock);
+
+    return UMF_RESULT_SUCCESS;
+
+err_unlock:
+    utils_mutex_unlock(&queue->lock);
+    umf_ba_global_free(req);
+    return ret;
+}
 
 umf_result_t umfTrackingMemoryProviderCreate(
     umf_memory_provider_handle_t hUpstream, umf_memory_pool_handle_t hPool,
@@ -770,29 +1974,60 @@ umf_result_t umfTrackingMemoryProviderCreate(
 
     umf_tracking_memory_provider_t params;
     params.hUpstream = hUpstream;
-    params.hTracker = TRACKER;
-    if (!params.hTracker) {
+    if (!TRACKER) {
         LOG_ERR("failed, TRACKER is NULL");
         return UMF_RESULT_ERROR_UNKNOWN;
     }
+    params.hShard = umfMemoryTrackerShardCreate(TRACKER, hPool);
+    if (!params.hShard) {
+        LOG_ERR("failed to create tracker shard");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
     params.pool = hPool;
-    params.ipcCache = critnib_new();
+    params.ipcCache = ipcHandleCacheCreate();
     if (!params.ipcCache) {
         LOG_ERR("failed to create IPC cache");
+        umfMemoryTrackerShardDestroy(params.hShard);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    params.ipcMappedPtrs = critnib_new();
+    if (!params.ipcMappedPtrs) {
+        LOG_ERR("failed to create the map of opened IPC handles");
+        ipcHandleCacheDestroy(&params);
+        umfMemoryTrackerShardDestroy(params.hShard);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    params.ipcPrefetch = ipcPrefetchQueueCreate();
+    if (!params.ipcPrefetch) {
+        LOG_ERR("failed to create the IPC prefetch queue");
+        critnib_delete(params.ipcMappedPtrs);
+        ipcHandleCacheDestroy(&params);
+        umfMemoryTrackerShardDestroy(params.hShard);
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
     params.hIpcMappedCache =
         umfIpcOpenedCacheCreate(ipcOpenedCacheEvictionCallback);
 
-    LOG_DEBUG("upstream=%p, tracker=%p, "
+    LOG_DEBUG("upstream=%p, tracker=%p, shard=%p, "
               "pool=%p, ipcCache=%p, hIpcMappedCache=%p",
-              (void *)params.hUpstream, (void *)params.hTracker,
+              (void *)params.hUpstream, (void *)TRACKER, (void *)params.hShard,
               (void *)params.pool, (void *)params.ipcCache,
               (void *)params.hIpcMappedCache);
 
-    return umfMemoryProviderCreate(&UMF_TRACKING_MEMORY_PROVIDER_OPS, &params,
-                                   hTrackingProvider);
+    umf_result_t ret = umfMemoryProviderCreate(
+        &UMF_TRACKING_MEMORY_PROVIDER_OPS, &params, hTrackingProvider);
+    if (ret != UMF_RESULT_SUCCESS) {
+        ipcPrefetchQueueDestroy(params.ipcPrefetch);
+        umfIpcOpenedCacheDestroy(params.hIpcMappedCache);
+        critnib_delete(params.ipcMappedPtrs);
+        ipcHandleCacheDestroy(&params);
+        umfMemoryTrackerShardDestroy(params.hShard);
+    }
+
+    return ret;
 }
 
 void umfTrackingMemoryProviderGetUpstreamProvider(
@@ -804,6 +2039,43 @@ void umfTrackingMemoryProviderGetUpstreamProvider(
     *hUpstream = p->hUpstream;
 }
 
+umf_result_t umfTrackingMemoryProviderOpenIPCHandle(
+    umf_memory_provider_handle_t hTrackingProvider, void *providerIpcData,
+    size_t count, void **ptr) {
+    assert(count > 0);
+    return trackingOpenIpcHandleRefs(
+        umfMemoryProviderGetPriv(hTrackingProvider), providerIpcData, count,
+        ptr);
+}
+
+umf_result_t
+umfTrackingMemoryProviderWalk(umf_memory_provider_handle_t hTrackingProvider,
+                              umf_region_walk_cb_t cb, void *arg) {
+    assert(cb);
+    umf_tracking_memory_provider_t *p =
+        umfMemoryProviderGetPriv(hTrackingProvider);
+
+    // the pool (and so the shard) cannot be destroyed during the walk
+    shard_walk(p->hShard, 0, UINTPTR_MAX, cb, arg);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+void umfTrackingMemoryProviderGetIPCCacheStats(
+    umf_memory_provider_handle_t hTrackingProvider,
+    umf_ipc_handle_cache_stats_t *stats) {
+    umf_tracking_memory_provider_t *p =
+        umfMemoryProviderGetPriv(hTrackingProvider);
+    ipc_handle_cache_t *cache = p->ipcCache;
+
+    utils_read_lock(&cache->lock);
+    stats->entries = cache->size;
+    utils_read_unlock(&cache->lock);
+    utils_atomic_load_acquire(&cache->hits, &stats->hits);
+    utils_atomic_load_acquire(&cache->misses, &stats->misses);
+    utils_atomic_load_acquire(&cache->evictions, &stats->evictions);
+}
+
 umf_memory_tracker_handle_t umfMemoryTrackerCreate(void) {
     umf_memory_tracker_handle_t handle =
         umf_ba_global_alloc(sizeof(struct umf_memory_tracker_t));
@@ -811,33 +2083,37 @@ umf_memory_tracker_handle_t umfMemoryTrackerCreate(void) {
         return NULL;
     }
 
-    umf_ba_pool_t *alloc_info_allocator =
-        umf_ba_create(sizeof(struct tracker_alloc_info_t));
-    if (!alloc_info_allocator) {
+    umf_ba_pool_t *range_allocator =
+        umf_ba_create(sizeof(struct tracker_range_t));
+    if (!range_allocator) {
         goto err_free_handle;
     }
 
-    handle->alloc_info_allocator = alloc_info_allocator;
+    handle->range_allocator = range_allocator;
+    memset(handle->retired_ranges, 0, sizeof(handle->retired_ranges));
+    handle->retired_ranges_idx = 0;
+    memset(handle->retired_shards, 0, sizeof(handle->retired_shards));
+    handle->retired_shards_idx = 0;
 
-    void *mutex_ptr = utils_mutex_init(&handle->splitMergeMutex);
-    if (!mutex_ptr) {
-        goto err_destroy_alloc_info_allocator;
+    void *rwlock_ptr = utils_rwlock_init(&handle->ranges_lock);
+    if (!rwlock_ptr) {
+        goto err_destroy_range_allocator;
     }
 
-    handle->alloc_segments_map = critnib_new();
-    if (!handle->alloc_segments_map) {
-        goto err_destroy_mutex;
+    handle->ranges_map = critnib_new();
+    if (!handle->ranges_map) {
+        goto err_destroy_rwlock;
     }
 
-    LOG_DEBUG("tracker created, handle=%p, alloc_segments_map=%p",
-              (void *)handle, (void *)handle->alloc_segments_map);
+    LOG_DEBUG("tracker created, handle=%p, ranges_map=%p", (void *)handle,
+              (void *)handle->ranges_map);
 
     return handle;
 
-err_destroy_mutex:
-    utils_mutex_destroy_not_free(&handle->splitMergeMutex);
-err_destroy_alloc_info_allocator:
-    umf_ba_destroy(alloc_info_allocator);
+err_destroy_rwlock:
+    utils_rwlock_destroy_not_free(&handle->ranges_lock);
+err_destroy_range_allocator:
+    umf_ba_destroy(range_allocator);
 err_free_handle:
     umf_ba_global_free(handle);
     return NULL;
@@ -859,13 +2135,25 @@ void umfMemoryTrackerDestroy(umf_memory_tracker_handle_t handle) {
     check_if_tracker_is_empty(handle, NULL);
 #endif /* NDEBUG */
 
+    for (size_t i = 0; i < TRACKER_SHARDS_DELETED_LIFE; i++) {
+        if (handle->retired_shards[i]) {
+            umfMemoryTrackerShardFree(handle->retired_shards[i]);
+        }
+    }
+
+    for (size_t i = 0; i < TRACKER_RANGES_DELETED_LIFE; i++) {
+        if (handle->retired_ranges[i]) {
+            umf_ba_free(handle->range_allocator, handle->retired_ranges[i]);
+        }
+    }
+
     // We have to zero all inner pointers,
     // because the tracker handle can be copied
     // and used in many places.
-    critnib_delete(handle->alloc_segments_map);
-    handle->alloc_segments_map = NULL;
-    utils_mutex_destroy_not_free(&handle->splitMergeMutex);
-    umf_ba_destroy(handle->alloc_info_allocator);
-    handle->alloc_info_allocator = NULL;
+    critnib_delete(handle->ranges_map);
+    handle->ranges_map = NULL;
+    utils_rwlock_destroy_not_free(&handle->ranges_lock);
+    umf_ba_destroy(handle->range_allocator);
+    handle->range_allocator = NULL;
     umf_ba_global_free(handle);
 }
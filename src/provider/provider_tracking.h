@@ -15,6 +15,7 @@
 #include <stdlib.h>
 
 #include <umf/base.h>
+#include <umf/ipc.h>
 #include <umf/memory_pool.h>
 #include <umf/memory_provider.h>
 
@@ -55,6 +56,38 @@ void umfTrackingMemoryProviderGetUpstreamProvider(
     umf_memory_provider_handle_t hTrackingProvider,
     umf_memory_provider_handle_t *hUpstream);
 
+// Opens the IPC handle like umfMemoryProviderOpenIPCHandle() but takes
+// `count` references to the opened mapping at once, so the mapping has to be
+// closed `count` times.
+umf_result_t umfTrackingMemoryProviderOpenIPCHandle(
+    umf_memory_provider_handle_t hTrackingProvider, void *providerIpcData,
+    size_t count, void **ptr);
+
+// Takes another reference to the cached IPC handle, as if it was got again,
+// so a copy of the handle can be put separately.
+umf_result_t umfTrackingMemoryProviderDupIPCHandle(
+    umf_memory_provider_handle_t hTrackingProvider, void *providerIpcData);
+
+// Queues the IPC handle to be opened in advance by a prefetch thread,
+// see umfPrefetchIPCHandle(). The handle is copied.
+umf_result_t
+umfTrackingMemoryProviderPrefetchIPCHandle(
+    umf_memory_provider_handle_t hTrackingProvider, void *providerIpcData);
+
+// Returns the statistics of the cache of IPC handles of the tracking
+// provider, see umfPoolGetIPCHandleCacheStats().
+void umfTrackingMemoryProviderGetIPCCacheStats(
+    umf_memory_provider_handle_t hTrackingProvider,
+    umf_ipc_handle_cache_stats_t *stats);
+
+// Walks the regions tracked by the tracking provider, see umfPoolWalk().
+umf_result_t
+umfTrackingMemoryProviderWalk(umf_memory_provider_handle_t hTrackingProvider,
+                              umf_region_walk_cb_t cb, void *arg);
+
+// Walks the regions of all tracking providers, see umfTrackerWalk().
+umf_result_t umfMemoryTrackerWalk(umf_region_walk_cb_t cb, void *arg);
+
 #ifdef __cplusplus
 }
 #endif
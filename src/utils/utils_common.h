@@ -154,6 +154,9 @@ size_t get_max_file_size(void);
 
 int utils_get_file_size(int fd, size_t *size);
 
+// get an identifier of the file the descriptor refers to (its inode number)
+int utils_get_file_id(int fd, uint64_t *id);
+
 int utils_set_file_size(int fd, size_t size);
 
 void *utils_mmap(void *hint_addr, size_t length, int prot, int flag, int fd,
@@ -176,6 +179,15 @@ int utils_file_open_or_create(const char *path);
 
 int utils_fallocate(int fd, long offset, long len);
 
+// deallocate the space of the given range of the file keeping its size
+int utils_punch_hole(int fd, size_t offset, size_t len);
+
+// get the time in milliseconds from a monotonic clock
+uint64_t utils_get_time_ms(void);
+
+// get the NUMA node the calling thread is running on (-1 if unknown)
+int utils_get_current_numa_node(void);
+
 long utils_get_size_threshold(char *str_threshold);
 
 size_t utils_max(size_t a, size_t b);
@@ -67,6 +67,37 @@ int utils_write_lock(utils_rwlock_t *rwlock);
 int utils_read_unlock(utils_rwlock_t *rwlock);
 int utils_write_unlock(utils_rwlock_t *rwlock);
 
+typedef struct utils_cond_t {
+#ifdef _WIN32
+    CONDITION_VARIABLE cond;
+#else
+    pthread_cond_t cond;
+#endif
+} utils_cond_t;
+
+utils_cond_t *utils_cond_init(utils_cond_t *ptr);
+void utils_cond_destroy_not_free(utils_cond_t *cond);
+int utils_cond_wait(utils_cond_t *cond, utils_mutex_t *mutex);
+int utils_cond_signal(utils_cond_t *cond);
+int utils_cond_broadcast(utils_cond_t *cond);
+
+typedef void *(*utils_thread_func_t)(void *arg);
+
+typedef struct utils_thread_t {
+#ifdef _WIN32
+    HANDLE handle;
+    utils_thread_func_t func;
+    void *arg;
+#else
+    pthread_t thread;
+#endif
+} utils_thread_t;
+
+// returns 0 on success
+int utils_thread_create(utils_thread_t *thread, utils_thread_func_t func,
+                        void *arg);
+int utils_thread_join(utils_thread_t *thread);
+
 #if defined(_WIN32)
 #define UTIL_ONCE_FLAG INIT_ONCE
 #define UTIL_ONCE_FLAG_INIT INIT_ONCE_STATIC_INIT
@@ -91,6 +122,10 @@ static __inline unsigned char utils_mssb_index(long long value) {
     return (unsigned char)ret;
 }
 
+static __inline unsigned char utils_popcount64(unsigned long long value) {
+    return (unsigned char)__popcnt64(value);
+}
+
 // There is no good way to do atomic_load on windows...
 #define utils_atomic_load_acquire(object, dest)                                \
     do {                                                                       \
@@ -118,6 +153,7 @@ static __inline unsigned char utils_mssb_index(long long value) {
 
 #define utils_lssb_index(x) ((unsigned char)__builtin_ctzll(x))
 #define utils_mssb_index(x) ((unsigned char)(63 - __builtin_clzll(x)))
+#define utils_popcount64(x) ((unsigned char)__builtin_popcountll(x))
 
 #define utils_atomic_load_acquire(object, dest)                                \
     do {                                                                       \
@@ -7,8 +7,11 @@
  *
  */
 
+#define _GNU_SOURCE 1
+
 #include <errno.h>
 #include <fcntl.h>
+#include <sched.h>
 #include <stdbool.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -122,6 +125,18 @@ int utils_get_file_size(int fd, size_t *size) {
     return 0;
 }
 
+int utils_get_file_id(int fd, uint64_t *id) {
+    struct stat statbuf;
+    int ret = fstat(fd, &statbuf);
+    if (ret) {
+        LOG_PERR("fstat(%i) failed", fd);
+        return ret;
+    }
+
+    *id = (uint64_t)statbuf.st_ino;
+    return 0;
+}
+
 int utils_set_file_size(int fd, size_t size) {
     errno = 0;
     int ret = ftruncate(fd, size);
@@ -138,6 +153,28 @@ int utils_fallocate(int fd, long offset, long len) {
     return posix_fallocate(fd, offset, len);
 }
 
+int utils_get_current_numa_node(void) {
+    unsigned cpu, node;
+    int ret;
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 29)
+    // getcpu() is served by vDSO, so it is cheap enough to be called
+    // on every allocation
+    ret = getcpu(&cpu, &node);
+#else
+    ret = (int)syscall(SYS_getcpu, &cpu, &node, NULL);
+#endif
+    if (ret) {
+        return -1;
+    }
+
+    return (int)node;
+}
+
+int utils_punch_hole(int fd, size_t offset, size_t len) {
+    return fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                     (off_t)offset, (off_t)len);
+}
+
 // create a shared memory file
 int utils_shm_create(const char *shm_name, size_t size) {
     if (shm_name == NULL) {
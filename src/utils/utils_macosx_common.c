@@ -46,6 +46,12 @@ int utils_get_file_size(int fd, size_t *size) {
     return -1;  // not supported on MacOSX
 }
 
+int utils_get_file_id(int fd, uint64_t *id) {
+    (void)fd;  // unused
+    (void)id;  // unused
+    return -1; // not supported on MacOSX
+}
+
 int utils_set_file_size(int fd, size_t size) {
     (void)fd;   // unused
     (void)size; // unused
@@ -60,6 +66,16 @@ int utils_fallocate(int fd, long offset, long len) {
     return -1;
 }
 
+int utils_get_current_numa_node(void) { return -1; }
+
+int utils_punch_hole(int fd, size_t offset, size_t len) {
+    (void)fd;     // unused
+    (void)offset; // unused
+    (void)len;    // unused
+
+    return -1;
+}
+
 // create a shared memory file
 int utils_shm_create(const char *shm_name, size_t size) {
     (void)shm_name; // unused
@@ -17,6 +17,7 @@
 #include <sys/stat.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "utils_common.h"
@@ -186,6 +187,12 @@ int utils_purge(void *addr, size_t length, int advice) {
     return madvise(addr, length, utils_translate_purge_advise(advice));
 }
 
+uint64_t utils_get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
 void utils_strerror(int errnum, char *buf, size_t buflen) {
 // 'strerror_r' implementation is XSI-compliant (returns 0 on success)
 #if (_POSIX_C_SOURCE >= 200112L || _XOPEN_SOURCE >= 600) && !_GNU_SOURCE
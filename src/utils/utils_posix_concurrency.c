@@ -70,3 +70,36 @@ int utils_read_unlock(utils_rwlock_t *rwlock) {
 int utils_write_unlock(utils_rwlock_t *rwlock) {
     return pthread_rwlock_unlock((pthread_rwlock_t *)rwlock);
 }
+
+utils_cond_t *utils_cond_init(utils_cond_t *ptr) {
+    int ret = pthread_cond_init(&ptr->cond, NULL);
+    return ret == 0 ? ptr : NULL;
+}
+
+void utils_cond_destroy_not_free(utils_cond_t *ptr) {
+    int ret = pthread_cond_destroy(&ptr->cond);
+    if (ret) {
+        LOG_ERR("pthread_cond_destroy failed");
+    }
+}
+
+int utils_cond_wait(utils_cond_t *cond, utils_mutex_t *mutex) {
+    return pthread_cond_wait(&cond->cond, &mutex->lock);
+}
+
+int utils_cond_signal(utils_cond_t *cond) {
+    return pthread_cond_signal(&cond->cond);
+}
+
+int utils_cond_broadcast(utils_cond_t *cond) {
+    return pthread_cond_broadcast(&cond->cond);
+}
+
+int utils_thread_create(utils_thread_t *thread, utils_thread_func_t func,
+                        void *arg) {
+    return pthread_create(&thread->thread, NULL, func, arg);
+}
+
+int utils_thread_join(utils_thread_t *thread) {
+    return pthread_join(thread->thread, NULL);
+}
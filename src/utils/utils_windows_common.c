@@ -141,6 +141,12 @@ int utils_get_file_size(int fd, size_t *size) {
     return -1;  // not supported on Windows
 }
 
+int utils_get_file_id(int fd, uint64_t *id) {
+    (void)fd;  // unused
+    (void)id;  // unused
+    return -1; // not supported on Windows
+}
+
 int utils_set_file_size(int fd, size_t size) {
     (void)fd;   // unused
     (void)size; // unused
@@ -226,6 +232,28 @@ int utils_fallocate(int fd, long offset, long len) {
     return -1;
 }
 
+int utils_punch_hole(int fd, size_t offset, size_t len) {
+    (void)fd;     // unused
+    (void)offset; // unused
+    (void)len;    // unused
+
+    return -1;
+}
+
+uint64_t utils_get_time_ms(void) { return GetTickCount64(); }
+
+int utils_get_current_numa_node(void) {
+    PROCESSOR_NUMBER proc_number;
+    USHORT node;
+
+    GetCurrentProcessorNumberEx(&proc_number);
+    if (!GetNumaProcessorNodeEx(&proc_number, &node)) {
+        return -1;
+    }
+
+    return (int)node;
+}
+
 // Expected input:
 // char *str_threshold = utils_env_var_get_str("UMF_PROXY", "size.threshold=");
 long utils_get_size_threshold(char *str_threshold) {
@@ -79,3 +79,50 @@ static BOOL CALLBACK initOnceCb(PINIT_ONCE InitOnce, PVOID Parameter,
 void utils_init_once(UTIL_ONCE_FLAG *flag, void (*onceCb)(void)) {
     InitOnceExecuteOnce(flag, initOnceCb, (void *)onceCb, NULL);
 }
+
+utils_cond_t *utils_cond_init(utils_cond_t *cond) {
+    InitializeConditionVariable(&cond->cond);
+    return cond;
+}
+
+void utils_cond_destroy_not_free(utils_cond_t *cond) {
+    // there is no call to destroy a condition variable
+    (void)cond;
+}
+
+int utils_cond_wait(utils_cond_t *cond, utils_mutex_t *mutex) {
+    return SleepConditionVariableCS(&cond->cond, &mutex->lock, INFINITE) ? 0
+                                                                          : -1;
+}
+
+int utils_cond_signal(utils_cond_t *cond) {
+    WakeConditionVariable(&cond->cond);
+    return 0; // never fails
+}
+
+int utils_cond_broadcast(utils_cond_t *cond) {
+    WakeAllConditionVariable(&cond->cond);
+    return 0; // never fails
+}
+
+static DWORD WINAPI threadStartCb(LPVOID param) {
+    utils_thread_t *thread = (utils_thread_t *)param;
+    thread->func(thread->arg);
+    return 0;
+}
+
+int utils_thread_create(utils_thread_t *thread, utils_thread_func_t func,
+                        void *arg) {
+    thread->func = func;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, threadStartCb, thread, 0, NULL);
+    return thread->handle ? 0 : -1;
+}
+
+int utils_thread_join(utils_thread_t *thread) {
+    if (WaitForSingleObject(thread->handle, INFINITE) != WAIT_OBJECT_0) {
+        return -1;
+    }
+    CloseHandle(thread->handle);
+    return 0;
+}
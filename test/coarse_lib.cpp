@@ -5,6 +5,9 @@
  * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 */
 
+#include <thread>
+#include <vector>
+
 #include "coarse.h"
 #include "provider.hpp"
 
@@ -82,6 +85,19 @@ static umf_result_t merge_cb_fails(void *provider, void *lowPtr, void *highPtr,
     return UMF_RESULT_ERROR_USER_SPECIFIC;
 }
 
+static size_t purged_bytes = 0;
+static size_t purge_calls = 0;
+
+static umf_result_t purge_cb(void *provider, void *ptr, size_t size) {
+    if (provider == NULL || ptr == NULL || size == 0) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    purged_bytes += size;
+    purge_calls++;
+    return UMF_RESULT_SUCCESS;
+}
+
 static void coarse_params_set_default(coarse_params_t *coarse_params,
                                       umf_memory_provider_handle_t provider,
                                       coarse_strategy_t allocation_strategy) {
@@ -121,7 +137,9 @@ INSTANTIATE_TEST_SUITE_P(
     CoarseWithMemoryStrategyTest, CoarseWithMemoryStrategyTest,
     ::testing::Values(UMF_COARSE_MEMORY_STRATEGY_FASTEST,
                       UMF_COARSE_MEMORY_STRATEGY_FASTEST_BUT_ONE,
-                      UMF_COARSE_MEMORY_STRATEGY_CHECK_ALL_SIZE));
+                      UMF_COARSE_MEMORY_STRATEGY_CHECK_ALL_SIZE,
+                      UMF_COARSE_MEMORY_STRATEGY_TLSF,
+                      UMF_COARSE_MEMORY_STRATEGY_BEST_FIT));
 
 TEST_P(CoarseWithMemoryStrategyTest, coarseTest_basic_provider) {
     umf_memory_provider_handle_t malloc_memory_provider;
@@ -1408,3 +1426,864 @@ TEST_P(CoarseWithMemoryStrategyTest,
 
     coarse_delete(ch);
 }
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_tlsf_good_fit) {
+    if (coarse_params.allocation_strategy != UMF_COARSE_MEMORY_STRATEGY_TLSF) {
+        // This test checks which free blocks
+        // the UMF_COARSE_MEMORY_STRATEGY_TLSF strategy chooses.
+        return;
+    }
+
+    const size_t page_size = coarse_params.page_size;
+    const size_t num_pages = 63;
+    const size_t buff_size = (num_pages + 1) * page_size;
+    std::vector<char> buffer(buff_size, 0);
+    void *buf = (void *)ALIGN_UP_SAFE((uintptr_t)buffer.data(), page_size);
+    ASSERT_NE(buf, nullptr);
+
+    coarse_params.cb.alloc = NULL;
+    coarse_params.cb.free = NULL;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+
+    umf_result = coarse_add_memory_fixed(ch, buf, num_pages * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the whole memory is allocated, although the only free block
+    // is not greater than the lower bound of its size class
+    void *ptr = nullptr;
+    umf_result = coarse_alloc(ch, num_pages * page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr, buf);
+
+    umf_result = coarse_free(ch, ptr, num_pages * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // allocate blocks of 1, 2, ..., 8 pages
+    const size_t nblocks = 8;
+    void *ptrs[nblocks];
+    for (size_t i = 0; i < nblocks; i++) {
+        umf_result = coarse_alloc(ch, (i + 1) * page_size, 0, &ptrs[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_NE(ptrs[i], nullptr);
+    }
+
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, nblocks + 1);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 1);
+
+    // free the blocks of 2 and 5 pages, they are not merged
+    umf_result = coarse_free(ch, ptrs[1], 2 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_free(ch, ptrs[4], 5 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 3);
+
+    // the free blocks of the best fitting size classes are reused
+    // instead of the large free block at the end
+    umf_result = coarse_alloc(ch, 5 * page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr, ptrs[4]);
+
+    umf_result = coarse_alloc(ch, 2 * page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr, ptrs[1]);
+
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 1);
+
+    // free all blocks, they are merged back into a single one
+    for (size_t i = 0; i < nblocks; i++) {
+        umf_result = coarse_free(ch, ptrs[i], (i + 1) * page_size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 0);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, 1);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 1);
+
+    coarse_delete(ch);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_resize) {
+    const size_t page_size = coarse_params.page_size;
+    const size_t buff_size = 16 * page_size;
+    std::vector<char> buffer(buff_size + page_size, 0);
+    unsigned char *buf = (unsigned char *)ALIGN_UP_SAFE(
+        (uintptr_t)buffer.data(), page_size);
+    ASSERT_NE(buf, nullptr);
+
+    coarse_params.cb.alloc = NULL;
+    coarse_params.cb.free = NULL;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+    void *ptr1 = nullptr;
+    void *ptr2 = nullptr;
+
+    umf_result = coarse_add_memory_fixed(ch, buf, buff_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the whole memory is one free block, so the first allocation
+    // starts at its beginning
+    umf_result = coarse_alloc(ch, 2 * page_size, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr1, buf);
+
+    umf_result = coarse_alloc(ch, 2 * page_size, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr2, nullptr);
+
+    // wrong arguments
+    umf_result = coarse_resize(ch, ptr1, 1 * page_size, 3 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    umf_result = coarse_resize(ch, ptr1, 2 * page_size, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    umf_result = coarse_resize(ch, INVALID_PTR, 2 * page_size, 3 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // the block following ptr1 is used
+    if (ptr2 == buf + 2 * page_size) {
+        umf_result = coarse_resize(ch, ptr1, 2 * page_size, 3 * page_size);
+        ASSERT_EQ(umf_result, UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+    }
+
+    // shrink ptr1 and grow it back
+    umf_result = coarse_resize(ch, ptr1, 2 * page_size, 1 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 3 * page_size);
+
+    umf_result = coarse_resize(ch, ptr1, 1 * page_size, 2 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 4 * page_size);
+
+    umf_result = coarse_free(ch, ptr1, 2 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // grow ptr2 into the free memory following it
+    size_t num_free_blocks = coarse_get_stats(ch).num_free_blocks;
+    size_t free_after = (size_t)(buf + buff_size - (unsigned char *)ptr2);
+    umf_result = coarse_resize(ch, ptr2, 2 * page_size, free_after / 2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).used_size, free_after / 2);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, num_free_blocks);
+
+    // the whole free block following ptr2 is used
+    umf_result = coarse_resize(ch, ptr2, free_after / 2, free_after);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).used_size, free_after);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, num_free_blocks - 1);
+
+    // there is no more free memory after ptr2
+    umf_result = coarse_resize(ch, ptr2, free_after, free_after + page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+    ASSERT_EQ(coarse_get_stats(ch).used_size, free_after);
+
+    umf_result = coarse_resize(ch, ptr2, free_after, 1 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = coarse_free(ch, ptr2, 1 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 0);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, 1);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 1);
+
+    coarse_delete(ch);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_best_fit) {
+    if (coarse_params.allocation_strategy !=
+        UMF_COARSE_MEMORY_STRATEGY_BEST_FIT) {
+        // This test checks which free blocks
+        // the UMF_COARSE_MEMORY_STRATEGY_BEST_FIT strategy chooses.
+        return;
+    }
+
+    // the buffer is aligned to 64 pages
+    const size_t page_size = coarse_params.page_size;
+    const size_t num_pages = 63;
+    const size_t buff_size = 128 * page_size;
+    std::vector<char> buffer(buff_size, 0);
+    unsigned char *buf = (unsigned char *)ALIGN_UP_SAFE(
+        (uintptr_t)buffer.data(), 64 * page_size);
+    ASSERT_NE(buf, nullptr);
+
+    coarse_params.cb.alloc = NULL;
+    coarse_params.cb.free = NULL;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+
+    umf_result = coarse_add_memory_fixed(ch, buf, num_pages * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // allocate blocks of 2, 2, 1, 2 and 1 pages
+    const size_t nblocks = 5;
+    const size_t sizes[nblocks] = {2, 2, 1, 2, 1};
+    void *ptrs[nblocks];
+    for (size_t i = 0; i < nblocks; i++) {
+        umf_result = coarse_alloc(ch, sizes[i] * page_size, 0, &ptrs[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_NE(ptrs[i], nullptr);
+    }
+
+    // free both blocks of 2 pages after the first one
+    umf_result = coarse_free(ch, ptrs[3], 2 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_free(ch, ptrs[1], 2 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the free block with the lowest address of the best fitting ones
+    // is chosen regardless of the order of freeing
+    void *ptr = nullptr;
+    umf_result = coarse_alloc(ch, 2 * page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr, ptrs[1]);
+
+    umf_result = coarse_alloc(ch, 1 * page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr, ptrs[3]);
+
+    umf_result = coarse_free(ch, ptr, 1 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // free the blocks #1-#3, so the free block of 5 pages
+    // starting at the page #2 is left
+    umf_result = coarse_free(ch, ptrs[1], 2 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_free(ch, ptrs[2], 1 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 2);
+    ASSERT_EQ(coarse_get_stats(ch).largest_free_block,
+              (num_pages - 8) * page_size);
+
+    // the properly aligned data is cut out of the free block of 5 pages,
+    // although it is smaller than (size + alignment)
+    umf_result = coarse_alloc(ch, 2 * page_size, 4 * page_size, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr, buf + 4 * page_size);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 3);
+
+    umf_result = coarse_free(ch, ptr, 2 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 2);
+
+    umf_result = coarse_free(ch, ptrs[0], 2 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_free(ch, ptrs[4], 1 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 0);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, 1);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 1);
+
+    coarse_delete(ch);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_trim_provider) {
+    umf_memory_provider_handle_t malloc_memory_provider;
+    umf_result = umfMemoryProviderCreate(&UMF_MALLOC_MEMORY_PROVIDER_OPS, NULL,
+                                         &malloc_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(malloc_memory_provider, nullptr);
+
+    coarse_params.provider = malloc_memory_provider;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+    void *ptr = nullptr;
+    const size_t alloc_size = 20 * MB;
+
+    umf_result = coarse_trim(nullptr, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = coarse_add_memory_from_provider(ch, alloc_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = coarse_alloc(ch, 2 * MB, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    // the region allocated from the provider is not entirely free
+    umf_result = coarse_trim(ch, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 2 * MB);
+    ASSERT_EQ(coarse_get_stats(ch).alloc_size, alloc_size);
+
+    umf_result = coarse_free(ch, ptr, 2 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, 1);
+
+    // the whole region is free now, so it is returned to the provider
+    umf_result = coarse_trim(ch, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 0);
+    ASSERT_EQ(coarse_get_stats(ch).alloc_size, 0);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, 0);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 0);
+
+    umf_result = coarse_alloc(ch, 2 * MB, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    umf_result = coarse_free(ch, ptr, 2 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // keep_bytes of free memory are kept
+    umf_result = coarse_trim(ch, 2 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).alloc_size, 2 * MB);
+
+    umf_result = coarse_trim(ch, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).alloc_size, 0);
+
+    coarse_delete(ch);
+    umfMemoryProviderDestroy(malloc_memory_provider);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_trim_high_water_mark) {
+    umf_memory_provider_handle_t malloc_memory_provider;
+    umf_result = umfMemoryProviderCreate(&UMF_MALLOC_MEMORY_PROVIDER_OPS, NULL,
+                                         &malloc_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(malloc_memory_provider, nullptr);
+
+    coarse_params.provider = malloc_memory_provider;
+    coarse_params.free_high_water_mark = 4 * MB;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+    void *ptr1 = nullptr;
+    void *ptr2 = nullptr;
+
+    umf_result = coarse_alloc(ch, 2 * MB, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_alloc(ch, 10 * MB, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).alloc_size, 12 * MB);
+
+    // the free memory below the high water mark is kept
+    umf_result = coarse_free(ch, ptr1, 2 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).alloc_size, 12 * MB);
+
+    // the free memory above the high water mark is trimmed
+    // to a half of the mark
+    umf_result = coarse_free(ch, ptr2, 10 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_LE(coarse_get_stats(ch).alloc_size, 2 * MB);
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 0);
+
+    coarse_delete(ch);
+    umfMemoryProviderDestroy(malloc_memory_provider);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_trim_purge) {
+    // preallocate some memory and initialize the vector with zeros
+    const size_t buff_size = 20 * MB + coarse_params.page_size;
+    std::vector<char> buffer(buff_size, 0);
+    void *buf = (void *)ALIGN_UP_SAFE((uintptr_t)buffer.data(),
+                                      coarse_params.page_size);
+    ASSERT_NE(buf, nullptr);
+
+    coarse_params.cb.alloc = NULL;
+    coarse_params.cb.free = NULL;
+
+    // trimming is not supported without the free() and purge() callbacks
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_trim(coarse_handle, 0), UMF_RESULT_ERROR_NOT_SUPPORTED);
+    coarse_delete(coarse_handle);
+
+    coarse_params.cb.purge = purge_cb;
+    purged_bytes = 0;
+    purge_calls = 0;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+    void *ptr1 = nullptr;
+    void *ptr2 = nullptr;
+
+    umf_result = coarse_add_memory_fixed(ch, buf, 20 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = coarse_alloc(ch, 2 * MB, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the free memory is purged, but it stays allocated
+    umf_result = coarse_trim(ch, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(purged_bytes, 18 * MB);
+    ASSERT_EQ(purge_calls, 1);
+    ASSERT_EQ(coarse_get_stats(ch).purged_size, 18 * MB);
+    ASSERT_EQ(coarse_get_stats(ch).alloc_size, 20 * MB);
+
+    // purged blocks are not purged again
+    umf_result = coarse_trim(ch, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(purge_calls, 1);
+
+    // purged blocks are reused
+    umf_result = coarse_alloc(ch, 4 * MB, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).purged_size, 14 * MB);
+
+    umf_result = coarse_free(ch, ptr1, 2 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_free(ch, ptr2, 4 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // a block merged with a not purged one is not purged
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, 1);
+    ASSERT_EQ(coarse_get_stats(ch).purged_size, 0);
+
+    coarse_delete(ch);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_lazy_purge) {
+    // preallocate some memory and initialize the vector with zeros
+    const size_t buff_size = 20 * MB + coarse_params.page_size;
+    std::vector<char> buffer(buff_size, 0);
+    void *buf = (void *)ALIGN_UP_SAFE((uintptr_t)buffer.data(),
+                                      coarse_params.page_size);
+    ASSERT_NE(buf, nullptr);
+
+    coarse_params.cb.alloc = NULL;
+    coarse_params.cb.free = NULL;
+    coarse_params.cb.purge = purge_cb;
+    coarse_params.purge_min_size = 4 * MB;
+    coarse_params.purge_delay_ms = 0;
+    purged_bytes = 0;
+    purge_calls = 0;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+    void *ptr1 = nullptr;
+    void *ptr2 = nullptr;
+    void *ptr3 = nullptr;
+
+    umf_result = coarse_add_memory_fixed(ch, buf, 20 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the rest of the block is purged right after the allocation
+    umf_result = coarse_alloc(ch, 2 * MB, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).purged_size, 18 * MB);
+    ASSERT_EQ(purge_calls, 1);
+
+    umf_result = coarse_alloc(ch, 1 * MB, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_alloc(ch, 1 * MB, 0, &ptr3);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).purged_size, 16 * MB);
+    ASSERT_EQ(purge_calls, 1);
+
+    // blocks smaller than purge_min_size are not purged
+    umf_result = coarse_free(ch, ptr2, 1 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).purged_size, 16 * MB);
+    ASSERT_EQ(purge_calls, 1);
+
+    // merged blocks are purged again
+    umf_result = coarse_free(ch, ptr3, 1 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).purged_size, 18 * MB);
+    ASSERT_EQ(purge_calls, 2);
+
+    umf_result = coarse_free(ch, ptr1, 2 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, 1);
+    ASSERT_EQ(coarse_get_stats(ch).purged_size, 20 * MB);
+    ASSERT_EQ(purge_calls, 3);
+
+    coarse_delete(ch);
+
+    // blocks are not purged before purge_delay_ms passes
+    coarse_params.purge_delay_ms = 3600 * 1000;
+    purge_calls = 0;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ch = coarse_handle;
+
+    umf_result = coarse_add_memory_fixed(ch, buf, 20 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_alloc(ch, 2 * MB, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_free(ch, ptr1, 2 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).purged_size, 0);
+    ASSERT_EQ(purge_calls, 0);
+
+    coarse_delete(ch);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_lazy_purge_capped) {
+    const uint64_t purge_delay_ms = 100;
+
+    // preallocate some memory and initialize the vector with zeros
+    const size_t buff_size = 20 * MB + coarse_params.page_size;
+    std::vector<char> buffer(buff_size, 0);
+    void *buf = (void *)ALIGN_UP_SAFE((uintptr_t)buffer.data(),
+                                      coarse_params.page_size);
+    ASSERT_NE(buf, nullptr);
+
+    coarse_params.cb.alloc = NULL;
+    coarse_params.cb.free = NULL;
+    coarse_params.cb.purge = purge_cb;
+    coarse_params.purge_min_size = 4 * MB;
+    coarse_params.purge_delay_ms = purge_delay_ms;
+    purged_bytes = 0;
+    purge_calls = 0;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+
+    umf_result = coarse_add_memory_fixed(ch, buf, 20 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // 1 MB blocks separate the 4 MB ones, so the latter are not merged
+    const size_t sizes[] = {1 * MB, 1 * MB, 4 * MB, 1 * MB,
+                            4 * MB, 1 * MB, 4 * MB, 1 * MB};
+    void *ptrs[8] = {nullptr};
+    for (int i = 0; i < 8; i++) {
+        umf_result = coarse_alloc(ch, sizes[i], 0, &ptrs[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    for (int i = 2; i < 8; i += 2) {
+        umf_result = coarse_free(ch, ptrs[i], sizes[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(2 * purge_delay_ms));
+
+    // only one expired block is purged in coarse_free()
+    // (the freed block is not merged with the used ptrs[1])
+    size_t calls = purge_calls;
+    umf_result = coarse_free(ch, ptrs[0], sizes[0]);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(purge_calls, calls + 1);
+
+    // the rest of them are purged in coarse_trim()
+    umf_result = coarse_trim(ch, SIZE_MAX);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).purged_size, 12 * MB);
+
+    for (int i = 1; i < 8; i += 2) {
+        umf_result = coarse_free(ch, ptrs[i], sizes[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    coarse_delete(ch);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_arenas_fixed_memory) {
+    // preallocate some memory and initialize the vector with zeros
+    const size_t buff_size = 4 * MB + coarse_params.page_size;
+    std::vector<char> buffer(buff_size, 0);
+    void *buf = (void *)ALIGN_UP_SAFE((uintptr_t)buffer.data(),
+                                      coarse_params.page_size);
+    ASSERT_NE(buf, nullptr);
+
+    coarse_params.cb.alloc = NULL;
+    coarse_params.cb.free = NULL;
+    coarse_params.num_arenas = 4;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+    void *ptr[4] = {nullptr};
+    void *ptr_oom = nullptr;
+
+    // every arena gets 1 MB of the memory
+    umf_result = coarse_add_memory_fixed(ch, buf, 4 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).alloc_size, 4 * MB);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, 4);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 4);
+
+    // the memory of the other arenas is used when the own one is exhausted
+    // (the UMF_COARSE_MEMORY_STRATEGY_FASTEST strategy needs
+    // an additional page for the alignment)
+    const size_t size = 1 * MB - coarse_params.page_size;
+    for (int i = 0; i < 4; i++) {
+        umf_result = coarse_alloc(ch, size, 0, &ptr[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_NE(ptr[i], nullptr);
+    }
+
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 4 * size);
+
+    umf_result = coarse_alloc(ch, size, 0, &ptr_oom);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+    ASSERT_EQ(ptr_oom, nullptr);
+
+    // blocks of different arenas cannot be merged
+    void *low = buf;
+    void *high = (void *)((uintptr_t)buf + 1 * MB);
+    umf_result = coarse_merge(ch, low, high, 2 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // but blocks of the same arena can be
+    size_t num_all_blocks = coarse_get_stats(ch).num_all_blocks;
+    umf_result = coarse_split(ch, ptr[0], size, 512 * KB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, num_all_blocks + 1);
+
+    high = (void *)((uintptr_t)ptr[0] + 512 * KB);
+    umf_result = coarse_merge(ch, ptr[0], high, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, num_all_blocks);
+
+    for (int i = 0; i < 4; i++) {
+        umf_result = coarse_free(ch, ptr[i], size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    umf_result = coarse_free(ch, INVALID_PTR, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // free blocks of different arenas are not merged
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 0);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, 4);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 4);
+
+    umf_result = coarse_alloc(ch, 2 * MB, 0, &ptr_oom);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+
+    coarse_delete(ch);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_arenas_numa_nodes) {
+    // preallocate some memory and initialize the vector with zeros
+    const size_t buff_size = 3 * MB + coarse_params.page_size;
+    std::vector<char> buffer(buff_size, 0);
+    unsigned char *buf = (unsigned char *)ALIGN_UP_SAFE(
+        (uintptr_t)buffer.data(), coarse_params.page_size);
+    ASSERT_NE(buf, nullptr);
+
+    int node = utils_get_current_numa_node();
+    if (node < 0) {
+        GTEST_SKIP() << "NUMA node of the calling thread is unknown";
+    }
+
+    coarse_params.cb.alloc = NULL;
+    coarse_params.cb.free = NULL;
+    coarse_params.num_arenas = 2;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+    void *ptr_local = nullptr;
+    void *ptr_remote = nullptr;
+    void *ptr_oom = nullptr;
+
+    // the first region is "remote", the second one is "local"
+    unsigned char *remote = buf;
+    unsigned char *local = buf + 1 * MB;
+    umf_result = coarse_add_memory_fixed_node(ch, remote, 1 * MB, 1, node + 1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_add_memory_fixed_node(ch, local, 1 * MB, 1, node);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).alloc_size, 2 * MB);
+
+    // all arenas already own memory
+    umf_result = coarse_add_memory_fixed_node(ch, buf + 2 * MB, 1 * MB, 1, -1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // the local region is used first and the remote one when it is exhausted
+    // (the UMF_COARSE_MEMORY_STRATEGY_FASTEST strategy needs
+    // an additional page for the alignment)
+    const size_t size = 1 * MB - coarse_params.page_size;
+    umf_result = coarse_alloc(ch, size, 0, &ptr_local);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_GE((unsigned char *)ptr_local, local);
+    ASSERT_LT((unsigned char *)ptr_local, local + 1 * MB);
+
+    umf_result = coarse_alloc(ch, size, 0, &ptr_remote);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_GE((unsigned char *)ptr_remote, remote);
+    ASSERT_LT((unsigned char *)ptr_remote, remote + 1 * MB);
+
+    umf_result = coarse_alloc(ch, size, 0, &ptr_oom);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+    ASSERT_EQ(ptr_oom, nullptr);
+
+    umf_result = coarse_free(ch, ptr_remote, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_free(ch, ptr_local, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 0);
+    ASSERT_EQ(coarse_get_stats(ch).num_free_blocks, 2);
+
+    coarse_delete(ch);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_arenas_provider_mt) {
+    umf_memory_provider_handle_t malloc_memory_provider;
+    umf_result = umfMemoryProviderCreate(&UMF_MALLOC_MEMORY_PROVIDER_OPS, NULL,
+                                         &malloc_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(malloc_memory_provider, nullptr);
+
+    coarse_params.provider = malloc_memory_provider;
+    coarse_params.num_arenas = 4;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+    const int num_threads = 8;
+    const int num_allocs = 100;
+    std::vector<std::thread> threads;
+    std::vector<umf_result_t> results(num_threads, UMF_RESULT_SUCCESS);
+
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            std::vector<void *> ptrs(num_allocs, nullptr);
+            for (int i = 0; i < num_allocs; i++) {
+                size_t size = (size_t)((i % 7) + 1) * 4 * KB;
+                umf_result_t ret = coarse_alloc(ch, size, 0, &ptrs[i]);
+                if (ret != UMF_RESULT_SUCCESS) {
+                    results[t] = ret;
+                    return;
+                }
+                // free every other block at once
+                if (i % 2) {
+                    ret = coarse_free(ch, ptrs[i], size);
+                    if (ret != UMF_RESULT_SUCCESS) {
+                        results[t] = ret;
+                        return;
+                    }
+                    ptrs[i] = nullptr;
+                }
+            }
+            for (int i = 0; i < num_allocs; i++) {
+                umf_result_t ret = coarse_free(ch, ptrs[i], 0);
+                if (ret != UMF_RESULT_SUCCESS) {
+                    results[t] = ret;
+                    return;
+                }
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < num_threads; t++) {
+        ASSERT_EQ(results[t], UMF_RESULT_SUCCESS);
+    }
+
+    ASSERT_EQ(coarse_get_stats(ch).used_size, 0);
+
+    // all regions allocated from the provider are returned to it
+    umf_result = coarse_trim(ch, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(coarse_get_stats(ch).alloc_size, 0);
+    ASSERT_EQ(coarse_get_stats(ch).num_all_blocks, 0);
+
+    coarse_delete(ch);
+    umfMemoryProviderDestroy(malloc_memory_provider);
+}
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseTest_stats_free_blocks) {
+    // preallocate some memory and initialize the vector with zeros
+    const size_t buff_size = 20 * MB + coarse_params.page_size;
+    std::vector<char> buffer(buff_size, 0);
+    void *buf = (void *)ALIGN_UP_SAFE((uintptr_t)buffer.data(),
+                                      coarse_params.page_size);
+    ASSERT_NE(buf, nullptr);
+
+    coarse_params.cb.alloc = NULL;
+    coarse_params.cb.free = NULL;
+
+    umf_result = coarse_new(&coarse_params, &coarse_handle);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_handle, nullptr);
+
+    coarse_t *ch = coarse_handle;
+    void *ptr1 = nullptr;
+    void *ptr2 = nullptr;
+
+    coarse_stats_t stats = coarse_get_stats(ch);
+    ASSERT_EQ(stats.largest_free_block, 0);
+    for (int i = 0; i < COARSE_STATS_FREE_HIST_SIZE; i++) {
+        ASSERT_EQ(stats.free_hist[i], 0);
+    }
+
+    umf_result = coarse_add_memory_fixed(ch, buf, 20 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // 20 MB is in the range [16 MB, 32 MB) of the bucket #24
+    stats = coarse_get_stats(ch);
+    ASSERT_EQ(stats.num_free_blocks, 1);
+    ASSERT_EQ(stats.largest_free_block, 20 * MB);
+    ASSERT_EQ(stats.free_hist[24], 1);
+
+    umf_result = coarse_alloc(ch, 2 * MB, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = coarse_alloc(ch, 2 * MB, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = coarse_free(ch, ptr1, 2 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the free 2 MB block is in the bucket #21
+    stats = coarse_get_stats(ch);
+    ASSERT_EQ(stats.free_hist[21], 1);
+    ASSERT_LT(stats.largest_free_block, 20 * MB);
+    ASSERT_GE(stats.largest_free_block, 15 * MB);
+
+    size_t num_free_blocks = 0;
+    for (int i = 0; i < COARSE_STATS_FREE_HIST_SIZE; i++) {
+        num_free_blocks += stats.free_hist[i];
+    }
+    ASSERT_EQ(num_free_blocks, stats.num_free_blocks);
+
+    umf_result = coarse_free(ch, ptr2, 2 * MB);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    stats = coarse_get_stats(ch);
+    ASSERT_EQ(stats.num_all_blocks, 1);
+    ASSERT_EQ(stats.num_free_blocks, 1);
+    ASSERT_EQ(stats.largest_free_block, 20 * MB);
+    ASSERT_EQ(stats.free_hist[21], 0);
+    ASSERT_EQ(stats.free_hist[24], 1);
+
+    coarse_delete(ch);
+}
@@ -17,6 +17,8 @@
 #include <stdlib.h>
 #endif
 
+#include <algorithm>
+
 #include <umf/base.h>
 #include <umf/memory_provider.h>
 #include <umf/pools/pool_disjoint.h>
@@ -46,7 +48,11 @@ bool isReallocSupported(umf_memory_pool_handle_t hPool) {
     bool supported = false;
     auto *ptr = umfPoolMalloc(hPool, allocSize);
     memset(ptr, 0, allocSize);
-    auto *new_ptr = umfPoolRealloc(hPool, ptr, allocSize * 2);
+    // grow beyond the usable size, because pools may support
+    // only the in-place realloc
+    size_t newSize =
+        std::max(allocSize * 2, umfPoolMallocUsableSize(hPool, ptr) + 1);
+    auto *new_ptr = umfPoolRealloc(hPool, ptr, newSize);
 
     if (new_ptr) {
         supported = true;
@@ -93,6 +93,21 @@ static umf_result_t nullAllocationSplit(void *provider, void *ptr,
     return UMF_RESULT_SUCCESS;
 }
 
+static umf_result_t nullAllocationResize(void *provider, void *ptr,
+                                         size_t oldSize, size_t newSize) {
+    (void)provider;
+    (void)ptr;
+    (void)oldSize;
+    (void)newSize;
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t nullTrim(void *provider, size_t keepBytes) {
+    (void)provider;
+    (void)keepBytes;
+    return UMF_RESULT_SUCCESS;
+}
+
 static umf_result_t nullGetIpcHandleSize(void *provider, size_t *size) {
     (void)provider;
     (void)size;
@@ -143,6 +158,8 @@ umf_memory_provider_ops_t UMF_NULL_PROVIDER_OPS = {
     .ext.purge_force = nullPurgeForce,
     .ext.allocation_merge = nullAllocationMerge,
     .ext.allocation_split = nullAllocationSplit,
+    .ext.allocation_resize = nullAllocationResize,
+    .ext.trim = nullTrim,
     .ipc.get_ipc_handle_size = nullGetIpcHandleSize,
     .ipc.get_ipc_handle = nullGetIpcHandle,
     .ipc.put_ipc_handle = nullPutIpcHandle,
@@ -137,6 +137,25 @@ static umf_result_t traceAllocationSplit(void *provider, void *ptr,
                                             ptr, totalSize, firstSize);
 }
 
+static umf_result_t traceAllocationResize(void *provider, void *ptr,
+                                          size_t oldSize, size_t newSize) {
+    umf_provider_trace_params_t *traceProvider =
+        (umf_provider_trace_params_t *)provider;
+
+    traceProvider->trace_handler(traceProvider->trace_context,
+                                 "allocation_resize");
+    return umfMemoryProviderAllocationResize(traceProvider->hUpstreamProvider,
+                                             ptr, oldSize, newSize);
+}
+
+static umf_result_t traceTrim(void *provider, size_t keepBytes) {
+    umf_provider_trace_params_t *traceProvider =
+        (umf_provider_trace_params_t *)provider;
+
+    traceProvider->trace_handler(traceProvider->trace_context, "trim");
+    return umfMemoryProviderTrim(traceProvider->hUpstreamProvider, keepBytes);
+}
+
 static umf_result_t traceGetIpcHandleSize(void *provider, size_t *pSize) {
     umf_provider_trace_params_t *traceProvider =
         (umf_provider_trace_params_t *)provider;
@@ -204,6 +223,8 @@ umf_memory_provider_ops_t UMF_TRACE_PROVIDER_OPS = {
     .ext.purge_force = tracePurgeForce,
     .ext.allocation_merge = traceAllocationMerge,
     .ext.allocation_split = traceAllocationSplit,
+    .ext.allocation_resize = traceAllocationResize,
+    .ext.trim = traceTrim,
     .ipc.get_ipc_handle_size = traceGetIpcHandleSize,
     .ipc.get_ipc_handle = traceGetIpcHandle,
     .ipc.put_ipc_handle = tracePutIpcHandle,
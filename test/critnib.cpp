@@ -0,0 +1,308 @@
+// Copyright (C) 2025 Intel Corporation
+// Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "base.hpp"
+
+#include "critnib/critnib.h"
+
+using umf_test::test;
+
+struct CritnibTest : umf_test::test,
+                     ::testing::WithParamInterface<critnib_variant_t> {
+    void SetUp() override {
+        test::SetUp();
+        c = critnib_new_variant(GetParam());
+        ASSERT_NE(c, nullptr);
+    }
+
+    void TearDown() override {
+        critnib_delete(c);
+        test::TearDown();
+    }
+
+    // checks all queries for the key against the reference map
+    void checkKey(const std::map<uintptr_t, void *> &ref, uintptr_t key) {
+        auto it = ref.find(key);
+        ASSERT_EQ(critnib_get(c, key), it == ref.end() ? nullptr : it->second);
+
+        uintptr_t rkey = 0;
+        void *rvalue = nullptr;
+
+        auto le = ref.upper_bound(key);
+        int found = critnib_find(c, key, FIND_LE, &rkey, &rvalue);
+        if (le == ref.begin()) {
+            ASSERT_EQ(found, 0);
+            ASSERT_EQ(critnib_find_le(c, key), nullptr);
+        } else {
+            --le;
+            ASSERT_EQ(found, 1);
+            ASSERT_EQ(rkey, le->first);
+            ASSERT_EQ(rvalue, le->second);
+            ASSERT_EQ(critnib_find_le(c, key), le->second);
+        }
+
+        auto ge = ref.lower_bound(key);
+        found = critnib_find(c, key, FIND_GE, &rkey, &rvalue);
+        if (ge == ref.end()) {
+            ASSERT_EQ(found, 0);
+        } else {
+            ASSERT_EQ(found, 1);
+            ASSERT_EQ(rkey, ge->first);
+            ASSERT_EQ(rvalue, ge->second);
+        }
+    }
+
+    critnib *c = nullptr;
+};
+
+static void *valueOf(uintptr_t key) { return (void *)((key << 1) | 1); }
+
+TEST_P(CritnibTest, insertFindRemove) {
+    std::mt19937_64 gen(0);
+    std::map<uintptr_t, void *> ref;
+
+    // keys clustered in a few ranges, like the addresses of allocations
+    const uintptr_t bases[] = {0x1000, 0x7f0000000000, 0x7fff00000000};
+    auto randomKey = [&]() {
+        uintptr_t base = bases[gen() % 3];
+        return base + (gen() % 4096) * 64;
+    };
+
+    for (int i = 0; i < 20000; i++) {
+        uintptr_t key = randomKey();
+        if (gen() % 3) {
+            int ret = critnib_insert(c, key, valueOf(key), 0);
+            ASSERT_EQ(ret, ref.count(key) ? EEXIST : 0);
+            ref[key] = valueOf(key);
+        } else {
+            auto it = ref.find(key);
+            ASSERT_EQ(critnib_remove(c, key),
+                      it == ref.end() ? nullptr : it->second);
+            ref.erase(key);
+        }
+
+        if (i % 16 == 0) {
+            checkKey(ref, randomKey());
+        }
+    }
+
+    for (int i = 0; i < 10000; i++) {
+        checkKey(ref, randomKey());
+    }
+
+    // boundary keys
+    checkKey(ref, 0);
+    checkKey(ref, UINTPTR_MAX);
+    ASSERT_EQ(critnib_insert(c, UINTPTR_MAX, valueOf(1), 0), 0);
+    ref[UINTPTR_MAX] = valueOf(1);
+    checkKey(ref, UINTPTR_MAX);
+    checkKey(ref, UINTPTR_MAX - 1);
+
+    // iteration visits all keys in order
+    std::vector<uintptr_t> keys;
+    critnib_iter(
+        c, 0, UINTPTR_MAX,
+        [](uintptr_t key, void *, void *privdata) {
+            ((std::vector<uintptr_t> *)privdata)->push_back(key);
+            return 0;
+        },
+        &keys);
+    ASSERT_EQ(keys.size(), ref.size());
+    size_t idx = 0;
+    for (auto &kv : ref) {
+        ASSERT_EQ(keys[idx++], kv.first);
+    }
+
+    for (auto &kv : ref) {
+        ASSERT_EQ(critnib_remove(c, kv.first), kv.second);
+    }
+    checkKey({}, bases[1]);
+}
+
+TEST_P(CritnibTest, updateValue) {
+    ASSERT_EQ(critnib_insert(c, 0x1000, valueOf(1), 0), 0);
+    ASSERT_EQ(critnib_insert(c, 0x1000, valueOf(2), 0), EEXIST);
+    ASSERT_EQ(critnib_get(c, 0x1000), valueOf(1));
+    ASSERT_EQ(critnib_insert(c, 0x1000, valueOf(2), 1), 0);
+    ASSERT_EQ(critnib_get(c, 0x1000), valueOf(2));
+    ASSERT_EQ(critnib_remove(c, 0x1000), valueOf(2));
+    ASSERT_EQ(critnib_get(c, 0x1000), nullptr);
+}
+
+TEST_P(CritnibTest, insertBulk) {
+    std::vector<uintptr_t> keys;
+    std::vector<void *> values;
+    for (uintptr_t i = 1; i <= 1000; i++) {
+        keys.push_back(i * 0x1000);
+        values.push_back(valueOf(i * 0x1000));
+    }
+
+    ASSERT_EQ(critnib_insert_bulk(c, keys.data(), values.data(), keys.size()),
+              0);
+    for (size_t i = 0; i < keys.size(); i++) {
+        ASSERT_EQ(critnib_get(c, keys[i]), values[i]);
+    }
+
+    // a duplicate key rolls back the whole batch
+    uintptr_t newKeys[] = {0x500, 0x1500, 0x2000, 0x2500};
+    void *newValues[] = {valueOf(0x500), valueOf(0x1500), valueOf(0x2000),
+                         valueOf(0x2500)};
+    ASSERT_EQ(critnib_insert_bulk(c, newKeys, newValues, 4), EEXIST);
+    ASSERT_EQ(critnib_get(c, 0x500), nullptr);
+    ASSERT_EQ(critnib_get(c, 0x1500), nullptr);
+    ASSERT_EQ(critnib_get(c, 0x2000), valueOf(0x2000));
+    ASSERT_EQ(critnib_get(c, 0x2500), nullptr);
+
+    ASSERT_EQ(critnib_insert_bulk(c, nullptr, nullptr, 0), 0);
+}
+
+TEST_P(CritnibTest, removeRange) {
+    std::map<uintptr_t, void *> ref;
+    for (uintptr_t i = 1; i <= 4096; i++) {
+        uintptr_t key = i * 0x40;
+        ASSERT_EQ(critnib_insert(c, key, valueOf(key), 0), 0);
+        ref[key] = valueOf(key);
+    }
+
+    std::vector<std::pair<uintptr_t, void *>> removed;
+    auto cb = [](uintptr_t key, void *value, void *privdata) {
+        ((std::vector<std::pair<uintptr_t, void *>> *)privdata)
+            ->emplace_back(key, value);
+    };
+
+    // remove keys in [0x1001, 0x2003f], the bounds are not keys
+    size_t count = critnib_remove_range(c, 0x1001, 0x20000 + 0x3f, cb,
+                                        &removed);
+    ASSERT_EQ(count, removed.size());
+    auto first = ref.lower_bound(0x1001);
+    auto last = ref.upper_bound(0x20000 + 0x3f);
+    ASSERT_EQ(count, (size_t)std::distance(first, last));
+    size_t idx = 0;
+    for (auto it = first; it != last; ++it, ++idx) {
+        ASSERT_EQ(removed[idx].first, it->first);
+        ASSERT_EQ(removed[idx].second, it->second);
+    }
+    ref.erase(first, last);
+
+    for (uintptr_t key = 0; key <= 4097 * 0x40; key += 0x20) {
+        checkKey(ref, key);
+    }
+
+    // an empty range
+    ASSERT_EQ(critnib_remove_range(c, 0x1001, 0x1002, nullptr, nullptr), 0);
+
+    // remove everything
+    ASSERT_EQ(critnib_remove_range(c, 0, UINTPTR_MAX, nullptr, nullptr),
+              ref.size());
+    checkKey({}, 0x40);
+}
+
+TEST_P(CritnibTest, removeRangeConcurrentReadersMt) {
+    static constexpr uintptr_t NUM_KEYS = 1024;
+    static constexpr uintptr_t STRIDE = 0x1000;
+    static constexpr uintptr_t CHURN_BASE = 0x100000000;
+
+    for (uintptr_t i = 1; i <= NUM_KEYS; i++) {
+        ASSERT_EQ(critnib_insert(c, i * STRIDE, valueOf(i * STRIDE), 0), 0);
+    }
+
+    // a writer inserts and removes a whole range of keys above the stable
+    // ones at once
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        std::vector<uintptr_t> keys;
+        std::vector<void *> values;
+        for (uintptr_t i = 0; i < 256; i++) {
+            keys.push_back(CHURN_BASE + i * STRIDE);
+            values.push_back(valueOf(CHURN_BASE + i * STRIDE));
+        }
+
+        while (!stop.load()) {
+            for (size_t i = 0; i < keys.size(); i++) {
+                ASSERT_EQ(critnib_insert(c, keys[i], values[i], 0), 0);
+            }
+            ASSERT_EQ(critnib_remove_range(c, CHURN_BASE, UINTPTR_MAX,
+                                           nullptr, nullptr),
+                      keys.size());
+        }
+    });
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&, t] {
+            std::mt19937_64 gen(t);
+            for (int i = 0; i < 100000; i++) {
+                uintptr_t key = (gen() % NUM_KEYS + 1) * STRIDE;
+                ASSERT_EQ(critnib_get(c, key), valueOf(key));
+                ASSERT_EQ(critnib_find_le(c, key + 1), valueOf(key));
+            }
+        });
+    }
+
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    stop.store(true);
+    writer.join();
+}
+
+TEST_P(CritnibTest, concurrentReadersMt) {
+    static constexpr uintptr_t NUM_STABLE = 1024;
+    static constexpr uintptr_t STRIDE = 0x10000;
+
+    // stable keys at even indices, a writer churns keys at odd indices
+    for (uintptr_t i = 0; i < NUM_STABLE; i++) {
+        uintptr_t key = 2 * i * STRIDE + STRIDE;
+        ASSERT_EQ(critnib_insert(c, key, valueOf(key), 0), 0);
+    }
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        std::mt19937_64 gen(1);
+        while (!stop.load()) {
+            uintptr_t key = (2 * (gen() % NUM_STABLE) + 1) * STRIDE + STRIDE;
+            if (critnib_insert(c, key, valueOf(key), 0) == EEXIST) {
+                critnib_remove(c, key);
+            }
+        }
+    });
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&, t] {
+            std::mt19937_64 gen(t + 2);
+            for (int i = 0; i < 100000; i++) {
+                uintptr_t idx = gen() % NUM_STABLE;
+                uintptr_t key = 2 * idx * STRIDE + STRIDE;
+                ASSERT_EQ(critnib_get(c, key), valueOf(key));
+
+                // the greatest key <= (key + STRIDE / 2) is always key
+                uintptr_t rkey = 0;
+                void *rvalue = nullptr;
+                ASSERT_EQ(critnib_find(c, key + STRIDE / 2, FIND_LE, &rkey,
+                                       &rvalue),
+                          1);
+                ASSERT_EQ(rkey, key);
+                ASSERT_EQ(rvalue, valueOf(key));
+            }
+        });
+    }
+
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    stop.store(true);
+    writer.join();
+}
+
+INSTANTIATE_TEST_SUITE_P(critnibVariants, CritnibTest,
+                         ::testing::Values(CRITNIB_VARIANT_4BIT,
+                                           CRITNIB_VARIANT_6BIT,
+                                           CRITNIB_VARIANT_8BIT));
@@ -16,8 +16,10 @@
 #include <umf/pools/pool_proxy.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <numeric>
+#include <thread>
 #include <random>
 #include <tuple>
 
@@ -389,6 +391,168 @@ TEST_P(umfIpcTest, BasicFlow) {
     EXPECT_EQ(stat.closeCount, stat.openCount);
 }
 
+TEST_P(umfIpcTest, GetIPCHandleInBuffer) {
+    constexpr size_t SIZE = 100;
+    std::vector<int> expected_data(SIZE);
+    umf::pool_unique_handle_t pool = makePool();
+    ASSERT_NE(pool.get(), nullptr);
+
+    int *ptr = (int *)umfPoolMalloc(pool.get(), SIZE * sizeof(int));
+    ASSERT_NE(ptr, nullptr);
+    std::iota(expected_data.begin(), expected_data.end(), 0);
+    memAccessor->copy(ptr, expected_data.data(), SIZE * sizeof(int));
+
+    size_t handleSize = 0;
+    umf_result_t ret = umfPoolGetIPCHandleSize(pool.get(), &handleSize);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // uint64_t elements keep the buffer aligned
+    std::vector<uint64_t> buffer(handleSize / sizeof(uint64_t) + 1);
+    umf_ipc_handle_t ipcHandle = nullptr;
+    ret = umfGetIPCHandleInBuffer(ptr + SIZE / 2, buffer.data(), handleSize,
+                                  &ipcHandle);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ((void *)ipcHandle, (void *)buffer.data());
+
+    umf_ipc_handler_handle_t ipcHandler = nullptr;
+    ret = umfPoolGetIPCHandler(pool.get(), &ipcHandler);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    void *halfArray = nullptr;
+    ret = umfOpenIPCHandle(ipcHandler, ipcHandle, &halfArray);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // the allocated handle is opened at the same address
+    umf_ipc_handle_t allocatedHandle = nullptr;
+    size_t allocatedHandleSize = 0;
+    ret = umfGetIPCHandle(ptr + SIZE / 2, &allocatedHandle,
+                          &allocatedHandleSize);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(allocatedHandleSize, handleSize);
+    void *allocatedHalfArray = nullptr;
+    ret = umfOpenIPCHandle(ipcHandler, allocatedHandle, &allocatedHalfArray);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(allocatedHalfArray, halfArray);
+    ret = umfCloseIPCHandle(allocatedHalfArray);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ret = umfPutIPCHandle(allocatedHandle);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    std::vector<int> actual_data(SIZE / 2);
+    memAccessor->copy(actual_data.data(), halfArray, SIZE / 2 * sizeof(int));
+    ASSERT_TRUE(std::equal(expected_data.begin() + SIZE / 2,
+                           expected_data.end(), actual_data.begin()));
+
+    ret = umfCloseIPCHandle(halfArray);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    ret = umfPutIPCHandleInBuffer(ipcHandle);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // too small or misaligned buffer
+    ret = umfGetIPCHandleInBuffer(ptr, buffer.data(), handleSize - 1,
+                                  &ipcHandle);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ret = umfGetIPCHandleInBuffer(ptr, (char *)buffer.data() + 1, handleSize,
+                                  &ipcHandle);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ret = umfGetIPCHandleInBuffer(ptr, nullptr, handleSize, &ipcHandle);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ret = umfPoolFree(pool.get(), ptr);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.putCount, stat.getCount);
+    EXPECT_EQ(stat.closeCount, stat.openCount);
+}
+
+TEST_P(umfIpcTest, BatchedGetOpenHandles) {
+    constexpr size_t SIZE = 64;
+    constexpr size_t NUM_ALLOCS = 32;
+    umf::pool_unique_handle_t pool = makePool();
+    ASSERT_NE(pool.get(), nullptr);
+
+    std::vector<void *> ptrs(NUM_ALLOCS);
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ptrs[i] = umfPoolMalloc(pool.get(), SIZE * sizeof(size_t));
+        ASSERT_NE(ptrs[i], nullptr);
+        std::vector<size_t> data(SIZE, i);
+        memAccessor->copy(ptrs[i], data.data(), SIZE * sizeof(size_t));
+    }
+
+    std::vector<umf_ipc_handle_t> ipcHandles(NUM_ALLOCS);
+    std::vector<size_t> sizes(NUM_ALLOCS);
+    umf_result_t ret = umfGetIPCHandles(ptrs.data(), NUM_ALLOCS,
+                                        ipcHandles.data(), sizes.data());
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // batched handles are the same as the ones got one by one
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        umf_ipc_handle_t ipcHandle = nullptr;
+        size_t size = 0;
+        ret = umfGetIPCHandle(ptrs[i], &ipcHandle, &size);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ASSERT_EQ(size, sizes[i]);
+        ASSERT_EQ(memcmp(ipcHandle, ipcHandles[i], size), 0);
+        ret = umfPutIPCHandle(ipcHandle);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    umf_ipc_handler_handle_t ipcHandler = nullptr;
+    ret = umfPoolGetIPCHandler(pool.get(), &ipcHandler);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    std::vector<void *> openedPtrs(NUM_ALLOCS);
+    ret = umfOpenIPCHandles(ipcHandler, ipcHandles.data(), NUM_ALLOCS,
+                            openedPtrs.data());
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // every remote allocation is mapped once
+    EXPECT_EQ(stat.openCount, stat.allocCount);
+
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        std::vector<size_t> data(SIZE);
+        memAccessor->copy(data.data(), openedPtrs[i], SIZE * sizeof(size_t));
+        ASSERT_TRUE(std::all_of(data.begin(), data.end(),
+                                [i](size_t v) { return v == i; }));
+    }
+
+    // each opened pointer holds its own reference
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ret = umfCloseIPCHandle(openedPtrs[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    // nothing is created nor opened when one of the arguments is invalid
+    umf_ipc_handle_t lastHandle = ipcHandles[NUM_ALLOCS - 1];
+    ipcHandles[NUM_ALLOCS - 1] = nullptr;
+    ret = umfOpenIPCHandles(ipcHandler, ipcHandles.data(), NUM_ALLOCS,
+                            openedPtrs.data());
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(openedPtrs[0], nullptr);
+    ipcHandles[NUM_ALLOCS - 1] = lastHandle;
+
+    int local_var;
+    std::vector<void *> badPtrs = {ptrs[0], &local_var};
+    std::vector<umf_ipc_handle_t> badHandles(2);
+    ret = umfGetIPCHandles(badPtrs.data(), 2, badHandles.data(), sizes.data());
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(badHandles[0], nullptr);
+
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ret = umfPutIPCHandle(ipcHandles[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ret = umfPoolFree(pool.get(), ptrs[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.closeCount, stat.openCount);
+}
+
 TEST_P(umfIpcTest, GetPoolByOpenedHandle) {
     constexpr size_t SIZE = 100;
     constexpr size_t NUM_ALLOCS = 100;
@@ -664,6 +828,324 @@ TEST_P(umfIpcTest, ConcurrentOpenCloseHandles) {
     EXPECT_EQ(stat.openCount, stat.closeCount);
 }
 
+TEST_P(umfIpcTest, PrefetchIPCHandle) {
+    constexpr size_t SIZE = 100;
+    constexpr size_t NUM_ALLOCS = 2;
+    umf::pool_unique_handle_t pool = makePool();
+    ASSERT_NE(pool.get(), nullptr);
+
+    umf_ipc_handler_handle_t ipcHandler = nullptr;
+    umf_result_t ret = umfPoolGetIPCHandler(pool.get(), &ipcHandler);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfPrefetchIPCHandle(nullptr, nullptr);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    void *ptrs[NUM_ALLOCS];
+    umf_ipc_handle_t ipcHandles[NUM_ALLOCS];
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ptrs[i] = umfPoolMalloc(pool.get(), SIZE);
+        ASSERT_NE(ptrs[i], nullptr);
+        memset(ptrs[i], (int)i + 1, SIZE);
+        size_t handleSize = 0;
+        ret = umfGetIPCHandle(ptrs[i], &ipcHandles[i], &handleSize);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ret = umfPrefetchIPCHandle(ipcHandler, ipcHandles[i]);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    // wait for the prefetch threads to open the handles
+    size_t numMappings = stat.allocCount;
+    for (int i = 0; i < 1000 && stat.openCount < numMappings; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(stat.openCount, numMappings);
+
+    // the prefetched mappings are found in the cache of opened handles
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        void *ptr = nullptr;
+        ret = umfOpenIPCHandle(ipcHandler, ipcHandles[i], &ptr);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        EXPECT_EQ(*(char *)ptr, (char)(i + 1));
+        ret = umfCloseIPCHandle(ptr);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+    EXPECT_EQ(stat.openCount, numMappings);
+
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ret = umfPutIPCHandle(ipcHandles[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+        ret = umfPoolFree(pool.get(), ptrs[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.closeCount, stat.openCount);
+}
+
+TEST_P(umfIpcTest, OpenedHandlesCacheLimit) {
+    constexpr size_t SIZE = 100;
+    constexpr size_t NUM_ALLOCS = 8;
+
+    // the cache of opened IPC handles is limited by the UMF_IPC_CACHE
+    // environment variable, it is unlimited by default
+    size_t maxEntries = 0;
+    const char *env = getenv("UMF_IPC_CACHE");
+    const char *option = env ? strstr(env, "max_entries=") : nullptr;
+    if (option) {
+        maxEntries = strtoull(option + strlen("max_entries="), nullptr, 10);
+    }
+
+    umf::pool_unique_handle_t pool = makePool();
+    ASSERT_NE(pool.get(), nullptr);
+
+    umf_ipc_handler_handle_t ipcHandler = nullptr;
+    umf_result_t ret = umfPoolGetIPCHandler(pool.get(), &ipcHandler);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    void *ptrs[NUM_ALLOCS];
+    umf_ipc_handle_t ipcHandles[NUM_ALLOCS];
+    void *openedPtrs[NUM_ALLOCS];
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ptrs[i] = umfPoolMalloc(pool.get(), SIZE);
+        ASSERT_NE(ptrs[i], nullptr);
+        size_t handleSize = 0;
+        ret = umfGetIPCHandle(ptrs[i], &ipcHandles[i], &handleSize);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ret = umfOpenIPCHandle(ipcHandler, ipcHandles[i], &openedPtrs[i]);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    // allocations from the same provider allocation share the mapping
+    size_t numMappings = stat.openCount;
+    EXPECT_EQ(numMappings, stat.allocCount);
+
+    // opened handles are never evicted, even if the cache is full
+    EXPECT_EQ(stat.closeCount, 0);
+
+    // opening the handle again is a cache hit and takes another reference
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        void *ptr = nullptr;
+        ret = umfOpenIPCHandle(ipcHandler, ipcHandles[i], &ptr);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ASSERT_EQ(ptr, openedPtrs[i]);
+        ret = umfCloseIPCHandle(ptr);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+    EXPECT_EQ(stat.openCount, numMappings);
+    EXPECT_EQ(stat.closeCount, 0);
+
+    // closed handles are evicted when the cache exceeds its limit
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ret = umfCloseIPCHandle(openedPtrs[i]);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+    size_t cached =
+        maxEntries ? std::min(maxEntries, numMappings) : numMappings;
+    EXPECT_EQ(stat.closeCount, numMappings - cached);
+
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ret = umfPutIPCHandle(ipcHandles[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+        ret = umfPoolFree(pool.get(), ptrs[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.closeCount, stat.openCount);
+}
+
+TEST_P(umfIpcTest, IPCHandleCacheStats) {
+    constexpr size_t SIZE = 100;
+    constexpr size_t NUM_ALLOCS = 8;
+
+    // the cache of IPC handles of the producer is limited by the
+    // UMF_IPC_CACHE environment variable, 16384 entries by default
+    size_t maxHandles = 16384;
+    const char *env = getenv("UMF_IPC_CACHE");
+    const char *option = env ? strstr(env, "max_handles=") : nullptr;
+    if (option) {
+        maxHandles = strtoull(option + strlen("max_handles="), nullptr, 10);
+    }
+
+    umf::pool_unique_handle_t pool = makePool();
+    ASSERT_NE(pool.get(), nullptr);
+
+    umf_ipc_handle_cache_stats_t stats;
+    umf_result_t ret = umfPoolGetIPCHandleCacheStats(pool.get(), &stats);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_EQ(stats.entries, 0);
+    EXPECT_EQ(stats.hits, 0);
+    EXPECT_EQ(stats.misses, 0);
+    EXPECT_EQ(stats.evictions, 0);
+
+    ret = umfPoolGetIPCHandleCacheStats(pool.get(), nullptr);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    void *ptrs[NUM_ALLOCS];
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ptrs[i] = umfPoolMalloc(pool.get(), SIZE);
+        ASSERT_NE(ptrs[i], nullptr);
+    }
+
+    // the second round hits the cache unless the entries were evicted
+    for (int round = 0; round < 2; round++) {
+        for (size_t i = 0; i < NUM_ALLOCS; i++) {
+            umf_ipc_handle_t ipcHandle = nullptr;
+            size_t handleSize = 0;
+            ret = umfGetIPCHandle(ptrs[i], &ipcHandle, &handleSize);
+            ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+            ret = umfPutIPCHandle(ipcHandle);
+            ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        }
+    }
+
+    ret = umfPoolGetIPCHandleCacheStats(pool.get(), &stats);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_EQ(stats.hits + stats.misses, 2 * NUM_ALLOCS);
+    EXPECT_EQ(stats.misses, stat.getCount);
+    EXPECT_EQ(stats.evictions, stat.putCount);
+    EXPECT_EQ(stats.entries, stat.getCount - stat.putCount);
+    EXPECT_LE(stats.entries, maxHandles);
+    if (stats.misses > maxHandles) {
+        EXPECT_GT(stats.evictions, 0);
+    } else {
+        EXPECT_EQ(stats.evictions, 0);
+        EXPECT_EQ(stats.hits, NUM_ALLOCS + (NUM_ALLOCS - stats.misses));
+    }
+
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ret = umfPoolFree(pool.get(), ptrs[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.putCount, stat.getCount);
+}
+
+TEST_P(umfIpcTest, HeldIPCHandlesAreNotEvicted) {
+    constexpr size_t SIZE = 100;
+    constexpr size_t NUM_ALLOCS = 8;
+
+    size_t maxHandles = 16384;
+    const char *env = getenv("UMF_IPC_CACHE");
+    const char *option = env ? strstr(env, "max_handles=") : nullptr;
+    if (option) {
+        maxHandles = strtoull(option + strlen("max_handles="), nullptr, 10);
+    }
+
+    umf::pool_unique_handle_t pool = makePool();
+    ASSERT_NE(pool.get(), nullptr);
+
+    umf_ipc_handler_handle_t ipcHandler = nullptr;
+    umf_result_t ret = umfPoolGetIPCHandler(pool.get(), &ipcHandler);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    void *ptrs[NUM_ALLOCS];
+    umf_ipc_handle_t ipcHandles[NUM_ALLOCS];
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ptrs[i] = umfPoolMalloc(pool.get(), SIZE);
+        ASSERT_NE(ptrs[i], nullptr);
+        memset(ptrs[i], (int)i + 1, SIZE);
+
+        size_t handleSize = 0;
+        ret = umfGetIPCHandle(ptrs[i], &ipcHandles[i], &handleSize);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    // none of the handles can be released while the user holds them,
+    // even if there are more of them than the limit of the cache
+    umf_ipc_handle_cache_stats_t stats;
+    ret = umfPoolGetIPCHandleCacheStats(pool.get(), &stats);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_EQ(stats.entries, stats.misses);
+    EXPECT_EQ(stats.evictions, 0);
+    EXPECT_EQ(stat.putCount, 0);
+
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        void *ptr = nullptr;
+        ret = umfOpenIPCHandle(ipcHandler, ipcHandles[i], &ptr);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        EXPECT_EQ(*(char *)ptr, (char)(i + 1));
+        ret = umfCloseIPCHandle(ptr);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    // the cache fits its limit again once the handles are put
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ret = umfPutIPCHandle(ipcHandles[i]);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    ret = umfPoolGetIPCHandleCacheStats(pool.get(), &stats);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_LE(stats.entries, maxHandles);
+    EXPECT_EQ(stats.evictions, stat.putCount);
+
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        ret = umfPoolFree(pool.get(), ptrs[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.putCount, stat.getCount);
+}
+
+TEST_P(umfIpcTest, ConcurrentReopenHandlesMt) {
+    constexpr size_t ALLOC_SIZE = 100;
+    constexpr size_t NUM_POINTERS = 16;
+    constexpr size_t NUM_ITERS = 500;
+    umf::pool_unique_handle_t pool = makePool();
+    ASSERT_NE(pool.get(), nullptr);
+
+    std::vector<void *> ptrs;
+    std::vector<umf_ipc_handle_t> ipcHandles;
+    for (size_t i = 0; i < NUM_POINTERS; ++i) {
+        void *ptr = umfPoolMalloc(pool.get(), ALLOC_SIZE);
+        ASSERT_NE(ptr, nullptr);
+        ptrs.push_back(ptr);
+
+        umf_ipc_handle_t ipcHandle;
+        size_t handleSize;
+        umf_result_t ret = umfGetIPCHandle(ptr, &ipcHandle, &handleSize);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ipcHandles.push_back(ipcHandle);
+    }
+
+    umf_ipc_handler_handle_t ipcHandler = nullptr;
+    umf_result_t ret = umfPoolGetIPCHandler(pool.get(), &ipcHandler);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // Threads open and close the same handles over and over, so most opens
+    // are cache hits racing with the evictions of the closed handles.
+    umf_test::syncthreads_barrier syncthreads(NTHREADS);
+    auto reopenHandlesFn = [&](size_t tid) {
+        std::mt19937 gen(tid);
+        syncthreads();
+        for (size_t i = 0; i < NUM_ITERS; ++i) {
+            umf_ipc_handle_t ipcHandle = ipcHandles[gen() % NUM_POINTERS];
+            void *ptr = nullptr;
+            umf_result_t ret = umfOpenIPCHandle(ipcHandler, ipcHandle, &ptr);
+            ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+            ASSERT_NE(ptr, nullptr);
+            ret = umfCloseIPCHandle(ptr);
+            ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        }
+    };
+
+    umf_test::parallel_exec(NTHREADS, reopenHandlesFn);
+
+    for (size_t i = 0; i < NUM_POINTERS; ++i) {
+        ret = umfPutIPCHandle(ipcHandles[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+        ret = umfPoolFree(pool.get(), ptrs[i]);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.openCount, stat.closeCount);
+}
+
 TEST_P(umfIpcTest, ConcurrentDestroyIpcHandlers) {
     constexpr size_t SIZE = 100;
     constexpr size_t NUM_ALLOCS = 100;
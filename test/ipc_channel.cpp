@@ -0,0 +1,291 @@
+// Copyright (C) 2025 Intel Corporation
+// Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "base.hpp"
+#include "pool.hpp"
+
+#include <umf/ipc.h>
+#include <umf/memory_pool.h>
+#include <umf/pools/pool_disjoint.h>
+#include <umf/providers/provider_os_memory.h>
+
+using umf_test::test;
+
+struct ipcChannelTest : umf_test::test {
+    void SetUp() override {
+        test::SetUp();
+
+        umf_os_memory_provider_params_handle_t providerParams = nullptr;
+        umf_result_t ret = umfOsMemoryProviderParamsCreate(&providerParams);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ret = umfOsMemoryProviderParamsSetVisibility(providerParams,
+                                                     UMF_MEM_MAP_SHARED);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        umf_disjoint_pool_params_handle_t poolParams = nullptr;
+        ret = umfDisjointPoolParamsCreate(&poolParams);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        umf_memory_provider_handle_t hProvider = nullptr;
+        ret = umfMemoryProviderCreate(umfOsMemoryProviderOps(), providerParams,
+                                      &hProvider);
+        umfOsMemoryProviderParamsDestroy(providerParams);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        ret = umfPoolCreate(umfDisjointPoolOps(), hProvider, poolParams,
+                            UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &pool);
+        umfDisjointPoolParamsDestroy(poolParams);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        ret = umfPoolGetIPCHandler(pool, &ipcHandler);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        ret = umfPoolGetIPCHandleSize(pool, &handleSize);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    void TearDown() override {
+        if (pool) {
+            umfPoolDestroy(pool);
+        }
+        test::TearDown();
+    }
+
+    // creates a channel and opens it like a consumer process would do
+    void createChannel(size_t capacity, umf_ipc_channel_handle_t *producer,
+                       umf_ipc_channel_handle_t *consumer) {
+        umf_result_t ret =
+            umfIPCChannelCreate(pool, capacity, handleSize, producer);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        umf_ipc_handle_t channelHandle = nullptr;
+        size_t channelHandleSize = 0;
+        ret = umfIPCChannelGetIPCHandle(*producer, &channelHandle,
+                                        &channelHandleSize);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        ret = umfIPCChannelOpen(ipcHandler, channelHandle, consumer);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        ret = umfPutIPCHandle(channelHandle);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    umf_memory_pool_handle_t pool = nullptr;
+    umf_ipc_handler_handle_t ipcHandler = nullptr;
+    size_t handleSize = 0;
+};
+
+TEST_F(ipcChannelTest, sendReceive) {
+    constexpr size_t CAPACITY = 8;
+    constexpr size_t NUM_BUFFERS = 20;
+    constexpr size_t SIZE = 1024;
+
+    umf_ipc_channel_handle_t producer = nullptr;
+    umf_ipc_channel_handle_t consumer = nullptr;
+    createChannel(CAPACITY, &producer, &consumer);
+
+    std::vector<void *> ptrs(NUM_BUFFERS);
+    std::vector<umf_ipc_handle_t> handles(NUM_BUFFERS);
+    std::vector<size_t> sizes(NUM_BUFFERS);
+    for (size_t i = 0; i < NUM_BUFFERS; i++) {
+        ptrs[i] = umfPoolMalloc(pool, SIZE);
+        ASSERT_NE(ptrs[i], nullptr);
+        memset(ptrs[i], (int)i + 1, SIZE);
+        umf_result_t ret = umfGetIPCHandle(ptrs[i], &handles[i], &sizes[i]);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    // nothing to receive yet
+    void *opened[NUM_BUFFERS];
+    size_t received = 0;
+    umf_result_t ret =
+        umfIPCChannelReceive(consumer, ipcHandler, opened, NUM_BUFFERS,
+                             &received);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(received, 0);
+
+    size_t sentTotal = 0;
+    size_t receivedTotal = 0;
+    while (receivedTotal < NUM_BUFFERS) {
+        // only CAPACITY handles fit in the channel
+        size_t sent = 0;
+        ret = umfIPCChannelSend(producer, handles.data() + sentTotal,
+                                sizes.data() + sentTotal,
+                                NUM_BUFFERS - sentTotal, &sent);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ASSERT_EQ(sent, std::min(CAPACITY, NUM_BUFFERS - sentTotal));
+        sentTotal += sent;
+
+        ret = umfIPCChannelReceive(consumer, ipcHandler, opened, NUM_BUFFERS,
+                                   &received);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ASSERT_EQ(received, sent);
+
+        for (size_t i = 0; i < received; i++) {
+            ASSERT_EQ(*(char *)opened[i], (char)(receivedTotal + i + 1));
+            ret = umfCloseIPCHandle(opened[i]);
+            ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        }
+        receivedTotal += received;
+    }
+
+    for (size_t i = 0; i < NUM_BUFFERS; i++) {
+        ret = umfPutIPCHandle(handles[i]);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ret = umfPoolFree(pool, ptrs[i]);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    ASSERT_EQ(umfIPCChannelDestroy(consumer), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfIPCChannelDestroy(producer), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(ipcChannelTest, multipleProducersMt) {
+    constexpr size_t NUM_PRODUCERS = 4;
+    constexpr size_t NUM_BUFFERS = 8; // per producer
+    constexpr size_t NUM_ROUNDS = 500;
+    constexpr size_t TOTAL = NUM_PRODUCERS * NUM_BUFFERS * NUM_ROUNDS;
+
+    umf_ipc_channel_handle_t producer = nullptr;
+    umf_ipc_channel_handle_t consumer = nullptr;
+    createChannel(64, &producer, &consumer);
+
+    // the first word of every buffer is its index
+    std::vector<size_t *> ptrs(NUM_PRODUCERS * NUM_BUFFERS);
+    std::vector<umf_ipc_handle_t> handles(ptrs.size());
+    std::vector<size_t> sizes(ptrs.size());
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        ptrs[i] = (size_t *)umfPoolMalloc(pool, sizeof(size_t));
+        ASSERT_NE(ptrs[i], nullptr);
+        *ptrs[i] = i;
+        umf_result_t ret = umfGetIPCHandle(ptrs[i], &handles[i], &sizes[i]);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    // a failure stops all threads, gtest assertions are checked after join()
+    std::atomic<bool> failed(false);
+
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < NUM_PRODUCERS; t++) {
+        producers.emplace_back([&, t] {
+            size_t first = t * NUM_BUFFERS;
+            for (size_t r = 0; r < NUM_ROUNDS && !failed; r++) {
+                size_t sentTotal = 0;
+                while (sentTotal < NUM_BUFFERS && !failed) {
+                    size_t sent = 0;
+                    umf_result_t ret = umfIPCChannelSend(
+                        producer, &handles[first + sentTotal],
+                        &sizes[first + sentTotal], NUM_BUFFERS - sentTotal,
+                        &sent);
+                    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+                    if (ret != UMF_RESULT_SUCCESS) {
+                        failed = true;
+                        break;
+                    }
+                    sentTotal += sent;
+                    if (sent == 0) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+    }
+
+    std::vector<size_t> counts(ptrs.size(), 0);
+    size_t receivedTotal = 0;
+    void *opened[32];
+    while (receivedTotal < TOTAL && !failed) {
+        size_t received = 0;
+        umf_result_t ret =
+            umfIPCChannelReceive(consumer, ipcHandler, opened, 32, &received);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+        if (ret != UMF_RESULT_SUCCESS) {
+            failed = true;
+            break;
+        }
+        for (size_t i = 0; i < received; i++) {
+            size_t idx = *(size_t *)opened[i];
+            EXPECT_LT(idx, counts.size());
+            if (idx < counts.size()) {
+                counts[idx]++;
+            } else {
+                failed = true;
+            }
+            EXPECT_EQ(umfCloseIPCHandle(opened[i]), UMF_RESULT_SUCCESS);
+        }
+        receivedTotal += received;
+        if (received == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto &thread : producers) {
+        thread.join();
+    }
+
+    ASSERT_FALSE(failed);
+    ASSERT_EQ(receivedTotal, TOTAL);
+
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        ASSERT_EQ(counts[i], NUM_ROUNDS);
+        ASSERT_EQ(umfPutIPCHandle(handles[i]), UMF_RESULT_SUCCESS);
+        ASSERT_EQ(umfPoolFree(pool, ptrs[i]), UMF_RESULT_SUCCESS);
+    }
+
+    ASSERT_EQ(umfIPCChannelDestroy(consumer), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfIPCChannelDestroy(producer), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(ipcChannelTest, invalidArguments) {
+    umf_ipc_channel_handle_t channel = nullptr;
+    ASSERT_EQ(umfIPCChannelCreate(nullptr, 8, handleSize, &channel),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfIPCChannelCreate(pool, 0, handleSize, &channel),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfIPCChannelCreate(pool, 8, 0, &channel),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfIPCChannelCreate(pool, 8, handleSize, nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfIPCChannelDestroy(nullptr), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_ipc_channel_handle_t producer = nullptr;
+    umf_ipc_channel_handle_t consumer = nullptr;
+    createChannel(8, &producer, &consumer);
+
+    // a consumer cannot share the channel again
+    umf_ipc_handle_t channelHandle = nullptr;
+    size_t channelHandleSize = 0;
+    ASSERT_EQ(
+        umfIPCChannelGetIPCHandle(consumer, &channelHandle, &channelHandleSize),
+        UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // a handle larger than the slots of the channel
+    void *ptr = umfPoolMalloc(pool, 64);
+    ASSERT_NE(ptr, nullptr);
+    umf_ipc_handle_t handle = nullptr;
+    size_t size = 0;
+    ASSERT_EQ(umfGetIPCHandle(ptr, &handle, &size), UMF_RESULT_SUCCESS);
+    size_t tooLarge = handleSize + 1;
+    size_t sent = 0;
+    ASSERT_EQ(umfIPCChannelSend(producer, &handle, &tooLarge, 1, &sent),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfIPCChannelSend(producer, &handle, &size, 1, nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // the memory of an IPC handle is not a channel
+    ASSERT_EQ(umfIPCChannelOpen(ipcHandler, handle, &channel),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ASSERT_EQ(umfPutIPCHandle(handle), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+
+    ASSERT_EQ(umfIPCChannelDestroy(consumer), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfIPCChannelDestroy(producer), UMF_RESULT_SUCCESS);
+}
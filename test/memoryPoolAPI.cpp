@@ -20,11 +20,13 @@
 #endif
 
 #include <array>
+#include <atomic>
 #include <string>
 #include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 using umf_test::test;
 using namespace umf_test;
@@ -294,6 +296,291 @@ TEST_F(tagTest, SetAndGetInvalidPool) {
     ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
+struct provider_ba_global_split_merge : public provider_ba_global {
+    umf_result_t allocation_split(void *, size_t, size_t) noexcept {
+        return UMF_RESULT_SUCCESS;
+    }
+    umf_result_t allocation_merge(void *, void *, size_t) noexcept {
+        return UMF_RESULT_SUCCESS;
+    }
+};
+
+umf_memory_provider_ops_t BA_GLOBAL_SPLIT_MERGE_PROVIDER_OPS =
+    umf::providerMakeCOps<provider_ba_global_split_merge, void>();
+
+// Pool that splits and merges every region it allocates
+// through the tracking provider before returning it.
+struct split_merge_pool : public umf_test::pool_base_t {
+    static constexpr size_t REGION_SIZE = 16 * 4096;
+    static constexpr size_t NUM_SPLITS = 256;
+
+    umf_result_t initialize(umf_memory_provider_handle_t provider) noexcept {
+        hProvider = provider;
+        return UMF_RESULT_SUCCESS;
+    }
+    void *malloc(size_t) noexcept {
+        void *ptr = nullptr;
+        if (umfMemoryProviderAlloc(hProvider, REGION_SIZE, 0, &ptr) !=
+            UMF_RESULT_SUCCESS) {
+            return nullptr;
+        }
+
+        for (size_t i = 0; i < NUM_SPLITS; i++) {
+            size_t firstSize = ((i % 15) + 1) * 4096;
+            void *highPtr = (char *)ptr + firstSize;
+            if (umfMemoryProviderAllocationSplit(hProvider, ptr, REGION_SIZE,
+                                                 firstSize) !=
+                    UMF_RESULT_SUCCESS ||
+                umfMemoryProviderAllocationMerge(hProvider, ptr, highPtr,
+                                                 REGION_SIZE) !=
+                    UMF_RESULT_SUCCESS) {
+                umfMemoryProviderFree(hProvider, ptr, REGION_SIZE);
+                return nullptr;
+            }
+        }
+
+        return ptr;
+    }
+    umf_result_t free(void *ptr) noexcept {
+        return umfMemoryProviderFree(hProvider, ptr, REGION_SIZE);
+    }
+
+    umf_memory_provider_handle_t hProvider = nullptr;
+};
+
+umf_memory_pool_ops_t SPLIT_MERGE_POOL_OPS =
+    umf::poolMakeCOps<split_merge_pool, void>();
+
+TEST_F(test, splitMergeMultiplePoolsMt) {
+    static constexpr size_t NUM_THREADS = 8;
+    static constexpr size_t NUM_ALLOCS_PER_THREAD = 8;
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < NUM_THREADS; i++) {
+        threads.emplace_back([] {
+            auto provider = wrapProviderUnique(createProviderChecked(
+                &BA_GLOBAL_SPLIT_MERGE_PROVIDER_OPS, nullptr));
+            auto pool = wrapPoolUnique(createPoolChecked(
+                &SPLIT_MERGE_POOL_OPS, provider.get(), nullptr));
+
+            for (size_t j = 0; j < NUM_ALLOCS_PER_THREAD; j++) {
+                char *ptr = (char *)umfPoolMalloc(pool.get(), 0);
+                ASSERT_NE(ptr, nullptr);
+
+                // the whole region has to be tracked as a single one again
+                ASSERT_EQ(umfPoolByPtr(ptr), pool.get());
+                ASSERT_EQ(umfPoolByPtr(ptr + split_merge_pool::REGION_SIZE -
+                                       1),
+                          pool.get());
+
+                ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+// Provider returning the memory chosen by the test, so that
+// regions of different pools can be placed next to each other.
+struct provider_fixed_ptr : public provider_base_t {
+    static void *nextPtr;
+
+    umf_result_t alloc(size_t, size_t, void **ptr) noexcept {
+        *ptr = nextPtr;
+        return UMF_RESULT_SUCCESS;
+    }
+    umf_result_t free(void *, size_t) noexcept { return UMF_RESULT_SUCCESS; }
+};
+
+void *provider_fixed_ptr::nextPtr = nullptr;
+
+umf_memory_provider_ops_t FIXED_PTR_PROVIDER_OPS =
+    umf::providerMakeCOps<provider_fixed_ptr, void>();
+
+TEST_F(test, poolByPtrInterleavedPools) {
+    static constexpr size_t PAGE = 4096;
+    static constexpr size_t NUM_PAGES = 8;
+
+    std::vector<char> buffer((NUM_PAGES + 1) * PAGE);
+    char *base = (char *)ALIGN_UP((uintptr_t)buffer.data(), PAGE);
+
+    auto provider = wrapProviderUnique(
+        createProviderChecked(&FIXED_PTR_PROVIDER_OPS, nullptr));
+    auto poolA = wrapPoolUnique(
+        createPoolChecked(umfProxyPoolOps(), provider.get(), nullptr));
+    auto poolB = wrapPoolUnique(
+        createPoolChecked(umfProxyPoolOps(), provider.get(), nullptr));
+
+    auto allocPage = [&](umf_memory_pool_handle_t pool, size_t page) {
+        provider_fixed_ptr::nextPtr = base + page * PAGE;
+        void *ptr = umfPoolMalloc(pool, PAGE);
+        ASSERT_EQ(ptr, base + page * PAGE);
+    };
+
+    // pool A owns all pages
+    for (size_t i = 0; i < NUM_PAGES; i++) {
+        allocPage(poolA.get(), i);
+    }
+
+    // pages 0, 3 and 7 are handed over to pool B
+    for (size_t i : {0, 3, 7}) {
+        ASSERT_EQ(umfPoolFree(poolA.get(), base + i * PAGE),
+                  UMF_RESULT_SUCCESS);
+        allocPage(poolB.get(), i);
+    }
+
+    for (size_t i = 0; i < NUM_PAGES; i++) {
+        auto expected =
+            (i == 0 || i == 3 || i == 7) ? poolB.get() : poolA.get();
+        ASSERT_EQ(umfPoolByPtr(base + i * PAGE), expected);
+        ASSERT_EQ(umfPoolByPtr(base + i * PAGE + PAGE - 1), expected);
+    }
+
+    // page 3 goes back to pool A
+    ASSERT_EQ(umfPoolFree(poolB.get(), base + 3 * PAGE), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfPoolByPtr(base + 3 * PAGE), nullptr);
+    allocPage(poolA.get(), 3);
+    ASSERT_EQ(umfPoolByPtr(base + 3 * PAGE), poolA.get());
+    ASSERT_EQ(umfPoolByPtr(base + 2 * PAGE), poolA.get());
+    ASSERT_EQ(umfPoolByPtr(base + 4 * PAGE), poolA.get());
+
+    for (size_t i = 0; i < NUM_PAGES; i++) {
+        void *ptr = base + i * PAGE;
+        ASSERT_EQ(umfPoolFree(umfPoolByPtr(ptr), ptr), UMF_RESULT_SUCCESS);
+        ASSERT_EQ(umfPoolByPtr(ptr), nullptr);
+    }
+
+    // destroying pool B must not affect pool A
+    poolB.reset();
+    allocPage(poolA.get(), 0);
+    ASSERT_EQ(umfPoolByPtr(base), poolA.get());
+    ASSERT_EQ(umfPoolFree(poolA.get(), base), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, walkTrackedRegions) {
+    static constexpr size_t PAGE = 4096;
+    static constexpr size_t NUM_PAGES = 8;
+
+    std::vector<char> buffer((NUM_PAGES + 1) * PAGE);
+    char *base = (char *)ALIGN_UP((uintptr_t)buffer.data(), PAGE);
+
+    auto provider = wrapProviderUnique(
+        createProviderChecked(&FIXED_PTR_PROVIDER_OPS, nullptr));
+    auto poolA = wrapPoolUnique(
+        createPoolChecked(umfProxyPoolOps(), provider.get(), nullptr));
+    auto poolB = wrapPoolUnique(
+        createPoolChecked(umfProxyPoolOps(), provider.get(), nullptr));
+
+    // even pages belong to pool A, odd pages to pool B
+    for (size_t i = 0; i < NUM_PAGES; i++) {
+        provider_fixed_ptr::nextPtr = base + i * PAGE;
+        auto pool = (i % 2) ? poolB.get() : poolA.get();
+        ASSERT_EQ(umfPoolMalloc(pool, PAGE), base + i * PAGE);
+    }
+
+    using regions_t = std::vector<umf_tracked_region_t>;
+    auto collect = [](const umf_tracked_region_t *region, void *arg) {
+        // the callback can query the tracker
+        EXPECT_EQ(umfPoolByPtr(region->base), region->pool);
+        ((regions_t *)arg)->push_back(*region);
+        return 0;
+    };
+
+    regions_t regions;
+    ASSERT_EQ(umfPoolWalk(poolA.get(), collect, &regions), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(regions.size(), NUM_PAGES / 2);
+    for (size_t i = 0; i < regions.size(); i++) {
+        ASSERT_EQ(regions[i].base, base + 2 * i * PAGE);
+        ASSERT_EQ(regions[i].size, PAGE);
+        ASSERT_EQ(regions[i].pool, poolA.get());
+    }
+
+    // all regions of the process in the address order
+    regions.clear();
+    ASSERT_EQ(umfTrackerWalk(collect, &regions), UMF_RESULT_SUCCESS);
+    size_t page = 0;
+    for (size_t i = 0; i < regions.size(); i++) {
+        ASSERT_TRUE(i == 0 || regions[i - 1].base < regions[i].base);
+        char *ptr = (char *)regions[i].base;
+        if (ptr < base || ptr >= base + NUM_PAGES * PAGE) {
+            continue;
+        }
+        ASSERT_EQ(regions[i].base, base + page * PAGE);
+        ASSERT_EQ(regions[i].pool, (page % 2) ? poolB.get() : poolA.get());
+        page++;
+    }
+    ASSERT_EQ(page, NUM_PAGES);
+
+    // the walk stops when the callback returns a non-zero value
+    size_t count = 0;
+    ASSERT_EQ(umfPoolWalk(
+                  poolB.get(),
+                  [](const umf_tracked_region_t *, void *arg) {
+                      return (int)(++*(size_t *)arg == 2);
+                  },
+                  &count),
+              UMF_RESULT_SUCCESS);
+    ASSERT_EQ(count, 2);
+
+    ASSERT_EQ(umfPoolWalk(poolA.get(), nullptr, nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfTrackerWalk(nullptr, nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    for (size_t i = 0; i < NUM_PAGES; i++) {
+        void *ptr = base + i * PAGE;
+        ASSERT_EQ(umfPoolFree(umfPoolByPtr(ptr), ptr), UMF_RESULT_SUCCESS);
+    }
+
+    regions.clear();
+    ASSERT_EQ(umfPoolWalk(poolA.get(), collect, &regions), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(regions.size(), 0);
+}
+
+TEST_F(test, walkTrackedRegionsConcurrentFreeMt) {
+    static constexpr size_t NUM_ALLOCS = 64;
+    static constexpr size_t NUM_ITERS = 200;
+    static constexpr size_t SIZE = 4096;
+
+    auto provider = wrapProviderUnique(
+        createProviderChecked(&BA_GLOBAL_PROVIDER_OPS, nullptr));
+    auto pool = wrapPoolUnique(
+        createPoolChecked(umfProxyPoolOps(), provider.get(), nullptr));
+
+    // regions are allocated and freed while the pool is walked
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        std::vector<void *> ptrs(NUM_ALLOCS);
+        for (size_t it = 0; it < NUM_ITERS; it++) {
+            for (auto &ptr : ptrs) {
+                ptr = umfPoolMalloc(pool.get(), SIZE);
+                EXPECT_NE(ptr, nullptr);
+            }
+            for (auto ptr : ptrs) {
+                EXPECT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+            }
+        }
+        stop = true;
+    });
+
+    // every reported region is a consistent snapshot
+    auto check = [](const umf_tracked_region_t *region, void *arg) {
+        EXPECT_EQ(region->size, SIZE);
+        EXPECT_EQ(region->pool, (umf_memory_pool_handle_t)arg);
+        return 0;
+    };
+
+    while (!stop) {
+        EXPECT_EQ(umfPoolWalk(pool.get(), check, pool.get()),
+                  UMF_RESULT_SUCCESS);
+    }
+
+    writer.join();
+}
+
 INSTANTIATE_TEST_SUITE_P(
     mallocPoolTest, umfPoolTest,
     ::testing::Values(
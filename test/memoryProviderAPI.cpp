@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 // This file contains tests for UMF provider API
 
+#include "memory_provider_internal.h"
 #include "provider.hpp"
 #include "provider_null.h"
 #include "test_helpers.h"
@@ -87,6 +88,17 @@ TEST_F(test, memoryProviderTrace) {
     ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
     ASSERT_EQ(calls["allocation_split"], 1);
     ASSERT_EQ(calls.size(), ++call_count);
+
+    ret = umfMemoryProviderAllocationResize(tracingProvider.get(), ptr, 4096,
+                                            2 * 4096);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(calls["allocation_resize"], 1);
+    ASSERT_EQ(calls.size(), ++call_count);
+
+    ret = umfMemoryProviderTrim(tracingProvider.get(), 0);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(calls["trim"], 1);
+    ASSERT_EQ(calls.size(), ++call_count);
 }
 
 TEST_F(test, memoryProviderOpsNullPurgeLazyField) {
@@ -136,6 +148,36 @@ TEST_F(test, memoryProviderOpsNullAllocationSplitAllocationMergeFields) {
     umfMemoryProviderDestroy(hProvider);
 }
 
+TEST_F(test, memoryProviderOpsNullAllocationResizeField) {
+    umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
+    provider_ops.ext.allocation_resize = nullptr;
+    umf_memory_provider_handle_t hProvider;
+    auto ret = umfMemoryProviderCreate(&provider_ops, nullptr, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    void *ptr = (void *)0xBAD;
+    ret = umfMemoryProviderAllocationResize(hProvider, ptr, 4096, 2 * 4096);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    ret = umfMemoryProviderAllocationResize(hProvider, ptr, 4096, 0);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umfMemoryProviderDestroy(hProvider);
+}
+
+TEST_F(test, memoryProviderOpsNullTrimField) {
+    umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
+    provider_ops.ext.trim = nullptr;
+    umf_memory_provider_handle_t hProvider;
+    auto ret = umfMemoryProviderCreate(&provider_ops, nullptr, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfMemoryProviderTrim(hProvider, 0);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    umfMemoryProviderDestroy(hProvider);
+}
+
 TEST_F(test, memoryProviderOpsNullAllIPCFields) {
     umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
     provider_ops.ipc.get_ipc_handle_size = nullptr;
@@ -169,6 +211,48 @@ TEST_F(test, memoryProviderOpsNullAllIPCFields) {
     umfMemoryProviderDestroy(hProvider);
 }
 
+TEST_F(test, memoryProviderOpsVersion0_11) {
+    const umf_memory_provider_ops_t &ops = UMF_NULL_PROVIDER_OPS;
+    umf_memory_provider_ops_0_11_t provider_ops = {};
+    provider_ops.version = UMF_MAKE_VERSION(0, 11);
+    provider_ops.initialize = ops.initialize;
+    provider_ops.finalize = ops.finalize;
+    provider_ops.alloc = ops.alloc;
+    provider_ops.free = ops.free;
+    provider_ops.get_last_native_error = ops.get_last_native_error;
+    provider_ops.get_recommended_page_size = ops.get_recommended_page_size;
+    provider_ops.get_min_page_size = ops.get_min_page_size;
+    provider_ops.get_name = ops.get_name;
+    provider_ops.ext.purge_lazy = ops.ext.purge_lazy;
+    provider_ops.ext.purge_force = ops.ext.purge_force;
+    provider_ops.ext.allocation_merge = ops.ext.allocation_merge;
+    provider_ops.ext.allocation_split = ops.ext.allocation_split;
+    provider_ops.ipc.get_ipc_handle_size = ops.ipc.get_ipc_handle_size;
+    provider_ops.ipc.get_ipc_handle = ops.ipc.get_ipc_handle;
+    provider_ops.ipc.put_ipc_handle = ops.ipc.put_ipc_handle;
+    provider_ops.ipc.open_ipc_handle = ops.ipc.open_ipc_handle;
+    provider_ops.ipc.close_ipc_handle = ops.ipc.close_ipc_handle;
+
+    umf_memory_provider_handle_t hProvider;
+    auto ret = umfMemoryProviderCreate(
+        (const umf_memory_provider_ops_t *)&provider_ops, nullptr, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // the members of the ops of version 0.11 are not shifted
+    size_t size = 0;
+    ret = umfMemoryProviderGetIPCHandleSize(hProvider, &size);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // the members added later are defaulted
+    void *ptr = (void *)0xBAD;
+    ret = umfMemoryProviderAllocationResize(hProvider, ptr, 4096, 2 * 4096);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ret = umfMemoryProviderTrim(hProvider, 0);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    umfMemoryProviderDestroy(hProvider);
+}
+
 ////////////////// Negative test cases /////////////////
 
 TEST_F(test, memoryProviderCreateNullOps) {
@@ -183,6 +267,14 @@ TEST_F(test, memoryProviderNullPoolHandle) {
     ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
+TEST_F(test, memoryProviderOpsUnsupportedVersion) {
+    umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
+    provider_ops.version = UMF_MAKE_VERSION(0, 10);
+    umf_memory_provider_handle_t hProvider;
+    auto ret = umfMemoryProviderCreate(&provider_ops, nullptr, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+}
+
 TEST_F(test, memoryProviderOpsNullAllocField) {
     umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
     provider_ops.alloc = nullptr;
@@ -5,6 +5,8 @@
 #include <memory>
 
 #include <umf/pools/pool_disjoint.h>
+#include <umf/providers/provider_fixed_memory.h>
+#include <umf/providers/provider_os_memory.h>
 
 #include "pool.hpp"
 #include "pool/pool_disjoint_internal.h"
@@ -270,6 +272,129 @@ TEST_F(test, sharedLimits) {
     EXPECT_EQ(MaxSize / SlabMinSize * 2, numFrees);
 }
 
+TEST_F(test, reallocInPlace) {
+    // the Fixed memory provider can resize its allocations in place
+    const size_t page_size = utils_get_page_size();
+    const size_t buffer_size = 64 * page_size;
+    std::vector<char> buffer(buffer_size + page_size);
+    void *buf = (void *)ALIGN_UP_SAFE((uintptr_t)buffer.data(), page_size);
+
+    umf_fixed_memory_provider_params_handle_t provider_params = nullptr;
+    umf_result_t ret =
+        umfFixedMemoryProviderParamsCreate(&provider_params, buf, buffer_size);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    auto provider = wrapProviderUnique(
+        createProviderChecked(umfFixedMemoryProviderOps(), provider_params));
+    umfFixedMemoryProviderParamsDestroy(provider_params);
+
+    static constexpr size_t MaxPoolableSize = 4096;
+
+    umf_disjoint_pool_params_handle_t params =
+        (umf_disjoint_pool_params_handle_t)defaultDisjointPoolConfig();
+    ret = umfDisjointPoolParamsSetMaxPoolableSize(params, MaxPoolableSize);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    umf_memory_pool_handle_t pool = NULL;
+    ret = umfPoolCreate(umfDisjointPoolOps(), provider.get(), params, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto poolHandle = umf_test::wrapPoolUnique(pool);
+    umfDisjointPoolParamsDestroy(params);
+
+    // large allocations are taken directly from the memory provider
+    const size_t size = 4 * page_size;
+    char *ptr = (char *)umfPoolMalloc(pool, size);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xAB, size);
+
+    // grow into the free memory following the allocation
+    char *new_ptr = (char *)umfPoolRealloc(pool, ptr, 16 * page_size);
+    ASSERT_EQ(new_ptr, ptr);
+    ASSERT_EQ(umfPoolMallocUsableSize(pool, ptr), 16 * page_size);
+    ASSERT_EQ(ptr[size - 1], (char)0xAB);
+    memset(ptr, 0xCD, 16 * page_size);
+
+    // shrink it, so the next allocation uses the released tail
+    new_ptr = (char *)umfPoolRealloc(pool, ptr, 2 * page_size);
+    ASSERT_EQ(new_ptr, ptr);
+    ASSERT_EQ(umfPoolMallocUsableSize(pool, ptr), 2 * page_size);
+    ASSERT_EQ(ptr[2 * page_size - 1], (char)0xCD);
+
+    char *next = (char *)umfPoolMalloc(pool, size);
+    ASSERT_EQ(next, ptr + 2 * page_size);
+
+    // the allocation cannot be grown in place anymore
+    // and the data is never copied, so it is left untouched
+    new_ptr = (char *)umfPoolRealloc(pool, ptr, 4 * page_size);
+    ASSERT_EQ(new_ptr, nullptr);
+    ASSERT_EQ(umfPoolGetLastAllocationError(pool),
+              UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umfPoolMallocUsableSize(pool, ptr), 2 * page_size);
+
+    ASSERT_EQ(umfPoolFree(pool, next), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, reallocNextToAnotherPool) {
+    // the OS memory provider does not support resizing allocations,
+    // so a failed realloc must not affect allocations of other pools
+    static constexpr size_t MaxPoolableSize = 4096;
+
+    auto createPool = []() {
+        umf_os_memory_provider_params_handle_t os_params = nullptr;
+        umf_result_t ret = umfOsMemoryProviderParamsCreate(&os_params);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        umf_memory_provider_handle_t provider = nullptr;
+        ret = umfMemoryProviderCreate(umfOsMemoryProviderOps(), os_params,
+                                      &provider);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+        umfOsMemoryProviderParamsDestroy(os_params);
+
+        umf_disjoint_pool_params_handle_t params =
+            (umf_disjoint_pool_params_handle_t)defaultDisjointPoolConfig();
+        ret = umfDisjointPoolParamsSetMaxPoolableSize(params, MaxPoolableSize);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        umf_memory_pool_handle_t pool = nullptr;
+        ret = umfPoolCreate(umfDisjointPoolOps(), provider, params,
+                            UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &pool);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+        umfDisjointPoolParamsDestroy(params);
+
+        return umf_test::wrapPoolUnique(pool);
+    };
+
+    auto pool1 = createPool();
+    auto pool2 = createPool();
+    ASSERT_NE(pool1.get(), nullptr);
+    ASSERT_NE(pool2.get(), nullptr);
+
+    // large allocations are taken directly from the memory provider
+    const size_t size = 16 * MaxPoolableSize;
+    char *ptr1 = (char *)umfPoolMalloc(pool1.get(), size);
+    ASSERT_NE(ptr1, nullptr);
+    char *ptr2 = (char *)umfPoolMalloc(pool2.get(), size);
+    ASSERT_NE(ptr2, nullptr);
+
+    // try to grow the lower allocation over the higher one
+    umf_memory_pool_handle_t low_pool = ptr1 < ptr2 ? pool1.get() : pool2.get();
+    char *low = std::min(ptr1, ptr2);
+    char *high = std::max(ptr1, ptr2);
+    size_t new_size = (size_t)(high - low) + size;
+
+    ASSERT_EQ(umfPoolRealloc(low_pool, low, new_size), nullptr);
+    ASSERT_EQ(umfPoolGetLastAllocationError(low_pool),
+              UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    ASSERT_EQ(umfPoolByPtr(ptr1), pool1.get());
+    ASSERT_EQ(umfPoolByPtr(ptr2), pool2.get());
+    ASSERT_EQ(umfPoolByPtr(ptr2 + size - 1), pool2.get());
+
+    ASSERT_EQ(umfFree(ptr2), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfFree(ptr1), UMF_RESULT_SUCCESS);
+}
+
 TEST_F(test, disjointPoolNullParams) {
     umf_result_t res = umfDisjointPoolParamsCreate(nullptr);
     EXPECT_EQ(res, UMF_RESULT_ERROR_INVALID_ARGUMENT);
@@ -2,6 +2,7 @@
 // Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include "umf/ipc.h"
 #include "umf/pools/pool_jemalloc.h"
 #include "umf/providers/provider_os_memory.h"
 
@@ -89,3 +90,75 @@ TEST_F(test, metadataNotAllocatedUsingProvider) {
             [pool = pool.get()](void *ptr) { umfPoolFree(pool, ptr); });
     }
 }
+
+// IPC handles of buffers of a jemalloc pool share only the part of
+// the jemalloc extent containing the buffer, found with get_block_range
+TEST_F(test, ipcHandlesOfBuffers) {
+    static constexpr size_t sizes[] = {64, 4096, 16 * 1024, 1024 * 1024,
+                                       4 * 1024 * 1024};
+    static constexpr size_t numAllocs = 16;
+    static constexpr size_t innerOffset = 40;
+
+    auto providerParamsCreate = []() {
+        umf_os_memory_provider_params_handle_t params = nullptr;
+        umf_result_t res = umfOsMemoryProviderParamsCreate(&params);
+        if (res != UMF_RESULT_SUCCESS) {
+            throw std::runtime_error(
+                "Failed to create OS Memory Provider params");
+        }
+        res = umfOsMemoryProviderParamsSetVisibility(params,
+                                                     UMF_MEM_MAP_SHARED);
+        if (res != UMF_RESULT_SUCCESS) {
+            umfOsMemoryProviderParamsDestroy(params);
+            throw std::runtime_error("Failed to set the visibility");
+        }
+        return (void *)params;
+    };
+
+    auto pool = poolCreateExtUnique({
+        umfJemallocPoolOps(),
+        nullptr,
+        nullptr,
+        umfOsMemoryProviderOps(),
+        (pfnProviderParamsCreate)providerParamsCreate,
+        (pfnProviderParamsDestroy)destroyOsMemoryProviderParams,
+    });
+    ASSERT_NE(pool.get(), nullptr);
+
+    umf_ipc_handler_handle_t hIPCHandler = nullptr;
+    umf_result_t ret = umfPoolGetIPCHandler(pool.get(), &hIPCHandler);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    std::vector<char *> ptrs;
+    for (size_t size : sizes) {
+        for (size_t i = 0; i < numAllocs; i++) {
+            char *ptr = (char *)umfPoolMalloc(pool.get(), size);
+            ASSERT_NE(ptr, nullptr);
+            memset(ptr, (int)ptrs.size() + 1, size);
+            ptrs.push_back(ptr);
+        }
+    }
+
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        // the beginning of the buffer and a pointer inside of its first page
+        for (size_t offset : {(size_t)0, innerOffset}) {
+            umf_ipc_handle_t handle = nullptr;
+            size_t handleSize = 0;
+            ret = umfGetIPCHandle(ptrs[i] + offset, &handle, &handleSize);
+            ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+            void *opened = nullptr;
+            ret = umfOpenIPCHandle(hIPCHandler, handle, &opened);
+            ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+            ASSERT_EQ(*(char *)opened, (char)(i + 1));
+            ASSERT_EQ(*((char *)opened - offset), (char)(i + 1));
+
+            ASSERT_EQ(umfCloseIPCHandle(opened), UMF_RESULT_SUCCESS);
+            ASSERT_EQ(umfPutIPCHandle(handle), UMF_RESULT_SUCCESS);
+        }
+    }
+
+    for (char *ptr : ptrs) {
+        ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+    }
+}
@@ -0,0 +1,354 @@
+// Copyright (C) 2025 Intel Corporation
+// Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <thread>
+#include <vector>
+
+#include <umf/pools/pool_shared_heap.h>
+#include <umf/providers/provider_os_memory.h>
+
+#include "pool.hpp"
+#include "poolFixtures.hpp"
+
+using umf_test::test;
+
+static void *createOsMemoryProviderParams() {
+    umf_os_memory_provider_params_handle_t params = nullptr;
+    umf_result_t res = umfOsMemoryProviderParamsCreate(&params);
+    if (res != UMF_RESULT_SUCCESS) {
+        throw std::runtime_error("Failed to create os memory provider params");
+    }
+
+    res = umfOsMemoryProviderParamsSetVisibility(params, UMF_MEM_MAP_SHARED);
+    if (res != UMF_RESULT_SUCCESS) {
+        umfOsMemoryProviderParamsDestroy(params);
+        throw std::runtime_error("Failed to set the visibility");
+    }
+
+    return params;
+}
+
+static umf_result_t destroyOsMemoryProviderParams(void *params) {
+    return umfOsMemoryProviderParamsDestroy(
+        (umf_os_memory_provider_params_handle_t)params);
+}
+
+static void *createSharedHeapPoolParams() {
+    umf_shared_heap_pool_params_handle_t params = nullptr;
+    umf_result_t res = umfSharedHeapPoolParamsCreate(&params);
+    if (res != UMF_RESULT_SUCCESS) {
+        throw std::runtime_error("Failed to create shared heap pool params");
+    }
+
+    // the tests allocate large buffers of many sizes
+    res = umfSharedHeapPoolParamsSetHeapSize(params, 1024 * 1024 * 1024);
+    if (res != UMF_RESULT_SUCCESS) {
+        umfSharedHeapPoolParamsDestroy(params);
+        throw std::runtime_error("Failed to set the heap size");
+    }
+
+    return params;
+}
+
+static umf_result_t destroySharedHeapPoolParams(void *params) {
+    return umfSharedHeapPoolParamsDestroy(
+        (umf_shared_heap_pool_params_handle_t)params);
+}
+
+INSTANTIATE_TEST_SUITE_P(sharedHeapPoolTests, umfPoolTest,
+                         ::testing::Values(poolCreateExtParams{
+                             umfSharedHeapPoolOps(), createSharedHeapPoolParams,
+                             destroySharedHeapPoolParams,
+                             umfOsMemoryProviderOps(),
+                             createOsMemoryProviderParams,
+                             destroyOsMemoryProviderParams}));
+
+struct sharedHeapPoolTest : umf_test::test {
+    // creates a pool on a new OS memory provider, attached to the heap
+    // of ipcHandle if it is not NULL, as another process would do
+    umf::pool_unique_handle_t createPool(size_t heapSize,
+                                         umf_ipc_handle_t ipcHandle) {
+        umf_memory_provider_handle_t hProvider = nullptr;
+        void *providerParams = createOsMemoryProviderParams();
+        umf_result_t ret = umfMemoryProviderCreate(
+            umfOsMemoryProviderOps(), providerParams, &hProvider);
+        destroyOsMemoryProviderParams(providerParams);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        umf_shared_heap_pool_params_handle_t params =
+            (umf_shared_heap_pool_params_handle_t)createSharedHeapPoolParams();
+        EXPECT_EQ(umfSharedHeapPoolParamsSetHeapSize(params, heapSize),
+                  UMF_RESULT_SUCCESS);
+        EXPECT_EQ(umfSharedHeapPoolParamsSetIPCHandle(params, ipcHandle),
+                  UMF_RESULT_SUCCESS);
+
+        umf_memory_pool_handle_t hPool = nullptr;
+        ret = umfPoolCreate(umfSharedHeapPoolOps(), hProvider, params,
+                            UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &hPool);
+        destroySharedHeapPoolParams(params);
+        if (ret != UMF_RESULT_SUCCESS) {
+            umfMemoryProviderDestroy(hProvider);
+        }
+
+        return umf::pool_unique_handle_t(hPool, &umfPoolDestroy);
+    }
+
+    // translates a pointer to the heap mapped by one pool to the other one,
+    // like the processes sharing the heap do
+    static void *translate(umf_memory_pool_handle_t from,
+                           umf_memory_pool_handle_t to, void *ptr) {
+        size_t offset = 0;
+        void *translated = nullptr;
+        EXPECT_EQ(umfSharedHeapPoolGetOffset(from, ptr, &offset),
+                  UMF_RESULT_SUCCESS);
+        EXPECT_EQ(umfSharedHeapPoolGetPtr(to, offset, &translated),
+                  UMF_RESULT_SUCCESS);
+        return translated;
+    }
+};
+
+TEST_F(sharedHeapPoolTest, allocFreeInAttachedPool) {
+    constexpr size_t HEAP_SIZE = 16 * 1024 * 1024;
+    constexpr size_t NUM_ALLOCS = 64;
+
+    auto creator = createPool(HEAP_SIZE, nullptr);
+    ASSERT_NE(creator.get(), nullptr);
+
+    umf_ipc_handle_t ipcHandle = nullptr;
+    size_t handleSize = 0;
+    ASSERT_EQ(
+        umfSharedHeapPoolGetIPCHandle(creator.get(), &ipcHandle, &handleSize),
+        UMF_RESULT_SUCCESS);
+
+    auto attached = createPool(HEAP_SIZE, ipcHandle);
+    ASSERT_NE(attached.get(), nullptr);
+    ASSERT_EQ(umfPutIPCHandle(ipcHandle), UMF_RESULT_SUCCESS);
+
+    // only the pool that created the heap can share it
+    ASSERT_EQ(
+        umfSharedHeapPoolGetIPCHandle(attached.get(), &ipcHandle, &handleSize),
+        UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // the memory allocated by one pool is freed by the other one
+    std::vector<size_t *> ptrs(NUM_ALLOCS);
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        umf_memory_pool_handle_t pool = i % 2 ? creator.get() : attached.get();
+        ptrs[i] = (size_t *)umfPoolMalloc(pool, (i + 1) * 64);
+        ASSERT_NE(ptrs[i], nullptr);
+        ASSERT_EQ(umfPoolByPtr(ptrs[i]), pool);
+        *ptrs[i] = i;
+    }
+
+    for (size_t i = 0; i < NUM_ALLOCS; i++) {
+        umf_memory_pool_handle_t pool = i % 2 ? creator.get() : attached.get();
+        umf_memory_pool_handle_t other =
+            i % 2 ? attached.get() : creator.get();
+        ASSERT_GE(umfPoolMallocUsableSize(pool, ptrs[i]), (i + 1) * 64);
+        auto *otherPtr = (size_t *)translate(pool, other, ptrs[i]);
+        ASSERT_NE(otherPtr, ptrs[i]);
+        ASSERT_EQ(*otherPtr, i);
+        ASSERT_EQ(umfPoolFree(other, otherPtr), UMF_RESULT_SUCCESS);
+        // a double free is detected
+        ASSERT_EQ(umfPoolFree(pool, ptrs[i]),
+                  UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    }
+
+    // the freed blocks are reused
+    void *ptr = umfPoolMalloc(creator.get(), 64);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(umfPoolFree(attached.get(),
+                          translate(creator.get(), attached.get(), ptr)),
+              UMF_RESULT_SUCCESS);
+
+    // pointers out of the heap are not translated
+    size_t offset = 0;
+    ASSERT_EQ(umfSharedHeapPoolGetOffset(creator.get(), &offset, &offset),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfSharedHeapPoolGetPtr(creator.get(), HEAP_SIZE, &ptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_F(sharedHeapPoolTest, attachedPoolsMt) {
+    constexpr size_t HEAP_SIZE = 64 * 1024 * 1024;
+    constexpr size_t NUM_THREADS = 4;
+    constexpr size_t NUM_ITERS = 10000;
+
+    auto creator = createPool(HEAP_SIZE, nullptr);
+    ASSERT_NE(creator.get(), nullptr);
+
+    umf_ipc_handle_t ipcHandle = nullptr;
+    size_t handleSize = 0;
+    ASSERT_EQ(
+        umfSharedHeapPoolGetIPCHandle(creator.get(), &ipcHandle, &handleSize),
+        UMF_RESULT_SUCCESS);
+    auto attached = createPool(HEAP_SIZE, ipcHandle);
+    ASSERT_NE(attached.get(), nullptr);
+    ASSERT_EQ(umfPutIPCHandle(ipcHandle), UMF_RESULT_SUCCESS);
+
+    // threads allocate from one pool and free from the other one,
+    // the heap is never exhausted if the freed blocks are reused
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&, t] {
+            umf_memory_pool_handle_t pools[] = {creator.get(), attached.get()};
+            for (size_t i = 0; i < NUM_ITERS; i++) {
+                size_t size = 16 << (i % 12);
+                auto *ptr = (unsigned char *)umfPoolMalloc(pools[t % 2], size);
+                ASSERT_NE(ptr, nullptr);
+                memset(ptr, (int)t, size);
+                ASSERT_EQ(ptr[size - 1], (unsigned char)t);
+                umf_memory_pool_handle_t other = pools[(t + 1) % 2];
+                ASSERT_EQ(umfPoolFree(other, translate(pools[t % 2], other,
+                                                       ptr)),
+                          UMF_RESULT_SUCCESS);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+TEST_F(sharedHeapPoolTest, heapExhausted) {
+    constexpr size_t HEAP_SIZE = 1024 * 1024;
+
+    auto pool = createPool(HEAP_SIZE, nullptr);
+    ASSERT_NE(pool.get(), nullptr);
+
+    ASSERT_EQ(umfPoolMalloc(pool.get(), HEAP_SIZE), nullptr);
+    ASSERT_EQ(umfPoolGetLastAllocationError(pool.get()),
+              UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+
+    std::vector<void *> ptrs;
+    void *ptr;
+    while ((ptr = umfPoolMalloc(pool.get(), 4096 - 16)) != nullptr) {
+        ptrs.push_back(ptr);
+    }
+    ASSERT_GT(ptrs.size(), 0);
+
+    // a freed block is split for smaller allocations
+    ASSERT_EQ(umfPoolFree(pool.get(), ptrs.back()), UMF_RESULT_SUCCESS);
+    ptrs.pop_back();
+    for (int i = 0; i < 2; i++) {
+        ptrs.push_back(umfPoolMalloc(pool.get(), 2048 - 16));
+        ASSERT_NE(ptrs.back(), nullptr);
+    }
+
+    for (void *p : ptrs) {
+        ASSERT_EQ(umfPoolFree(pool.get(), p), UMF_RESULT_SUCCESS);
+    }
+}
+
+TEST_F(sharedHeapPoolTest, freedBlocksAreMerged) {
+    constexpr size_t HEAP_SIZE = 4 * 1024 * 1024;
+    constexpr size_t LARGE_SIZE = 1024 * 1024;
+
+    auto pool = createPool(HEAP_SIZE, nullptr);
+    ASSERT_NE(pool.get(), nullptr);
+
+    // the heap is split into small blocks only
+    std::vector<void *> ptrs;
+    void *ptr;
+    while ((ptr = umfPoolMalloc(pool.get(), 64)) != nullptr) {
+        ptrs.push_back(ptr);
+    }
+    ASSERT_GT(ptrs.size(), HEAP_SIZE / 256);
+
+    for (void *p : ptrs) {
+        ASSERT_EQ(umfPoolFree(pool.get(), p), UMF_RESULT_SUCCESS);
+    }
+    ptrs.clear();
+
+    // the freed small blocks are merged into large ones
+    for (size_t size = 2 * LARGE_SIZE; size >= LARGE_SIZE / 2; size /= 2) {
+        ptr = umfPoolMalloc(pool.get(), size);
+        ASSERT_NE(ptr, nullptr);
+        ptrs.push_back(ptr);
+
+        // a page allocation does not need a tag in its block
+        ASSERT_EQ(umfPoolMallocUsableSize(pool.get(), ptr), size);
+        memset(ptr, 0xAB, size);
+    }
+
+    for (void *p : ptrs) {
+        ASSERT_EQ(umfPoolFree(pool.get(), p), UMF_RESULT_SUCCESS);
+        // a double free is detected
+        ASSERT_EQ(umfPoolFree(pool.get(), p),
+                  UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    }
+}
+
+TEST_F(sharedHeapPoolTest, freedBlocksAreMergedMt) {
+    constexpr size_t HEAP_SIZE = 8 * 1024 * 1024;
+    constexpr size_t NUM_THREADS = 4;
+    constexpr size_t NUM_ITERS = 20000;
+    constexpr size_t MAX_LIVE = 64;
+
+    auto pool = createPool(HEAP_SIZE, nullptr);
+    ASSERT_NE(pool.get(), nullptr);
+
+    // the heap is exhausted often, so the free blocks are merged
+    // while other threads allocate and free memory
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&, t] {
+            std::vector<std::pair<unsigned char *, size_t>> live;
+            for (size_t i = 0; i < NUM_ITERS; i++) {
+                size_t size = (size_t)16 << ((i * 7 + t) % 15);
+                auto *ptr = (unsigned char *)umfPoolMalloc(pool.get(), size);
+                if (ptr) {
+                    memset(ptr, (int)t, size);
+                    live.emplace_back(ptr, size);
+                }
+
+                if (live.size() == MAX_LIVE ||
+                    (ptr == nullptr && !live.empty())) {
+                    auto &oldest = live.front();
+                    EXPECT_EQ(oldest.first[0], (unsigned char)t);
+                    EXPECT_EQ(oldest.first[oldest.second - 1],
+                              (unsigned char)t);
+                    EXPECT_EQ(umfPoolFree(pool.get(), oldest.first),
+                              UMF_RESULT_SUCCESS);
+                    live.erase(live.begin());
+                }
+            }
+
+            for (auto &p : live) {
+                EXPECT_EQ(umfPoolFree(pool.get(), p.first), UMF_RESULT_SUCCESS);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // all the freed blocks are merged again
+    void *ptr = umfPoolMalloc(pool.get(), HEAP_SIZE / 2);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(sharedHeapPoolTest, invalidParams) {
+    umf_shared_heap_pool_params_handle_t params = nullptr;
+    ASSERT_EQ(umfSharedHeapPoolParamsCreate(nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfSharedHeapPoolParamsSetHeapSize(nullptr, 4096),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfSharedHeapPoolParamsSetIPCHandle(nullptr, nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ASSERT_EQ(umfSharedHeapPoolParamsCreate(&params), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfSharedHeapPoolParamsSetHeapSize(params, 0),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfSharedHeapPoolParamsSetHeapSize(params, SIZE_MAX),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfSharedHeapPoolParamsDestroy(params), UMF_RESULT_SUCCESS);
+
+    umf_ipc_handle_t ipcHandle = nullptr;
+    size_t handleSize = 0;
+    ASSERT_EQ(umfSharedHeapPoolGetIPCHandle(nullptr, &ipcHandle, &handleSize),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
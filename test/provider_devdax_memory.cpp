@@ -389,6 +389,9 @@ TEST_F(test, params_null_handle) {
 
     ret = umfDevDaxMemoryProviderParamsSetProtection(nullptr, 1);
     ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ret = umfDevDaxMemoryProviderParamsSetFreeHighWaterMark(nullptr, 0);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
 TEST_F(test, create_empty_path) {
@@ -268,6 +268,13 @@ TEST_P(FileProviderParamsDefault, purge_force) {
     test_alloc_free_success(provider.get(), page_plus_64, 0, PURGE_FORCE);
 }
 
+TEST_P(FileProviderParamsDefault, trim) {
+    test_alloc_free_success(provider.get(), page_plus_64, 0, PURGE_NONE);
+
+    umf_result_t umf_result = umfMemoryProviderTrim(provider.get(), 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
 // negative tests using test_alloc_failure
 
 TEST_P(FileProviderParamsDefault, alloc_WRONG_SIZE) {
@@ -395,6 +402,9 @@ TEST_F(test, params_null_handle) {
     umf_result =
         umfFileMemoryProviderParamsSetVisibility(nullptr, UMF_MEM_MAP_PRIVATE);
     ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfFileMemoryProviderParamsSetFreeHighWaterMark(nullptr, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
 TEST_F(test, create_empty_path) {
@@ -331,6 +331,261 @@ TEST_F(test, create_with_zero_size) {
     ASSERT_EQ(wrong_params, nullptr);
 }
 
+TEST_F(test, params_num_arenas) {
+    constexpr size_t memory_size = 100;
+    char memory_buffer[memory_size];
+    umf_result_t umf_result =
+        umfFixedMemoryProviderParamsSetNumArenas(nullptr, 4);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_fixed_memory_provider_params_handle_t params = nullptr;
+    umf_result =
+        umfFixedMemoryProviderParamsCreate(&params, memory_buffer, memory_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfFixedMemoryProviderParamsSetNumArenas(params, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfFixedMemoryProviderParamsSetNumArenas(params, 4);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfFixedMemoryProviderParamsDestroy(params);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, alloc_free_num_arenas) {
+    const size_t page_size = utils_get_page_size();
+    const size_t memory_size = 16 * page_size;
+    std::vector<char> buffer(memory_size + page_size, 0);
+    void *memory_buffer =
+        (void *)ALIGN_UP_SAFE((uintptr_t)buffer.data(), page_size);
+    ASSERT_NE(memory_buffer, nullptr);
+
+    umf_fixed_memory_provider_params_handle_t params = nullptr;
+    umf_result_t umf_result =
+        umfFixedMemoryProviderParamsCreate(&params, memory_buffer, memory_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfFixedMemoryProviderParamsSetNumArenas(params, 4);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result =
+        umfMemoryProviderCreate(umfFixedMemoryProviderOps(), params, &provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umfFixedMemoryProviderParamsDestroy(params);
+
+    // every arena owns 4 pages, the calling thread uses all of them
+    void *ptrs[16] = {nullptr};
+    for (int i = 0; i < 16; i++) {
+        umf_result =
+            umfMemoryProviderAlloc(provider, page_size, page_size, &ptrs[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_NE(ptrs[i], nullptr);
+    }
+
+    for (int i = 0; i < 16; i++) {
+        umf_result = umfMemoryProviderFree(provider, ptrs[i], page_size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    umfMemoryProviderDestroy(provider);
+}
+
+TEST_F(test, params_free_high_water_mark) {
+    constexpr size_t memory_size = 100;
+    char memory_buffer[memory_size];
+    umf_result_t umf_result =
+        umfFixedMemoryProviderParamsSetFreeHighWaterMark(nullptr, 4096);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_fixed_memory_provider_params_handle_t params = nullptr;
+    umf_result =
+        umfFixedMemoryProviderParamsCreate(&params, memory_buffer, memory_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfFixedMemoryProviderParamsSetFreeHighWaterMark(params, 4096);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfFixedMemoryProviderParamsDestroy(params);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+// the trimmed free memory is purged, so it reads as zeros
+static void test_trim(size_t free_high_water_mark) {
+    const size_t page_size = utils_get_page_size();
+    const size_t memory_size = 16 * page_size;
+    std::vector<char> buffer(memory_size + page_size, 0);
+    char *memory_buffer =
+        (char *)ALIGN_UP_SAFE((uintptr_t)buffer.data(), page_size);
+    ASSERT_NE(memory_buffer, nullptr);
+
+    umf_fixed_memory_provider_params_handle_t params = nullptr;
+    umf_result_t umf_result =
+        umfFixedMemoryProviderParamsCreate(&params, memory_buffer, memory_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfFixedMemoryProviderParamsSetFreeHighWaterMark(
+        params, free_high_water_mark);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result =
+        umfMemoryProviderCreate(umfFixedMemoryProviderOps(), params, &provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umfFixedMemoryProviderParamsDestroy(params);
+
+    void *ptr = nullptr;
+    umf_result = umfMemoryProviderAlloc(provider, 8 * page_size, page_size,
+                                        &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xFF, 8 * page_size);
+
+    umf_result = umfMemoryProviderFree(provider, ptr, 8 * page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    if (free_high_water_mark == 0) {
+        // nothing is trimmed in umfMemoryProviderFree()
+        ASSERT_EQ(*(char *)ptr, (char)0xFF);
+        umf_result = umfMemoryProviderTrim(provider, 0);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    for (size_t i = 0; i < 8 * page_size; i++) {
+        ASSERT_EQ(((char *)ptr)[i], 0);
+    }
+
+    umfMemoryProviderDestroy(provider);
+}
+
+TEST_F(test, trim) { test_trim(0); }
+
+TEST_F(test, free_high_water_mark) {
+    test_trim(2 * utils_get_page_size());
+}
+
+TEST_F(test, params_add_memory) {
+    constexpr size_t memory_size = 100;
+    char memory_buffer[2 * memory_size];
+    umf_result_t umf_result = umfFixedMemoryProviderParamsAddMemory(
+        nullptr, memory_buffer, memory_size, -1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_fixed_memory_provider_params_handle_t params = nullptr;
+    umf_result =
+        umfFixedMemoryProviderParamsCreate(&params, memory_buffer, memory_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfFixedMemoryProviderParamsAddMemory(
+        params, nullptr, memory_size, -1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfFixedMemoryProviderParamsAddMemory(
+        params, memory_buffer + memory_size, 0, -1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfFixedMemoryProviderParamsAddMemory(
+        params, memory_buffer + memory_size, memory_size, -2);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // overlapping regions
+    umf_result = umfFixedMemoryProviderParamsAddMemory(
+        params, memory_buffer + memory_size / 2, memory_size, -1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfFixedMemoryProviderParamsAddMemory(
+        params, memory_buffer + memory_size, memory_size, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfFixedMemoryProviderParamsDestroy(params);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, alloc_free_multiple_regions) {
+    const size_t page_size = utils_get_page_size();
+    const size_t region_size = 4 * page_size;
+    const int num_regions = 4;
+    std::vector<char> buffer(num_regions * 2 * region_size + page_size, 0);
+    char *memory_buffer =
+        (char *)ALIGN_UP_SAFE((uintptr_t)buffer.data(), page_size);
+    ASSERT_NE(memory_buffer, nullptr);
+
+    // the regions are not contiguous and are located on different NUMA nodes
+    umf_fixed_memory_provider_params_handle_t params = nullptr;
+    umf_result_t umf_result =
+        umfFixedMemoryProviderParamsCreate(&params, memory_buffer, region_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    for (int i = 1; i < num_regions; i++) {
+        umf_result = umfFixedMemoryProviderParamsAddMemory(
+            params, memory_buffer + i * 2 * region_size, region_size, i);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    umf_result = umfFixedMemoryProviderParamsSetNumArenas(params, 2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result =
+        umfMemoryProviderCreate(umfFixedMemoryProviderOps(), params, &provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umfFixedMemoryProviderParamsDestroy(params);
+
+    // the calling thread uses the memory of all regions
+    const int num_pages = num_regions * 4;
+    void *ptrs[num_pages] = {nullptr};
+    for (int i = 0; i < num_pages; i++) {
+        umf_result =
+            umfMemoryProviderAlloc(provider, page_size, page_size, &ptrs[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_NE(ptrs[i], nullptr);
+
+        size_t offset = (size_t)((char *)ptrs[i] - memory_buffer);
+        ASSERT_LT(offset % (2 * region_size), region_size);
+    }
+
+    void *ptr_oom = nullptr;
+    umf_result =
+        umfMemoryProviderAlloc(provider, page_size, page_size, &ptr_oom);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+
+    for (int i = 0; i < num_pages; i++) {
+        umf_result = umfMemoryProviderFree(provider, ptrs[i], page_size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    umfMemoryProviderDestroy(provider);
+}
+
+TEST_P(FixedProviderTest, allocation_resize) {
+    umf_result_t umf_result;
+    void *ptr = nullptr;
+    size_t size = page_size;
+
+    umf_result = umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    // grow the allocation in place and shrink it back
+    umf_result = umfMemoryProviderAllocationResize(provider.get(), ptr, size,
+                                                   4 * size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    memset(ptr, 0xFF, 4 * size);
+
+    umf_result = umfMemoryProviderAllocationResize(provider.get(), ptr,
+                                                   4 * size, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the allocation cannot exceed the buffer
+    umf_result = umfMemoryProviderAllocationResize(provider.get(), ptr, size,
+                                                   memory_size + size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
 TEST_P(FixedProviderTest, alloc_size_exceeds_buffer) {
     size_t size = memory_size + page_size;
     test_alloc_failure(size, 0, UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY, 0);
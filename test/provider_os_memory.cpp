@@ -8,6 +8,10 @@
 #include "ipcFixtures.hpp"
 #include "test_helpers.h"
 
+#include <filesystem>
+
+#include <umf/ipc.h>
+#include <umf/memory_pool.h>
 #include <umf/memory_provider.h>
 #include <umf/pools/pool_disjoint.h>
 #include <umf/providers/provider_os_memory.h>
@@ -403,6 +407,259 @@ TEST_P(umfProviderTest, close_ipc_handle_wrong_visibility) {
     ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
+#ifdef __linux__
+static size_t count_open_fds() {
+    size_t count = 0;
+    for ([[maybe_unused]] auto &entry :
+         std::filesystem::directory_iterator("/proc/self/fd")) {
+        count++;
+    }
+    return count;
+}
+
+TEST_F(test, open_ipc_handles_reuse_fd) {
+    const size_t numAllocs = 16;
+    const size_t size = 64 * 1024;
+
+    umf_os_memory_provider_params_handle_t params = nullptr;
+    umf_result_t umf_result = umfOsMemoryProviderParamsCreate(&params);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result =
+        umfOsMemoryProviderParamsSetVisibility(params, UMF_MEM_MAP_SHARED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf::provider_unique_handle_t provider;
+    providerCreateExt(std::make_tuple(umfOsMemoryProviderOps(), params),
+                      &provider);
+    umfOsMemoryProviderParamsDestroy(params);
+    ASSERT_NE(provider, nullptr);
+
+    size_t handleSize = 0;
+    umf_result = umfMemoryProviderGetIPCHandleSize(provider.get(), &handleSize);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    std::vector<void *> ptrs(numAllocs);
+    std::vector<std::vector<char>> handles(numAllocs,
+                                           std::vector<char>(handleSize));
+    for (size_t i = 0; i < numAllocs; i++) {
+        umf_result = umfMemoryProviderAlloc(provider.get(), size, 0, &ptrs[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        memset(ptrs[i], (int)i, size);
+        umf_result = umfMemoryProviderGetIPCHandle(provider.get(), ptrs[i],
+                                                   size, handles[i].data());
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    // all handles are mapped from a single duplicate of the provider's fd
+    size_t fdsBefore = count_open_fds();
+    std::vector<void *> opened(numAllocs);
+    for (size_t i = 0; i < numAllocs; i++) {
+        umf_result = umfMemoryProviderOpenIPCHandle(
+            provider.get(), handles[i].data(), &opened[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_EQ(*(char *)opened[i], (char)i);
+    }
+    ASSERT_LE(count_open_fds(), fdsBefore + 1);
+
+    for (size_t i = 0; i < numAllocs; i++) {
+        umf_result =
+            umfMemoryProviderCloseIPCHandle(provider.get(), opened[i], size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    // the duplicate is closed together with the last mapping
+    ASSERT_EQ(count_open_fds(), fdsBefore);
+
+    for (size_t i = 0; i < numAllocs; i++) {
+        umf_result =
+            umfMemoryProviderPutIPCHandle(provider.get(), handles[i].data());
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        umf_result = umfMemoryProviderFree(provider.get(), ptrs[i], size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+}
+#endif
+
+TEST_F(test, ipc_handle_of_part_of_allocation) {
+    const size_t slabSize = 16 * 1024 * 1024;
+    const size_t bufferSize = 4096;
+    const size_t numBuffers = 4;
+
+    umf_os_memory_provider_params_handle_t providerParams = nullptr;
+    umf_result_t umf_result = umfOsMemoryProviderParamsCreate(&providerParams);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = umfOsMemoryProviderParamsSetVisibility(providerParams,
+                                                        UMF_MEM_MAP_SHARED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf::provider_unique_handle_t provider;
+    providerCreateExt(
+        std::make_tuple(umfOsMemoryProviderOps(), (void *)providerParams),
+        &provider);
+    umfOsMemoryProviderParamsDestroy(providerParams);
+    ASSERT_NE(provider, nullptr);
+
+    // small buffers are allocated from a single large slab
+    umf_disjoint_pool_params_handle_t poolParams = nullptr;
+    umf_result = umfDisjointPoolParamsCreate(&poolParams);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = umfDisjointPoolParamsSetSlabMinSize(poolParams, slabSize);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_memory_pool_handle_t hPool = nullptr;
+    umf_result = umfPoolCreate(umfDisjointPoolOps(), provider.get(),
+                               poolParams, 0, &hPool);
+    umfDisjointPoolParamsDestroy(poolParams);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf::pool_unique_handle_t pool(hPool, &umfPoolDestroy);
+
+    umf_ipc_handler_handle_t hIPCHandler = nullptr;
+    umf_result = umfPoolGetIPCHandler(pool.get(), &hIPCHandler);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    std::vector<char *> ptrs(numBuffers);
+    std::vector<umf_ipc_handle_t> handles(numBuffers);
+    std::vector<void *> opened(numBuffers);
+    for (size_t i = 0; i < numBuffers; i++) {
+        ptrs[i] = (char *)umfPoolMalloc(pool.get(), bufferSize);
+        ASSERT_NE(ptrs[i], nullptr);
+        memset(ptrs[i], (int)i + 1, bufferSize);
+
+        size_t handleSize = 0;
+        umf_result = umfGetIPCHandle(ptrs[i], &handles[i], &handleSize);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        umf_result = umfOpenIPCHandle(hIPCHandler, handles[i], &opened[i]);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_EQ(*(char *)opened[i], (char)(i + 1));
+    }
+
+    // a handle of the inside of a buffer is opened as the same mapping
+    umf_ipc_handle_t innerHandle = nullptr;
+    size_t innerHandleSize = 0;
+    void *innerOpened = nullptr;
+    umf_result = umfGetIPCHandle(ptrs[0] + bufferSize / 2, &innerHandle,
+                                 &innerHandleSize);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = umfOpenIPCHandle(hIPCHandler, innerHandle, &innerOpened);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(innerOpened, (char *)opened[0] + bufferSize / 2);
+    ASSERT_EQ(umfCloseIPCHandle(innerOpened), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfPutIPCHandle(innerHandle), UMF_RESULT_SUCCESS);
+
+    // only a part of the slab is mapped
+    using regions_t = std::vector<umf_tracked_region_t>;
+    regions_t regions;
+    umf_result = umfPoolWalk(
+        pool.get(),
+        [](const umf_tracked_region_t *region, void *arg) {
+            ((regions_t *)arg)->push_back(*region);
+            return 0;
+        },
+        &regions);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    bool found = false;
+    for (auto &region : regions) {
+        if (opened[0] >= region.base &&
+            (char *)opened[0] < (char *)region.base + region.size) {
+            ASSERT_LT(region.size, slabSize);
+            found = true;
+        }
+    }
+    ASSERT_TRUE(found);
+
+    for (size_t i = 0; i < numBuffers; i++) {
+        ASSERT_EQ(umfCloseIPCHandle(opened[i]), UMF_RESULT_SUCCESS);
+        ASSERT_EQ(umfPutIPCHandle(handles[i]), UMF_RESULT_SUCCESS);
+        ASSERT_EQ(umfPoolFree(pool.get(), ptrs[i]), UMF_RESULT_SUCCESS);
+    }
+}
+
+// Pool that allocates every buffer directly from the memory provider
+// and does not know whether a pointer is the start of a buffer.
+struct provider_buffer_pool : public umf_test::pool_base_t {
+    static constexpr size_t BUFFER_SIZE = 8 * 1024 * 1024;
+
+    umf_result_t initialize(umf_memory_provider_handle_t provider) noexcept {
+        hProvider = provider;
+        return UMF_RESULT_SUCCESS;
+    }
+    void *malloc(size_t) noexcept {
+        void *ptr = nullptr;
+        if (umfMemoryProviderAlloc(hProvider, BUFFER_SIZE, 0, &ptr) !=
+            UMF_RESULT_SUCCESS) {
+            return nullptr;
+        }
+        return ptr;
+    }
+    size_t malloc_usable_size(void *) noexcept { return BUFFER_SIZE; }
+    umf_result_t free(void *ptr) noexcept {
+        return umfMemoryProviderFree(hProvider, ptr, BUFFER_SIZE);
+    }
+
+    umf_memory_provider_handle_t hProvider = nullptr;
+};
+
+umf_memory_pool_ops_t PROVIDER_BUFFER_POOL_OPS =
+    umf::poolMakeCOps<provider_buffer_pool, void>();
+
+TEST_F(test, ipc_handle_of_inside_of_allocation) {
+    const size_t offset = provider_buffer_pool::BUFFER_SIZE / 2 + 64;
+
+    umf_os_memory_provider_params_handle_t providerParams = nullptr;
+    umf_result_t umf_result = umfOsMemoryProviderParamsCreate(&providerParams);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = umfOsMemoryProviderParamsSetVisibility(providerParams,
+                                                        UMF_MEM_MAP_SHARED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf::provider_unique_handle_t provider;
+    providerCreateExt(
+        std::make_tuple(umfOsMemoryProviderOps(), (void *)providerParams),
+        &provider);
+    umfOsMemoryProviderParamsDestroy(providerParams);
+    ASSERT_NE(provider, nullptr);
+
+    umf_memory_pool_handle_t hPool = nullptr;
+    umf_result = umfPoolCreate(&PROVIDER_BUFFER_POOL_OPS, provider.get(),
+                               nullptr, 0, &hPool);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf::pool_unique_handle_t pool(hPool, &umfPoolDestroy);
+
+    umf_ipc_handler_handle_t hIPCHandler = nullptr;
+    umf_result = umfPoolGetIPCHandler(pool.get(), &hIPCHandler);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    char *ptr = (char *)umfPoolMalloc(pool.get(), 0);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xAB, provider_buffer_pool::BUFFER_SIZE);
+
+    umf_ipc_handle_t handle = nullptr;
+    size_t handleSize = 0;
+    void *opened = nullptr;
+    umf_result = umfGetIPCHandle(ptr, &handle, &handleSize);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = umfOpenIPCHandle(hIPCHandler, handle, &opened);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the pool cannot tell the size of a buffer inside of the allocation,
+    // so the whole allocation is shared and opened as the same mapping
+    umf_ipc_handle_t innerHandle = nullptr;
+    size_t innerHandleSize = 0;
+    void *innerOpened = nullptr;
+    umf_result = umfGetIPCHandle(ptr + offset, &innerHandle, &innerHandleSize);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = umfOpenIPCHandle(hIPCHandler, innerHandle, &innerOpened);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(innerOpened, (char *)opened + offset);
+    ASSERT_EQ(*((char *)innerOpened - offset), (char)0xAB);
+
+    ASSERT_EQ(umfCloseIPCHandle(innerOpened), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfPutIPCHandle(innerHandle), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfCloseIPCHandle(opened), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfPutIPCHandle(handle), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+}
+
 GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(umfIpcTest);
 
 void *createOsMemoryProviderParamsShared() {